@@ -0,0 +1,47 @@
+# Turns resource files into constexpr byte arrays so they can be compiled into the executable.
+#
+# Usage: cmake -DROOT=<res dir> -DRESOURCES=<file|file|...> -DOUTPUT=<header> -P embedResources.cmake
+#
+# Each file becomes a constexpr array named after its path relative to ROOT, followed by a
+# lookup table of EmbeddedResource entries. Every array gets a trailing zero byte (not counted
+# in its size) so text resources such as shaders can be used as C strings directly.
+
+string(REPLACE "|" ";" RESOURCES "${RESOURCES}")
+
+set(ARRAYS "")
+set(TABLE "")
+foreach(RESOURCE ${RESOURCES})
+    file(RELATIVE_PATH NAME ${ROOT} ${RESOURCE})
+    string(MAKE_C_IDENTIFIER "res_${NAME}" IDENTIFIER)
+
+    file(READ ${RESOURCE} HEX HEX)
+    string(LENGTH "${HEX}" HEX_LENGTH)
+    math(EXPR SIZE "${HEX_LENGTH} / 2")
+    string(REGEX REPLACE "([0-9a-f][0-9a-f])" "0x\\1," BYTES "${HEX}")
+
+    string(APPEND ARRAYS "inline constexpr unsigned char ${IDENTIFIER}[] = {${BYTES}0x00};\n")
+    string(APPEND TABLE "    {\"${NAME}\", ${IDENTIFIER}, ${SIZE}},\n")
+endforeach()
+
+file(WRITE ${OUTPUT}.tmp
+"// Generated by cmake/embedResources.cmake, do not edit.
+#ifndef GRAPHICS_EMBEDDEDRESOURCES_H
+#define GRAPHICS_EMBEDDEDRESOURCES_H
+
+#include <cstddef>
+
+struct EmbeddedResource {
+    const char *name;
+    const unsigned char *data;
+    size_t size;
+};
+
+${ARRAYS}
+inline constexpr EmbeddedResource EMBEDDED_RESOURCES[] = {
+${TABLE}};
+
+#endif //GRAPHICS_EMBEDDEDRESOURCES_H
+")
+# only touch the header when it changes so dependent files aren't rebuilt for nothing
+configure_file(${OUTPUT}.tmp ${OUTPUT} COPYONLY)
+file(REMOVE ${OUTPUT}.tmp)
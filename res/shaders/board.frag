@@ -0,0 +1,14 @@
+#version 330 core
+in vec2 TexCoords;
+out vec4 FragColor;
+
+// one texel per cell: 1 = light on, 0 = light off
+uniform sampler2D lights;
+uniform vec4 onColor;
+uniform vec4 offColor;
+
+void main()
+{
+    // far zoomed out, a pixel covers several cells and the mipmaps blend them
+    FragColor = mix(offColor, onColor, texture(lights, TexCoords).r);
+}
@@ -0,0 +1,20 @@
+#version 330 core
+layout (location = 0) in vec2 aPos;
+layout (location = 1) in vec2 aTexCoords; // normalized shorts
+out vec2 TexCoords;
+
+// per-frame constants shared by every shader (see gl/frameUniforms.h)
+layout (std140) uniform Frame {
+    mat4 projection;
+    mat4 view;
+    vec4 viewport;
+    vec2 hover;
+    float time;
+};
+
+void main()
+{
+    // the board quad is in world space, so it moves with the camera
+    gl_Position = projection * view * vec4(aPos, 0.0, 1.0);
+    TexCoords = aTexCoords;
+}
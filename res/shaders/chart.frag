@@ -0,0 +1,15 @@
+#version 330 core
+in vec2 screenPos;
+out vec4 FragColor;
+
+uniform vec4 color;
+uniform vec2 screenMin;
+uniform vec2 screenMax;
+
+void main()
+{
+    // whatever lies outside the chart's rectangle (e.g. the points just past its edges) is cut off
+    if (any(lessThan(screenPos, screenMin)) || any(greaterThan(screenPos, screenMax)))
+        discard;
+    FragColor = color;
+}
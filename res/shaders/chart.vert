@@ -0,0 +1,27 @@
+#version 330 core
+layout (location = 0) in vec2 aPoint; // in the chart's units
+
+// per-frame constants shared by every shader (see gl/frameUniforms.h)
+layout (std140) uniform Frame {
+    mat4 projection;
+    mat4 view;
+    vec4 viewport;
+    vec2 hover;
+    float time;
+};
+
+// the chart's data window and where it is on screen (see ChartRenderer)
+uniform vec2 dataMin;
+uniform vec2 dataScale; // pixels per unit
+uniform vec2 screenMin;
+uniform float pointSize;
+
+out vec2 screenPos;
+
+void main()
+{
+    // charts are drawn in screen space like text, the camera doesn't move them
+    screenPos = screenMin + (aPoint - dataMin) * dataScale;
+    gl_Position = projection * vec4(screenPos, 0.0, 1.0);
+    gl_PointSize = pointSize;
+}
@@ -0,0 +1,49 @@
+#version 330 core
+in vec2 TexCoords;
+out vec4 FragColor;
+
+uniform sampler2D densities;
+uniform float peak;   // about the highest density in the texture
+uniform float extent; // millimetres from the bull to the texture's edges
+
+const float PI = 3.14159265;
+// the wires of the board (see BoardModel), millimetres from the bull
+const float RINGS[6] = float[](6.35, 15.9, 99.0, 107.0, 162.0, 170.0);
+
+// cold to hot: dark blue, cyan, green, yellow, red, white
+vec3 ramp(float t)
+{
+    const vec3 STOPS[6] = vec3[](vec3(0.0, 0.0, 0.5), vec3(0.0, 0.8, 1.0), vec3(0.1, 0.9, 0.2),
+                                 vec3(1.0, 0.9, 0.0), vec3(1.0, 0.1, 0.0), vec3(1.0, 1.0, 1.0));
+    float at = clamp(t, 0.0, 1.0) * 5.0;
+    int i = min(int(at), 4);
+    return mix(STOPS[i], STOPS[i + 1], at - float(i));
+}
+
+void main()
+{
+    // log scaled, so a handful of darts still shows next to the thousands in the treble 20
+    float density = texture(densities, TexCoords).r;
+    float t = log(1.0 + density) / log(1.0 + peak);
+    vec4 heat = vec4(ramp(t), smoothstep(0.0, 0.1, t) * 0.85);
+
+    // the wires, about a pixel wide whatever the size of the square
+    vec2 mm = (TexCoords * 2.0 - 1.0) * extent;
+    float r = length(mm);
+    float pixel = fwidth(r);
+    float wire = 0.0;
+    for (int i = 0; i < 6; ++i)
+        wire = max(wire, 1.0 - abs(r - RINGS[i]) / pixel);
+    // the segments' edges are 9 degrees either side of their middles, the 20's is straight up
+    if (r > RINGS[1] && r < RINGS[5]) {
+        float segment = PI / 10.0;
+        float angle = atan(mm.y, mm.x) - (PI / 2.0 - segment / 2.0);
+        float edge = abs(angle - segment * round(angle / segment)) * r;
+        wire = max(wire, 1.0 - edge / pixel);
+    }
+    wire = clamp(wire, 0.0, 1.0) * 0.6;
+
+    FragColor = vec4(mix(heat.rgb, vec3(0.8), wire), max(heat.a, wire));
+    if (FragColor.a <= 0.0)
+        discard;
+}
@@ -0,0 +1,24 @@
+#version 330 core
+
+// per-frame constants shared by every shader (see gl/frameUniforms.h)
+layout (std140) uniform Frame {
+    mat4 projection;
+    mat4 view;
+    vec4 viewport;
+    vec2 hover;
+    float time;
+};
+
+// the square the heatmap is drawn in, pixels from the bottom left of the window
+uniform vec2 screenMin;
+uniform vec2 screenMax;
+
+out vec2 TexCoords;
+
+void main()
+{
+    // no vertex data, the corners come from the vertex number (drawn as a 4 vertex strip)
+    TexCoords = vec2(gl_VertexID & 1, gl_VertexID >> 1);
+    // drawn in screen space like text, the camera doesn't move it
+    gl_Position = projection * vec4(mix(screenMin, screenMax, TexCoords), 0.0, 1.0);
+}
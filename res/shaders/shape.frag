@@ -1,13 +1,13 @@
 #version 330 core
 
-out vec4 FragColor;
+in vec4 shapeColor;
 
-uniform vec4 shapeColor;
+out vec4 FragColor;
 
 void main()
 {
     // How does the fragment shader know about the shapeColor variable?
-    // It is passed as a uniform variable from the shape's setUniform method.
+    // It is passed per shape (instance) from SceneRenderer through the vertex shader.
     // FragColor is a built-in variable that holds the color of the fragment.
     FragColor = shapeColor;
-}
\ No newline at end of file
+}
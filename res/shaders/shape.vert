@@ -1,11 +1,24 @@
 #version 330 core
 
-layout (location = 0) in vec2 aPos;
+layout (location = 0) in vec2 aPos;      // unit mesh vertex (normalized shorts)
+layout (location = 1) in vec2 aPosition; // per shape
+layout (location = 2) in vec2 aSize;     // per shape (half floats)
+layout (location = 3) in vec4 aColor;    // per shape (normalized bytes)
 
-uniform mat4 model;
-uniform mat4 projection;
+// per-frame constants shared by every shader (see gl/frameUniforms.h)
+layout (std140) uniform Frame {
+    mat4 projection;
+    mat4 view;
+    vec4 viewport;
+    vec2 hover;
+    float time;
+};
+
+out vec4 shapeColor;
 
 void main()
 {
-    gl_Position = projection * model * vec4(aPos.x, aPos.y, 0.0, 1.0);
-}
\ No newline at end of file
+    // scale the unit mesh to the shape's size, move it to the shape's position, then look at it through the camera
+    gl_Position = projection * view * vec4(aPosition + aPos * aSize, 0.0, 1.0);
+    shapeColor = aColor;
+}
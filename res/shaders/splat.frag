@@ -0,0 +1,11 @@
+#version 330 core
+in vec2 offset;
+out float density;
+
+uniform float sigma;
+
+void main()
+{
+    // added onto the texture (blending is GL_ONE, GL_ONE), so a dart is 1 at its centre
+    density = exp(-dot(offset, offset) / (2.0 * sigma * sigma));
+}
@@ -0,0 +1,17 @@
+#version 330 core
+layout (location = 0) in vec2 aDart; // per instance, tenths of millimetres from the bull
+
+// see HeatmapRenderer
+uniform float extent; // millimetres from the bull to the texture's edges
+uniform float radius; // millimetres from the dart to the sprite's edges
+
+out vec2 offset; // millimetres from the dart
+
+void main()
+{
+    // a quad around the dart, its corners from the vertex number (drawn as a 4 vertex strip)
+    vec2 corner = vec2(gl_VertexID & 1, gl_VertexID >> 1) * 2.0 - 1.0;
+    offset = corner * radius;
+    // straight to clip space, the texture covers -extent to extent both ways
+    gl_Position = vec4((aDart * 0.1 + offset) / extent, 0.0, 1.0);
+}
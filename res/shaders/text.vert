@@ -1,11 +1,20 @@
 #version 330 core
-layout (location = 0) in vec4 vertex; // <vec2 pos, vec2 tex>
+layout (location = 0) in vec2 aPos;
+layout (location = 1) in vec2 aTexCoords; // normalized shorts
 out vec2 TexCoords;
 
-uniform mat4 projection;
+// per-frame constants shared by every shader (see gl/frameUniforms.h)
+layout (std140) uniform Frame {
+    mat4 projection;
+    mat4 view;
+    vec4 viewport;
+    vec2 hover;
+    float time;
+};
 
 void main()
 {
-    gl_Position = projection * vec4(vertex.xy, 0.0, 1.0);
-    TexCoords = vertex.zw;
-}  
\ No newline at end of file
+    // text is drawn in screen space, so it ignores the camera (view)
+    gl_Position = projection * vec4(aPos, 0.0, 1.0);
+    TexCoords = aTexCoords;
+}
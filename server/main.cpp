@@ -0,0 +1,93 @@
+#include "matchServer.h"
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <iostream>
+#include <string>
+#include <thread>
+
+// the server signal handlers stop (signal handlers can't take arguments)
+static MatchServer *running = nullptr;
+
+static void onSignal(int) {
+    if (running != nullptr)
+        running->stop();
+}
+
+int main(int argc, char *argv[]) {
+    // --host <ipv4> --port <n> (0 for none) --unix <path> --workers <n> --stats <seconds> (0 for none)
+    // --spectator-port <n> (0 for none) --spectator-unix <path> --publish-ms <n>
+    // --idle-match-s <seconds> --max-open-matches <n> (per worker)
+    MatchServerConfig config;
+    int statsInterval = 5;
+    for (int i = 1; i + 1 < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--host")
+            config.host = argv[++i];
+        else if (arg == "--port")
+            config.port = std::stoi(argv[++i]);
+        else if (arg == "--unix")
+            config.unixPath = argv[++i];
+        else if (arg == "--workers")
+            config.workers = std::stoi(argv[++i]);
+        else if (arg == "--stats")
+            statsInterval = std::stoi(argv[++i]);
+        else if (arg == "--spectator-port")
+            config.spectatorPort = std::stoi(argv[++i]);
+        else if (arg == "--spectator-unix")
+            config.spectatorUnixPath = argv[++i];
+        else if (arg == "--publish-ms")
+            config.publishIntervalMs = std::stoi(argv[++i]);
+        else if (arg == "--idle-match-s")
+            config.idleMatchSeconds = std::stoi(argv[++i]);
+        else if (arg == "--max-open-matches")
+            config.maxOpenMatches = std::stoul(argv[++i]);
+    }
+
+    MatchServer server(config);
+    if (!server.listen())
+        return 1;
+
+    running = &server;
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+    std::signal(SIGPIPE, SIG_IGN);
+
+    std::cout << "Match server listening";
+    if (config.port > 0)
+        std::cout << " on " << config.host << ":" << config.port;
+    if (!config.unixPath.empty())
+        std::cout << " on unix:" << config.unixPath;
+    if (config.spectatorPort > 0)
+        std::cout << ", spectators on " << config.host << ":" << config.spectatorPort;
+    if (!config.spectatorUnixPath.empty())
+        std::cout << ", spectators on unix:" << config.spectatorUnixPath;
+    std::cout << std::endl;
+
+    // the event loop runs here, the stats are printed from a second thread
+    std::atomic<bool> done{false};
+    std::thread stats([&]() {
+        MatchServer::Stats last = server.getStats();
+        auto interval = std::chrono::seconds(statsInterval);
+        auto next = std::chrono::steady_clock::now() + interval;
+        while (statsInterval > 0 && !done) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            if (std::chrono::steady_clock::now() < next)
+                continue;
+            next += interval;
+            MatchServer::Stats now = server.getStats();
+            std::cout << "connections " << now.connections << ", matches " << now.matches
+                      << ", throws/s " << (now.throws - last.throws) / statsInterval
+                      << ", requests/s " << (now.requests - last.requests) / statsInterval
+                      << ", spectators " << now.spectators << ", resyncs " << now.resyncs << std::endl;
+            last = now;
+        }
+    });
+
+    server.run();
+    done = true;
+    stats.join();
+    running = nullptr;
+    return 0;
+}
@@ -0,0 +1,790 @@
+#include "matchServer.h"
+#include "../src/darts/checkout.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// epoll ids of the sockets that aren't connections (connection ids start after them)
+static const uint64_t TCP_LISTENER = 1;
+static const uint64_t UNIX_LISTENER = 2;
+static const uint64_t LOOP_WAKE = 3;
+static const uint64_t SPECTATOR_TCP_LISTENER = 4;
+static const uint64_t SPECTATOR_UNIX_LISTENER = 5;
+static const uint64_t PUBLISH_TIMER = 6;
+static const uint64_t FIRST_CONNECTION = 16;
+
+// how many epoll events are handled per wait
+static const int MAX_EVENTS = 256;
+// how much is read from a connection at a time
+static const size_t READ_SIZE = 64 * 1024;
+// stop reading from a client that has this much unread output (it isn't keeping up)
+static const size_t MAX_PENDING_OUTPUT = 4 << 20;
+// finished matches each worker keeps around for getMatch before dropping the oldest
+static const size_t KEEP_FINISHED_MATCHES = 4096;
+// how often a worker looks for idle matches (it's a pass over all of them)
+static const std::chrono::seconds IDLE_SWEEP_INTERVAL(60);
+// the connection of a worker's note that it dropped a match, no client has it
+static const uint64_t DROPPED_MATCH = 0;
+// a spectator with this much unsent stream is dropped back to the next keyframe
+static const size_t MAX_SUBSCRIBER_BACKLOG = 1 << 20;
+
+static void wake(int fd) {
+    uint64_t one = 1;
+    // the only failure is the counter overflowing, in which case the other side is awake anyway
+    ssize_t ignored = write(fd, &one, sizeof(one));
+    (void)ignored;
+}
+
+/// @brief Opens a non-blocking TCP socket listening on host:port
+/// @return the socket, or -1 (the reason is printed)
+static int openTcpListener(const string &host, int port) {
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    if (inet_pton(AF_INET, host.c_str(), &addr.sin_addr) != 1) {
+        std::cout << "ERROR::MATCHSERVER: Not an IPv4 address: " << host << std::endl;
+        return -1;
+    }
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    int on = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    if (fd < 0 || bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0 || listen(fd, SOMAXCONN) != 0) {
+        std::cout << "ERROR::MATCHSERVER: Could not listen on " << host << ":" << port << ": " << std::strerror(errno) << std::endl;
+        if (fd >= 0)
+            close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/// @brief Opens a non-blocking Unix socket listening on path
+/// @return the socket, or -1 (the reason is printed)
+static int openUnixListener(const string &path) {
+    sockaddr_un addr{};
+    if (path.size() >= sizeof(addr.sun_path)) {
+        std::cout << "ERROR::MATCHSERVER: Socket path too long: " << path << std::endl;
+        return -1;
+    }
+    addr.sun_family = AF_UNIX;
+    std::strcpy(addr.sun_path, path.c_str());
+    // a socket file left behind by a previous run would make bind() fail
+    unlink(path.c_str());
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0 || bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0 || listen(fd, SOMAXCONN) != 0) {
+        std::cout << "ERROR::MATCHSERVER: Could not listen on " << path << ": " << std::strerror(errno) << std::endl;
+        if (fd >= 0)
+            close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+MatchServer::MatchServer(MatchServerConfig config) : config(std::move(config)), nextConnection(FIRST_CONNECTION) {}
+
+MatchServer::~MatchServer() {
+    running = false;
+    for (unique_ptr<Worker> &worker : workers) {
+        wake(worker->wakeFd);
+        if (worker->thread.joinable())
+            worker->thread.join();
+        close(worker->wakeFd);
+    }
+    for (auto &entry : connections)
+        close(entry.second.fd);
+    for (auto &entry : subscribers)
+        close(entry.second.fd);
+    for (int fd : {tcpFd, unixFd, spectatorTcpFd, spectatorUnixFd, publishTimerFd, loopWakeFd, epollFd}) {
+        if (fd >= 0)
+            close(fd);
+    }
+    if (unixFd >= 0)
+        unlink(config.unixPath.c_str());
+    if (spectatorUnixFd >= 0)
+        unlink(config.spectatorUnixPath.c_str());
+}
+
+bool MatchServer::listen() {
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    loopWakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epollFd < 0 || loopWakeFd < 0) {
+        std::cout << "ERROR::MATCHSERVER: Could not create epoll instance: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.u64 = LOOP_WAKE;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, loopWakeFd, &event);
+
+    // opens a listener if it's configured and registers it with epoll
+    auto add = [&](int fd, uint64_t id) {
+        if (fd < 0)
+            return false;
+        event.data.u64 = id;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event);
+        return true;
+    };
+    if (config.port > 0 && !add(tcpFd = openTcpListener(config.host, config.port), TCP_LISTENER))
+        return false;
+    if (!config.unixPath.empty() && !add(unixFd = openUnixListener(config.unixPath), UNIX_LISTENER))
+        return false;
+    if (config.spectatorPort > 0 && !add(spectatorTcpFd = openTcpListener(config.host, config.spectatorPort), SPECTATOR_TCP_LISTENER))
+        return false;
+    if (!config.spectatorUnixPath.empty() && !add(spectatorUnixFd = openUnixListener(config.spectatorUnixPath), SPECTATOR_UNIX_LISTENER))
+        return false;
+
+    // publish to spectators on a fixed interval, however busy the matches are
+    if (spectatorTcpFd >= 0 || spectatorUnixFd >= 0) {
+        publishTimerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+        long interval = std::max(1, config.publishIntervalMs) * 1000000L;
+        itimerspec spec{};
+        spec.it_interval.tv_sec = spec.it_value.tv_sec = interval / 1000000000L;
+        spec.it_interval.tv_nsec = spec.it_value.tv_nsec = interval % 1000000000L;
+        timerfd_settime(publishTimerFd, 0, &spec, nullptr);
+        add(publishTimerFd, PUBLISH_TIMER);
+    }
+
+    if (tcpFd < 0 && unixFd < 0) {
+        std::cout << "ERROR::MATCHSERVER: Nothing to listen on (no port or socket path)" << std::endl;
+        return false;
+    }
+
+    int count = config.workers;
+    if (count <= 0)
+        count = std::max(1, static_cast<int>(std::thread::hardware_concurrency()) - 1);
+    running = true;
+    for (int i = 0; i < count; ++i) {
+        workers.push_back(std::make_unique<Worker>());
+        Worker &worker = *workers.back();
+        // blocking, the worker sleeps on it when it has nothing to do
+        worker.wakeFd = eventfd(0, EFD_CLOEXEC);
+        worker.thread = std::thread(&MatchServer::workerLoop, this, std::ref(worker));
+    }
+    return true;
+}
+
+void MatchServer::stop() {
+    running = false;
+    if (loopWakeFd >= 0)
+        wake(loopWakeFd);
+}
+
+MatchServer::Stats MatchServer::getStats() const {
+    return {connectionCount.load(std::memory_order_relaxed), requestCount.load(std::memory_order_relaxed),
+            throwCount.load(std::memory_order_relaxed), matchCount.load(std::memory_order_relaxed),
+            spectatorCount.load(std::memory_order_relaxed), resyncCount.load(std::memory_order_relaxed)};
+}
+
+// --------------------------------------------------------
+// Event loop
+// --------------------------------------------------------
+
+void MatchServer::run() {
+    epoll_event events[MAX_EVENTS];
+
+    while (running.load(std::memory_order_acquire)) {
+        // connections waiting on a full queue are retried soon, otherwise sleep until something happens
+        int count = epoll_wait(epollFd, events, MAX_EVENTS, stalled.empty() ? -1 : 1);
+        if (count < 0 && errno != EINTR) {
+            std::cout << "ERROR::MATCHSERVER: epoll_wait failed: " << std::strerror(errno) << std::endl;
+            break;
+        }
+
+        for (int i = 0; i < count; ++i) {
+            uint64_t id = events[i].data.u64;
+            if (id == TCP_LISTENER) {
+                accept(tcpFd);
+                continue;
+            }
+            if (id == UNIX_LISTENER) {
+                accept(unixFd);
+                continue;
+            }
+            if (id == LOOP_WAKE) {
+                uint64_t value;
+                ssize_t ignored = read(loopWakeFd, &value, sizeof(value));
+                (void)ignored;
+                continue;
+            }
+            if (id == SPECTATOR_TCP_LISTENER) {
+                acceptSpectator(spectatorTcpFd);
+                continue;
+            }
+            if (id == SPECTATOR_UNIX_LISTENER) {
+                acceptSpectator(spectatorUnixFd);
+                continue;
+            }
+            if (id == PUBLISH_TIMER) {
+                uint64_t expirations;
+                ssize_t ignored = read(publishTimerFd, &expirations, sizeof(expirations));
+                (void)ignored;
+                // pick up every state change made so far before publishing
+                collectResponses();
+                publish();
+                continue;
+            }
+
+            auto subscriber = subscribers.find(id);
+            if (subscriber != subscribers.end()) {
+                if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+                    closeSubscriber(id);
+                    continue;
+                }
+                if (events[i].events & EPOLLOUT)
+                    writeTo(id, subscriber->second);
+                if ((events[i].events & EPOLLIN) && subscribers.count(id) != 0) {
+                    // spectators don't send anything, this is only to notice them leaving
+                    char discard[256];
+                    ssize_t got = recv(subscriber->second.fd, discard, sizeof(discard), 0);
+                    if (got == 0 || (got < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR))
+                        closeSubscriber(id);
+                }
+                continue;
+            }
+
+            auto found = connections.find(id);
+            if (found == connections.end())
+                continue;
+            if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+                closeConnection(id);
+                continue;
+            }
+            if (events[i].events & EPOLLOUT)
+                writeTo(id, found->second);
+            if ((events[i].events & EPOLLIN) && connections.count(id) != 0)
+                readFrom(id, found->second);
+        }
+
+        // retry the frames that didn't fit last time (responses collected below make room)
+        collectResponses();
+        if (!stalled.empty()) {
+            vector<uint64_t> retry;
+            retry.swap(stalled);
+            for (uint64_t id : retry) {
+                auto found = connections.find(id);
+                if (found == connections.end())
+                    continue;
+                found->second.stalled = false;
+                if (handleFrames(id, found->second))
+                    updateEvents(id, found->second);
+            }
+        }
+
+        // one wake-up per worker per loop iteration, however many requests it was given
+        for (unique_ptr<Worker> &worker : workers) {
+            if (worker->notify) {
+                worker->notify = false;
+                wake(worker->wakeFd);
+            }
+        }
+
+        // write everything that was answered this iteration in one go per connection
+        collectResponses();
+        for (uint64_t id : dirty) {
+            auto found = connections.find(id);
+            if (found == connections.end())
+                continue;
+            found->second.dirty = false;
+            writeTo(id, found->second);
+        }
+        dirty.clear();
+    }
+}
+
+void MatchServer::accept(int listenFd) {
+    while (true) {
+        int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+                std::cout << "ERROR::MATCHSERVER: accept failed: " << std::strerror(errno) << std::endl;
+            return;
+        }
+        if (listenFd == tcpFd) {
+            int on = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+        }
+
+        uint64_t id = nextConnection++;
+        Connection &connection = connections[id];
+        connection.fd = fd;
+        connectionCount.fetch_add(1, std::memory_order_relaxed);
+
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.u64 = id;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event);
+        connection.events = EPOLLIN;
+    }
+}
+
+void MatchServer::readFrom(uint64_t id, Connection &connection) {
+    size_t size = connection.in.size();
+    connection.in.resize(size + READ_SIZE);
+    ssize_t got = recv(connection.fd, connection.in.data() + size, READ_SIZE, 0);
+    connection.in.resize(size + (got > 0 ? got : 0));
+
+    if (got == 0 || (got < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+        closeConnection(id);
+        return;
+    }
+    if (handleFrames(id, connection))
+        updateEvents(id, connection);
+}
+
+bool MatchServer::handleFrames(uint64_t id, Connection &connection) {
+    MatchMessage message;
+    while (true) {
+        long used = decodeMessage(connection.in.data() + connection.inOffset, connection.in.size() - connection.inOffset, message);
+        if (used == 0)
+            break;
+        if (used < 0) {
+            // not speaking the protocol, there's no telling where the next frame starts
+            closeConnection(id);
+            return false;
+        }
+        if (!dispatch(id, connection, message)) {
+            // leave the frame in the buffer and try again next loop iteration
+            connection.stalled = true;
+            stalled.push_back(id);
+            break;
+        }
+        connection.inOffset += used;
+        requestCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // drop what has been handled once it's all gone, or it's piling up in front of the buffer
+    if (connection.inOffset == connection.in.size()) {
+        connection.in.clear();
+        connection.inOffset = 0;
+    }
+    else if (connection.inOffset >= READ_SIZE) {
+        connection.in.erase(connection.in.begin(), connection.in.begin() + connection.inOffset);
+        connection.inOffset = 0;
+    }
+    return true;
+}
+
+bool MatchServer::dispatch(uint64_t id, Connection &connection, const MatchMessage &message) {
+    MatchMessage request = message;
+
+    switch (message.type) {
+        case MatchMessage::createMatch: {
+            if (message.players < 1 || message.players > X01Game::MAX_PLAYERS || message.startScore < 2)
+                break;
+            // the event loop hands out ids, so it knows which worker will own the match
+            request.match = nextMatch;
+            Worker &worker = *workers[request.match % workers.size()];
+            if (!worker.requests.push({id, request}))
+                return false;
+            worker.notify = true;
+            // skip 0 when the ids wrap around, it's never a valid match
+            if (++nextMatch == 0)
+                nextMatch = 1;
+            return true;
+        }
+        case MatchMessage::submitThrow:
+        case MatchMessage::getMatch: {
+            Worker &worker = *workers[request.match % workers.size()];
+            if (!worker.requests.push({id, request}))
+                return false;
+            worker.notify = true;
+            return true;
+        }
+        default:
+            break;
+    }
+
+    // not a request a client can make, or asked for something impossible
+    MatchMessage reply;
+    reply.type = MatchMessage::error;
+    reply.sequence = message.sequence;
+    reply.match = message.match;
+    reply.errorCode = MatchMessage::badRequest;
+    respond(id, connection, reply);
+    return true;
+}
+
+void MatchServer::respond(uint64_t id, Connection &connection, const MatchMessage &message) {
+    size_t size = connection.out.size();
+    connection.out.resize(size + MAX_FRAME_SIZE);
+    connection.out.resize(size + encodeMessage(message, connection.out.data() + size));
+    if (!connection.dirty) {
+        connection.dirty = true;
+        dirty.push_back(id);
+    }
+}
+
+void MatchServer::collectResponses() {
+    Envelope envelope;
+    for (unique_ptr<Worker> &worker : workers) {
+        while (worker->responses.pop(envelope)) {
+            if (envelope.connection == DROPPED_MATCH) {
+                // an abandoned match, it goes off the scoreboards too
+                encoder.retire(envelope.message.match);
+                continue;
+            }
+            observe(envelope.message);
+            // the client may have gone away while the worker was busy
+            auto found = connections.find(envelope.connection);
+            if (found != connections.end())
+                respond(envelope.connection, found->second, envelope.message);
+        }
+    }
+}
+
+void MatchServer::writeTo(uint64_t id, Connection &connection) {
+    while (connection.outOffset < connection.out.size()) {
+        ssize_t written = send(connection.fd, connection.out.data() + connection.outOffset,
+                               connection.out.size() - connection.outOffset, MSG_NOSIGNAL);
+        if (written < 0) {
+            if (errno == EINTR)
+                continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+                break;
+            closeConnection(id);
+            return;
+        }
+        connection.outOffset += written;
+    }
+    if (connection.outOffset == connection.out.size()) {
+        connection.out.clear();
+        connection.outOffset = 0;
+    }
+    updateEvents(id, connection);
+}
+
+void MatchServer::updateEvents(uint64_t id, Connection &connection) {
+    size_t pending = connection.out.size() - connection.outOffset;
+    uint32_t wanted = 0;
+    // a stalled connection already has a frame it can't hand off, and a slow reader gets no more work
+    if (!connection.stalled && pending < MAX_PENDING_OUTPUT)
+        wanted |= EPOLLIN;
+    if (pending > 0)
+        wanted |= EPOLLOUT;
+    if (wanted == connection.events)
+        return;
+
+    epoll_event event{};
+    event.events = wanted;
+    event.data.u64 = id;
+    epoll_ctl(epollFd, EPOLL_CTL_MOD, connection.fd, &event);
+    connection.events = wanted;
+}
+
+void MatchServer::closeConnection(uint64_t id) {
+    auto found = connections.find(id);
+    if (found == connections.end())
+        return;
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, found->second.fd, nullptr);
+    close(found->second.fd);
+    connections.erase(found);
+}
+
+// --------------------------------------------------------
+// Spectators
+// --------------------------------------------------------
+
+void MatchServer::acceptSpectator(int listenFd) {
+    while (true) {
+        int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+                std::cout << "ERROR::MATCHSERVER: accept failed: " << std::strerror(errno) << std::endl;
+            return;
+        }
+
+        uint64_t id = nextConnection++;
+        Subscriber &subscriber = subscribers[id];
+        subscriber.fd = fd;
+        spectatorCount.fetch_add(1, std::memory_order_relaxed);
+
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.u64 = id;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event);
+        subscriber.events = EPOLLIN;
+
+        // late joiners start from everything published so far
+        queueFrame(subscriber, currentKeyframe());
+        subscriber.needsKeyframe = false;
+        writeTo(id, subscriber);
+    }
+}
+
+void MatchServer::observe(const MatchMessage &response) {
+    if (publishTimerFd < 0)
+        return;
+    bool changed = response.type == MatchMessage::matchCreated ||
+                   (response.type == MatchMessage::throwResult && response.result != rejected);
+    if (!changed)
+        return;
+
+    SpectatorMatch match;
+    match.id = response.match;
+    match.players = response.players;
+    match.startScore = response.startScore;
+    match.doubleOut = response.doubleOut;
+    std::copy(std::begin(response.remaining), std::end(response.remaining), match.remaining);
+    match.current = response.current;
+    match.dartsInVisit = response.dartsInVisit;
+    match.winner = response.winner;
+    if (response.type == MatchMessage::throwResult) {
+        match.lastPlayer = response.player;
+        match.lastDart = response.dart;
+    }
+    if (match.winner < 0)
+        match.checkout = suggestCheckout(match.remaining[match.current], X01Game::DARTS_PER_VISIT - match.dartsInVisit, match.doubleOut);
+    encoder.update(match);
+}
+
+void MatchServer::publish() {
+    publishTick++;
+    bool keyframeTick = config.keyframeInterval > 0 && publishTick % config.keyframeInterval == 0;
+    // won matches stay on the scoreboards until the next keyframe, then they go
+    if (keyframeTick)
+        encoder.retireFinished();
+
+    bool changed = encoder.encodeDelta(publishTick, scratch);
+    Frame delta;
+    if (changed && !keyframeTick)
+        delta = std::make_shared<const vector<uint8_t>>(scratch);
+
+    for (auto &entry : subscribers) {
+        Subscriber &subscriber = entry.second;
+        if (keyframeTick || subscriber.needsKeyframe) {
+            subscriber.needsKeyframe = false;
+            queueFrame(subscriber, currentKeyframe());
+        }
+        else if (delta) {
+            queueFrame(subscriber, delta);
+        }
+    }
+
+    // queueFrame() may have closed nobody, but writing can, so go through a copy of the ids
+    vector<uint64_t> ids;
+    ids.reserve(subscribers.size());
+    for (auto &entry : subscribers)
+        if (!entry.second.frames.empty())
+            ids.push_back(entry.first);
+    for (uint64_t id : ids) {
+        auto found = subscribers.find(id);
+        if (found != subscribers.end())
+            writeTo(id, found->second);
+    }
+}
+
+MatchServer::Frame MatchServer::currentKeyframe() {
+    if (!keyframe || keyframeTick != publishTick) {
+        vector<uint8_t> frame;
+        encoder.encodeKeyframe(publishTick, frame);
+        keyframe = std::make_shared<const vector<uint8_t>>(std::move(frame));
+        keyframeTick = publishTick;
+    }
+    return keyframe;
+}
+
+void MatchServer::queueFrame(Subscriber &subscriber, const Frame &frame) {
+    if (subscriber.queued > 0 && subscriber.queued + frame->size() > MAX_SUBSCRIBER_BACKLOG) {
+        // Too far behind: forget the backlog (but finish the frame that is half written, or the
+        // stream would be corrupt) and catch up with a keyframe on the next publish.
+        while (subscriber.frames.size() > (subscriber.offset > 0 ? 1u : 0u))
+            subscriber.frames.pop_back();
+        subscriber.queued = subscriber.frames.empty() ? 0 : subscriber.frames.front()->size() - subscriber.offset;
+        subscriber.needsKeyframe = true;
+        resyncCount.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    subscriber.frames.push_back(frame);
+    subscriber.queued += frame->size();
+}
+
+void MatchServer::writeTo(uint64_t id, Subscriber &subscriber) {
+    while (!subscriber.frames.empty()) {
+        const vector<uint8_t> &frame = *subscriber.frames.front();
+        ssize_t written = send(subscriber.fd, frame.data() + subscriber.offset, frame.size() - subscriber.offset, MSG_NOSIGNAL);
+        if (written < 0) {
+            if (errno == EINTR)
+                continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+                break;
+            closeSubscriber(id);
+            return;
+        }
+        subscriber.offset += written;
+        subscriber.queued -= written;
+        if (subscriber.offset == frame.size()) {
+            subscriber.frames.pop_front();
+            subscriber.offset = 0;
+        }
+    }
+
+    uint32_t wanted = subscriber.frames.empty() ? EPOLLIN : EPOLLIN | EPOLLOUT;
+    if (wanted != subscriber.events) {
+        epoll_event event{};
+        event.events = wanted;
+        event.data.u64 = id;
+        epoll_ctl(epollFd, EPOLL_CTL_MOD, subscriber.fd, &event);
+        subscriber.events = wanted;
+    }
+}
+
+void MatchServer::closeSubscriber(uint64_t id) {
+    auto found = subscribers.find(id);
+    if (found == subscribers.end())
+        return;
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, found->second.fd, nullptr);
+    close(found->second.fd);
+    subscribers.erase(found);
+}
+
+// --------------------------------------------------------
+// Workers
+// --------------------------------------------------------
+
+void MatchServer::workerLoop(Worker &worker) {
+    Envelope envelope;
+    while (running.load(std::memory_order_acquire)) {
+        int handled = 0;
+        uint64_t throws = 0;
+        while (worker.requests.pop(envelope)) {
+            if (envelope.message.type == MatchMessage::submitThrow)
+                throws++;
+            envelope.message = handle(worker, envelope.message);
+            if (!pushResponse(worker, envelope))
+                return;
+            handled++;
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        if (now - worker.lastSweep >= IDLE_SWEEP_INTERVAL)
+            dropIdleMatches(worker, now);
+
+        if (handled > 0) {
+            throwCount.fetch_add(throws, std::memory_order_relaxed);
+            wake(loopWakeFd);
+            continue;
+        }
+
+        // nothing to do, sleep until the event loop queues something (or the server stops)
+        uint64_t value;
+        ssize_t ignored = read(worker.wakeFd, &value, sizeof(value));
+        (void)ignored;
+    }
+}
+
+bool MatchServer::pushResponse(Worker &worker, const Envelope &envelope) {
+    // the event loop never waits on us, so it will make room soon, unless it has stopped
+    while (!worker.responses.push(envelope)) {
+        if (!running.load(std::memory_order_acquire))
+            return false;
+        wake(loopWakeFd);
+        std::this_thread::yield();
+    }
+    return true;
+}
+
+void MatchServer::dropIdleMatches(Worker &worker, std::chrono::steady_clock::time_point now) {
+    worker.lastSweep = now;
+    const auto timeout = std::chrono::seconds(config.idleMatchSeconds);
+    bool droppedAny = false;
+    for (auto match = worker.matches.begin(); match != worker.matches.end();) {
+        // finished ones are dropped in the order they finished
+        if (match->second.game.getWinner() >= 0 || now - match->second.used < timeout) {
+            ++match;
+            continue;
+        }
+        Envelope dropped;
+        dropped.connection = DROPPED_MATCH;
+        dropped.message.match = match->first;
+        match = worker.matches.erase(match);
+        worker.open--;
+        droppedAny = true;
+        if (!pushResponse(worker, dropped))
+            return;
+    }
+    if (droppedAny)
+        wake(loopWakeFd);
+}
+
+MatchMessage MatchServer::handle(Worker &worker, const MatchMessage &request) {
+    MatchMessage reply;
+    reply.sequence = request.sequence;
+    reply.match = request.match;
+
+    // Replies carry the whole state of the match, even though the wire format only sends part of it
+    // to the client, so the event loop can publish it to spectators without asking the worker again.
+    auto fillState = [&reply](const X01Game &game) {
+        reply.players = static_cast<uint8_t>(game.getPlayers());
+        reply.startScore = static_cast<uint16_t>(game.getStartScore());
+        reply.doubleOut = game.isDoubleOut();
+        reply.current = static_cast<uint8_t>(game.getCurrentPlayer());
+        reply.winner = static_cast<int8_t>(game.getWinner());
+        reply.dartsInVisit = static_cast<uint8_t>(game.getDartsInVisit());
+        for (int i = 0; i < game.getPlayers(); ++i)
+            reply.remaining[i] = static_cast<uint16_t>(game.getRemaining(i));
+    };
+
+    auto now = std::chrono::steady_clock::now();
+    if (request.type == MatchMessage::createMatch) {
+        // abandoned matches would pile up forever, so there's a limit to the ones being played
+        if (worker.open >= config.maxOpenMatches)
+            dropIdleMatches(worker, now);
+        if (worker.open >= config.maxOpenMatches) {
+            reply.type = MatchMessage::error;
+            reply.errorCode = MatchMessage::serverBusy;
+            return reply;
+        }
+        auto created = worker.matches.emplace(request.match, HostedMatch{X01Game(request.players, request.startScore, request.doubleOut), now});
+        if (created.second)
+            worker.open++;
+        matchCount.fetch_add(1, std::memory_order_relaxed);
+        reply.type = MatchMessage::matchCreated;
+        fillState(created.first->second.game);
+        return reply;
+    }
+
+    auto found = worker.matches.find(request.match);
+    if (found == worker.matches.end()) {
+        reply.type = MatchMessage::error;
+        reply.errorCode = MatchMessage::unknownMatch;
+        return reply;
+    }
+    X01Game &game = found->second.game;
+    found->second.used = now;
+
+    if (request.type == MatchMessage::submitThrow) {
+        throwResult result = game.submit(request.player, request.dart);
+        reply.type = MatchMessage::throwResult;
+        reply.result = static_cast<uint8_t>(result);
+        reply.player = request.player % X01Game::MAX_PLAYERS;
+        reply.dart = request.dart;
+        fillState(game);
+
+        // keep a finished match around for a while so clients can still look at it, then drop it
+        if (result == checkout) {
+            worker.open--;
+            worker.finished.push_back(request.match);
+            if (worker.finished.size() > KEEP_FINISHED_MATCHES) {
+                worker.matches.erase(worker.finished.front());
+                worker.finished.pop_front();
+            }
+        }
+        return reply;
+    }
+
+    // getMatch
+    reply.type = MatchMessage::matchState;
+    fillState(game);
+    return reply;
+}
@@ -0,0 +1,229 @@
+#ifndef GRAPHICS_MATCHSERVER_H
+#define GRAPHICS_MATCHSERVER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "../src/darts/x01.h"
+#include "../src/net/protocol.h"
+#include "../src/net/spectatorStream.h"
+#include "../src/util/spscQueue.h"
+
+using std::string, std::vector, std::unique_ptr;
+
+/// @brief Where and how the match server listens
+struct MatchServerConfig {
+    /// @brief Address to accept TCP connections on (loopback only by default)
+    string host = "127.0.0.1";
+    /// @brief TCP port, 0 for no TCP listener
+    int port = 7878;
+    /// @brief Path of a Unix socket to accept connections on, empty for none
+    string unixPath;
+    /// @brief Number of worker threads running matches, 0 for one per core (minus the event loop's)
+    int workers = 0;
+
+    /// @brief TCP port spectators connect to for the state stream, 0 for none
+    int spectatorPort = 7879;
+    /// @brief Path of a Unix socket spectators connect to, empty for none
+    string spectatorUnixPath;
+    /// @brief How often changes are published to spectators (milliseconds)
+    int publishIntervalMs = 50;
+    /// @brief Every this many publishes, everyone gets a keyframe instead of a delta
+    int keyframeInterval = 40;
+
+    /// @brief A match nobody has thrown at or asked about for this long is dropped (seconds)
+    int idleMatchSeconds = 2 * 60 * 60;
+    /// @brief Matches still being played a worker holds at most, new ones are refused (serverBusy) past it
+    size_t maxOpenMatches = 65536;
+};
+
+/**
+ * @brief Hosts many X01 matches for scoring clients (see net/protocol.h).
+ * @details One thread runs an epoll event loop that accepts connections, reads and decodes frames
+ *          and writes responses; it never touches a match. Matches are split between worker threads
+ *          by id (match % workers), so each match is only ever used by one thread and needs no lock.
+ *          The loop hands a worker its requests through a lock-free SPSC queue and the worker hands
+ *          back responses through another, waking the other side with an eventfd once per batch.
+ *          When a worker's queue is full, the loop stops reading from the connection that filled it
+ *          (the frame stays in its buffer) until there is room again, so a flood of throws slows the
+ *          sender down instead of growing memory. Matches nobody uses any more are dropped after
+ *          idleMatchSeconds, and a worker refuses new matches past maxOpenMatches, so clients that
+ *          create matches and walk away can't grow it either.
+ *
+ *          Spectators (scoreboards, stream overlays) connect to a separate socket and get the state
+ *          of every match as a stream (see SpectatorEncoder): a keyframe when they join, then a
+ *          delta of whatever changed every publish interval, and a keyframe for everyone every so
+ *          often. A frame is encoded once and shared by every subscriber's queue. A subscriber that
+ *          falls too far behind has its backlog dropped and gets a keyframe on the next publish,
+ *          so one slow screen never holds up the event loop or uses unbounded memory.
+ * @note Linux only (epoll, eventfd, timerfd).
+ */
+class MatchServer {
+    public:
+        /// @brief Counters for monitoring, safe to read from any thread
+        struct Stats {
+            uint64_t connections;
+            uint64_t requests;
+            uint64_t throws;
+            uint64_t matches;
+            uint64_t spectators;
+            /// @brief Times a lagging spectator's backlog was dropped for a keyframe
+            uint64_t resyncs;
+        };
+
+        explicit MatchServer(MatchServerConfig config);
+
+        /// @brief Stops the workers and closes every socket
+        ~MatchServer();
+
+        MatchServer(const MatchServer &) = delete;
+        MatchServer &operator=(const MatchServer &) = delete;
+
+        /// @brief Opens the listening sockets and starts the workers
+        /// @return false if a socket couldn't be opened (the reason is printed)
+        bool listen();
+
+        /// @brief Runs the event loop on the calling thread until stop() is called
+        void run();
+
+        /// @brief Makes run() return (callable from any thread and from signal handlers)
+        void stop();
+
+        Stats getStats() const;
+
+    private:
+        /// @brief A request or response on its way between the event loop and a worker
+        struct Envelope {
+            uint64_t connection;
+            MatchMessage message;
+        };
+
+        static const size_t QUEUE_SIZE = 8192;
+
+        /// @brief A match and when a client last used it
+        struct HostedMatch {
+            X01Game game;
+            std::chrono::steady_clock::time_point used;
+        };
+
+        struct Worker {
+            std::thread thread;
+            SpscQueue<Envelope, QUEUE_SIZE> requests;
+            SpscQueue<Envelope, QUEUE_SIZE> responses;
+            /// @brief Written by the event loop when it queued requests
+            int wakeFd = -1;
+            /// @brief The matches this worker owns (only touched by its thread)
+            std::unordered_map<uint32_t, HostedMatch> matches;
+            /// @brief Finished matches, oldest first, so they can be dropped after a while
+            std::deque<uint32_t> finished;
+            /// @brief Matches still being played, and when the idle ones were last looked for
+            size_t open = 0;
+            std::chrono::steady_clock::time_point lastSweep;
+            /// @brief True if requests were queued since the worker was last woken (event loop only)
+            bool notify = false;
+        };
+
+        struct Connection {
+            int fd = -1;
+            vector<uint8_t> in;
+            size_t inOffset = 0;
+            vector<uint8_t> out;
+            size_t outOffset = 0;
+            /// @brief The epoll events currently registered
+            uint32_t events = 0;
+            /// @brief A frame is waiting for room in a worker's queue
+            bool stalled = false;
+            /// @brief Has output that hasn't been written yet this loop iteration
+            bool dirty = false;
+        };
+
+        /// @brief Frames are encoded once and shared by every subscriber's queue
+        typedef std::shared_ptr<const vector<uint8_t>> Frame;
+
+        struct Subscriber {
+            int fd = -1;
+            std::deque<Frame> frames;
+            /// @brief How much of the front frame has been written
+            size_t offset = 0;
+            /// @brief Bytes queued, not counting what was written of the front frame
+            size_t queued = 0;
+            bool needsKeyframe = true;
+            uint32_t events = 0;
+        };
+
+        MatchServerConfig config;
+        std::atomic<bool> running{false};
+
+        int epollFd = -1;
+        int tcpFd = -1;
+        int unixFd = -1;
+        /// @brief Written by workers (and stop()) to wake the event loop
+        int loopWakeFd = -1;
+        int spectatorTcpFd = -1;
+        int spectatorUnixFd = -1;
+        /// @brief Fires every publish interval
+        int publishTimerFd = -1;
+
+        vector<unique_ptr<Worker>> workers;
+        std::unordered_map<uint64_t, Connection> connections;
+        uint64_t nextConnection;
+        uint32_t nextMatch = 1;
+        vector<uint64_t> stalled;
+        vector<uint64_t> dirty;
+
+        // spectators
+        std::unordered_map<uint64_t, Subscriber> subscribers;
+        SpectatorEncoder encoder;
+        uint64_t publishTick = 0;
+        /// @brief The keyframe of publishTick (built when someone needs it)
+        Frame keyframe;
+        uint64_t keyframeTick = ~0ull;
+        /// @brief Reused for encoding deltas
+        vector<uint8_t> scratch;
+
+        std::atomic<uint64_t> connectionCount{0}, requestCount{0}, throwCount{0}, matchCount{0}, spectatorCount{0}, resyncCount{0};
+
+        // event loop
+        void accept(int listenFd);
+        void readFrom(uint64_t id, Connection &connection);
+        /// @brief Decodes and dispatches buffered frames until one doesn't fit in a worker's queue
+        bool handleFrames(uint64_t id, Connection &connection);
+        /// @brief Sends a request to the worker that owns its match, or answers it right away
+        /// @return false if the worker's queue is full
+        bool dispatch(uint64_t id, Connection &connection, const MatchMessage &message);
+        void respond(uint64_t id, Connection &connection, const MatchMessage &message);
+        void collectResponses();
+        void writeTo(uint64_t id, Connection &connection);
+        /// @brief Registers the epoll events the connection needs now
+        void updateEvents(uint64_t id, Connection &connection);
+        void closeConnection(uint64_t id);
+
+        // spectators
+        void acceptSpectator(int listenFd);
+        /// @brief Records a match's new state for the next publish
+        void observe(const MatchMessage &response);
+        /// @brief Sends everyone what changed since the last publish
+        void publish();
+        Frame currentKeyframe();
+        /// @brief Adds a frame to a subscriber's queue, or drops its backlog if it's too far behind
+        void queueFrame(Subscriber &subscriber, const Frame &frame);
+        void writeTo(uint64_t id, Subscriber &subscriber);
+        void closeSubscriber(uint64_t id);
+
+        // workers
+        void workerLoop(Worker &worker);
+        MatchMessage handle(Worker &worker, const MatchMessage &request);
+        /// @brief Hands a response to the event loop, waiting for room
+        /// @return false if the server stopped first (the response is dropped)
+        bool pushResponse(Worker &worker, const Envelope &envelope);
+        /// @brief Drops the matches still being played that have been idle too long
+        void dropIdleMatches(Worker &worker, std::chrono::steady_clock::time_point now);
+};
+
+#endif //GRAPHICS_MATCHSERVER_H
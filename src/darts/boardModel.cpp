@@ -0,0 +1,45 @@
+#include "boardModel.h"
+
+#include <cmath>
+
+static const double PI = 3.14159265358979323846;
+static const double SEGMENT_WIDTH = 2.0 * PI / 20.0;
+
+Dart BoardModel::dartAt(double x, double y) {
+    Dart dart;
+    double radius = std::sqrt(x * x + y * y);
+    if (radius > DOUBLE_OUTER_RADIUS)
+        return dart;
+    if (radius <= BULL_RADIUS) {
+        dart.segment = 25;
+        dart.multiplier = 2;
+        return dart;
+    }
+    if (radius <= OUTER_BULL_RADIUS) {
+        dart.segment = 25;
+        dart.multiplier = 1;
+        return dart;
+    }
+
+    // clockwise from the top, shifted by half a segment so the 20 covers [0, width)
+    double clockwise = std::atan2(x, y) + SEGMENT_WIDTH / 2;
+    if (clockwise < 0)
+        clockwise += 2.0 * PI;
+    int index = static_cast<int>(clockwise / SEGMENT_WIDTH) % 20;
+    dart.segment = static_cast<uint8_t>(SEGMENTS[index]);
+    if (radius >= DOUBLE_INNER_RADIUS)
+        dart.multiplier = 2;
+    else if (radius >= TRIPLE_INNER_RADIUS && radius <= TRIPLE_OUTER_RADIUS)
+        dart.multiplier = 3;
+    else
+        dart.multiplier = 1;
+    return dart;
+}
+
+double BoardModel::segmentAngle(int segment) {
+    for (int i = 0; i < 20; ++i) {
+        if (SEGMENTS[i] == segment)
+            return PI / 2 - i * SEGMENT_WIDTH;
+    }
+    return 0;
+}
@@ -0,0 +1,31 @@
+#ifndef GRAPHICS_BOARDMODEL_H
+#define GRAPHICS_BOARDMODEL_H
+
+#include "x01.h"
+
+/**
+ * @brief The geometry of a regulation dartboard.
+ * @details Positions are in millimetres from the centre of the bull, x to the right and y up,
+ *          so the 20 is straight up. Wires are treated as having no width.
+ */
+class BoardModel {
+    public:
+        static constexpr double BULL_RADIUS = 6.35;
+        static constexpr double OUTER_BULL_RADIUS = 15.9;
+        static constexpr double TRIPLE_INNER_RADIUS = 99.0;
+        static constexpr double TRIPLE_OUTER_RADIUS = 107.0;
+        static constexpr double DOUBLE_INNER_RADIUS = 162.0;
+        static constexpr double DOUBLE_OUTER_RADIUS = 170.0;
+
+        /// @brief The segments clockwise, starting with the 20 at the top
+        static constexpr int SEGMENTS[20] = {20, 1, 18, 4, 13, 6, 10, 15, 2, 17, 3, 19, 7, 16, 8, 11, 14, 9, 12, 5};
+
+        /// @brief The dart that lands at (x, y), a miss outside the double ring
+        static Dart dartAt(double x, double y);
+
+        /// @brief The angle (radians, counterclockwise from the x axis) through the middle of segment
+        /// @return 0 for something that isn't a segment (e.g. 25)
+        static double segmentAngle(int segment);
+};
+
+#endif //GRAPHICS_BOARDMODEL_H
@@ -0,0 +1,76 @@
+#include "checkout.h"
+
+#include <array>
+#include <vector>
+
+// the highest score one visit can finish (T20 T20 T20 when playing straight out)
+static const int MAX_CHECKOUT = 180;
+
+namespace {
+    /// @brief Every dart that scores, in the order players would rather throw them as a setup
+    std::vector<Dart> setupDarts() {
+        std::vector<Dart> darts;
+        for (int multiplier = 3; multiplier >= 1; --multiplier)
+            for (int segment = 20; segment >= 1; --segment)
+                darts.push_back({static_cast<uint8_t>(segment), static_cast<uint8_t>(multiplier)});
+        darts.push_back({25, 1});
+        darts.push_back({25, 2});
+        return darts;
+    }
+
+    /// @brief Darts that can finish a double-out leg, favourite first
+    std::vector<Dart> finishingDoubles() {
+        std::vector<Dart> darts;
+        for (int segment : {20, 16, 18, 12, 10, 8, 14, 6, 4, 2, 19, 17, 15, 13, 11, 9, 7, 5, 3, 1})
+            darts.push_back({static_cast<uint8_t>(segment), 2});
+        darts.push_back({25, 2});
+        return darts;
+    }
+
+    /// @brief Best checkout per score and number of darts, for double-out [1] and straight-out [0]
+    struct CheckoutTable {
+        std::array<std::array<Checkout, X01Game::DARTS_PER_VISIT + 1>, MAX_CHECKOUT + 1> best[2];
+
+        CheckoutTable() {
+            std::vector<Dart> setups = setupDarts();
+            for (int doubleOut = 0; doubleOut < 2; ++doubleOut) {
+                std::vector<Dart> finishes = doubleOut ? finishingDoubles() : setups;
+                // the first combination found is kept, so the loops run in order of preference
+                for (const Dart &last : finishes) {
+                    record(doubleOut, 1, {last, {}, {}});
+                    for (const Dart &first : setups) {
+                        record(doubleOut, 2, {first, last, {}});
+                        for (const Dart &second : setups)
+                            record(doubleOut, 3, {first, second, last});
+                    }
+                }
+                // a finish with fewer darts also works when more are left
+                for (int score = 0; score <= MAX_CHECKOUT; ++score)
+                    for (int darts = 2; darts <= X01Game::DARTS_PER_VISIT; ++darts)
+                        if (best[doubleOut][score][darts - 1].count > 0)
+                            best[doubleOut][score][darts] = best[doubleOut][score][darts - 1];
+            }
+        }
+
+        void record(int doubleOut, int count, std::array<Dart, 3> darts) {
+            int score = 0;
+            for (int i = 0; i < count; ++i)
+                score += darts[i].points();
+            Checkout &slot = best[doubleOut][score][count];
+            if (slot.count != 0)
+                return;
+            slot.count = count;
+            for (int i = 0; i < count; ++i)
+                slot.darts[i] = darts[i];
+        }
+    };
+}
+
+Checkout suggestCheckout(int remaining, int darts, bool doubleOut) {
+    static const CheckoutTable table;
+    if (remaining <= 0 || remaining > MAX_CHECKOUT || darts <= 0)
+        return {};
+    if (darts > X01Game::DARTS_PER_VISIT)
+        darts = X01Game::DARTS_PER_VISIT;
+    return table.best[doubleOut ? 1 : 0][remaining][darts];
+}
@@ -0,0 +1,22 @@
+#ifndef GRAPHICS_CHECKOUT_H
+#define GRAPHICS_CHECKOUT_H
+
+#include "x01.h"
+
+/// @brief A way to finish a leg from a given score
+struct Checkout {
+    /// @brief Number of darts used (0 if there is no finish)
+    int count = 0;
+    Dart darts[X01Game::DARTS_PER_VISIT];
+};
+
+/**
+ * @brief Suggests how to finish from remaining with at most darts darts.
+ * @details Uses the fewest darts possible, preferring big setup darts (T20 first) and the
+ *          doubles players usually aim for (D20, D16, ...). Results come from a table built
+ *          once, so asking is cheap enough to do on every throw.
+ * @return a checkout with count 0 if remaining can't be finished with that many darts
+ */
+Checkout suggestCheckout(int remaining, int darts, bool doubleOut = true);
+
+#endif //GRAPHICS_CHECKOUT_H
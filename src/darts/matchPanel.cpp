@@ -0,0 +1,363 @@
+#include "matchPanel.h"
+#include "../util/log.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+
+MatchPanel::~MatchPanel() {
+    // the log is still writing, so the last throws can be waited for
+    if (statsWriter.isOpen()) {
+        statsWriter.submit(stats);
+        statsWriter.close();
+    }
+}
+
+bool MatchPanel::openThrowLog(const string &path) {
+    if (!throws.open(path))
+        return false;
+    // the saved statistics, plus whatever was logged after they were saved (e.g. before a crash)
+    statsPath = path + ".stats";
+    stats.load(statsPath);
+    ThrowLogReader log;
+    if (log.open(path)) {
+        size_t added = stats.catchUp(log);
+        if (added > 0)
+            LOG_INFO("STATS", "Counted {} throws the saved statistics were missing", added);
+    }
+    statsWriter.open(statsPath, throws);
+    return true;
+}
+
+bool MatchPanel::connect(const string &address, int players, int startScore) {
+    this->players = players;
+    this->startScore = startScore;
+    if (!client.connect(address))
+        return false;
+    clock.reset(GameClock::steadyNow());
+    createMatch();
+    return true;
+}
+
+bool MatchPanel::rejoin(const string &address, const SavedMatch &saved) {
+    players = saved.players;
+    startScore = saved.startScore;
+    match = saved.match;
+    // the splits go on from where they were, without the time the game was away
+    clock = saved.clock;
+    clock.rebase(saved.savedAt, GameClock::steadyNow());
+    if (!client.connect(address))
+        return false;
+
+    haveState = false;
+    waiting = false;
+    rejoining = true;
+    status = "Rejoining match...";
+    MatchMessage request;
+    request.type = MatchMessage::getMatch;
+    request.match = match;
+    client.send(request);
+    return true;
+}
+
+SavedMatch MatchPanel::save(clockTime now) const {
+    SavedMatch saved;
+    saved.match = match;
+    saved.players = players;
+    saved.startScore = startScore;
+    saved.clock = clock;
+    saved.savedAt = now;
+    return saved;
+}
+
+void MatchPanel::createMatch() {
+    MatchMessage request;
+    request.type = MatchMessage::createMatch;
+    request.players = static_cast<uint8_t>(players);
+    request.startScore = static_cast<uint16_t>(startScore);
+    client.send(request);
+
+    match = 0;
+    haveState = false;
+    waiting = false;
+    rejoining = false;
+    status = "Starting match...";
+}
+
+bool MatchPanel::update() {
+    if (!client.isConnected())
+        return false;
+
+    responses.clear();
+    if (!client.receive(responses)) {
+        status = "Lost connection to server";
+        return true;
+    }
+
+    for (const MatchMessage &response : responses) {
+        switch (response.type) {
+            case MatchMessage::matchCreated: {
+                match = response.match;
+                status = "";
+                MatchMessage request;
+                request.type = MatchMessage::getMatch;
+                request.match = match;
+                client.send(request);
+                break;
+            }
+            case MatchMessage::throwResult: {
+                visitOver = response.result == bust || response.result == checkout;
+                // the dart counts (even a bust), so it's kept; the statistics only count what the log has
+                if (response.result != rejected) {
+                    pending.result = response.result;
+                    lastScored = pending;
+                    scored++;
+                    if (!throws.isOpen() || throws.append(pending))
+                        stats.add(pending);
+                    // a finished leg is a good moment to save them
+                    if (response.result == checkout && statsWriter.isOpen())
+                        statsWriter.submit(stats);
+                }
+                switch (response.result) {
+                    case bust:     status = "Bust!"; break;
+                    case checkout: status = "Game shot!"; break;
+                    case rejected: status = "Not accepted"; break;
+                    default:       status = ""; break;
+                }
+                // ask for the whole state, the result only has the thrower's score
+                MatchMessage request;
+                request.type = MatchMessage::getMatch;
+                request.match = match;
+                client.send(request);
+                break;
+            }
+            case MatchMessage::matchState:
+                if (response.match == match) {
+                    if (rejoining)
+                        status = "";
+                    updateClock(response);
+                    state = response;
+                    haveState = true;
+                    waiting = false;
+                }
+                break;
+            case MatchMessage::error:
+                // the server was restarted too, so the match is gone
+                if (rejoining && response.errorCode == MatchMessage::unknownMatch) {
+                    LOG_WARNING("MATCH", "The server doesn't know match {} any more, starting a new one", match);
+                    clock.reset(GameClock::steadyNow());
+                    createMatch();
+                    break;
+                }
+                waiting = false;
+                status = response.errorCode == MatchMessage::unknownMatch ? "Match not found" : "Request refused";
+                break;
+            default:
+                break;
+        }
+    }
+    return !responses.empty();
+}
+
+void MatchPanel::updateClock(const MatchMessage &next) {
+    clockTime now = GameClock::steadyNow();
+    // a rejoined match's clock was saved with it
+    if (rejoining) {
+        rejoining = false;
+        visitOver = false;
+        return;
+    }
+    if (!haveState) {
+        // the first state of a match: the leg starts with the first player's visit
+        clock.startLeg(now);
+        if (next.winner < 0)
+            clock.startVisit(next.current, now);
+        visitOver = false;
+        return;
+    }
+    if (!clock.inLeg())
+        return;
+    if (next.winner >= 0) {
+        clock.endLeg(now);
+        return;
+    }
+    // the turn passed (for a single player only dartsInVisit going back to 0 shows it)
+    bool passed = visitOver || next.current != state.current || next.dartsInVisit < state.dartsInVisit;
+    if (passed)
+        clock.startVisit(next.current, now);
+    visitOver = false;
+}
+
+void MatchPanel::type(unsigned int codepoint) {
+    if (codepoint < 128 && std::isalnum(static_cast<int>(codepoint)) && input.size() < 4)
+        input += static_cast<char>(std::toupper(static_cast<int>(codepoint)));
+}
+
+void MatchPanel::erase() {
+    if (!input.empty())
+        input.pop_back();
+}
+
+void MatchPanel::submit() {
+    if (!client.isConnected() || match == 0)
+        return;
+
+    // after the leg is won, enter starts the next one
+    if (haveState && state.winner >= 0) {
+        createMatch();
+        input.clear();
+        return;
+    }
+
+    Dart dart;
+    if (!parseDart(input, dart)) {
+        status = "Type e.g. T20, D16, 5, 25, 50 or 0";
+        return;
+    }
+    if (submitDart(dart))
+        input.clear();
+}
+
+bool MatchPanel::submitDart(Dart dart) {
+    return send(dart, ThrowRecord::NO_POSITION, ThrowRecord::NO_POSITION);
+}
+
+bool MatchPanel::submitDart(Dart dart, double x, double y) {
+    // tenths of millimetres, kept just inside the record's range
+    auto tenths = [](double mm) { return static_cast<int16_t>(std::clamp(mm * 10.0, -32767.0, 32767.0)); };
+    return send(dart, tenths(x), tenths(y));
+}
+
+bool MatchPanel::send(Dart dart, int16_t x, int16_t y) {
+    // whose turn it is isn't known until the last dart has been answered
+    if (!client.isConnected() || match == 0 || waiting || (haveState && state.winner >= 0))
+        return false;
+    MatchMessage request;
+    request.type = MatchMessage::submitThrow;
+    request.match = match;
+    request.player = haveState ? state.current : 0;
+    request.dart = dart;
+    client.send(request);
+    waiting = true;
+
+    // what the log gets if the server scores it
+    pending = ThrowRecord();
+    pending.time = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+    pending.match = match;
+    pending.leg = static_cast<uint16_t>(clock.getLegCount());
+    pending.visit = static_cast<uint16_t>(clock.getPlayerVisits(request.player));
+    pending.player = request.player;
+    pending.dart = haveState ? state.dartsInVisit : 0;
+    pending.remaining = static_cast<uint16_t>(haveState ? state.remaining[request.player] : startScore);
+    pending.segment = dart.segment;
+    pending.multiplier = dart.multiplier;
+    pending.x = x;
+    pending.y = y;
+    return true;
+}
+
+void MatchPanel::render(FontRenderer &text, FrameArena &frame, float x, float y) {
+    const glm::vec3 white{1, 1, 1}, yellow{1, 1, 0};
+    const float line = 22;
+
+    if (!client.isConnected()) {
+        text.renderText("Match server: offline", x, y, 0.5, white);
+        return;
+    }
+
+    clockTime now = GameClock::steadyNow();
+    char leg[24], visit[24];
+    GameClock::format(clock.getLegTime(now), leg, sizeof(leg));
+    text.renderText(frame.print("Match %u (%d)  %s", match, startScore, leg), x, y, 0.5, white);
+    y -= line;
+    if (haveState) {
+        static const char *const STARS[] = {"", "*", "**", "***"};
+        for (int i = 0; i < state.players; ++i) {
+            bool throwing = i == state.current && state.winner < 0;
+            // the running visit for the thrower, the average visit for everyone else
+            std::string_view score;
+            if (throwing) {
+                GameClock::format(clock.getVisitTime(now), visit, sizeof(visit));
+                score = frame.print("P%d: %d %s %s", i + 1, state.remaining[i], STARS[state.dartsInVisit % 4], visit);
+            }
+            else if (clock.getPlayerVisits(i) > 0) {
+                GameClock::format(clock.getAverageVisit(i), visit, sizeof(visit));
+                score = frame.print("P%d: %d  avg %s", i + 1, state.remaining[i], visit);
+            }
+            else
+                score = frame.print("P%d: %d", i + 1, state.remaining[i]);
+            text.renderText(score, x, y, 0.5, throwing ? yellow : white);
+            y -= line;
+        }
+        if (state.winner >= 0) {
+            text.renderText(frame.print("P%d wins! Enter: new leg", state.winner + 1), x, y, 0.5, yellow);
+            y -= line;
+        }
+    }
+    text.renderText(frame.print("Dart: %s_", input.c_str()), x, y, 0.5, white);
+    y -= line;
+    if (!status.empty())
+        text.renderText(status, x, y, 0.5, white);
+}
+
+void MatchPanel::renderStats(FontRenderer &text, FrameArena &frame, float x, float y) {
+    const glm::vec3 white{1, 1, 1}, yellow{1, 1, 0};
+    const float line = 20;
+    uint64_t now = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+
+    text.renderText("Player stats (3-dart avg, first 9, checkout, trebles, doubles)", x, y, 0.4, yellow);
+    y -= line;
+    for (int i = 0; i < players; ++i) {
+        const PlayerStats &player = stats.getPlayer(i);
+        const StatsSummary windows[] = {player.getSession(), player.getLastLegs(),
+                                        player.getLastDays(now), player.getAllTime()};
+        static const char *const NAMES[] = {"Session", "Last 10 legs", "Last 30 days", "All time"};
+        text.renderText(frame.print("P%d", i + 1), x, y, 0.4, yellow);
+        y -= line;
+        for (int w = 0; w < 4; ++w) {
+            const StatsSummary &s = windows[w];
+            text.renderText(frame.print("%-13s %5.1f  %5.1f  %4.1f%%  %4.1f%%  %4.1f%%  180s %llu  legs %llu/%llu",
+                                        NAMES[w], s.threeDartAverage(), s.first9Average(), s.checkoutPercentage(),
+                                        s.trebleRate(), s.doubleRate(), static_cast<unsigned long long>(s.count180),
+                                        static_cast<unsigned long long>(s.legsWon), static_cast<unsigned long long>(s.legs)),
+                            x, y, 0.4, white);
+            y -= line;
+        }
+    }
+}
+
+bool MatchPanel::parseDart(const string &text, Dart &dart) {
+    if (text.empty())
+        return false;
+
+    // optional S/D/T prefix, then the segment
+    uint8_t multiplier = 1;
+    size_t start = 0;
+    if (text[0] == 'S' || text[0] == 'D' || text[0] == 'T') {
+        multiplier = text[0] == 'T' ? 3 : text[0] == 'D' ? 2 : 1;
+        start = 1;
+    }
+    if (start == text.size() || text.size() - start > 2)
+        return false;
+    int segment = 0;
+    for (size_t i = start; i < text.size(); ++i) {
+        if (!std::isdigit(static_cast<unsigned char>(text[i])))
+            return false;
+        segment = segment * 10 + (text[i] - '0');
+    }
+
+    // "50" is the bull, "0" a miss
+    if (start == 0 && segment == 50) {
+        segment = 25;
+        multiplier = 2;
+    }
+    if (segment == 0)
+        multiplier = 0;
+
+    dart.segment = static_cast<uint8_t>(segment);
+    dart.multiplier = multiplier;
+    return dart.valid();
+}
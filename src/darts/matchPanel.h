@@ -0,0 +1,136 @@
+#ifndef GRAPHICS_MATCHPANEL_H
+#define GRAPHICS_MATCHPANEL_H
+
+#include <string>
+#include <vector>
+#include "playerStats.h"
+#include "throwLog.h"
+#include "x01.h"
+#include "../game/gameClock.h"
+#include "../game/sessionSnapshot.h"
+#include "../net/matchClient.h"
+#include "../font/fontRenderer.h"
+#include "../util/frameArena.h"
+
+using std::string, std::vector;
+
+/**
+ * @brief Lets the game score an X01 match on a match server, as one of its clients.
+ * @details Darts are typed in the usual notation ("T20", "D16", "5", "25", "50" for the bull,
+ *          "0" for a miss) and sent on enter. The server's answers are picked up without
+ *          blocking once per frame, so a slow or missing server never stalls rendering.
+ */
+class MatchPanel {
+    public:
+        MatchPanel() = default;
+        /// @brief Saves the player statistics (if there is a throw log)
+        ~MatchPanel();
+
+        MatchPanel(const MatchPanel &) = delete;
+        MatchPanel &operator=(const MatchPanel &) = delete;
+
+        /// @brief Connects to the server and starts a new match on it
+        /// @param address "host:port" or "unix:<path>"
+        /// @return false if the server couldn't be reached
+        bool connect(const string &address, int players = 2, int startScore = 501);
+
+        /// @brief Connects to the server and carries on with a match it is already playing (e.g. after a restart)
+        /// @details If the server doesn't know the match any more, a new one is started.
+        /// @return false if the server couldn't be reached (the match is still kept, for the next snapshot)
+        bool rejoin(const string &address, const SavedMatch &saved);
+
+        bool isConnected() const { return client.isConnected(); }
+
+        /// @brief What rejoin() needs to carry on with the match, as it is at now (steadyNow())
+        SavedMatch save(clockTime now) const;
+        /// @brief The match being scored (0 until the server created it)
+        uint32_t getMatch() const { return match; }
+
+        /// @brief Sends queued requests and handles the server's answers (call once per frame)
+        /// @return true if the server answered anything
+        bool update();
+
+        /// @brief Adds a typed character to the dart being entered
+        void type(unsigned int codepoint);
+        /// @brief Removes the last typed character
+        void erase();
+        /// @brief Sends the typed dart (or starts a new match once this one is won)
+        void submit();
+        /// @brief Sends a dart for the player whose turn it is (e.g. one typed in)
+        /// @return false if it can't be sent now (no match yet, or the last dart hasn't been answered)
+        bool submitDart(Dart dart);
+        /// @brief Sends a dart that is known to have landed at (x, y), millimetres from the bull (e.g. one found by a DartFeed)
+        bool submitDart(Dart dart, double x, double y);
+        /// @brief Returns true while a dart is waiting for the server's answer
+        bool isWaiting() const { return waiting; }
+
+        /// @brief Appends every dart the server scores to a throw log from now on
+        /// @details The player statistics are kept next to it (path + ".stats") and brought up to date
+        ///          with whatever was logged since they were last saved.
+        /// @return false if it couldn't be opened
+        bool openThrowLog(const string &path);
+        const ThrowLog &getThrowLog() const { return throws; }
+        /// @brief Waits for the darts scored so far to be in the throw log's file
+        void flushThrowLog() { throws.flush(); }
+        /// @brief Darts scored since the panel was made, and the last of them (to follow new darts as they come)
+        uint64_t getScoredCount() const { return scored; }
+        const ThrowRecord &getLastScored() const { return lastScored; }
+        /// @brief Statistics of every dart scored (all the ones in the throw log, if there is one)
+        const StatsEngine &getStats() const { return stats; }
+
+        /// @brief Leg and visit times of the match (visits run from the turn passing to the next pass)
+        const GameClock &getClock() const { return clock; }
+
+        /// @brief Draws the scores, the times and the dart being typed, top left corner at (x, y)
+        /// @param frame Where the lines are formatted, so drawing doesn't allocate
+        void render(FontRenderer &text, FrameArena &frame, float x, float y);
+        /// @brief Draws every player's statistics (this session, the last legs, the last days and all time)
+        void renderStats(FontRenderer &text, FrameArena &frame, float x, float y);
+
+        /// @brief Reads a dart in the usual notation
+        /// @return false if text isn't a dart
+        static bool parseDart(const string &text, Dart &dart);
+
+    private:
+        MatchClient client;
+        int players = 2;
+        int startScore = 501;
+
+        /// @brief The match being scored (0 until the server created it)
+        uint32_t match = 0;
+        /// @brief The last full state the server sent
+        MatchMessage state;
+        bool haveState = false;
+        /// @brief True from sending a dart until the state after it arrives
+        bool waiting = false;
+        /// @brief True if the last dart ended the visit early (bust or checkout)
+        bool visitOver = false;
+        /// @brief True from rejoin() until the match's state arrives (the clock is already running)
+        bool rejoining = false;
+        GameClock clock;
+        /// @brief Where scored darts are kept (if it's open)
+        ThrowLog throws;
+        /// @brief The dart waiting for the server's answer, logged once it's scored
+        ThrowRecord pending;
+        ThrowRecord lastScored;
+        uint64_t scored = 0;
+        StatsEngine stats;
+        /// @brief Where stats are saved ("" without a throw log)
+        string statsPath;
+        /// @brief Saves them off the render thread (after the throw log, so it goes first)
+        StatsWriter statsWriter;
+
+        string input;
+        /// @brief What happened to the last dart (e.g. "Bust!")
+        string status;
+        /// @brief Reused every frame
+        vector<MatchMessage> responses;
+
+        void createMatch();
+        /// @brief Moves the leg and visit splits on to a new state from the server
+        void updateClock(const MatchMessage &next);
+        /// @brief Sends a dart, x and y in tenths of millimetres (or ThrowRecord::NO_POSITION)
+        bool send(Dart dart, int16_t x, int16_t y);
+};
+
+#endif //GRAPHICS_MATCHPANEL_H
@@ -0,0 +1,327 @@
+#include "playerStats.h"
+#include "checkout.h"
+#include "../util/log.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <type_traits>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#define STATS_POSIX 1
+#endif
+
+// "DARTSTAT", version, size of a player's stats
+static const char MAGIC[8] = {'D', 'A', 'R', 'T', 'S', 'T', 'A', 'T'};
+static const uint32_t VERSION = 1;
+static const uint64_t DAY = 86400ull * 1000000000ull;
+
+static_assert(std::is_trivially_copyable<PlayerStats>::value, "player stats are saved as they are in memory");
+
+void StatsSummary::merge(const StatsSummary &other) {
+    darts += other.darts;
+    visitPoints += other.visitPoints;
+    visitDarts += other.visitDarts;
+    visits += other.visits;
+    first9Points += other.first9Points;
+    first9Darts += other.first9Darts;
+    checkoutAttempts += other.checkoutAttempts;
+    checkouts += other.checkouts;
+    trebles += other.trebles;
+    doubles += other.doubles;
+    count180 += other.count180;
+    legs += other.legs;
+    legsWon += other.legsWon;
+    if (other.bestLeg != 0 && (bestLeg == 0 || other.bestLeg < bestLeg))
+        bestLeg = other.bestLeg;
+    highestCheckout = std::max(highestCheckout, other.highestCheckout);
+}
+
+void PlayerStats::add(const ThrowRecord &record) {
+    if (record.result == rejected)
+        return;
+    advanceDay(static_cast<int64_t>(record.time / DAY));
+    legOpen = true;
+    legDarts++;
+
+    StatsSummary change;
+    change.darts = 1;
+    change.trebles = record.multiplier == 3;
+    change.doubles = record.multiplier == 2;
+    // an attempt at a finish is a dart thrown with a one-dart checkout left (a finish always was one)
+    bool attempt = record.result == checkout || (record.remaining > 0 && suggestCheckout(record.remaining, 1).count == 1);
+    change.checkoutAttempts = attempt;
+    change.checkouts = record.result == checkout;
+
+    visitScore += static_cast<uint32_t>(record.getDart().points());
+    visitDarts++;
+    bool visitOver = record.dart >= X01Game::DARTS_PER_VISIT - 1 || record.result == bust || record.result == checkout;
+    if (visitOver) {
+        uint32_t points = record.result == bust ? 0 : visitScore;
+        change.visits = 1;
+        change.visitPoints = points;
+        change.visitDarts = visitDarts;
+        if (record.visit < 3) {
+            change.first9Points = points;
+            change.first9Darts = visitDarts;
+        }
+        change.count180 = points == 180;
+        if (record.result == checkout) {
+            change.legs = 1;
+            change.legsWon = 1;
+            change.bestLeg = legDarts;
+            change.highestCheckout = visitScore;
+        }
+        visitScore = 0;
+        visitDarts = 0;
+    }
+    count(change);
+
+    if (record.result == checkout) {
+        lastLegs[legNext] = leg;
+        legNext = (legNext + 1) % LEG_WINDOW;
+        legCount = std::min(legCount + 1, LEG_WINDOW);
+        leg = StatsSummary();
+        legOpen = false;
+        legDarts = 0;
+    }
+}
+
+void PlayerStats::endLeg() {
+    if (!legOpen)
+        return;
+    StatsSummary change;
+    change.legs = 1;
+    count(change);
+    lastLegs[legNext] = leg;
+    legNext = (legNext + 1) % LEG_WINDOW;
+    legCount = std::min(legCount + 1, LEG_WINDOW);
+    leg = StatsSummary();
+    legOpen = false;
+    legDarts = 0;
+    // a visit cut short by the end of the leg never finished
+    visitScore = 0;
+    visitDarts = 0;
+}
+
+void PlayerStats::count(const StatsSummary &change) {
+    session.merge(change);
+    leg.merge(change);
+    days[static_cast<size_t>(lastDay % DAY_WINDOW)].merge(change);
+}
+
+void PlayerStats::advanceDay(int64_t day) {
+    // a clock set back counts towards the newest day
+    if (day <= lastDay)
+        return;
+    if (lastDay < 0 || day - lastDay >= DAY_WINDOW)
+        days.fill(StatsSummary());
+    else {
+        for (int64_t d = lastDay + 1; d <= day; ++d)
+            days[static_cast<size_t>(d % DAY_WINDOW)] = StatsSummary();
+    }
+    lastDay = day;
+}
+
+StatsSummary PlayerStats::getAllTime() const {
+    StatsSummary all = before;
+    all.merge(session);
+    return all;
+}
+
+StatsSummary PlayerStats::getLastLegs() const {
+    StatsSummary legs;
+    for (int i = 0; i < legCount; ++i)
+        legs.merge(lastLegs[static_cast<size_t>(i)]);
+    return legs;
+}
+
+StatsSummary PlayerStats::getLastDays(uint64_t now) const {
+    StatsSummary window;
+    int64_t today = static_cast<int64_t>(now / DAY);
+    for (int64_t d = std::max<int64_t>(lastDay - DAY_WINDOW + 1, 0); lastDay >= 0 && d <= lastDay; ++d) {
+        if (d > today - DAY_WINDOW && d <= today)
+            window.merge(days[static_cast<size_t>(d % DAY_WINDOW)]);
+    }
+    return window;
+}
+
+void PlayerStats::startSession() {
+    before.merge(session);
+    session = StatsSummary();
+}
+
+void StatsEngine::add(const ThrowRecord &record) {
+    throwCount++;
+    if (record.player >= X01Game::MAX_PLAYERS || record.result == rejected)
+        return;
+    if (record.match != match || record.leg != leg) {
+        // the last leg was given up (or lost by everyone who didn't win it)
+        endLeg();
+        match = record.match;
+        leg = record.leg;
+    }
+    players[record.player].add(record);
+    if (record.result == checkout)
+        endLeg();
+}
+
+void StatsEngine::endLeg() {
+    for (PlayerStats &player : players)
+        player.endLeg();
+}
+
+size_t StatsEngine::catchUp(const ThrowLogReader &log) {
+    if (log.size() < throwCount) {
+        // throws the log lost (a crash before they were synced, or a failed write) or a different log,
+        // either way the log is what's true
+        LOG_WARNING("STATS", "The throw log has {} throws but the statistics counted {}, counting them all again", log.size(), throwCount);
+        *this = StatsEngine();
+        for (size_t i = 0; i < log.size(); ++i)
+            add(log[i]);
+        for (PlayerStats &player : players)
+            player.startSession();
+        return log.size();
+    }
+    size_t first = static_cast<size_t>(throwCount);
+    for (size_t i = first; i < log.size(); ++i)
+        add(log[i]);
+    return log.size() - first;
+}
+
+bool StatsEngine::load(const string &path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+        return false;
+    char magic[sizeof(MAGIC)];
+    uint32_t version = 0, playerSize = 0;
+    in.read(magic, sizeof(magic));
+    in.read(reinterpret_cast<char *>(&version), sizeof(version));
+    in.read(reinterpret_cast<char *>(&playerSize), sizeof(playerSize));
+    if (!in || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0 || version != VERSION || playerSize != sizeof(PlayerStats)) {
+        LOG_WARNING("STATS", "{} isn't saved statistics (or from a different version), starting over", path);
+        return false;
+    }
+    StatsEngine loaded;
+    in.read(reinterpret_cast<char *>(&loaded.throwCount), sizeof(loaded.throwCount));
+    in.read(reinterpret_cast<char *>(&loaded.match), sizeof(loaded.match));
+    in.read(reinterpret_cast<char *>(&loaded.leg), sizeof(loaded.leg));
+    in.read(reinterpret_cast<char *>(loaded.players.data()), sizeof(loaded.players));
+    if (!in) {
+        LOG_WARNING("STATS", "{} is cut short, starting over", path);
+        return false;
+    }
+    *this = loaded;
+    for (PlayerStats &player : players)
+        player.startSession();
+    LOG_INFO("STATS", "Loaded statistics of {} throws from {}", throwCount, path);
+    return true;
+}
+
+bool StatsEngine::save(const string &path) const {
+    string temporary = path + ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        uint32_t playerSize = sizeof(PlayerStats);
+        out.write(MAGIC, sizeof(MAGIC));
+        out.write(reinterpret_cast<const char *>(&VERSION), sizeof(VERSION));
+        out.write(reinterpret_cast<const char *>(&playerSize), sizeof(playerSize));
+        out.write(reinterpret_cast<const char *>(&throwCount), sizeof(throwCount));
+        out.write(reinterpret_cast<const char *>(&match), sizeof(match));
+        out.write(reinterpret_cast<const char *>(&leg), sizeof(leg));
+        out.write(reinterpret_cast<const char *>(players.data()), sizeof(players));
+        if (!out.flush()) {
+            LOG_ERROR("STATS", "Could not write {}", temporary);
+            return false;
+        }
+    }
+#ifdef STATS_POSIX
+    // the data has to be on disk before the rename is, or a power loss could leave an empty file
+    int fd = ::open(temporary.c_str(), O_RDONLY | O_CLOEXEC);
+#ifdef __APPLE__
+    int status = fd >= 0 ? fcntl(fd, F_FULLFSYNC) : -1;
+#else
+    int status = fd >= 0 ? fdatasync(fd) : -1;
+#endif
+    if (status != 0) {
+        LOG_ERROR("STATS", "Could not sync {}: {}", temporary, std::strerror(errno));
+        if (fd >= 0)
+            ::close(fd);
+        ::unlink(temporary.c_str());
+        return false;
+    }
+    ::close(fd);
+#endif
+#ifdef _WIN32
+    // rename doesn't replace a file on Windows
+    std::remove(path.c_str());
+#endif
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        LOG_ERROR("STATS", "Could not replace {}", path);
+        return false;
+    }
+    return true;
+}
+
+StatsWriter::~StatsWriter() {
+    close();
+}
+
+void StatsWriter::open(const string &path, const ThrowLog &log) {
+    close();
+    this->path = path;
+    this->log = &log;
+    havePending = false;
+    running = true;
+    writer = std::thread(&StatsWriter::run, this);
+}
+
+void StatsWriter::close() {
+    if (!writer.joinable())
+        return;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        running = false;
+    }
+    wake.notify_one();
+    writer.join();
+}
+
+void StatsWriter::submit(const StatsEngine &stats) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pending = stats;
+        pendingAppended = log->getAppended();
+        havePending = true;
+    }
+    wake.notify_one();
+}
+
+void StatsWriter::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+        wake.wait(lock, [this] { return havePending || !running; });
+        // the last one is saved before stopping
+        if (!havePending)
+            return;
+        writing = pending;
+        uint64_t appended = pendingAppended;
+        havePending = false;
+        lock.unlock();
+
+        // the statistics may only count throws the log has on disk, or after a crash they'd be ahead of it
+        while (log->getHandled() < appended && log->isWriting())
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        if (log->getSynced() < writing.getThrowCount())
+            LOG_WARNING("STATS", "The throw log has {} throws on disk but the statistics counted {}, not saving them",
+                        log->getSynced(), writing.getThrowCount());
+        else if (writing.save(path))
+            saved.fetch_add(1, std::memory_order_relaxed);
+        lock.lock();
+    }
+}
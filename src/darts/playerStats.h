@@ -0,0 +1,217 @@
+#ifndef GRAPHICS_PLAYERSTATS_H
+#define GRAPHICS_PLAYERSTATS_H
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "throwLog.h"
+#include "x01.h"
+
+using std::string;
+
+/**
+ * @brief Everything the statistics are worked out from, as counts.
+ * @details Nearly every field is a plain sum (bestLeg and highestCheckout are a min and a max), so
+ *          the summaries of two sessions, days or legs merge into the summary of both with merge(),
+ *          whatever order they come in. Averages and rates are only worked out when they're read.
+ */
+struct StatsSummary {
+    uint64_t darts = 0;
+    /// @brief Points and darts of finished visits (a bust scores nothing), for the 3-dart average
+    uint64_t visitPoints = 0;
+    uint64_t visitDarts = 0;
+    uint64_t visits = 0;
+    /// @brief The same for the first three visits of every leg
+    uint64_t first9Points = 0;
+    uint64_t first9Darts = 0;
+    /// @brief Darts thrown with a one-dart finish left, and the ones that finished
+    uint64_t checkoutAttempts = 0;
+    uint64_t checkouts = 0;
+    uint64_t trebles = 0;
+    /// @brief Darts in the double ring (and the bull)
+    uint64_t doubles = 0;
+    uint64_t count180 = 0;
+    uint64_t legs = 0;
+    uint64_t legsWon = 0;
+    /// @brief Fewest darts in a won leg (0 if none was won)
+    uint32_t bestLeg = 0;
+    /// @brief The biggest visit that finished a leg
+    uint32_t highestCheckout = 0;
+
+    /// @brief Adds other's counts to these
+    void merge(const StatsSummary &other);
+
+    double threeDartAverage() const { return visitDarts > 0 ? 3.0 * visitPoints / visitDarts : 0.0; }
+    double first9Average() const { return first9Darts > 0 ? 3.0 * first9Points / first9Darts : 0.0; }
+    /// @brief Percentages (0 to 100)
+    double checkoutPercentage() const { return checkoutAttempts > 0 ? 100.0 * checkouts / checkoutAttempts : 0.0; }
+    double trebleRate() const { return darts > 0 ? 100.0 * trebles / darts : 0.0; }
+    double doubleRate() const { return darts > 0 ? 100.0 * doubles / darts : 0.0; }
+};
+
+/**
+ * @brief One player's statistics: all time, this session, the last 10 legs and the last 30 days.
+ * @details Every dart updates a handful of counters, whatever the history, so adding one costs the
+ *          same after ten throws or ten million. The sliding windows are rings of summaries (one per
+ *          leg, one per day) that are merged when read, so reading costs at most 30 merges and never
+ *          looks at a single throw.
+ *
+ *          Plain data, so it can be saved and loaded as it is (see StatsEngine).
+ */
+class PlayerStats {
+    public:
+        static const int LEG_WINDOW = 10;
+        static const int DAY_WINDOW = 30;
+
+        /// @brief Counts a dart the player threw (in the order they were thrown)
+        void add(const ThrowRecord &record);
+        /// @brief Ends the leg the player is in (a leg they won ends by itself)
+        void endLeg();
+        bool inLeg() const { return legOpen; }
+
+        /// @brief Everything up to the start of this session
+        const StatsSummary &getBefore() const { return before; }
+        /// @brief Everything since the start of this session
+        const StatsSummary &getSession() const { return session; }
+        /// @brief Both
+        StatsSummary getAllTime() const;
+        /// @brief The last LEG_WINDOW finished legs
+        StatsSummary getLastLegs() const;
+        /// @brief The last DAY_WINDOW days up to and including the day of now (nanoseconds since the epoch)
+        StatsSummary getLastDays(uint64_t now) const;
+
+        /// @brief Folds this session into the ones before, so a new one starts from zero
+        void startSession();
+
+    private:
+        StatsSummary before, session;
+
+        // the leg and visit being thrown
+        bool legOpen = false;
+        StatsSummary leg;
+        uint32_t legDarts = 0;
+        uint32_t visitScore = 0;
+        uint8_t visitDarts = 0;
+
+        /// @brief The last legs, lastLegs[legNext] is where the next one goes
+        std::array<StatsSummary, LEG_WINDOW> lastLegs{};
+        int legNext = 0;
+        int legCount = 0;
+
+        /// @brief One summary per day, day d is in days[d % DAY_WINDOW] (for the DAY_WINDOW days up to lastDay)
+        std::array<StatsSummary, DAY_WINDOW> days{};
+        int64_t lastDay = -1;
+
+        /// @brief Adds a change to the session, the running leg and the day
+        void count(const StatsSummary &change);
+        /// @brief Moves the day ring on to day (clearing the days in between)
+        void advanceDay(int64_t day);
+};
+
+/**
+ * @brief Keeps the statistics of every player slot from the throws of a throw log.
+ * @details Feed it every throw as it's scored with add(). The summaries can be saved next to the log
+ *          and loaded in the next session, together with how many throws they have counted, so
+ *          catchUp() only has to read the throws logged since they were saved.
+ *
+ * Usage:
+ * @code
+ * StatsEngine stats;
+ * stats.load("throws.bin.stats");
+ * stats.catchUp(reader);         // the throws the saved stats haven't seen
+ * stats.add(record);             // every new throw
+ * stats.getPlayer(0).getLastLegs().threeDartAverage();
+ * stats.save("throws.bin.stats");
+ * @endcode
+ */
+class StatsEngine {
+    public:
+        /// @brief Counts a throw (in the order they were thrown)
+        void add(const ThrowRecord &record);
+        /// @brief Counts the throws of a log that haven't been counted yet
+        /// @details If the log has fewer throws than were counted (it lost some in a crash, or it's a
+        ///          different log), everything is counted again from the log.
+        /// @return how many were added
+        size_t catchUp(const ThrowLogReader &log);
+
+        const PlayerStats &getPlayer(int player) const { return players[player]; }
+        /// @brief Throws counted so far, all sessions together
+        uint64_t getThrowCount() const { return throwCount; }
+
+        /// @brief Loads saved statistics and starts a new session on top of them
+        /// @return false if there are none (or they're from a different version), and nothing changes
+        bool load(const string &path);
+        /// @brief Saves the statistics (written to a temporary file and synced first, so a crash keeps the old ones)
+        /// @note Blocks until they're on disk, StatsWriter does it on its own thread
+        bool save(const string &path) const;
+
+    private:
+        std::array<PlayerStats, X01Game::MAX_PLAYERS> players{};
+        uint64_t throwCount = 0;
+        /// @brief The match and leg being played, every match is a leg
+        uint32_t match = 0;
+        uint16_t leg = 0;
+
+        /// @brief Ends the leg for everyone still in it
+        void endLeg();
+};
+
+/**
+ * @brief Saves the statistics of a throw log's throws on its own thread, so scoring never waits for the disk.
+ * @details submit() copies the statistics and wakes the writer. Before saving, the writer waits for the
+ *          log to have written the throws that were appended when they were submitted, and only saves
+ *          them if the log has every throw they counted on disk. Otherwise a crash could leave saved
+ *          statistics that are ahead of the log. If statistics come faster than the disk takes them,
+ *          the writer skips to the newest.
+ *
+ * Usage:
+ * @code
+ * StatsWriter writer;
+ * writer.open("throws.bin.stats", log);   // the ThrowLog the statistics count, it has to outlive the writer
+ * writer.submit(stats);                   // e.g. after every leg, from the thread that appends to the log
+ * @endcode
+ */
+class StatsWriter {
+    public:
+        StatsWriter() = default;
+        /// @brief Saves the last statistics submitted and stops the writer
+        ~StatsWriter();
+
+        StatsWriter(const StatsWriter &) = delete;
+        StatsWriter &operator=(const StatsWriter &) = delete;
+
+        void open(const string &path, const ThrowLog &log);
+        /// @brief Saves the last statistics submitted and stops the writer
+        void close();
+        bool isOpen() const { return writer.joinable(); }
+
+        /// @brief Hands statistics to the writer, replacing ones it hasn't started on
+        void submit(const StatsEngine &stats);
+
+        /// @brief Times the statistics were saved
+        uint64_t getSaved() const { return saved.load(std::memory_order_relaxed); }
+
+    private:
+        string path;
+        const ThrowLog *log = nullptr;
+        std::thread writer;
+        std::mutex mutex;
+        std::condition_variable wake;
+        bool running = false;
+        /// @brief The newest statistics (if there are some) and how many throws had been appended then
+        StatsEngine pending;
+        uint64_t pendingAppended = 0;
+        bool havePending = false;
+        /// @brief The ones being saved
+        StatsEngine writing;
+        std::atomic<uint64_t> saved{0};
+
+        /// @brief The writer thread's loop
+        void run();
+};
+
+#endif //GRAPHICS_PLAYERSTATS_H
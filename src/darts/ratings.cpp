@@ -0,0 +1,335 @@
+#include "ratings.h"
+#include "x01.h"
+#include "../util/log.h"
+
+#include <algorithm>
+#include <cmath>
+#include <future>
+#include <mutex>
+
+static_assert(X01Game::MAX_PLAYERS <= 32, "a leg's players are a bit mask");
+
+// Glicko's q, ln(10) / 400, so 10^(x / 400) is exp(Q x)
+static const double Q = 0.0057564627324851142;
+static const double PI = 3.14159265358979323846;
+static const double DAY = 86400.0;
+
+// how much a result against a player with this deviation tells
+static double g(double deviation) {
+    return 1 / std::sqrt(1 + 3 * Q * Q * deviation * deviation / (PI * PI));
+}
+
+// the probability of beating a player rated difference lower
+static double winProbability(double difference) {
+    return 1 / (1 + std::exp(-Q * difference));
+}
+
+// a deviation grown back over the time a player didn't play
+static double grown(const RatingParams &params, double deviation, uint32_t results, uint32_t last, uint32_t now) {
+    if (results == 0 || now <= last)
+        return deviation;
+    double days = (now - last) / DAY;
+    return std::min(std::sqrt(deviation * deviation + params.deviationGrowth * params.deviationGrowth * days),
+                    params.initialDeviation);
+}
+
+namespace {
+    // a set of ratings, column by column
+    struct Columns {
+        double *ratings;
+        double *deviations;
+        uint32_t *results;
+        uint32_t *last;
+    };
+}
+
+// rates a result of a against b, both players' ratings from before it are used for both
+static void rateResult(const RatingParams &params, const Columns &players, uint32_t time, uint32_t a, uint32_t b,
+                       double score, double weight, RatingAccuracy &accuracy) {
+    double ra = players.ratings[a], rb = players.ratings[b];
+    if (params.system == eloRating) {
+        double expected = winProbability(ra - rb);
+        accuracy.add(expected, score);
+        double change = params.k * weight * (score - expected);
+        players.ratings[a] = ra + change;
+        players.ratings[b] = rb - change;
+    }
+    else {
+        double da = grown(params, players.deviations[a], players.results[a], players.last[a], time);
+        double db = grown(params, players.deviations[b], players.results[b], players.last[b], time);
+        accuracy.add(winProbability(g(std::sqrt(da * da + db * db)) * (ra - rb)), score);
+
+        // a match is weight legs with the same result
+        double ga = g(da), gb = g(db);
+        double ea = winProbability(gb * (ra - rb)), eb = winProbability(ga * (rb - ra));
+        double inverseA = 1 / (da * da) + weight * Q * Q * gb * gb * ea * (1 - ea);
+        double inverseB = 1 / (db * db) + weight * Q * Q * ga * ga * eb * (1 - eb);
+        players.ratings[a] = ra + Q / inverseA * gb * weight * (score - ea);
+        players.ratings[b] = rb + Q / inverseB * ga * weight * ((1 - score) - eb);
+        players.deviations[a] = std::max(std::sqrt(1 / inverseA), params.minDeviation);
+        players.deviations[b] = std::max(std::sqrt(1 / inverseB), params.minDeviation);
+    }
+    players.results[a]++;
+    players.results[b]++;
+    players.last[a] = time;
+    players.last[b] = time;
+}
+
+void RatingAccuracy::add(double p, double score) {
+    // a certain prediction that's wrong would be infinitely bad
+    double clamped = std::clamp(p, 1e-9, 1 - 1e-9);
+    results++;
+    logLoss -= score * std::log(clamped) + (1 - score) * std::log(1 - clamped);
+    squaredError += (p - score) * (p - score);
+    if (p == 0.5 || score == 0.5)
+        correct += 0.5;
+    else if ((p > 0.5) == (score > 0.5))
+        correct += 1;
+}
+
+RatingAccuracy &RatingAccuracy::operator+=(const RatingAccuracy &other) {
+    results += other.results;
+    logLoss += other.logLoss;
+    squaredError += other.squaredError;
+    correct += other.correct;
+    return *this;
+}
+
+RatingEngine::RatingEngine(const RatingParams &params, uint32_t seasonDays)
+    : params(params), seasonSeconds(std::max(seasonDays, 1u) * 86400u) {}
+
+uint32_t RatingEngine::indexOf(uint32_t player) {
+    auto found = indices.find(player);
+    if (found != indices.end())
+        return found->second;
+    uint32_t index = static_cast<uint32_t>(ids.size());
+    indices.emplace(player, index);
+    ids.push_back(player);
+    ratings.push_back(params.initialRating);
+    deviations.push_back(params.initialDeviation);
+    resultCounts.push_back(0);
+    lastPlayed.push_back(0);
+    return index;
+}
+
+bool RatingEngine::add(const RatingResult &result) {
+    if (result.first == result.second || !(result.score >= 0 && result.score <= 1)) {
+        LOG_WARNING("RATINGS", "Skipped a result of {} against {} scored {}", result.first, result.second, result.score);
+        return false;
+    }
+    uint32_t season = seasonOf(result.time);
+    if (seasons.empty() || season > seasons.back().number)
+        startSeason(season, history.size());
+
+    Rated rated{result.time, indexOf(result.first), indexOf(result.second), result.score, static_cast<uint8_t>(result.kind)};
+    history.push_back(rated);
+    Columns players{ratings.data(), deviations.data(), resultCounts.data(), lastPlayed.data()};
+    rateResult(params, players, rated.time, rated.first, rated.second, rated.score,
+               rated.kind == matchResult ? params.matchWeight : 1.0, accuracy);
+    return true;
+}
+
+size_t RatingEngine::catchUp(const ThrowLogReader &log) {
+    if (log.size() < throwCount) {
+        LOG_WARNING("RATINGS", "The throw log has {} throws but {} were rated, it isn't the log they came from", log.size(), throwCount);
+        return 0;
+    }
+    size_t first = static_cast<size_t>(throwCount);
+    for (size_t i = first; i < log.size(); ++i) {
+        const ThrowRecord &record = log[i];
+        throwCount++;
+        if (record.player >= X01Game::MAX_PLAYERS || record.result == rejected)
+            continue;
+        // a leg nobody checked out in has no result
+        if (record.match != match || record.leg != leg) {
+            match = record.match;
+            leg = record.leg;
+            legPlayers = 0;
+        }
+        legPlayers |= 1u << record.player;
+        if (record.result != checkout)
+            continue;
+        uint32_t time = static_cast<uint32_t>(record.time / 1000000000ull);
+        for (uint32_t player = 0; player < X01Game::MAX_PLAYERS; ++player) {
+            if (player != record.player && (legPlayers & (1u << player)) != 0)
+                add({time, record.player, player, 1.0f, legResult});
+        }
+        legPlayers = 0;
+    }
+    return log.size() - first;
+}
+
+void RatingEngine::reserve(size_t results) {
+    history.reserve(history.size() + results);
+}
+
+void RatingEngine::startSeason(uint32_t number, size_t firstResult) {
+    Season season{number, firstResult, vector<PlayerRating>(ids.size()), accuracy};
+    for (size_t i = 0; i < ids.size(); ++i)
+        season.start[i] = {ids[i], ratings[i], deviations[i], resultCounts[i], lastPlayed[i]};
+    seasons.push_back(std::move(season));
+}
+
+void RatingEngine::restore(const Season &season) {
+    for (size_t i = 0; i < ids.size(); ++i) {
+        if (i < season.start.size()) {
+            ratings[i] = season.start[i].rating;
+            deviations[i] = season.start[i].deviation;
+            resultCounts[i] = season.start[i].results;
+            lastPlayed[i] = season.start[i].lastPlayed;
+        }
+        else {
+            ratings[i] = params.initialRating;
+            deviations[i] = params.initialDeviation;
+            resultCounts[i] = 0;
+            lastPlayed[i] = 0;
+        }
+    }
+    accuracy = season.accuracy;
+}
+
+void RatingEngine::recompute(const RatingParams &rules, ThreadPool *pool, uint32_t fromSeason) {
+    params = rules;
+    auto from = std::lower_bound(seasons.begin(), seasons.end(), fromSeason,
+                                 [](const Season &season, uint32_t number) { return season.number < number; });
+    if (from == seasons.end())
+        return;
+
+    // the seasons rated again, and where their results start
+    vector<std::pair<uint32_t, size_t>> bounds;
+    for (auto season = from; season != seasons.end(); ++season)
+        bounds.emplace_back(season->number, season->firstResult);
+    restore(*from);
+    seasons.erase(from, seasons.end());
+
+    for (size_t i = 0; i < bounds.size(); ++i) {
+        startSeason(bounds[i].first, bounds[i].second);
+        rate(bounds[i].second, i + 1 < bounds.size() ? bounds[i + 1].second : history.size(), pool);
+    }
+}
+
+void RatingEngine::rate(size_t first, size_t last, ThreadPool *pool) {
+    Columns players{ratings.data(), deviations.data(), resultCounts.data(), lastPlayed.data()};
+    const RatingParams rules = params;
+    auto rateOne = [&rules, &players](const Rated &result, RatingAccuracy &into) {
+        rateResult(rules, players, result.time, result.first, result.second, result.score,
+                   result.kind == matchResult ? rules.matchWeight : 1.0, into);
+    };
+    if (pool == nullptr || pool->size() < 2 || last - first < 2 * parallelGrain) {
+        for (size_t i = first; i < last; ++i)
+            rateOne(history[i], accuracy);
+        return;
+    }
+
+    // a result's level is past both players' previous results, so a level's results share no players
+    const size_t count = last - first;
+    vector<uint32_t> levels(count), playerLevels(ids.size(), 0);
+    uint32_t levelCount = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const Rated &result = history[first + i];
+        uint32_t level = std::max(playerLevels[result.first], playerLevels[result.second]);
+        levels[i] = level;
+        playerLevels[result.first] = playerLevels[result.second] = level + 1;
+        levelCount = std::max(levelCount, level + 1);
+    }
+    // counting sort, a level's results stay in the order they were played
+    vector<size_t> starts(size_t(levelCount) + 1, 0);
+    for (uint32_t level : levels)
+        starts[level + 1]++;
+    for (uint32_t level = 0; level < levelCount; ++level)
+        starts[level + 1] += starts[level];
+    vector<uint32_t> order(count);
+    {
+        vector<size_t> next(starts.begin(), starts.end() - 1);
+        for (size_t i = 0; i < count; ++i)
+            order[next[levels[i]]++] = static_cast<uint32_t>(i);
+    }
+
+    std::mutex merging;
+    for (uint32_t level = 0; level < levelCount; ++level) {
+        const uint32_t *results = order.data() + starts[level];
+        size_t size = starts[level + 1] - starts[level];
+        // at least parallelGrain results a worker, or handing them out takes longer than rating them
+        size_t workers = std::min(pool->size(), size / parallelGrain);
+        if (workers < 2) {
+            for (size_t i = 0; i < size; ++i)
+                rateOne(history[first + results[i]], accuracy);
+            continue;
+        }
+        pool->parallelFor(workers, [&](size_t begin, size_t end) {
+            RatingAccuracy part;
+            for (size_t i = size * begin / workers; i < size * end / workers; ++i)
+                rateOne(history[first + results[i]], part);
+            std::lock_guard<std::mutex> lock(merging);
+            accuracy += part;
+        });
+    }
+}
+
+vector<RatingAccuracy> RatingEngine::sweep(const vector<RatingParams> &rules, ThreadPool *pool) const {
+    vector<RatingAccuracy> accuracies(rules.size());
+    // every set of rules rates the whole history on its own columns
+    auto run = [this, &rules, &accuracies](size_t index) {
+        const RatingParams &params = rules[index];
+        size_t count = ids.size();
+        vector<double> ratings(count, params.initialRating), deviations(count, params.initialDeviation);
+        vector<uint32_t> results(count, 0), last(count, 0);
+        Columns players{ratings.data(), deviations.data(), results.data(), last.data()};
+        RatingAccuracy accuracy;
+        for (const Rated &result : history)
+            rateResult(params, players, result.time, result.first, result.second, result.score,
+                       result.kind == matchResult ? params.matchWeight : 1.0, accuracy);
+        accuracies[index] = accuracy;
+    };
+    if (pool == nullptr) {
+        for (size_t i = 0; i < rules.size(); ++i)
+            run(i);
+        return accuracies;
+    }
+    // a task each, so rules that take longer don't hold up a worker's share of the others
+    vector<std::future<void>> done;
+    done.reserve(rules.size());
+    for (size_t i = 0; i < rules.size(); ++i)
+        done.push_back(pool->submit([&run, i]() { run(i); }));
+    for (std::future<void> &task : done)
+        task.get();
+    return accuracies;
+}
+
+PlayerRating RatingEngine::getPlayer(uint32_t player) const {
+    auto found = indices.find(player);
+    if (found == indices.end())
+        return {player, params.initialRating, params.initialDeviation, 0, 0};
+    uint32_t i = found->second;
+    return {player, ratings[i], deviations[i], resultCounts[i], lastPlayed[i]};
+}
+
+double RatingEngine::expected(uint32_t first, uint32_t second) const {
+    PlayerRating a = getPlayer(first), b = getPlayer(second);
+    if (params.system == eloRating)
+        return winProbability(a.rating - b.rating);
+    return winProbability(g(std::sqrt(a.deviation * a.deviation + b.deviation * b.deviation)) * (a.rating - b.rating));
+}
+
+vector<PlayerRating> RatingEngine::standings() const {
+    vector<PlayerRating> players(ids.size());
+    for (size_t i = 0; i < ids.size(); ++i)
+        players[i] = {ids[i], ratings[i], deviations[i], resultCounts[i], lastPlayed[i]};
+    return sorted(std::move(players));
+}
+
+vector<PlayerRating> RatingEngine::standings(uint32_t season) const {
+    // a season ends where the next one starts
+    auto next = std::upper_bound(seasons.begin(), seasons.end(), season,
+                                 [](uint32_t number, const Season &other) { return number < other.number; });
+    if (next == seasons.end())
+        return standings();
+    return sorted(next->start);
+}
+
+vector<PlayerRating> RatingEngine::sorted(vector<PlayerRating> players) const {
+    std::sort(players.begin(), players.end(), [](const PlayerRating &a, const PlayerRating &b) {
+        return a.rating != b.rating ? a.rating > b.rating : a.player < b.player;
+    });
+    return players;
+}
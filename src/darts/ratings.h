@@ -0,0 +1,198 @@
+#ifndef GRAPHICS_RATINGS_H
+#define GRAPHICS_RATINGS_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "throwLog.h"
+#include "../util/threadPool.h"
+
+using std::vector;
+
+/// @brief How ratings move after a result
+enum ratingSystem {eloRating, glickoRating};
+
+/// @brief What a result was the result of
+enum resultKind {legResult, matchResult};
+
+/// @brief The rules ratings are worked out with
+struct RatingParams {
+    ratingSystem system = glickoRating;
+    /// @brief Where a new player starts
+    double initialRating = 1500;
+    /// @brief Elo: how far a result can move a rating
+    double k = 24;
+    /// @brief A match counts as this many legs
+    double matchWeight = 3;
+    /// @brief Glicko: a new player's deviation, which is also as uncertain as a rating gets
+    double initialDeviation = 350;
+    /// @brief Glicko: as certain as a rating gets
+    double minDeviation = 30;
+    /// @brief Glicko: how fast the deviation grows back while a player doesn't play (after t days it's
+    ///        sqrt(deviation^2 + deviationGrowth^2 t))
+    double deviationGrowth = 5;
+};
+
+/// @brief A leg or match between two league players
+struct RatingResult {
+    /// @brief Seconds since the Unix epoch
+    uint32_t time = 0;
+    /// @brief League player IDs
+    uint32_t first = 0, second = 0;
+    /// @brief 1 if the first player won, 0 if the second did, 0.5 for a draw
+    float score = 1;
+    resultKind kind = legResult;
+};
+
+/// @brief A player's rating
+struct PlayerRating {
+    uint32_t player = 0;
+    double rating = 1500;
+    /// @brief Glicko's rating deviation (the rating is within about two of it of the player's real
+    ///        strength), unused by Elo
+    double deviation = 350;
+    /// @brief Results rated, and when the last one was
+    uint32_t results = 0;
+    uint32_t lastPlayed = 0;
+};
+
+/// @brief How well the ratings before each result predicted it
+struct RatingAccuracy {
+    uint64_t results = 0;
+    /// @brief Sums over the results of -log(p) of what happened, (p - score)^2 and 1 for each winner
+    ///        that was the favourite (a half for a draw or a coin toss)
+    double logLoss = 0;
+    double squaredError = 0;
+    double correct = 0;
+
+    /// @brief Counts a result the ratings gave the first player a probability p of winning
+    void add(double p, double score);
+    RatingAccuracy &operator+=(const RatingAccuracy &other);
+
+    /// @brief Averages (the lower the better for the first two, 0.693, 0.25 and 0.5 are a coin toss)
+    double meanLogLoss() const { return results > 0 ? logLoss / results : 0.0; }
+    double brierScore() const { return results > 0 ? squaredError / results : 0.0; }
+    double hitRate() const { return results > 0 ? correct / results : 0.0; }
+};
+
+/**
+ * @brief Elo or Glicko ratings of league players, kept up to date result by result.
+ * @details add() rates a result straight away: it only reads and writes the two players' ratings,
+ *          so it's O(1) however long the history is. Every result is kept (20 bytes each), so the
+ *          history can be rated again when the rules change:
+ *
+ *          - recompute() goes through it season by season. Inside a season, results are put into
+ *            levels: a result's level is one more than the level of either player's previous result,
+ *            so no two results of a level share a player and a level is rated in parallel on a
+ *            ThreadPool. Every player still gets their results in the same order, so the ratings
+ *            come out exactly as if they'd been added one by one.
+ *          - The ratings at the start of every season are cached, so a rule change from a season on
+ *            only rates that season and the ones after it again, and standings() of a past season
+ *            are a lookup.
+ *          - sweep() rates the whole history with many sets of rules, one per worker at a time, and
+ *            says how well each predicted the results, e.g. to tune the K-factor.
+ *
+ *          Results have to be added in the order they were played; a season is seasonDays long,
+ *          counted from the Unix epoch.
+ *
+ * Usage:
+ * @code
+ * RatingEngine ratings;
+ * ratings.add({time, alice, bob, 1.0f, legResult});
+ * printf("%.0f\n", ratings.getPlayer(alice).rating);
+ * params.k = 32;
+ * ratings.recompute(params, &pool);
+ * @endcode
+ */
+class RatingEngine {
+    public:
+        /// @brief The fewest results of a level a worker is given by default. A result takes about 175 ns
+        ///        and handing a worker its share about 4 us, so 64 keep the hand-off to a fifth of the work.
+        static const size_t PARALLEL_GRAIN = 64;
+
+        explicit RatingEngine(const RatingParams &params = RatingParams(), uint32_t seasonDays = 91);
+
+        /// @brief Rates a result
+        /// @return false (and nothing changes) if a player played themselves or the score isn't 0 to 1
+        bool add(const RatingResult &result);
+        /// @brief Rates the legs of a throw log that haven't been rated yet: whoever checked out beat
+        ///        everyone else who threw in the leg. The log only knows seats, so they're the player IDs.
+        /// @return how many throws were read
+        size_t catchUp(const ThrowLogReader &log);
+        /// @brief Makes room for more results
+        void reserve(size_t results);
+
+        /// @brief Rates the whole history again from the start of a season (the ones before it keep
+        ///        their ratings), with new rules that are then used for new results too
+        void recompute(const RatingParams &params, ThreadPool *pool = nullptr, uint32_t fromSeason = 0);
+        /// @brief Rates the whole history with every set of rules, without changing the ratings
+        /// @return how well each one predicted the results, in the same order
+        vector<RatingAccuracy> sweep(const vector<RatingParams> &rules, ThreadPool *pool = nullptr) const;
+
+        /// @brief A player's rating (a new player's if they haven't played)
+        PlayerRating getPlayer(uint32_t player) const;
+        /// @brief The probability the first player beats the second, going by their ratings now
+        double expected(uint32_t first, uint32_t second) const;
+        /// @brief Every player's rating, the best first
+        vector<PlayerRating> standings() const;
+        /// @brief Every player's rating at the end of a season, the best first (none before the first one)
+        vector<PlayerRating> standings(uint32_t season) const;
+
+        const RatingParams &getParams() const { return params; }
+        const RatingAccuracy &getAccuracy() const { return accuracy; }
+        size_t size() const { return history.size(); }
+        size_t getPlayerCount() const { return ids.size(); }
+        /// @brief Sets the fewest results of a level a worker is given (a level with fewer than twice as
+        ///        many is rated on the calling thread)
+        void setParallelGrain(size_t results) { parallelGrain = std::max<size_t>(results, 1); }
+        size_t getParallelGrain() const { return parallelGrain; }
+        uint32_t seasonOf(uint32_t time) const { return time / seasonSeconds; }
+
+    private:
+        /// @brief A result with the players' indices instead of their IDs
+        struct Rated {
+            uint32_t time;
+            uint32_t first, second;
+            float score;
+            uint8_t kind;
+        };
+        /// @brief Everyone's ratings before a season's first result
+        struct Season {
+            uint32_t number;
+            size_t firstResult;
+            vector<PlayerRating> start;
+            RatingAccuracy accuracy;
+        };
+
+        RatingParams params;
+        uint32_t seasonSeconds;
+        size_t parallelGrain = PARALLEL_GRAIN;
+        vector<Rated> history;
+        vector<Season> seasons;
+
+        // players by index, column by column
+        vector<uint32_t> ids;
+        std::unordered_map<uint32_t, uint32_t> indices;
+        vector<double> ratings, deviations;
+        vector<uint32_t> resultCounts, lastPlayed;
+        RatingAccuracy accuracy;
+
+        // the throw log's leg being played
+        uint64_t throwCount = 0;
+        uint32_t match = 0;
+        uint16_t leg = 0;
+        uint32_t legPlayers = 0;
+
+        uint32_t indexOf(uint32_t player);
+        /// @brief Caches everyone's ratings as the start of a season
+        void startSeason(uint32_t number, size_t firstResult);
+        /// @brief Puts a season's cached ratings back (players who came later start again)
+        void restore(const Season &season);
+        /// @brief Rates history[first, last) a level at a time
+        void rate(size_t first, size_t last, ThreadPool *pool);
+        vector<PlayerRating> sorted(vector<PlayerRating> players) const;
+};
+
+#endif //GRAPHICS_RATINGS_H
@@ -0,0 +1,306 @@
+#include "throwLog.h"
+#include "../util/log.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define THROW_LOG_POSIX 1
+#endif
+
+// "DARTTHRW", version, record size
+static const char MAGIC[8] = {'D', 'A', 'R', 'T', 'T', 'H', 'R', 'W'};
+static const uint32_t VERSION = 1;
+static const size_t HEADER_SIZE = 16;
+// how long the writer waits for more throws when there are none
+static const std::chrono::milliseconds IDLE_SLEEP(10);
+
+// CRC-32 (the zlib one), table driven
+static const uint32_t *crcTable() {
+    static const auto table = [] {
+        std::unique_ptr<uint32_t[]> entries(new uint32_t[256]);
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int bit = 0; bit < 8; ++bit)
+                c = c & 1 ? 0xedb88320u ^ (c >> 1) : c >> 1;
+            entries[i] = c;
+        }
+        return entries;
+    }();
+    return table.get();
+}
+
+uint32_t ThrowRecord::computeChecksum() const {
+    const uint32_t *table = crcTable();
+    const unsigned char *bytes = reinterpret_cast<const unsigned char *>(this);
+    uint32_t crc = 0xffffffffu;
+    for (size_t i = 0; i < offsetof(ThrowRecord, checksum); ++i)
+        crc = table[(crc ^ bytes[i]) & 0xff] ^ (crc >> 8);
+    return crc ^ 0xffffffffu;
+}
+
+// how many records are good: only the last batch can be torn, so only it is checked
+static size_t goodRecords(const ThrowRecord *records, size_t count) {
+    size_t first = count > ThrowLog::QUEUE_CAPACITY ? count - ThrowLog::QUEUE_CAPACITY : 0;
+    for (size_t i = first; i < count; ++i) {
+        if (!records[i].isValid())
+            return i;
+    }
+    return count;
+}
+
+static void makeHeader(unsigned char *header) {
+    uint32_t recordSize = sizeof(ThrowRecord);
+    std::memcpy(header, MAGIC, sizeof(MAGIC));
+    std::memcpy(header + 8, &VERSION, 4);
+    std::memcpy(header + 12, &recordSize, 4);
+}
+
+ThrowLog::~ThrowLog() {
+    close();
+}
+
+bool ThrowLog::append(const ThrowRecord &record) {
+    if (!queue.push(record)) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    appended++;
+    return true;
+}
+
+void ThrowLog::flush() {
+    // the writer looks at the queue every IDLE_SLEEP at the most
+    while (isOpen() && handled.load(std::memory_order_acquire) < appended)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+}
+
+void ThrowLog::run() {
+    while (running.load(std::memory_order_acquire)) {
+        if (!writeBatch())
+            std::this_thread::sleep_for(IDLE_SLEEP);
+    }
+    // whatever came in while closing
+    while (writeBatch()) {}
+}
+
+#ifdef THROW_LOG_POSIX
+
+bool ThrowLog::open(const string &path) {
+    close();
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        LOG_ERROR("THROWLOG", "Could not open {}: {}", path, std::strerror(errno));
+        return false;
+    }
+    batch.reset(new ThrowRecord[QUEUE_CAPACITY]);
+
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        LOG_ERROR("THROWLOG", "Could not read the size of {}: {}", path, std::strerror(errno));
+        ::close(fd);
+        fd = -1;
+        return false;
+    }
+    size_t size = static_cast<size_t>(info.st_size);
+    unsigned char header[HEADER_SIZE], expected[HEADER_SIZE];
+    makeHeader(expected);
+    if (size < HEADER_SIZE) {
+        // a new log (or one whose header never made it to disk)
+        if (ftruncate(fd, 0) != 0 || pwrite(fd, expected, HEADER_SIZE, 0) != static_cast<ssize_t>(HEADER_SIZE) || fdatasync(fd) != 0) {
+            LOG_ERROR("THROWLOG", "Could not write to {}: {}", path, std::strerror(errno));
+            ::close(fd);
+            fd = -1;
+            return false;
+        }
+        size = HEADER_SIZE;
+    }
+    else if (pread(fd, header, HEADER_SIZE, 0) != static_cast<ssize_t>(HEADER_SIZE) || std::memcmp(header, expected, HEADER_SIZE) != 0) {
+        LOG_ERROR("THROWLOG", "{} is not a throw log (or a different version of one)", path);
+        ::close(fd);
+        fd = -1;
+        return false;
+    }
+
+    // check the last batch and cut off anything torn, so new records follow the last good one
+    size_t count = (size - HEADER_SIZE) / sizeof(ThrowRecord);
+    size_t tail = std::min(count, QUEUE_CAPACITY);
+    size_t tailStart = HEADER_SIZE + (count - tail) * sizeof(ThrowRecord);
+    size_t good = count - tail;
+    if (pread(fd, batch.get(), tail * sizeof(ThrowRecord), static_cast<off_t>(tailStart)) == static_cast<ssize_t>(tail * sizeof(ThrowRecord)))
+        good += goodRecords(batch.get(), tail);
+    size_t end = HEADER_SIZE + good * sizeof(ThrowRecord);
+    if (end != size) {
+        LOG_WARNING("THROWLOG", "{}: cut off {} bytes of torn records after record {}", path, size - end, good);
+        if (ftruncate(fd, static_cast<off_t>(end)) != 0 || fdatasync(fd) != 0)
+            LOG_ERROR("THROWLOG", "Could not repair {}: {}", path, std::strerror(errno));
+    }
+    lseek(fd, static_cast<off_t>(end), SEEK_SET);
+
+    synced.store(good, std::memory_order_release);
+    running = true;
+    writer = std::thread(&ThrowLog::run, this);
+    LOG_INFO("THROWLOG", "Logging throws to {} ({} already in it)", path, good);
+    return true;
+}
+
+void ThrowLog::close() {
+    if (writer.joinable()) {
+        running.store(false, std::memory_order_release);
+        writer.join();
+    }
+    if (fd >= 0)
+        ::close(fd);
+    fd = -1;
+}
+
+bool ThrowLog::writeBatch() {
+    size_t n = 0;
+    while (n < QUEUE_CAPACITY && queue.pop(batch[n])) {
+        batch[n].checksum = batch[n].computeChecksum();
+        n++;
+    }
+    if (n == 0)
+        return false;
+
+    // a failed batch is cut off again, so the file only ever holds whole records
+    off_t start = lseek(fd, 0, SEEK_CUR);
+    auto drop = [this, n, start](const char *what) {
+        LOG_ERROR("THROWLOG", "Could not {} {} throws: {}", what, n, std::strerror(errno));
+        dropped.fetch_add(n, std::memory_order_relaxed);
+        handled.fetch_add(n, std::memory_order_release);
+        if (start < 0 || ftruncate(fd, start) != 0 || lseek(fd, start, SEEK_SET) != start)
+            LOG_ERROR("THROWLOG", "Could not cut the failed throws off the log: {}", std::strerror(errno));
+    };
+
+    const char *data = reinterpret_cast<const char *>(batch.get());
+    size_t left = n * sizeof(ThrowRecord);
+    while (left > 0) {
+        ssize_t done = ::write(fd, data, left);
+        if (done < 0 && errno == EINTR)
+            continue;
+        if (done <= 0) {
+            // the disk is full or gone, the records are lost
+            drop("write");
+            return true;
+        }
+        data += done;
+        left -= static_cast<size_t>(done);
+    }
+    // only the data has to reach the disk (the file size too, which fdatasync includes)
+#ifdef __APPLE__
+    int status = fcntl(fd, F_FULLFSYNC);
+#else
+    int status = fdatasync(fd);
+#endif
+    if (status != 0) {
+        // nothing says the batch is on the disk, so it doesn't count as written
+        drop("sync");
+        return true;
+    }
+    written.fetch_add(n, std::memory_order_relaxed);
+    batches.fetch_add(1, std::memory_order_relaxed);
+    synced.fetch_add(n, std::memory_order_release);
+    handled.fetch_add(n, std::memory_order_release);
+    return true;
+}
+
+ThrowLogReader::~ThrowLogReader() {
+    close();
+}
+
+bool ThrowLogReader::open(const string &path) {
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        LOG_ERROR("THROWLOG", "Could not open {}: {}", path, std::strerror(errno));
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        LOG_ERROR("THROWLOG", "Could not read the size of {}: {}", path, std::strerror(errno));
+        ::close(fd);
+        return false;
+    }
+    size_t size = static_cast<size_t>(info.st_size);
+    if (size < HEADER_SIZE) {
+        LOG_ERROR("THROWLOG", "{} is not a throw log", path);
+        ::close(fd);
+        return false;
+    }
+
+    void *data = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    // the mapping keeps the file open
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        LOG_ERROR("THROWLOG", "Could not map {}: {}", path, std::strerror(errno));
+        return false;
+    }
+    mapping = data;
+    mappedBytes = size;
+
+    unsigned char expected[HEADER_SIZE];
+    makeHeader(expected);
+    if (std::memcmp(data, expected, HEADER_SIZE) != 0) {
+        LOG_ERROR("THROWLOG", "{} is not a throw log (or a different version of one)", path);
+        close();
+        return false;
+    }
+#ifdef MADV_SEQUENTIAL
+    // scans go front to back, so read ahead
+    madvise(data, size, MADV_SEQUENTIAL);
+#endif
+
+    records = reinterpret_cast<const ThrowRecord *>(static_cast<const unsigned char *>(data) + HEADER_SIZE);
+    size_t whole = (size - HEADER_SIZE) / sizeof(ThrowRecord);
+    count = goodRecords(records, whole);
+    torn = whole - count + ((size - HEADER_SIZE) % sizeof(ThrowRecord) != 0 ? 1 : 0);
+    return true;
+}
+
+void ThrowLogReader::close() {
+    if (mapping != nullptr)
+        munmap(mapping, mappedBytes);
+    mapping = nullptr;
+    mappedBytes = 0;
+    records = nullptr;
+    count = torn = 0;
+}
+
+#else
+
+bool ThrowLog::open(const string &path) {
+    LOG_ERROR("THROWLOG", "Throw logs ({}) aren't supported on this platform", path);
+    return false;
+}
+
+void ThrowLog::close() {}
+
+bool ThrowLog::writeBatch() {
+    return false;
+}
+
+ThrowLogReader::~ThrowLogReader() {}
+
+bool ThrowLogReader::open(const string &path) {
+    LOG_ERROR("THROWLOG", "Throw logs ({}) aren't supported on this platform", path);
+    return false;
+}
+
+void ThrowLogReader::close() {}
+
+#endif
+
+size_t ThrowLogReader::verifyAll() const {
+    for (size_t i = 0; i < count; ++i) {
+        if (!records[i].isValid())
+            return i;
+    }
+    return count;
+}
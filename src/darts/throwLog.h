@@ -0,0 +1,183 @@
+#ifndef GRAPHICS_THROWLOG_H
+#define GRAPHICS_THROWLOG_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include "x01.h"
+#include "../util/spscQueue.h"
+
+using std::string;
+
+/**
+ * @brief One thrown dart as it's stored in a throw log, 32 bytes.
+ * @details Records are written exactly as they are in memory (little endian) and read back the same
+ *          way, straight out of the mapped file.
+ */
+struct ThrowRecord {
+    /// @brief x and y when it isn't known where the dart landed (it was typed in)
+    static const int16_t NO_POSITION = INT16_MIN;
+
+    /// @brief When the dart was thrown, nanoseconds since the Unix epoch
+    uint64_t time = 0;
+    /// @brief The match on the server (a new one is created for every leg)
+    uint32_t match = 0;
+    /// @brief Legs played before this one this session, and the thrower's visits before this one in the leg
+    uint16_t leg = 0;
+    uint16_t visit = 0;
+    uint8_t player = 0;
+    /// @brief 0 to 2, the dart's place in its visit
+    uint8_t dart = 0;
+    uint8_t segment = 0;
+    uint8_t multiplier = 0;
+    /// @brief Where it landed, tenths of millimetres from the bull (x right, y up), or NO_POSITION
+    int16_t x = NO_POSITION;
+    int16_t y = NO_POSITION;
+    /// @brief The throwResult the server gave it
+    uint8_t result = 0;
+    uint8_t flags = 0;
+    /// @brief The score the thrower needed before this dart (0 if it isn't known)
+    uint16_t remaining = 0;
+    /// @brief CRC-32 of the 28 bytes before it, filled in by the writer
+    uint32_t checksum = 0;
+
+    Dart getDart() const { return Dart{segment, multiplier}; }
+    bool hasPosition() const { return x != NO_POSITION; }
+    /// @brief Computes the checksum of the record as it is
+    uint32_t computeChecksum() const;
+    bool isValid() const { return checksum == computeChecksum(); }
+};
+
+static_assert(sizeof(ThrowRecord) == 32, "throw records are 32 bytes on disk");
+
+/**
+ * @brief Appends throws to a binary log file from a background thread.
+ * @details append() only puts the record in a lock-free queue, so it never waits for the disk. The
+ *          writer thread takes whatever has queued up every few milliseconds, checksums it and
+ *          writes it with one write() followed by fdatasync(), so once a batch is written it survives
+ *          a crash or a power loss. A power loss can only ever tear the batch that was being written,
+ *          and those records fail their checksum and are ignored by ThrowLogReader (and cut off
+ *          when the log is opened for writing again).
+ *
+ *          The file is a 16 byte header ("DARTTHRW", version, record size) followed by the records.
+ *
+ * Usage:
+ * @code
+ * ThrowLog log;
+ * log.open("throws.bin");
+ * log.append(record);    // from one thread, e.g. the render thread
+ * @endcode
+ */
+class ThrowLog {
+    public:
+        /// @brief Records that can wait for the writer (the most a single batch writes)
+        static const size_t QUEUE_CAPACITY = 4096;
+
+        ThrowLog() = default;
+        /// @brief Writes whatever is queued and closes the file
+        ~ThrowLog();
+
+        ThrowLog(const ThrowLog &) = delete;
+        ThrowLog &operator=(const ThrowLog &) = delete;
+
+        /// @brief Opens (or creates) a log and starts the writer
+        /// @details A torn batch at the end of an existing log is cut off, so new records follow the last good one.
+        /// @return false if the file couldn't be opened or isn't a throw log (the reason is logged)
+        bool open(const string &path);
+        /// @brief Writes whatever is queued, waits for it to be on disk and closes the file
+        void close();
+        bool isOpen() const { return writer.joinable(); }
+        /// @brief True until close() is called (safe to read from any thread)
+        bool isWriting() const { return running.load(std::memory_order_acquire); }
+
+        /// @brief Queues a record for writing, never blocks (call from one thread only)
+        /// @return false if the queue was full and the record was dropped
+        bool append(const ThrowRecord &record);
+        /// @brief Waits until everything appended so far has been written (or dropped), e.g. before
+        ///        reading the log back (call from the thread that appends)
+        void flush();
+
+        /// @brief Records written and synced so far
+        uint64_t getWritten() const { return written.load(std::memory_order_relaxed); }
+        /// @brief Records dropped because the queue was full, or they couldn't be written and synced
+        uint64_t getDropped() const { return dropped.load(std::memory_order_relaxed); }
+        /// @brief write() + fdatasync() rounds so far
+        uint64_t getBatches() const { return batches.load(std::memory_order_relaxed); }
+        /// @brief Records in the file, all of them synced (safe to read from any thread)
+        uint64_t getSynced() const { return synced.load(std::memory_order_acquire); }
+        /// @brief Records appended so far (call from the thread that appends)
+        uint64_t getAppended() const { return appended; }
+        /// @brief Records the writer has taken off the queue, written or dropped (safe to read from any thread)
+        uint64_t getHandled() const { return handled.load(std::memory_order_acquire); }
+
+    private:
+        int fd = -1;
+        std::thread writer;
+        std::atomic<bool> running{false};
+        SpscQueue<ThrowRecord, QUEUE_CAPACITY> queue;
+        /// @brief Where the writer gathers a batch (QUEUE_CAPACITY records, allocated once)
+        std::unique_ptr<ThrowRecord[]> batch;
+        std::atomic<uint64_t> written{0}, dropped{0}, batches{0};
+        /// @brief Records queued (by the appending thread) and taken off the queue by the writer
+        uint64_t appended = 0;
+        std::atomic<uint64_t> handled{0};
+        std::atomic<uint64_t> synced{0};
+
+        /// @brief The writer thread's loop
+        void run();
+        /// @brief Writes and syncs everything queued, returns false if nothing was
+        bool writeBatch();
+};
+
+/**
+ * @brief Reads a throw log by mapping it into memory, so scanning it copies nothing.
+ * @details Only the records that could have been torn by a crash (the last QUEUE_CAPACITY, one
+ *          batch) are checked when the log is opened; the log ends at the first one that fails its
+ *          checksum. Everything before that was synced before the last batch was started.
+ *
+ * Usage:
+ * @code
+ * ThrowLogReader reader;
+ * if (reader.open("throws.bin"))
+ *     for (const ThrowRecord &record : reader)
+ *         points += record.getDart().points();
+ * @endcode
+ */
+class ThrowLogReader {
+    public:
+        ThrowLogReader() = default;
+        ~ThrowLogReader();
+
+        ThrowLogReader(const ThrowLogReader &) = delete;
+        ThrowLogReader &operator=(const ThrowLogReader &) = delete;
+
+        /// @brief Maps a log (a snapshot: records appended later aren't seen)
+        /// @return false if it can't be read or isn't a throw log (the reason is logged)
+        bool open(const string &path);
+        void close();
+
+        /// @brief Good records
+        size_t size() const { return count; }
+        const ThrowRecord &operator[](size_t index) const { return records[index]; }
+        const ThrowRecord *begin() const { return records; }
+        const ThrowRecord *end() const { return records + count; }
+
+        /// @brief Records after the good ones that are torn or incomplete (ignored)
+        size_t getTorn() const { return torn; }
+
+        /// @brief Checks every record's checksum, not just the last batch's
+        /// @return the number of good records before the first bad one
+        size_t verifyAll() const;
+
+    private:
+        void *mapping = nullptr;
+        size_t mappedBytes = 0;
+        const ThrowRecord *records = nullptr;
+        size_t count = 0;
+        size_t torn = 0;
+};
+
+#endif //GRAPHICS_THROWLOG_H
@@ -0,0 +1,572 @@
+#include "throwStore.h"
+#include "../util/log.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define COLUMNS_SSE2
+#include <emmintrin.h>
+#elif defined(__aarch64__)
+#define COLUMNS_NEON
+#include <arm_neon.h>
+#endif
+
+namespace fs = std::filesystem;
+
+// "DARTCOLS", version, then the rows and the player dictionary
+static const char MAGIC[8] = {'D', 'A', 'R', 'T', 'C', 'O', 'L', 'S'};
+static const uint32_t VERSION = 1;
+static const uint32_t DAY = 86400;
+// segments are stored as 0 to 21 on disk, the bull (25) being 21
+static const uint8_t BULL_CODE = 21;
+
+// the filter turned into what the kernels compare against
+struct Selection {
+    bool checkTime, checkPlayer, checkMultiplier, checkResult;
+    uint32_t from, to;
+    uint16_t player;
+    uint8_t multiplier, result;
+};
+
+// marks the rows of a chunk that pass the selection with 255, the rest with 0
+static void selectRows(const Selection &s, const uint32_t *times, const uint16_t *players, const uint8_t *multipliers,
+                       const uint8_t *results, uint8_t *mask, size_t n) {
+    size_t i = 0;
+#if defined(COLUMNS_SSE2)
+    // SSE2 only compares signed integers, flipping the top bit keeps unsigned times in order
+    const __m128i bias = _mm_set1_epi32(INT32_MIN);
+    const __m128i from = _mm_xor_si128(_mm_set1_epi32(static_cast<int>(s.from)), bias);
+    const __m128i to = _mm_xor_si128(_mm_set1_epi32(static_cast<int>(s.to)), bias);
+    const __m128i player = _mm_set1_epi16(static_cast<short>(s.player));
+    const __m128i multiplier = _mm_set1_epi8(static_cast<char>(s.multiplier));
+    const __m128i result = _mm_set1_epi8(static_cast<char>(s.result));
+    const __m128i all = _mm_set1_epi8(-1);
+    for (; i + 16 <= n; i += 16) {
+        __m128i selected = all;
+        if (s.checkTime) {
+            // from <= t < to for four times at a time, then the 32-bit answers packed down to bytes
+            __m128i in[4];
+            for (int k = 0; k < 4; ++k) {
+                __m128i t = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(times + i + 4 * k)), bias);
+                in[k] = _mm_andnot_si128(_mm_cmpgt_epi32(from, t), _mm_cmpgt_epi32(to, t));
+            }
+            selected = _mm_and_si128(selected, _mm_packs_epi16(_mm_packs_epi32(in[0], in[1]), _mm_packs_epi32(in[2], in[3])));
+        }
+        if (s.checkPlayer) {
+            __m128i low = _mm_cmpeq_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(players + i)), player);
+            __m128i high = _mm_cmpeq_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(players + i + 8)), player);
+            selected = _mm_and_si128(selected, _mm_packs_epi16(low, high));
+        }
+        if (s.checkMultiplier)
+            selected = _mm_and_si128(selected, _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(multipliers + i)), multiplier));
+        if (s.checkResult)
+            selected = _mm_and_si128(selected, _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(results + i)), result));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(mask + i), selected);
+    }
+#elif defined(COLUMNS_NEON)
+    const uint32x4_t from = vdupq_n_u32(s.from), to = vdupq_n_u32(s.to);
+    const uint16x8_t player = vdupq_n_u16(s.player);
+    const uint8x16_t multiplier = vdupq_n_u8(s.multiplier), result = vdupq_n_u8(s.result);
+    for (; i + 16 <= n; i += 16) {
+        uint8x16_t selected = vdupq_n_u8(255);
+        if (s.checkTime) {
+            uint16x4_t in[4];
+            for (int k = 0; k < 4; ++k) {
+                uint32x4_t t = vld1q_u32(times + i + 4 * k);
+                in[k] = vmovn_u32(vandq_u32(vcgeq_u32(t, from), vcltq_u32(t, to)));
+            }
+            selected = vandq_u8(selected, vcombine_u8(vmovn_u16(vcombine_u16(in[0], in[1])), vmovn_u16(vcombine_u16(in[2], in[3]))));
+        }
+        if (s.checkPlayer) {
+            uint8x8_t low = vmovn_u16(vceqq_u16(vld1q_u16(players + i), player));
+            uint8x8_t high = vmovn_u16(vceqq_u16(vld1q_u16(players + i + 8), player));
+            selected = vandq_u8(selected, vcombine_u8(low, high));
+        }
+        if (s.checkMultiplier)
+            selected = vandq_u8(selected, vceqq_u8(vld1q_u8(multipliers + i), multiplier));
+        if (s.checkResult)
+            selected = vandq_u8(selected, vceqq_u8(vld1q_u8(results + i), result));
+        vst1q_u8(mask + i, selected);
+    }
+#endif
+    for (; i < n; ++i) {
+        bool pass = (!s.checkTime || (times[i] >= s.from && times[i] < s.to))
+                    && (!s.checkPlayer || players[i] == s.player)
+                    && (!s.checkMultiplier || multipliers[i] == s.multiplier)
+                    && (!s.checkResult || results[i] == s.result);
+        mask[i] = pass ? 255 : 0;
+    }
+}
+
+// adds up the points and the number of the marked rows
+static void maskedSum(const uint8_t *points, const uint8_t *mask, size_t n, uint64_t &sum, uint64_t &count) {
+    size_t i = 0;
+#if defined(COLUMNS_SSE2)
+    // sums of absolute differences against zero add up the bytes of each half
+    const __m128i zero = _mm_setzero_si128(), ones = _mm_set1_epi8(1);
+    __m128i sums = zero, counts = zero;
+    for (; i + 16 <= n; i += 16) {
+        __m128i selected = _mm_loadu_si128(reinterpret_cast<const __m128i *>(mask + i));
+        __m128i value = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(points + i)), selected);
+        sums = _mm_add_epi64(sums, _mm_sad_epu8(value, zero));
+        counts = _mm_add_epi64(counts, _mm_sad_epu8(_mm_and_si128(selected, ones), zero));
+    }
+    sum += static_cast<uint64_t>(_mm_cvtsi128_si64(sums)) + static_cast<uint64_t>(_mm_cvtsi128_si64(_mm_unpackhi_epi64(sums, sums)));
+    count += static_cast<uint64_t>(_mm_cvtsi128_si64(counts)) + static_cast<uint64_t>(_mm_cvtsi128_si64(_mm_unpackhi_epi64(counts, counts)));
+#elif defined(COLUMNS_NEON)
+    // a chunk's points fit in 32 bits (CHUNK_ROWS * MAX_POINTS)
+    uint32x4_t sums = vdupq_n_u32(0), counts = vdupq_n_u32(0);
+    for (; i + 16 <= n; i += 16) {
+        uint8x16_t selected = vld1q_u8(mask + i);
+        sums = vpadalq_u16(sums, vpaddlq_u8(vandq_u8(vld1q_u8(points + i), selected)));
+        counts = vpadalq_u16(counts, vpaddlq_u8(vshrq_n_u8(selected, 7)));
+    }
+    sum += vaddvq_u32(sums);
+    count += vaddvq_u32(counts);
+#endif
+    for (; i < n; ++i) {
+        sum += points[i] & mask[i];
+        count += mask[i] & 1;
+    }
+}
+
+// maskedSum() of the marked rows whose key is key
+static void keyedSum(const uint8_t *points, const uint8_t *mask, const uint16_t *keys, uint16_t key, size_t n, uint64_t &sum, uint64_t &count) {
+    size_t i = 0;
+#if defined(COLUMNS_SSE2)
+    const __m128i zero = _mm_setzero_si128(), ones = _mm_set1_epi8(1), wanted = _mm_set1_epi16(static_cast<short>(key));
+    __m128i sums = zero, counts = zero;
+    for (; i + 16 <= n; i += 16) {
+        __m128i low = _mm_cmpeq_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(keys + i)), wanted);
+        __m128i high = _mm_cmpeq_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(keys + i + 8)), wanted);
+        __m128i selected = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(mask + i)), _mm_packs_epi16(low, high));
+        __m128i value = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(points + i)), selected);
+        sums = _mm_add_epi64(sums, _mm_sad_epu8(value, zero));
+        counts = _mm_add_epi64(counts, _mm_sad_epu8(_mm_and_si128(selected, ones), zero));
+    }
+    sum += static_cast<uint64_t>(_mm_cvtsi128_si64(sums)) + static_cast<uint64_t>(_mm_cvtsi128_si64(_mm_unpackhi_epi64(sums, sums)));
+    count += static_cast<uint64_t>(_mm_cvtsi128_si64(counts)) + static_cast<uint64_t>(_mm_cvtsi128_si64(_mm_unpackhi_epi64(counts, counts)));
+#elif defined(COLUMNS_NEON)
+    const uint16x8_t wanted = vdupq_n_u16(key);
+    uint32x4_t sums = vdupq_n_u32(0), counts = vdupq_n_u32(0);
+    for (; i + 16 <= n; i += 16) {
+        uint8x16_t match = vcombine_u8(vmovn_u16(vceqq_u16(vld1q_u16(keys + i), wanted)), vmovn_u16(vceqq_u16(vld1q_u16(keys + i + 8), wanted)));
+        uint8x16_t selected = vandq_u8(vld1q_u8(mask + i), match);
+        sums = vpadalq_u16(sums, vpaddlq_u8(vandq_u8(vld1q_u8(points + i), selected)));
+        counts = vpadalq_u16(counts, vpaddlq_u8(vshrq_n_u8(selected, 7)));
+    }
+    sum += vaddvq_u32(sums);
+    count += vaddvq_u32(counts);
+#endif
+    for (; i < n; ++i) {
+        uint8_t selected = keys[i] == key ? mask[i] : 0;
+        sum += points[i] & selected;
+        count += selected & 1;
+    }
+}
+
+// groups with more keys than this are added up in one pass over the rows instead of one per key
+static const size_t KEYED_GROUPS = 8;
+
+void ThrowStore::Sums::merge(const Sums &other) {
+    for (size_t k = 0; k < counts.size(); ++k) {
+        counts[k] += other.counts[k];
+        points[k] += other.points[k];
+    }
+}
+
+void ThrowStore::append(const ThrowRecord &record) {
+    if (record.result == rejected)
+        return;
+    auto code = codes.find(record.player);
+    if (code == codes.end()) {
+        code = codes.emplace(record.player, static_cast<uint16_t>(dictionary.size())).first;
+        dictionary.push_back(record.player);
+    }
+    uint64_t seconds = std::min<uint64_t>(record.time / 1000000000ull, UINT32_MAX);
+    appendRow(static_cast<uint32_t>(seconds), code->second, record.segment, record.multiplier, record.result);
+}
+
+void ThrowStore::append(const ThrowLogReader &log) {
+    reserve(size() + log.size());
+    for (const ThrowRecord &record : log)
+        append(record);
+}
+
+void ThrowStore::reserve(size_t rows) {
+    times.reserve(rows);
+    players.reserve(rows);
+    segments.reserve(rows);
+    multipliers.reserve(rows);
+    results.reserve(rows);
+    points.reserve(rows);
+    zones.reserve((rows + CHUNK_ROWS - 1) / CHUNK_ROWS);
+}
+
+void ThrowStore::appendRow(uint32_t time, uint16_t player, uint8_t segment, uint8_t multiplier, uint8_t result) {
+    if (times.size() % CHUNK_ROWS == 0)
+        zones.emplace_back();
+    Zone &zone = zones.back();
+    if (times.size() % CHUNK_ROWS != 0 && time < times.back())
+        zone.ordered = false;
+    zone.minTime = std::min(zone.minTime, time);
+    zone.maxTime = std::max(zone.maxTime, time);
+    times.push_back(time);
+    players.push_back(player);
+    segments.push_back(segment);
+    multipliers.push_back(multiplier);
+    results.push_back(result);
+    points.push_back(static_cast<uint8_t>(segment * multiplier));
+}
+
+ThrowStore::Sums ThrowStore::scanChunks(const ThrowFilter &filter, ThreadPool *pool, size_t keys, const ChunkScan &scan) const {
+    Sums total(keys);
+    Selection selection{};
+    selection.from = filter.from;
+    selection.to = filter.to;
+    selection.checkMultiplier = filter.multiplier != ThrowFilter::ANY;
+    selection.multiplier = static_cast<uint8_t>(filter.multiplier);
+    selection.checkResult = filter.result != ThrowFilter::ANY;
+    selection.result = static_cast<uint8_t>(filter.result);
+    selection.checkPlayer = filter.player != ThrowFilter::ANY;
+    if (selection.checkPlayer) {
+        auto code = codes.find(filter.player);
+        // a player who never threw matches nothing
+        if (code == codes.end())
+            return total;
+        selection.player = code->second;
+    }
+
+    std::mutex mutex;
+    auto scanRange = [&](size_t first, size_t last) {
+        Sums sums(keys);
+        vector<uint8_t> mask(CHUNK_ROWS);
+        for (size_t chunk = first; chunk < last; ++chunk) {
+            const Zone &zone = zones[chunk];
+            if (zone.maxTime < filter.from || zone.minTime >= filter.to)
+                continue;
+            // only the chunks the range cuts through need their times compared
+            Selection s = selection;
+            s.checkTime = zone.minTime < filter.from || zone.maxTime >= filter.to;
+            size_t begin = chunk * CHUNK_ROWS, rows = size() - begin < CHUNK_ROWS ? size() - begin : CHUNK_ROWS;
+            selectRows(s, times.data() + begin, players.data() + begin, multipliers.data() + begin, results.data() + begin, mask.data(), rows);
+            scan(sums, begin, mask.data(), rows);
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        total.merge(sums);
+    };
+    if (pool != nullptr)
+        pool->parallelFor(zones.size(), scanRange);
+    else
+        scanRange(0, zones.size());
+    return total;
+}
+
+vector<ThrowGroup> ThrowStore::aggregate(const ThrowFilter &filter, throwGroup group, ThreadPool *pool) const {
+    vector<ThrowGroup> groups;
+    if (empty())
+        return groups;
+
+    // every group is an index into the sums: the player code, the day since the first one, ...
+    uint32_t firstDay = UINT32_MAX, lastDay = 0;
+    for (const Zone &zone : zones) {
+        firstDay = std::min(firstDay, zone.minTime / DAY);
+        lastDay = std::max(lastDay, zone.maxTime / DAY);
+    }
+    size_t keys = 1;
+    switch (group) {
+        case byPlayer:     keys = dictionary.size(); break;
+        case byDay:        keys = lastDay - firstDay + 1; break;
+        case bySegment:    keys = 26; break;
+        case byMultiplier: keys = 4; break;
+        case byResult:     keys = 4; break;
+        default:           break;
+    }
+
+    ChunkScan scan;
+    switch (group) {
+        case byNothing:
+            scan = [this](Sums &sums, size_t begin, const uint8_t *mask, size_t rows) {
+                maskedSum(points.data() + begin, mask, rows, sums.points[0], sums.counts[0]);
+            };
+            break;
+        case byPlayer:
+            if (keys <= KEYED_GROUPS) {
+                // one vectorised pass per player
+                scan = [this, keys](Sums &sums, size_t begin, const uint8_t *mask, size_t rows) {
+                    for (size_t k = 0; k < keys; ++k)
+                        keyedSum(points.data() + begin, mask, players.data() + begin, static_cast<uint16_t>(k), rows, sums.points[k], sums.counts[k]);
+                };
+            }
+            else {
+                scan = [this](Sums &sums, size_t begin, const uint8_t *mask, size_t rows) {
+                    for (size_t i = 0; i < rows; ++i) {
+                        sums.points[players[begin + i]] += points[begin + i] & mask[i];
+                        sums.counts[players[begin + i]] += mask[i] & 1;
+                    }
+                };
+            }
+            break;
+        case byDay:
+            scan = [this, firstDay](Sums &sums, size_t begin, const uint8_t *mask, size_t rows) {
+                // times in order split into a run of rows per day
+                const Zone &zone = zones[begin / CHUNK_ROWS];
+                if (zone.ordered) {
+                    const uint32_t *chunkTimes = times.data() + begin;
+                    for (size_t row = 0; row < rows;) {
+                        uint32_t day = chunkTimes[row] / DAY;
+                        size_t end = static_cast<size_t>(std::lower_bound(chunkTimes + row, chunkTimes + rows, (day + 1ull) * DAY) - chunkTimes);
+                        maskedSum(points.data() + begin + row, mask + row, end - row, sums.points[day - firstDay], sums.counts[day - firstDay]);
+                        row = end;
+                    }
+                    return;
+                }
+                for (size_t i = 0; i < rows; ++i) {
+                    size_t day = times[begin + i] / DAY - firstDay;
+                    sums.points[day] += points[begin + i] & mask[i];
+                    sums.counts[day] += mask[i] & 1;
+                }
+            };
+            break;
+        default: {
+            // segments, multipliers and results are bytes with few values
+            const vector<uint8_t> &column = group == bySegment ? segments : group == byMultiplier ? multipliers : results;
+            scan = [this, &column](Sums &sums, size_t begin, const uint8_t *mask, size_t rows) {
+                for (size_t i = 0; i < rows; ++i) {
+                    sums.points[column[begin + i]] += points[begin + i] & mask[i];
+                    sums.counts[column[begin + i]] += mask[i] & 1;
+                }
+            };
+            break;
+        }
+    }
+
+    Sums sums = scanChunks(filter, pool, keys, scan);
+    for (size_t k = 0; k < keys; ++k) {
+        if (sums.counts[k] == 0)
+            continue;
+        ThrowGroup result;
+        result.count = sums.counts[k];
+        result.points = sums.points[k];
+        switch (group) {
+            case byPlayer: result.key = dictionary[k]; break;
+            case byDay:    result.key = firstDay + static_cast<uint32_t>(k); break;
+            case byNothing: break;
+            default:       result.key = static_cast<uint32_t>(k); break;
+        }
+        groups.push_back(result);
+    }
+    // player codes are in the order players were first seen
+    if (group == byPlayer)
+        std::sort(groups.begin(), groups.end(), [](const ThrowGroup &a, const ThrowGroup &b) { return a.key < b.key; });
+    return groups;
+}
+
+std::array<uint64_t, ThrowStore::MAX_POINTS + 1> ThrowStore::histogram(const ThrowFilter &filter, ThreadPool *pool) const {
+    std::array<uint64_t, MAX_POINTS + 1> counts{};
+    if (empty())
+        return counts;
+    Sums sums = scanChunks(filter, pool, MAX_POINTS + 1, [this](Sums &sums, size_t begin, const uint8_t *mask, size_t rows) {
+        for (size_t i = 0; i < rows; ++i)
+            sums.counts[points[begin + i]] += mask[i] & 1;
+    });
+    std::copy(sums.counts.begin(), sums.counts.end(), counts.begin());
+    return counts;
+}
+
+int ThrowStore::percentile(const ThrowFilter &filter, double percent, ThreadPool *pool) const {
+    // points only take MAX_POINTS + 1 values, so the histogram gives the exact answer
+    std::array<uint64_t, MAX_POINTS + 1> counts = histogram(filter, pool);
+    uint64_t total = 0;
+    for (uint64_t count : counts)
+        total += count;
+    if (total == 0)
+        return -1;
+    // the smallest score at least percent of the throws are at or below
+    double wanted = std::clamp(percent, 0.0, 100.0) / 100.0 * static_cast<double>(total);
+    uint64_t below = 0;
+    for (int score = 0; score <= MAX_POINTS; ++score) {
+        below += counts[score];
+        if (below > 0 && static_cast<double>(below) >= wanted)
+            return score;
+    }
+    return MAX_POINTS;
+}
+
+// columns on disk
+
+static void putVarint(vector<uint8_t> &out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+static bool getVarint(const vector<uint8_t> &in, size_t &at, uint64_t &value) {
+    value = 0;
+    for (int shift = 0; shift < 64 && at < in.size(); shift += 7) {
+        uint8_t byte = in[at++];
+        value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0)
+            return true;
+    }
+    return false;
+}
+
+// the values (each less than 2^bits) one after the other, bits bits each
+template<typename T, typename Code>
+static vector<uint8_t> packBits(const vector<T> &values, int bits, Code code) {
+    vector<uint8_t> out;
+    out.reserve((values.size() * bits + 7) / 8);
+    uint64_t buffer = 0;
+    int buffered = 0;
+    for (T value : values) {
+        buffer |= static_cast<uint64_t>(code(value)) << buffered;
+        buffered += bits;
+        while (buffered >= 8) {
+            out.push_back(static_cast<uint8_t>(buffer));
+            buffer >>= 8;
+            buffered -= 8;
+        }
+    }
+    if (buffered > 0)
+        out.push_back(static_cast<uint8_t>(buffer));
+    return out;
+}
+
+// the index-th value packed by packBits()
+static uint32_t unpackBits(const vector<uint8_t> &packed, size_t index, int bits) {
+    size_t bit = index * bits;
+    uint32_t value = 0;
+    for (int done = 0; done < bits;) {
+        size_t byte = (bit + done) / 8;
+        int offset = static_cast<int>((bit + done) % 8);
+        int take = std::min(8 - offset, bits - done);
+        value |= static_cast<uint32_t>((packed[byte] >> offset) & ((1u << take) - 1)) << done;
+        done += take;
+    }
+    return value;
+}
+
+static int bitsFor(size_t values) {
+    int bits = 1;
+    while ((size_t{1} << bits) < values)
+        bits++;
+    return bits;
+}
+
+static bool writeFile(const fs::path &path, const void *data, size_t bytes) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(static_cast<const char *>(data), static_cast<std::streamsize>(bytes));
+    if (!out.flush()) {
+        LOG_ERROR("STORE", "Could not write {}", path.string());
+        return false;
+    }
+    return true;
+}
+
+static bool readFile(const fs::path &path, vector<uint8_t> &data) {
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in) {
+        LOG_ERROR("STORE", "Could not open {}", path.string());
+        return false;
+    }
+    data.resize(static_cast<size_t>(in.tellg()));
+    in.seekg(0);
+    in.read(reinterpret_cast<char *>(data.data()), static_cast<std::streamsize>(data.size()));
+    return static_cast<bool>(in);
+}
+
+bool ThrowStore::save(const string &directory) const {
+    std::error_code error;
+    fs::create_directories(directory, error);
+    fs::path dir(directory);
+
+    vector<uint8_t> meta(MAGIC, MAGIC + sizeof(MAGIC));
+    putVarint(meta, VERSION);
+    putVarint(meta, size());
+    putVarint(meta, dictionary.size());
+    for (uint32_t id : dictionary)
+        putVarint(meta, id);
+
+    // times mostly go up a few seconds a throw, so their differences take a byte each
+    vector<uint8_t> timeColumn;
+    timeColumn.reserve(size() + 8);
+    int64_t previous = 0;
+    for (uint32_t time : times) {
+        int64_t delta = static_cast<int64_t>(time) - previous;
+        putVarint(timeColumn, static_cast<uint64_t>(delta < 0 ? ~(delta << 1) : delta << 1));
+        previous = time;
+    }
+    auto same = [](auto value) { return static_cast<uint32_t>(value); };
+    auto segmentCode = [](uint8_t segment) { return static_cast<uint32_t>(segment == 25 ? BULL_CODE : segment); };
+
+    return writeFile(dir / "meta", meta.data(), meta.size())
+           && writeFile(dir / "times.col", timeColumn.data(), timeColumn.size())
+           && [&] { vector<uint8_t> c = packBits(players, bitsFor(dictionary.size()), same); return writeFile(dir / "players.col", c.data(), c.size()); }()
+           && [&] { vector<uint8_t> c = packBits(segments, 5, segmentCode); return writeFile(dir / "segments.col", c.data(), c.size()); }()
+           && [&] { vector<uint8_t> c = packBits(multipliers, 2, same); return writeFile(dir / "multipliers.col", c.data(), c.size()); }()
+           && [&] { vector<uint8_t> c = packBits(results, 2, same); return writeFile(dir / "results.col", c.data(), c.size()); }();
+}
+
+bool ThrowStore::load(const string &directory) {
+    fs::path dir(directory);
+    vector<uint8_t> meta, timeColumn, playerColumn, segmentColumn, multiplierColumn, resultColumn;
+    if (!readFile(dir / "meta", meta) || !readFile(dir / "times.col", timeColumn) || !readFile(dir / "players.col", playerColumn)
+        || !readFile(dir / "segments.col", segmentColumn) || !readFile(dir / "multipliers.col", multiplierColumn)
+        || !readFile(dir / "results.col", resultColumn))
+        return false;
+
+    size_t at = sizeof(MAGIC);
+    uint64_t version = 0, rows = 0, playerCount = 0;
+    if (meta.size() < sizeof(MAGIC) || std::memcmp(meta.data(), MAGIC, sizeof(MAGIC)) != 0
+        || !getVarint(meta, at, version) || version != VERSION || !getVarint(meta, at, rows) || !getVarint(meta, at, playerCount)
+        || playerCount > UINT16_MAX + 1ull) {
+        LOG_ERROR("STORE", "{} isn't a throw store (or a different version of one)", directory);
+        return false;
+    }
+    ThrowStore loaded;
+    for (uint64_t code = 0, id; code < playerCount; ++code) {
+        if (!getVarint(meta, at, id)) {
+            LOG_ERROR("STORE", "{}: the player dictionary is cut short", directory);
+            return false;
+        }
+        loaded.codes.emplace(static_cast<uint32_t>(id), static_cast<uint16_t>(code));
+        loaded.dictionary.push_back(static_cast<uint32_t>(id));
+    }
+    int playerBits = bitsFor(loaded.dictionary.size());
+    auto packedBytes = [rows](int bits) { return static_cast<size_t>((rows * bits + 7) / 8); };
+    if (playerColumn.size() < packedBytes(playerBits) || segmentColumn.size() < packedBytes(5)
+        || multiplierColumn.size() < packedBytes(2) || resultColumn.size() < packedBytes(2)) {
+        LOG_ERROR("STORE", "{}: a column is shorter than its {} rows", directory, rows);
+        return false;
+    }
+
+    loaded.reserve(static_cast<size_t>(rows));
+    size_t timeAt = 0;
+    int64_t time = 0;
+    for (size_t row = 0; row < rows; ++row) {
+        uint64_t zigzag;
+        if (!getVarint(timeColumn, timeAt, zigzag)) {
+            LOG_ERROR("STORE", "{}: the times column is cut short at row {}", directory, row);
+            return false;
+        }
+        time += static_cast<int64_t>(zigzag >> 1) ^ -static_cast<int64_t>(zigzag & 1);
+        uint32_t segment = unpackBits(segmentColumn, row, 5);
+        uint32_t player = unpackBits(playerColumn, row, playerBits);
+        if (player >= loaded.dictionary.size()) {
+            LOG_ERROR("STORE", "{}: row {} has a player that isn't in the dictionary", directory, row);
+            return false;
+        }
+        loaded.appendRow(static_cast<uint32_t>(time), static_cast<uint16_t>(player), static_cast<uint8_t>(segment == BULL_CODE ? 25 : segment),
+                         static_cast<uint8_t>(unpackBits(multiplierColumn, row, 2)), static_cast<uint8_t>(unpackBits(resultColumn, row, 2)));
+    }
+    *this = std::move(loaded);
+    LOG_INFO("STORE", "Loaded {} throws of {} players from {}", size(), dictionary.size(), directory);
+    return true;
+}
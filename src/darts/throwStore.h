@@ -0,0 +1,135 @@
+#ifndef GRAPHICS_THROWSTORE_H
+#define GRAPHICS_THROWSTORE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "throwLog.h"
+#include "../util/threadPool.h"
+
+using std::string, std::vector;
+
+/// @brief Which throws a query looks at (every field left at its default matches everything)
+struct ThrowFilter {
+    static const uint32_t ANY = UINT32_MAX;
+
+    uint32_t player = ANY;
+    /// @brief Thrown in [from, to), seconds since the Unix epoch
+    uint32_t from = 0;
+    uint32_t to = UINT32_MAX;
+    /// @brief A throwResult, or ANY
+    uint32_t result = ANY;
+    /// @brief 0 (a miss) to 3, or ANY
+    uint32_t multiplier = ANY;
+};
+
+/// @brief What a query's throws are grouped by
+enum throwGroup {byNothing, byPlayer, byDay, bySegment, byMultiplier, byResult};
+
+/// @brief The points of a group of throws
+struct ThrowGroup {
+    /// @brief The player, day (since the epoch), segment, multiplier or result (0 for byNothing)
+    uint32_t key = 0;
+    uint64_t count = 0;
+    uint64_t points = 0;
+
+    double average() const { return count > 0 ? static_cast<double>(points) / count : 0.0; }
+};
+
+/**
+ * @brief Throws stored column by column, for queries over years of them.
+ * @details Every column is a plain array, so a query only reads the columns it needs and scans them
+ *          16 rows at a time with SSE2 (x86-64) or NEON (AArch64), like the vision kernels. The rows
+ *          are split into chunks of CHUNK_ROWS that know their first and last time, so a date filter
+ *          skips whole chunks, and a ThreadPool scans the chunks in parallel.
+ *
+ *          Player IDs are dictionary encoded (the players column holds 16-bit codes). Times are kept
+ *          to the second. On disk (save()) every column is its own file: times as delta encoded
+ *          varints, and players, segments, multipliers and results bit packed, which is about 2.5
+ *          bytes a throw.
+ *
+ *          The throw log doesn't know what game was played, so there is no filter for it.
+ *
+ * Usage:
+ * @code
+ * ThrowStore store;
+ * store.append(reader);                        // a ThrowLogReader
+ * ThrowFilter filter;
+ * filter.from = lastYear;
+ * for (const ThrowGroup &group : store.aggregate(filter, byPlayer, &pool))
+ *     printf("P%u: %.1f\n", group.key + 1, 3 * group.average());
+ * @endcode
+ */
+class ThrowStore {
+    public:
+        static const size_t CHUNK_ROWS = 65536;
+        /// @brief Points a dart can score are 0 to MAX_POINTS
+        static const int MAX_POINTS = 60;
+
+        /// @brief Adds a throw (rejected ones are skipped)
+        void append(const ThrowRecord &record);
+        /// @brief Adds every throw of a log
+        void append(const ThrowLogReader &log);
+        /// @brief Makes room for rows throws in every column
+        void reserve(size_t rows);
+        size_t size() const { return times.size(); }
+        bool empty() const { return times.empty(); }
+
+        /// @brief Sums the points of the throws that pass the filter, per group
+        /// @param pool scans the chunks in parallel if given (call from outside the pool)
+        /// @return the groups that have throws, by key
+        vector<ThrowGroup> aggregate(const ThrowFilter &filter, throwGroup group = byNothing, ThreadPool *pool = nullptr) const;
+        /// @brief How many of the throws that pass the filter scored 0, 1, ... MAX_POINTS
+        std::array<uint64_t, MAX_POINTS + 1> histogram(const ThrowFilter &filter, ThreadPool *pool = nullptr) const;
+        /// @brief The points that percent percent of the throws that pass the filter scored at most
+        /// @return -1 if no throw does
+        int percentile(const ThrowFilter &filter, double percent, ThreadPool *pool = nullptr) const;
+
+        /// @brief Writes every column to its own file in directory (created if needed)
+        bool save(const string &directory) const;
+        /// @brief Replaces the store with one saved in directory
+        /// @return false (and nothing changes) if it can't be read (the reason is logged)
+        bool load(const string &directory);
+
+    private:
+        /// @brief The first and last time in a chunk
+        struct Zone {
+            uint32_t minTime = UINT32_MAX;
+            uint32_t maxTime = 0;
+            /// @brief True if its times never go back (they're in the order they were thrown)
+            bool ordered = true;
+        };
+
+        vector<uint32_t> times;
+        vector<uint16_t> players;
+        vector<uint8_t> segments, multipliers, results;
+        /// @brief segment * multiplier, so no query has to work it out
+        vector<uint8_t> points;
+        vector<Zone> zones;
+
+        /// @brief Player ID of every code, and the code of every ID
+        vector<uint32_t> dictionary;
+        std::unordered_map<uint32_t, uint16_t> codes;
+
+        /// @brief Counts and points per key, what every scan adds up
+        struct Sums {
+            vector<uint64_t> counts, points;
+
+            explicit Sums(size_t keys) : counts(keys, 0), points(keys, 0) {}
+            void merge(const Sums &other);
+        };
+        /// @brief Adds up the rows of a chunk: scan(sums, first row, mask, rows)
+        /// @details mask marks the rows that pass the filter with 255 (the others are 0).
+        typedef std::function<void(Sums &, size_t, const uint8_t *, size_t)> ChunkScan;
+
+        /// @brief Adds a row that is already encoded
+        void appendRow(uint32_t time, uint16_t player, uint8_t segment, uint8_t multiplier, uint8_t result);
+        /// @brief Runs scan on every chunk that can have throws passing the filter, into sums of keys keys
+        Sums scanChunks(const ThrowFilter &filter, ThreadPool *pool, size_t keys, const ChunkScan &scan) const;
+};
+
+#endif //GRAPHICS_THROWSTORE_H
@@ -0,0 +1,49 @@
+#include "x01.h"
+#include <algorithm>
+
+bool Dart::valid() const {
+    if (segment == 0)
+        return multiplier <= 1; // a miss
+    if (segment == 25)
+        return multiplier == 1 || multiplier == 2; // outer bull (25) and bull (50)
+    return segment <= 20 && multiplier >= 1 && multiplier <= 3;
+}
+
+X01Game::X01Game(int players, int startScore, bool doubleOut)
+    : players(std::clamp(players, 1, MAX_PLAYERS)), startScore(startScore), doubleOut(doubleOut) {
+    remaining.fill(startScore);
+    visitStart = startScore;
+}
+
+throwResult X01Game::submit(int player, Dart dart) {
+    if (isOver() || player != current || !dart.valid())
+        return rejected;
+
+    dartsThrown[player]++;
+    dartsInVisit++;
+    int left = remaining[player] - dart.points();
+
+    // can't go below zero, and on double-out can't be left on one or finish without a double
+    bool busted = left < 0 || (doubleOut && (left == 1 || (left == 0 && !dart.isDouble())));
+    if (busted) {
+        remaining[player] = visitStart;
+        nextVisit();
+        return bust;
+    }
+
+    remaining[player] = left;
+    if (left == 0) {
+        winner = player;
+        return checkout;
+    }
+
+    if (dartsInVisit == DARTS_PER_VISIT)
+        nextVisit();
+    return accepted;
+}
+
+void X01Game::nextVisit() {
+    current = (current + 1) % players;
+    dartsInVisit = 0;
+    visitStart = remaining[current];
+}
@@ -0,0 +1,78 @@
+#ifndef GRAPHICS_X01_H
+#define GRAPHICS_X01_H
+
+#include <array>
+#include <cstdint>
+
+/// @brief Where a single dart landed
+struct Dart {
+    /// @brief 1 to 20, 25 for the bull, 0 for a miss
+    uint8_t segment = 0;
+    /// @brief 1 = single, 2 = double, 3 = triple (0 for a miss)
+    uint8_t multiplier = 0;
+
+    /// @brief Returns true if the dart is a real spot on the board (e.g. there is no triple bull)
+    bool valid() const;
+    /// @brief The points the dart scores
+    int points() const { return segment * multiplier; }
+    /// @brief Doubles (and the bull) are the only darts that can finish a double-out leg
+    bool isDouble() const { return multiplier == 2; }
+};
+
+/// @brief What happened to a submitted dart
+enum throwResult {accepted, bust, checkout, rejected};
+
+/**
+ * @brief The rules of one leg of an X01 game (301, 501, ...).
+ * @details Every player starts on startScore and players take turns throwing visits of up to three
+ *          darts, counting down. Going below zero (or to one, or finishing on anything but a double
+ *          when playing double-out) is a bust: the score goes back to what it was at the start of
+ *          the visit and the turn passes. The first player to reach exactly zero wins the leg.
+ */
+class X01Game {
+    public:
+        static const int MAX_PLAYERS = 8;
+        static const int DARTS_PER_VISIT = 3;
+
+        /// @brief Starts a new leg
+        /// @param players Number of players (1 to MAX_PLAYERS)
+        /// @param startScore The score everyone counts down from
+        /// @param doubleOut If true the last dart has to be a double
+        X01Game(int players = 2, int startScore = 501, bool doubleOut = true);
+
+        /// @brief Scores a dart thrown by player
+        /// @return rejected (and nothing changes) if it's not player's turn, the dart isn't valid or the leg is over
+        throwResult submit(int player, Dart dart);
+
+        int getPlayers() const { return players; }
+        int getStartScore() const { return startScore; }
+        bool isDoubleOut() const { return doubleOut; }
+        /// @brief The score player still has to get
+        int getRemaining(int player) const { return remaining[player]; }
+        /// @brief Number of darts player has thrown this leg
+        int getDartsThrown(int player) const { return dartsThrown[player]; }
+        /// @brief Whose turn it is
+        int getCurrentPlayer() const { return current; }
+        /// @brief Darts the current player has thrown this visit
+        int getDartsInVisit() const { return dartsInVisit; }
+        /// @brief The player that won the leg, or -1 if it isn't over
+        int getWinner() const { return winner; }
+        bool isOver() const { return winner >= 0; }
+
+    private:
+        int players;
+        int startScore;
+        bool doubleOut;
+        std::array<int, MAX_PLAYERS> remaining{};
+        std::array<int, MAX_PLAYERS> dartsThrown{};
+        int current = 0;
+        int dartsInVisit = 0;
+        /// @brief The current player's score when their visit started (restored on a bust)
+        int visitStart = 0;
+        int winner = -1;
+
+        /// @brief Passes the turn to the next player
+        void nextVisit();
+};
+
+#endif //GRAPHICS_X01_H
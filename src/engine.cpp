@@ -1,13 +1,30 @@
 #include "engine.h"
-#include <iostream>
-
-enum state {start, play, over};
-state screen;
+#include "util/resources.h"
+#include "gl/glState.h"
+#include "gl/gpuResource.h"
+#include "gl/glDebug.h"
+#include "util/log.h"
+#include "util/allocationCounter.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <iterator>
+
+// how long a pressed light flashes white for (seconds)
+static const double FLASH_TIME = 0.15;
+// bytes of dynamic vertex data each frame can stream
+static const GLsizeiptr STREAM_REGION_SIZE = 1 << 22;
 
 // global color setting
 color offFill, onFill, hoverOff, hoverOn;
 
-Engine::Engine() : keys() {
+// how much one notch of the scroll wheel zooms
+static const float ZOOM_STEP = 1.1f;
+// how fast the arrow keys pan (screen pixels per second)
+static const float PAN_SPEED = 600.0f;
+
+Engine::Engine(int cols, int rows, const std::string &snapshot) : keys(), boardCols(cols), boardRows(rows), snapshotPath(snapshot) {
     offFill.vec = {0.5, 0.5, 0.5, 1};   // grey
     onFill.vec = {1, 1, 0, 1};          // yellow
     hoverOff.vec = {0, 0, 0, 1};        // unaffected
@@ -18,7 +35,38 @@ Engine::Engine() : keys() {
     this->initShapes();
 }
 
-Engine::~Engine() {}
+Engine::~Engine() {
+    // the simulation thread has to be stopped before the rest of the engine goes away
+    if (simulation)
+        simulation->stop();
+    // the game as it is now, so the next start carries on from here
+    if (snapshotWriter.isOpen()) {
+        snapshotWriter.submit(current, matchPanel.save(GameClock::steadyNow()));
+        snapshotWriter.close();
+    }
+
+    // GL objects are deleted by their owners, which needs the context, so they go before the window does
+    heatmapRenderer.reset();
+    chartRenderer.reset();
+    boardRenderer.reset();
+    sceneRenderer.reset();
+    frameUniforms.reset();
+    fontRenderer.reset();
+    streamBuffer.reset();
+    shaderManager.reset();
+    pacer.release();
+    for (int type = 0; type < GPU_RESOURCE_TYPES; ++type) {
+        if (GpuMemory::getCount(static_cast<gpuResourceType>(type)) != 0) {
+            char leaked[96];
+            GpuMemory::summary(leaked, sizeof(leaked));
+            LOG_ERROR("ENGINE", "GL objects leaked: {}", leaked);
+            break;
+        }
+    }
+
+    glfwDestroyWindow(window);
+    glfwTerminate();
+}
 
 // initialize the actual window using GLFW
 unsigned int Engine::initWindow(bool debug) {
@@ -36,14 +84,18 @@ unsigned int Engine::initWindow(bool debug) {
     glfwWindowHint(GLFW_COCOA_RETINA_FRAMEBUFFER, GLFW_FALSE);
 #endif
 
-    // prevents the window from being resized
-    glfwWindowHint(GLFW_RESIZABLE, false);
+    // the window can be resized, the camera keeps the board in view
+    glfwWindowHint(GLFW_RESIZABLE, true);
+#if DARTS_GL_DEBUG
+    // drivers report more (and more reliably) to a debug context, see GLDebug
+    glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GLFW_TRUE);
+#endif
 
     // This creates the window using GLFW.
     // It's a C function, so we have to pass it a pointer to the window variable.
     window = glfwCreateWindow(width, height, "Lights Out", nullptr, nullptr);
     if (window == nullptr) {
-        cout << "Failed to create GLFW window" << endl;
+        LOG_ERROR("ENGINE", "Failed to create GLFW window");
         glfwTerminate();
         return -1;
     }
@@ -51,6 +103,13 @@ unsigned int Engine::initWindow(bool debug) {
     // This sets the OpenGL context to the window we just created.
     glfwMakeContextCurrent(window);
 
+    // the scroll wheel zooms, the callback finds the engine through the window
+    glfwSetWindowUserPointer(window, this);
+    glfwSetScrollCallback(window, scrollCallback);
+    glfwSetCharCallback(window, charCallback);
+    glfwSetMouseButtonCallback(window, mouseButtonCallback);
+    glfwSetKeyCallback(window, keyCallback);
+
     // Glad is an OpenGL function loader.
     // It loads all the OpenGL functions that are defined by the driver.
     // This is required because OpenGL is a specification,
@@ -58,18 +117,28 @@ unsigned int Engine::initWindow(bool debug) {
     // The driver is the implementation of OpenGL
     //      that is installed on your computer.
     if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
-        cout << "Failed to initialize GLAD" << endl;
+        LOG_ERROR("ENGINE", "Failed to initialize GLAD");
         return -1;
     }
+    // GL errors go to the log from here on (debug builds only)
+    GLDebug::install();
 
     // OpenGL configuration
     // This defines the size of the area OpenGL should render to.
-    glViewport(0, 0, width, height);
+    // (updateWindowSize() changes it when the window is resized)
+    int framebufferWidth, framebufferHeight;
+    glfwGetFramebufferSize(window, &framebufferWidth, &framebufferHeight);
+    glViewport(0, 0, framebufferWidth, framebufferHeight);
     // This enables depth testing which prevents triangles from overlapping.
-    glEnable(GL_BLEND);
+    GLState::setBlend(true);
     // Alpha blending allows for transparent backgrounds.
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    glfwSwapInterval(1);
+    GLState::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    // vsync until told otherwise, low latency mode paces itself to the display's refresh rate
+    const GLFWvidmode *videoMode = glfwGetVideoMode(glfwGetPrimaryMonitor());
+    if (videoMode != nullptr && videoMode->refreshRate > 0)
+        pacer.setRefreshRate(videoMode->refreshRate);
+    pacer.setMode(vsync, noThrottle);
 
     return 0;
 }
@@ -81,265 +150,739 @@ void Engine::initShaders() {
     // manager will load and store your shaders,
     //      so you can access them by name
     shaderManager = make_unique<ShaderManager>();
+    // reuse the programs the driver linked on a previous run instead of compiling them again
+    shaderManager->enableCache(ShaderCache::defaultDirectory());
+
+    // Shaders and fonts are compiled into the executable (see util/resources.h),
+    // so this doesn't depend on the working directory or touch the disk.
+    Resource shapeVert = Resource::load("shaders/shape.vert");
+    Resource shapeFrag = Resource::load("shaders/shape.frag");
+    Resource textVert = Resource::load("shaders/text.vert");
+    Resource textFrag = Resource::load("shaders/text.frag");
+    Resource boardVert = Resource::load("shaders/board.vert");
+    Resource boardFrag = Resource::load("shaders/board.frag");
+    Resource chartVert = Resource::load("shaders/chart.vert");
+    Resource chartFrag = Resource::load("shaders/chart.frag");
+    Resource splatVert = Resource::load("shaders/splat.vert");
+    Resource splatFrag = Resource::load("shaders/splat.frag");
+    Resource heatmapVert = Resource::load("shaders/heatmap.vert");
+    Resource heatmapFrag = Resource::load("shaders/heatmap.frag");
+    Resource font = Resource::load("fonts/MxPlus_IBM_BIOS.ttf");
 
     // Load shader into shader manager and retrieve it
     // loads a shader for drawing shapes
         // uses a vertex shader called shape.vert
         //      a fragment shader called shape.frag
     // 'shape' lets you look it up later
-    shapeShader = this->shaderManager->loadShader("../res/shaders/shape.vert",
-                                                  "../res/shaders/shape.frag",
-                                                  nullptr, "shape");
+    Shader &shapeShader = this->shaderManager->loadShaderFromMemory(shapeVert.c_str(), shapeFrag.c_str(), nullptr, "shape");
 
     // loads a shader for rendering text
-    textShader = shaderManager->loadShader("../res/shaders/text.vert", "../res/shaders/text.frag", nullptr, "text");
+    Shader &textShader = shaderManager->loadShaderFromMemory(textVert.c_str(), textFrag.c_str(), nullptr, "text");
+    // loads a shader for drawing a far zoomed out board as one texture
+    Shader &boardShader = shaderManager->loadShaderFromMemory(boardVert.c_str(), boardFrag.c_str(), nullptr, "board");
+    // loads a shader for chart lines and scatter points
+    Shader &chartShader = shaderManager->loadShaderFromMemory(chartVert.c_str(), chartFrag.c_str(), nullptr, "chart");
+    // loads shaders for adding darts to the heatmap and colouring it in
+    Shader &splatShader = shaderManager->loadShaderFromMemory(splatVert.c_str(), splatFrag.c_str(), nullptr, "splat");
+    Shader &heatmapShader = shaderManager->loadShaderFromMemory(heatmapVert.c_str(), heatmapFrag.c_str(), nullptr, "heatmap");
+    // dynamic geometry (text, overlays) is streamed through one buffer with a region per frame in flight
+    streamBuffer = make_unique<StreamBuffer>(STREAM_REGION_SIZE);
     // to draw text on screen
-    fontRenderer = make_unique<FontRenderer>(shaderManager->getShader("text"), "../res/fonts/MxPlus_IBM_BIOS.ttf", 24);
-
-    // Set uniforms that never change
-    textShader.setVector2f("vertex", vec4(100, 100, .5, .5));
-
-    // tells OpenG to use the shape shader
-    shapeShader.use();
-    shapeShader.use().setMatrix4("projection", this->PROJECTION);
+    fontRenderer = make_unique<FontRenderer>(textShader, *streamBuffer, font.data(), font.size(), 24);
+
+    // The projection (and the rest of the per-frame constants) lives in one uniform buffer
+    // that every shader reads from, see updateFrameUniforms()
+    frameUniforms = make_unique<FrameUniforms>();
+
+    // every shape in the scene is drawn from the same few unit meshes with instancing
+    sceneRenderer = make_unique<SceneRenderer>(shapeShader, *streamBuffer);
+    // the board's lights are drawn straight from the bitboard, only the part on screen
+    boardRenderer = make_unique<BoardRenderer>(*sceneRenderer, boardShader, *streamBuffer);
+    // charts keep their series on the GPU, uploaded once when they're opened
+    chartRenderer = make_unique<ChartRenderer>(chartShader);
+    std::fill(std::begin(legSeries), std::end(legSeries), -1);
+    // darts are splatted into a texture once, drawing the heatmap is one quad
+    heatmapRenderer = make_unique<HeatmapRenderer>(splatShader, heatmapShader);
 }
 
 void Engine::initShapes() {
 //TODO change this for making the dart board
-    int Xoffset = 100;
-    int Yoffset = 100;
-    // initialize 25 "off" squares
-    for (int j = 0; j < 5; ++j) {
-        for (int i = 0; i < 5; ++i) {
-            hoverShapes.push_back(make_unique<Rect>(shapeShader, vec2(Xoffset, Yoffset), vec2(110,110), hoverOff));
-            shapes.push_back(make_unique<Rect>(shapeShader, vec2(Xoffset, Yoffset), vec2(100,100), onFill));
-            Yoffset += 125; // evenly space the squares
-        }
-        Yoffset = 100; // reset Yoffset so next col starts in same spot
-        Xoffset += 125; // increment Xoffset to add another column
-    }
-
-    // default all start as "off"
-    for (const unique_ptr<Shape>& s : shapes) {
-        s->isOn = true;
-    }
-    // randomize start configuration
-    // have the program toggle a random 10 buttons to start the game
-    for (int i = 0; i < 10; i++) {
-        // random button to toggle
-        int randButtonIndex = rand() % 25;
-        shapes[randButtonIndex]->toggle(offFill, onFill); // toggle button
-        // toggle button above
-        if (i!= 4 && i!= 9 && i!= 14 && i!= 19) {
-            if (i + 1 < shapes.size()) { shapes[i + 1]->toggle(offFill, onFill); }
-        }
-        // toggle button below
-        if (i!= 5 && i!= 10 && i!= 15 && i!= 20) {
-            if (i - 1 < shapes.size()) { shapes[i - 1]->toggle(offFill, onFill); }
-        }
-        // toggle button to the left
-        if (i - 5 < shapes.size()) { shapes[i - 5]->toggle(offFill, onFill); }
-        // toggle button to the right
-        if (i + 5 < shapes.size()) { shapes[i + 5]->toggle(offFill, onFill); }
-    }
+    // The simulation owns the actual lights, the board renderer draws them from its snapshots.
+    // Cells are laid out row by row from the bottom left, 125 apart.
+    // If the last session saved itself (e.g. the kiosk restarted mid-game), it carries on from there
+    GameState resumed;
+    if (resumeSession(resumed))
+        simulation = make_unique<Simulation>(resumed);
+    else
+        simulation = make_unique<Simulation>(boardCols, boardRows);
+    current = previous = simulation->snapshots().front();
+    savedChanges = current.changes;
+    if (!snapshotPath.empty())
+        snapshotWriter.open(snapshotPath, SessionSnapshot::bytesFor(boardCols, boardRows));
+
+    layout.cols = boardCols;
+    layout.rows = boardRows;
+
+    // The hover outline is the only shape left in the scene. It's drawn before the board,
+    // so the light it surrounds is on top of it.
+    hoverOutline = make_unique<Rect>(scene, layout.origin, vec2(110, 110), hoverOn);
+    hoverOutline->setPickable(false);
+    hoverOutline->setVisible(false);
+
+    resetCamera();
+    simulation->start();
 }
 
 void Engine::processInput() {
+    allocationsAtFrameStart = AllocationCounter::getCount();
+
+    // in low latency mode this sleeps until just before the frame is due, so the input is fresh
+    pacer.waitForFrame();
     glfwPollEvents();
 
     // Set keys to true if pressed, false if released
     for (int key = 0; key < 1024; ++key) {
+        bool was = keys[key];
         if (glfwGetKey(window, key) == GLFW_PRESS)
             keys[key] = true;
         else if (glfwGetKey(window, key) == GLFW_RELEASE)
             keys[key] = false;
+        if (keys[key] != was)
+            frameEvent = true;
     }
 
     // Close window if escape key is pressed
     if (keys[GLFW_KEY_ESCAPE])
         glfwSetWindowShouldClose(window, true);
 
+    // Toggle the stats overlay when F1 is pressed
+    if (keys[GLFW_KEY_F1] && !statsKeyLastFrame)
+        showStats = !showStats;
+    statsKeyLastFrame = keys[GLFW_KEY_F1];
+
+    // F3 switches between vsync and low latency presentation, F4 goes through the throttle modes
+    if (keys[GLFW_KEY_F3] && !presentKeyLastFrame)
+        setPresentation(pacer.getMode() == vsync ? lowLatency : vsync, pacer.getThrottle());
+    presentKeyLastFrame = keys[GLFW_KEY_F3];
+    if (keys[GLFW_KEY_F4] && !throttleKeyLastFrame)
+        setPresentation(pacer.getMode(), static_cast<throttleMode>((pacer.getThrottle() + 1) % 3));
+    throttleKeyLastFrame = keys[GLFW_KEY_F4];
+
+    // F5 logs the live GL objects and how much memory they hold
+    if (keys[GLFW_KEY_F5] && !memoryKeyLastFrame) {
+        string report = GpuMemory::report();
+        for (size_t start = 0, end; (end = report.find('\n', start)) != string::npos; start = end + 1)
+            LOG_INFO("GPU", "{}", std::string_view(report).substr(start, end - start));
+    }
+    memoryKeyLastFrame = keys[GLFW_KEY_F5];
+
+    // Toggle the match panel with F2, then enter sends the typed dart and backspace erases
+    if (keys[GLFW_KEY_F2] && !matchKeyLastFrame && matchPanel.isConnected())
+        showMatch = !showMatch;
+    matchKeyLastFrame = keys[GLFW_KEY_F2];
+    if (showMatch) {
+        if (keys[GLFW_KEY_ENTER] && !enterLastFrame)
+            matchPanel.submit();
+        if (keys[GLFW_KEY_BACKSPACE] && !backspaceLastFrame)
+            matchPanel.erase();
+    }
+    enterLastFrame = keys[GLFW_KEY_ENTER];
+    // F6 shows every player's statistics from the scored darts
+    if (keys[GLFW_KEY_F6] && !playerStatsKeyLastFrame)
+        showPlayerStats = !showPlayerStats;
+    playerStatsKeyLastFrame = keys[GLFW_KEY_F6];
+    // F7 shows the charts of the throw log, read again every time they're opened
+    if (keys[GLFW_KEY_F7] && !chartsKeyLastFrame) {
+        showCharts = !showCharts;
+        if (showCharts)
+            loadCharts();
+        else
+            chartRenderer->clear();
+    }
+    chartsKeyLastFrame = keys[GLFW_KEY_F7];
+    // F8 shows a heatmap of where a player's darts landed, the next player who threw on every press (then none)
+    if (keys[GLFW_KEY_F8] && !heatmapKeyLastFrame) {
+        do
+            heatmapPlayer = heatmapPlayer + 1 < X01Game::MAX_PLAYERS ? heatmapPlayer + 1 : -1;
+        while (heatmapPlayer >= 0 && matchPanel.getStats().getPlayer(heatmapPlayer).getAllTime().darts == 0);
+        loadHeatmap();
+    }
+    heatmapKeyLastFrame = keys[GLFW_KEY_F8];
+    backspaceLastFrame = keys[GLFW_KEY_BACKSPACE];
+    // pick up the server's answers without waiting for them
+    if (matchPanel.update())
+        frameEvent = true;
+    // a dart scored goes onto the heatmap by itself, the ones already there aren't splatted again
+    if (heatmapScored != matchPanel.getScoredCount()) {
+        heatmapScored = matchPanel.getScoredCount();
+        const ThrowRecord &scored = matchPanel.getLastScored();
+        if (scored.player == heatmapPlayer && scored.hasPosition())
+            heatmapRenderer->add(HeatPoint{scored.x, scored.y});
+    }
+    // darts found by the camera are scored one at a time, each once the last one was answered
+    if (!haveDetectedDart)
+        haveDetectedDart = dartFeed.poll(detectedDart);
+    if (haveDetectedDart && matchPanel.submitDart(detectedDart.dart, detectedDart.board.x, detectedDart.board.y)) {
+        haveDetectedDart = false;
+        frameEvent = true;
+    }
+
+    // the window may have been resized since last frame
+    updateWindowSize();
+
     // Mouse position saved to check for collisions
     glfwGetCursorPos(window, &MouseX, &MouseY);
 
-    // Change screen from start to play when user hits s
-    if (keys[GLFW_KEY_S] && screen == start) {
-        screen = play;
+    // Change screen from start to play when user hits s (unless it's being typed into the match panel)
+    if (keys[GLFW_KEY_S] && current.screen == start && !showMatch) {
+        simulation->submit({GameCommand::startGame});
     }
-
-    // Calculate delta time
-    float currentFrame = glfwGetTime();
-    deltaTime = currentFrame - lastFrame;
-    lastFrame = currentFrame;
+    // P pauses the game (unless it's being typed into the match panel)
+    if (keys[GLFW_KEY_P] && !pauseKeyLastFrame && current.screen == play && !showMatch)
+        simulation->submit({GameCommand::togglePause});
+    pauseKeyLastFrame = keys[GLFW_KEY_P];
 
     // Mouse position is inverted because the origin of the window is in the top left corner
     MouseY = height - MouseY; // Invert y-axis of mouse position
+    vec2 mouse(MouseX, MouseY);
+
+    // Camera: scroll to zoom around the mouse, drag with the right button or use the arrow keys to pan,
+    // home to see the whole board again
+    // (while the charts are shown the wheel zooms the legs around the mouse instead)
+    if (scrollOffset != 0 && showCharts && chartLegs > 1) {
+        ChartView view = legChartView();
+        double at = glm::clamp((mouse.x - view.screenMin.x) / (view.screenMax.x - view.screenMin.x), 0.0f, 1.0f);
+        double center = chartFirst + at * (chartLast - chartFirst);
+        double span = glm::clamp((chartLast - chartFirst) / std::pow(static_cast<double>(ZOOM_STEP), scrollOffset), 8.0, static_cast<double>(chartLegs - 1));
+        chartFirst = glm::clamp(center - at * span, 0.0, static_cast<double>(chartLegs - 1) - span);
+        chartLast = chartFirst + span;
+        scrollOffset = 0;
+    }
+    if (scrollOffset != 0) {
+        camera.zoomAt(mouse, glm::pow(ZOOM_STEP, static_cast<float>(scrollOffset)));
+        scrollOffset = 0;
+    }
+    if (glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_RIGHT) == GLFW_PRESS)
+        camera.pan(mouse - lastMouse);
+    lastMouse = mouse;
+    vec2 keyPan((keys[GLFW_KEY_LEFT] ? 1.0f : 0.0f) - (keys[GLFW_KEY_RIGHT] ? 1.0f : 0.0f),
+                (keys[GLFW_KEY_DOWN] ? 1.0f : 0.0f) - (keys[GLFW_KEY_UP] ? 1.0f : 0.0f));
+    camera.pan(keyPan * PAN_SPEED * deltaTime);
+    if (keys[GLFW_KEY_HOME])
+        resetCamera();
 
     // Check if mouse has been pressed
     bool mousePressed = glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_LEFT) == GLFW_PRESS;
+    if (mousePressed != mousePressedLastFrame)
+        frameEvent = true;
 
     // update squares
-    if (screen == play) {
-    for (int i = 0; i < shapes.size(); ++i) {
-        const auto& s = shapes[i]; // current shape
-        bool buttonOverlapsMouse = s->isOverlapping(vec2(MouseX, MouseY));
-
-        // create hover affect
-        if (buttonOverlapsMouse && screen == play) {
-            hoverShapes[i]->setColor(hoverOn);
+    if (current.screen == play && !current.paused) {
+        // the light under the mouse, if any (grid math, so it costs the same on any board size)
+        int cell = layout.cellAt(camera.screenToWorld(mouse));
+
+        // move the hover affect to that light
+        if (cell != hoveredCell) {
+            if (cell >= 0)
+                hoverOutline->setPos(layout.cellCenter(cell));
+            hoverOutline->setVisible(cell >= 0);
+            hoveredCell = cell;
         }
-        // remove hover affect
-        if (!buttonOverlapsMouse) {
-            hoverShapes[i]->setColor(hoverOff);
-        }
-        // check for mouse release to toggle and change color
-        // tracking clicks
-        if (!mousePressed && mousePressedLastFrame && s->isOverlapping(vec2(MouseX, MouseY))) {
-            // for tracking clicks
-            clickTracker++;
-
-            s->toggle(offFill, onFill);
-            // toggle button above
-            if (i!= 4 && i!= 9 && i!= 14 && i!= 19) {
-                if (i + 1 < shapes.size()) {
-                    shapes[i + 1]->toggle(offFill, onFill);
-                }
-            }
-            // toggle button below
-            if (i!= 5 && i!= 10 && i!= 15 && i!= 20) {
-                if (i - 1 < shapes.size()) {
-                    shapes[i - 1]->toggle(offFill, onFill);
-                }
-            }
-            // toggle button to the left
-            if (i - 5 < shapes.size()) {
-                shapes[i - 5]->toggle(offFill, onFill);
-            }
-            // toggle button to the right
-            if (i + 5 < shapes.size()) {
-                shapes[i + 5]->toggle(offFill, onFill);
+
+        // on mouse release, tell the simulation which light was clicked
+        if (!mousePressed && mousePressedLastFrame && cell >= 0) {
+            simulation->submit({GameCommand::pressCell, cell});
+            // time it until the light is seen toggled (the first click, if several are on their way)
+            if (clickTime < 0) {
+                clickTime = releaseTime;
+                clickTarget = current.clicks + 1;
             }
         }
-        }
     }
     // save mousePressed for next frame
     mousePressedLastFrame = mousePressed;
 }
+
 void Engine::update() {
     // Calculate delta time
-    float currentFrame = glfwGetTime();
-    deltaTime = currentFrame - lastFrame;
+    clockTime currentFrame = GameClock::steadyNow();
+    deltaTime = static_cast<float>(GameClock::toSeconds(currentFrame - lastFrame));
     lastFrame = currentFrame;
 
-    int count = 0;
-    for (int i = 0; i < shapes.size(); ++i) {
-        if (shapes[i]->isOn) {
-            count++;
-        }
-    }
-    if (count == 0) {
-        screen = over;
-    }
-
-    // vector for time at each update
-    vector <float> times;
-    switch (screen) {
-        case start: {
-            currentTime = 0;
-            glfwSetTime(0);
-            break;
-        }
-        case play: {
-            // push current time to vec
-            times.push_back(glfwGetTime());
-            // time since start = last item in vector - first item
-            currentTime = times[times.size()] - times[0];
-            break;
-        }
-        case over: {
-            this->currentTime = currentTime;
-            break;
-        }
+    // Pick up the newest snapshot, if the simulation published one since last frame.
+    // Both copies keep their board storage, so this never allocates.
+    TripleBuffer<GameState> &snapshots = simulation->snapshots();
+    if (snapshots.update()) {
+        std::swap(previous, current);
+        current = snapshots.front();
+        if (current.screen != previous.screen || current.paused != previous.paused)
+            frameEvent = true;
     }
+    saveSession();
 
-    // This function polls for events like keyboard input and mouse movement
-    // It needs to be called every frame
-    // Without this function, the window will freeze and become unresponsive
-    glfwPollEvents();
+    // Frames are drawn one tick behind the simulation, and interpolation says how far
+    // into that tick we are (0 = previous snapshot, 1 = current snapshot).
+    std::chrono::duration<double> sincePublish = std::chrono::steady_clock::now() - current.publishedAt;
+    interpolation = glm::clamp(static_cast<float>(sincePublish.count() / Simulation::DT), 0.0f, 1.0f);
 }
 
 void Engine::render() {
+    // count GL state calls per frame for the stats overlay
+    GLState::beginFrame();
+    // move on to a region of the stream buffer the GPU is done with
+    streamBuffer->beginFrame();
+
     glClearColor(0, 0, 0, 1); // black background
     glClear(GL_COLOR_BUFFER_BIT);
 
-    shapeShader.use();
+    updateFrameUniforms();
 
-    switch (screen) {
+    // interpolate between the two newest ticks so motion and timers stay smooth at any frame rate
+    double simTime = glm::mix(previous.simTime, current.simTime, (double)interpolation);
+    clockTime elapsed = previous.elapsed + static_cast<clockTime>((current.elapsed - previous.elapsed) * (double)interpolation);
+    // the timer text is formatted in place, it changes every frame
+    char timeText[32] = "Time: ";
+    GameClock::format(elapsed, timeText + 6, sizeof(timeText) - 6);
+
+    switch (current.screen) {
         case start: {
-            string welcome = "Welcome to Lights out!";
-            string start = "Press 's' to start.";
-            string instructions = "Instructions:";
-            string instructions1 = "The game begins with a fully lit grid.";
-            string instructions2 = "Click on a light to turn it and the four";
-            string instructions3 = "adjacent lights off. You win the game when";
-            string instructions4 = "all the lights have been turned off.";
-            this->fontRenderer->renderText(welcome, width/2 - (14 * welcome.length()), height/1.35, projection, 1.2, vec3{1, 1, 1});
-            this->fontRenderer->renderText(start, width/2 - (12 * start.length()), height/1.5, projection, 1, vec3{1, 1, 1});
-            this->fontRenderer->renderText(instructions, width/2 - (12 * instructions.length()), height/2.3, projection, 1, vec3{1, 1, 1});
-            this->fontRenderer->renderText(instructions1, width/2 - (8.6 * instructions1.length()), height/2.5, projection, 0.7, vec3{1, 1, 1});
-            this->fontRenderer->renderText(instructions2, width/2 - (8.5 * instructions1.length()), height/2.7, projection, 0.65, vec3{1, 1, 1});
-            this->fontRenderer->renderText(instructions3, width/2 - (8.8 * instructions1.length()), height/2.9, projection, 0.65, vec3{1, 1, 1});
-            this->fontRenderer->renderText(instructions4, width/2 - (8.3 * instructions1.length()), height/3.15, projection, 0.7, vec3{1, 1, 1});
+            std::string_view welcome = "Welcome to Lights out!";
+            std::string_view start = "Press 's' to start.";
+            std::string_view instructions = "Instructions:";
+            std::string_view instructions1 = "The game begins with a fully lit grid.";
+            std::string_view instructions2 = "Click on a light to turn it and the four";
+            std::string_view instructions3 = "adjacent lights off. You win the game when";
+            std::string_view instructions4 = "all the lights have been turned off.";
+            this->fontRenderer->renderText(welcome, width/2 - (14 * welcome.length()), height/1.35, 1.2, vec3{1, 1, 1});
+            this->fontRenderer->renderText(start, width/2 - (12 * start.length()), height/1.5, 1, vec3{1, 1, 1});
+            this->fontRenderer->renderText(instructions, width/2 - (12 * instructions.length()), height/2.3, 1, vec3{1, 1, 1});
+            this->fontRenderer->renderText(instructions1, width/2 - (8.6 * instructions1.length()), height/2.5, 0.7, vec3{1, 1, 1});
+            this->fontRenderer->renderText(instructions2, width/2 - (8.5 * instructions1.length()), height/2.7, 0.65, vec3{1, 1, 1});
+            this->fontRenderer->renderText(instructions3, width/2 - (8.8 * instructions1.length()), height/2.9, 0.65, vec3{1, 1, 1});
+            this->fontRenderer->renderText(instructions4, width/2 - (8.3 * instructions1.length()), height/3.15, 0.7, vec3{1, 1, 1});
             break;
         }
         case play: {
-            this->shapeShader.use();
-            // Render shapes
-            // For each shape, call it's setUniforms() function and then call it's draw() function
-            for (const unique_ptr<Shape>& s : hoverShapes) {
-                s->setUniforms();
-                s->draw();
-            }
-            for (const unique_ptr<Shape>& s : shapes) {
-                s->setUniforms();
-                s->draw();
+            // Show the lights as the simulation left them, with a short flash on the last one clicked
+            double sincePress = simTime - current.lastPressTime;
+            int flashCell = sincePress < FLASH_TIME ? current.lastPressed : -1;
+            color flash = onFill;
+            if (flashCell >= 0) {
+                color fill = current.board.isOn(flashCell) ? onFill : offFill;
+                flash.vec = glm::mix(WHITE.vec, fill.vec, static_cast<float>(sincePress / FLASH_TIME));
             }
+
+            // Render shapes (the hover outline first, then the lights on top)
+            Bounds view = camera.getVisibleBounds();
+            sceneRenderer->draw(scene, view);
+            boardRenderer->draw(current.board, layout, camera, onFill, offFill, flashCell, flash);
+
             // title of the game
-            string title = "Lights Out!";
-            this->fontRenderer->renderText(title, 20, height - 30, projection, 1, vec3{1, 1, 1});
+            std::string_view title = "Lights Out!";
+            this->fontRenderer->renderText(title, 20, height - 30, 1, vec3{1, 1, 1});
 
             // putting the clickTracker on the top-left corner
-            string clickTrackerString = "Number of Clicks: " + to_string(clickTracker);
-            this->fontRenderer->renderText(clickTrackerString, 60, height - 90, projection, 1, vec3{1, 1, 1});
+            std::string_view clickTrackerString = frameArena.print("Number of Clicks: %d", current.clicks);
+            this->fontRenderer->renderText(clickTrackerString, 60, height - 90, 1, vec3{1, 1, 1});
 
             // putting the timer below clickTracker
-            string deltaTimeString = "Time: " + to_string(abs((int)currentTime));
-            this->fontRenderer->renderText(deltaTimeString, 60, height - 120, projection, 1, vec3{1, 1, 1});
-
+            this->fontRenderer->renderText(timeText, 60, height - 120, 1, vec3{1, 1, 1});
+            if (current.paused)
+                this->fontRenderer->renderText("Paused - press 'p' to resume", 60, height - 150, 1, vec3{1, 1, 0});
 
             break;
         }
         case over: {
-
-            for (const unique_ptr<Shape>& s : shapes) {
-                s->setUniforms();
-                s->draw();
-            }
-
-            string over = "You win!";
-            string clickTrackerStringEnd = "Number of Clicks: " + to_string(clickTracker);
-            string deltaTimeStringEnd = "Time: " + to_string(abs((int)currentTime));
-            this->fontRenderer->renderText(over, 20, height - 30, projection, 1, vec3{1, 1, 1});
-            this->fontRenderer->renderText(clickTrackerStringEnd, 60, height - 90, projection, 1, vec3{1, 1, 1});
-            this->fontRenderer->renderText(deltaTimeStringEnd, 60, height - 120, projection, 1, vec3{1, 1, 1});
+            // the hover outline isn't shown once the game is won
+            hoverOutline->setVisible(false);
+            hoveredCell = -1;
+            boardRenderer->draw(current.board, layout, camera, onFill, offFill);
+
+            std::string_view over = "You win!";
+            std::string_view clickTrackerStringEnd = frameArena.print("Number of Clicks: %d", current.clicks);
+            this->fontRenderer->renderText(over, 20, height - 30, 1, vec3{1, 1, 1});
+            this->fontRenderer->renderText(clickTrackerStringEnd, 60, height - 90, 1, vec3{1, 1, 1});
+            this->fontRenderer->renderText(timeText, 60, height - 120, 1, vec3{1, 1, 1});
             break;
         }
     }
 
+    if (showMatch)
+        matchPanel.render(*fontRenderer, frameArena, width - 260, height - 30);
+    if (showPlayerStats)
+        matchPanel.renderStats(*fontRenderer, frameArena, 20, height - 160);
+    if (showCharts)
+        renderCharts();
+    if (heatmapPlayer >= 0)
+        renderHeatmap();
+
+    if (showStats)
+        renderStats();
+
+    // the GPU reads this frame's stream region until this fence passes
+    streamBuffer->endFrame();
+
     // This is glfw function call is required to display the final image on the screen
     // The front buffer contains the final image that is displayed.
     // The back buffer contains the image that is currently being rendered.
     glfwSwapBuffers(window);
+    pacer.presented();
+
+    if (current.screen != play)
+        clickTime = -1;
+    else if (clickTime >= 0 && current.clicks >= clickTarget) {
+        clickLatency.add(pacer.getPresentTime() - clickTime);
+        clickTime = -1;
+    }
+
+    endFrame();
+}
+
+bool Engine::resumeSession(GameState &state) {
+    SnapshotReader reader;
+    if (snapshotPath.empty() || !reader.open(snapshotPath))
+        return false;
+    // read straight from the mapped file
+    const SessionSnapshot &snapshot = *reader.get();
+    // the match goes on even if the game doesn't
+    resumedMatch = snapshot.match;
+    if (snapshot.cols != boardCols || snapshot.rows != boardRows) {
+        LOG_WARNING("ENGINE", "{} is a {}x{} game, starting a new {}x{} one", snapshotPath, snapshot.cols, snapshot.rows,
+                    boardCols, boardRows);
+        return false;
+    }
+    if (snapshot.screen == over) {
+        LOG_INFO("ENGINE", "The game in {} was finished, starting a new one", snapshotPath);
+        return false;
+    }
+    snapshot.restore(state);
+    LOG_INFO("ENGINE", "Resumed the session from {} ({} clicks, match {})", snapshotPath, state.clicks, resumedMatch.match);
+    return true;
+}
+
+void Engine::saveSession() {
+    // a second of a running game, at most, is lost to a crash
+    const clockTime SNAPSHOT_INTERVAL = GameClock::SECOND;
+    if (!snapshotWriter.isOpen())
+        return;
+    clockTime now = GameClock::steadyNow();
+    bool changed = current.changes != savedChanges || matchPanel.getScoredCount() != savedScored ||
+                   matchPanel.getMatch() != savedMatch;
+    // the timer runs without anything changing
+    bool running = current.screen == play && !current.paused && now - lastSnapshot >= SNAPSHOT_INTERVAL;
+    if (!changed && !running)
+        return;
+    snapshotWriter.submit(current, matchPanel.save(now));
+    savedChanges = current.changes;
+    savedScored = matchPanel.getScoredCount();
+    savedMatch = matchPanel.getMatch();
+    lastSnapshot = now;
+}
+
+void Engine::endFrame() {
+    frameArena.reset();
+
+    // input, a new screen or a message from the server may allocate (a status string, a buffer's
+    // first use), but once nothing has happened for a while every frame must get by without the heap
+    const int SETTLE_FRAMES = 60;
+    frameAllocations = AllocationCounter::getCount() - allocationsAtFrameStart;
+    quietFrames = frameEvent ? 0 : quietFrames + 1;
+    frameEvent = false;
+    if (AllocationCounter::ENABLED && quietFrames > SETTLE_FRAMES && frameAllocations != 0) {
+        LOG_ERROR("ENGINE", "{} heap allocations ({} bytes) in a settled frame", frameAllocations,
+                  AllocationCounter::getBytes());
+        Log::stop();
+        assert(frameAllocations == 0 && "the settled game loop must not allocate");
+    }
+}
+
+void Engine::updateFrameUniforms() {
+    FrameConstants constants{};
+    constants.projection = projection;
+    constants.view = camera.getView();
+    constants.viewport = vec4(0, 0, width, height);
+    constants.hover = camera.screenToWorld(vec2(MouseX, MouseY));
+    constants.time = static_cast<float>(glfwGetTime());
+    frameUniforms->update(constants);
+}
+
+void Engine::renderStats() {
+    const vec3 green{0, 1, 0};
+    GLStats gl = GLState::lastFrame();
+    fontRenderer->renderText(frameArena.print("GL calls: %u issued, %u skipped", gl.issued, gl.skipped), 10, 10, 0.5, green);
+
+    if (boardRenderer->usedTexture())
+        fontRenderer->renderText(frameArena.print("Board: texture, zoom %f", camera.getZoom()), 10, 25, 0.5, green);
+    else
+        fontRenderer->renderText(frameArena.print("Board: %d cells drawn, zoom %f", boardRenderer->getCellsDrawn(), camera.getZoom()), 10, 25, 0.5, green);
+
+    // milliseconds with one decimal
+    auto ms = [](double seconds) { return seconds * 1000; };
+    static const char *throttles[] = {"no throttle", "fence throttle", "glFinish throttle"};
+    if (pacer.getMode() == vsync)
+        fontRenderer->renderText(frameArena.print("Present: vsync, %s, frame %.1f ms", throttles[pacer.getThrottle()],
+                                                  ms(pacer.getFrameWork())), 10, 40, 0.5, green);
+    else
+        fontRenderer->renderText(frameArena.print("Present: low latency at %d Hz, %s, frame %.1f ms",
+                                                  static_cast<int>(pacer.getRefreshRate() + 0.5), throttles[pacer.getThrottle()],
+                                                  ms(pacer.getFrameWork())), 10, 40, 0.5, green);
+
+    const LatencyStats &input = pacer.getInputLatency();
+    fontRenderer->renderText(frameArena.print("Input to photon: %.1f ms, avg %.1f, max %.1f (+ up to %.1f before the poll)",
+                                              ms(input.getLast()), ms(input.getAverage()), ms(input.getMax()),
+                                              ms(pacer.getPollInterval())), 10, 55, 0.5, green);
+    fontRenderer->renderText(frameArena.print("Click to light: %.1f ms, avg %.1f, max %.1f", ms(clickLatency.getLast()),
+                                              ms(clickLatency.getAverage()), ms(clickLatency.getMax())), 10, 70, 0.5, green);
+
+    char *gpu = frameArena.allocate<char>(96);
+    size_t length = GpuMemory::summary(gpu, 96);
+    fontRenderer->renderText(std::string_view(gpu, length), 10, 85, 0.5, green);
+
+    // frame memory: what the arena held and what the heap was asked for (debug builds count it)
+    if (AllocationCounter::ENABLED)
+        fontRenderer->renderText(frameArena.print("Frame memory: arena %zu / %zu bytes, heap %llu allocations",
+                                                  frameArena.getUsed(), frameArena.getCapacity(),
+                                                  static_cast<unsigned long long>(frameAllocations)), 10, 100, 0.5, green);
+    else
+        fontRenderer->renderText(frameArena.print("Frame memory: arena %zu / %zu bytes", frameArena.getUsed(),
+                                                  frameArena.getCapacity()), 10, 100, 0.5, green);
+}
+
+void Engine::setPresentation(presentMode mode, throttleMode throttle) {
+    pacer.setMode(mode, throttle);
+    clickLatency.clear();
+}
+
+void Engine::updateWindowSize() {
+    int newWidth, newHeight;
+    glfwGetWindowSize(window, &newWidth, &newHeight);
+    // minimized windows report 0x0, keep the old size until it comes back
+    if (newWidth <= 0 || newHeight <= 0 || (newWidth == (int)width && newHeight == (int)height))
+        return;
+
+    width = newWidth;
+    height = newHeight;
+    projection = ortho(0.0f, static_cast<float>(width), 0.0f, static_cast<float>(height), -1.0f, 1.0f);
+    camera.setViewport(vec2(width, height));
+
+    // the framebuffer can be bigger than the window (high DPI screens)
+    int framebufferWidth, framebufferHeight;
+    glfwGetFramebufferSize(window, &framebufferWidth, &framebufferHeight);
+    glViewport(0, 0, framebufferWidth, framebufferHeight);
+}
+
+void Engine::resetCamera() {
+    // lift the limits first so fitting a huge board isn't clamped
+    camera.setZoomLimits(0.0f, 4.0f);
+    Bounds board = layout.getBounds();
+    Bounds screen = {vec2(0, 0), vec2(width, height)};
+    // A board that fits the window as it is (like the classic 5x5) stays exactly where it always was.
+    // Bigger boards are centered and zoomed out until all of them are visible.
+    if (screen.contains(board.min) && screen.contains(board.max)) {
+        camera.setCenter(vec2(width, height) * 0.5f);
+        camera.setZoom(1.0f);
+    }
+    else {
+        camera.fit(board);
+    }
+    // never zoom out further than a quarter of the whole board, or in further than 4:1
+    camera.setZoomLimits(glm::min(camera.getZoom(), 1.0f) * 0.25f, 4.0f);
+}
+
+bool Engine::connectToMatchServer(const std::string &address) {
+    // a resumed session goes on with its match, if the server still has it
+    if (resumedMatch.match != 0)
+        showMatch = matchPanel.rejoin(address, resumedMatch);
+    else
+        showMatch = matchPanel.connect(address);
+    savedMatch = matchPanel.getMatch();
+    return showMatch;
+}
+
+bool Engine::openThrowLog(const std::string &path) {
+    if (!matchPanel.openThrowLog(path))
+        return false;
+    throwLogPath = path;
+    return true;
+}
+
+void Engine::loadCharts() {
+    chartRenderer->clear();
+    std::fill(std::begin(legSeries), std::end(legSeries), -1);
+    positionSeries = -1;
+    chartLegs = 0;
+    // darts still waiting for the log's writer have to be in the file first
+    matchPanel.flushThrowLog();
+    ThrowLogReader log;
+    if (throwLogPath.empty() || !log.open(throwLogPath))
+        return;
+
+    // every player's points and darts in the leg being read, a bust takes its visit's points back
+    const int players = X01Game::MAX_PLAYERS;
+    vector<float> averages[players];
+    vector<ChartVertex> positions;
+    uint64_t legPoints[players] = {}, legDarts[players] = {}, visitPoints[players] = {};
+    uint32_t match = 0;
+    uint16_t leg = 0;
+    auto endLeg = [&]() {
+        for (int p = 0; p < players; ++p) {
+            if (legDarts[p] > 0)
+                averages[p].push_back(3.0f * static_cast<float>(legPoints[p]) / static_cast<float>(legDarts[p]));
+            legPoints[p] = legDarts[p] = visitPoints[p] = 0;
+        }
+    };
+    for (const ThrowRecord &record : log) {
+        if (record.player >= players)
+            continue;
+        if (record.match != match || record.leg != leg) {
+            endLeg();
+            match = record.match;
+            leg = record.leg;
+        }
+        int p = record.player;
+        legDarts[p]++;
+        if (record.result == bust) {
+            legPoints[p] -= visitPoints[p];
+            visitPoints[p] = 0;
+        }
+        else {
+            legPoints[p] += record.getDart().points();
+            visitPoints[p] = record.dart >= X01Game::DARTS_PER_VISIT - 1 ? 0 : visitPoints[p] + record.getDart().points();
+        }
+        // tenths of millimetres to millimetres
+        if (record.hasPosition())
+            positions.push_back({record.x * 0.1f, record.y * 0.1f});
+    }
+    endLeg();
+
+    for (int p = 0; p < players; ++p) {
+        if (!averages[p].empty()) {
+            legSeries[p] = chartRenderer->addLine(averages[p].data(), averages[p].size());
+            chartLegs = std::max(chartLegs, averages[p].size());
+        }
+    }
+    if (!positions.empty())
+        positionSeries = chartRenderer->addPoints(positions.data(), positions.size());
+    chartFirst = 0;
+    chartLast = std::max<double>(static_cast<double>(chartLegs) - 1, 1);
+}
+
+ChartView Engine::legChartView() const {
+    ChartView view;
+    view.screenMin = vec2(60, 40);
+    view.screenMax = vec2(width - 30.0f, 40 + height * 0.35f);
+    view.dataMin = vec2(chartFirst, 0);
+    view.dataMax = vec2(chartLast, 180);
+    return view;
+}
+
+void Engine::renderCharts() {
+    static const color PLAYER_COLORS[X01Game::MAX_PLAYERS] = {
+        {1, 0.8f, 0.2f}, {0.3f, 0.7f, 1}, {1, 0.4f, 0.4f}, {0.5f, 1, 0.5f},
+        {1, 0.5f, 1}, {0.5f, 1, 1}, {1, 1, 1}, {1, 0.6f, 0.3f}
+    };
+    const vec3 white{1, 1, 1};
+    if (throwLogPath.empty()) {
+        fontRenderer->renderText("No throw log to chart (--throw-log)", 60, 40, 0.5, white);
+        return;
+    }
+
+    // 3-dart average per leg, every player on the same axes
+    ChartView legs = legChartView();
+    size_t vertices = 0;
+    int level = 0;
+    for (int p = 0; p < X01Game::MAX_PLAYERS; ++p) {
+        if (legSeries[p] < 0)
+            continue;
+        chartRenderer->draw(legSeries[p], legs, PLAYER_COLORS[p]);
+        vertices += chartRenderer->getVerticesDrawn();
+        level = std::max(level, chartRenderer->getLevelDrawn());
+    }
+    fontRenderer->renderText("180", 20, legs.screenMax.y - 10, 0.4, white);
+    fontRenderer->renderText("0", 40, legs.screenMin.y, 0.4, white);
+    fontRenderer->renderText(frameArena.print("3-dart average, legs %.0f to %.0f of %zu (%zu vertices, level %d)",
+                                              chartFirst + 1, chartLast + 1, chartLegs, vertices, level),
+                             60, legs.screenMax.y + 8, 0.4, white);
+
+    // where the darts landed, a square around the board (its outer edge is 170 mm from the bull)
+    if (positionSeries >= 0) {
+        float side = std::min(width * 0.5f, height * 0.4f);
+        ChartView board;
+        board.screenMax = vec2(width - 30.0f, height - 40.0f);
+        board.screenMin = board.screenMax - vec2(side);
+        board.dataMin = vec2(-180, -180);
+        board.dataMax = vec2(180, 180);
+        chartRenderer->draw(positionSeries, board, color(0.3f, 1, 0.3f, 0.5f), 2);
+        fontRenderer->renderText(frameArena.print("%zu darts by position", chartRenderer->getCount(positionSeries)),
+                                 board.screenMin.x, board.screenMin.y - 20, 0.4, white);
+    }
+}
+
+void Engine::loadHeatmap() {
+    heatmapRenderer->clear();
+    // darts scored from here on are added as they come, the ones before have to be in the file first
+    heatmapScored = matchPanel.getScoredCount();
+    matchPanel.flushThrowLog();
+    ThrowLogReader log;
+    if (heatmapPlayer < 0 || throwLogPath.empty() || !log.open(throwLogPath))
+        return;
+
+    vector<HeatPoint> points;
+    for (const ThrowRecord &record : log) {
+        if (record.player == heatmapPlayer && record.hasPosition())
+            points.push_back({record.x, record.y});
+    }
+    heatmapRenderer->add(points.data(), points.size());
+}
+
+void Engine::renderHeatmap() {
+    // a square in the middle of the window, the board's wires are drawn over it
+    float side = std::min(width, height) * 0.6f;
+    vec2 min = (vec2(width, height) - vec2(side)) * 0.5f;
+    heatmapRenderer->draw(min, min + vec2(side));
+    fontRenderer->renderText(frameArena.print("P%d: %zu darts", heatmapPlayer + 1, heatmapRenderer->getCount()),
+                             min.x, min.y - 20, 0.4, vec3{1, 1, 1});
+}
+
+bool Engine::startDartDetection(const std::string &recording, const std::string &calibration) {
+    return dartFeed.start(recording, calibration);
+}
+
+void Engine::charCallback(GLFWwindow* window, unsigned int codepoint) {
+    Engine *engine = static_cast<Engine *>(glfwGetWindowUserPointer(window));
+    if (engine == nullptr)
+        return;
+    engine->frameEvent = true;
+    if (engine->showMatch)
+        engine->matchPanel.type(codepoint);
+}
+
+void Engine::mouseButtonCallback(GLFWwindow* window, int button, int action, int) {
+    Engine *engine = static_cast<Engine *>(glfwGetWindowUserPointer(window));
+    if (engine == nullptr)
+        return;
+    double now = glfwGetTime();
+    engine->pacer.inputArrived(now);
+    engine->frameEvent = true;
+    if (button == GLFW_MOUSE_BUTTON_LEFT && action == GLFW_RELEASE)
+        engine->releaseTime = now;
+}
+
+void Engine::keyCallback(GLFWwindow* window, int, int, int action, int) {
+    Engine *engine = static_cast<Engine *>(glfwGetWindowUserPointer(window));
+    if (engine == nullptr)
+        return;
+    engine->frameEvent = true;
+    if (action == GLFW_PRESS)
+        engine->pacer.inputArrived(glfwGetTime());
+}
+
+void Engine::scrollCallback(GLFWwindow* window, double xOffset, double yOffset) {
+    Engine *engine = static_cast<Engine *>(glfwGetWindowUserPointer(window));
+    if (engine != nullptr) {
+        engine->scrollOffset += yOffset;
+        engine->frameEvent = true;
+    }
 }
 
 bool Engine::shouldClose() {
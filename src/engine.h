@@ -9,9 +9,23 @@
 #include "font/fontRenderer.h"
 #include "shapes/shape.h"
 #include "shapes/rect.h"
+#include "shapes/sceneStore.h"
+#include "shapes/sceneRenderer.h"
+#include "shapes/boardRenderer.h"
+#include "shapes/chartRenderer.h"
+#include "shapes/heatmapRenderer.h"
+#include "game/boardLayout.h"
+#include "gl/camera.h"
+#include "darts/matchPanel.h"
+#include "vision/dartFeed.h"
+#include "game/simulation.h"
+#include "game/sessionSnapshot.h"
+#include "gl/frameUniforms.h"
+#include "gl/framePacer.h"
+#include "util/frameArena.h"
 
 using std::vector, std::unique_ptr, std::make_unique, std::to_string;
-using glm::ortho, glm::mat4, glm::vec3, glm::vec4;
+using glm::ortho, glm::mat4, glm::vec2, glm::vec3, glm::vec4;
 
 /**
  * @brief The Engine class.
@@ -20,21 +34,35 @@ using glm::ortho, glm::mat4, glm::vec3, glm::vec4;
  */
 class Engine {
     private:
-        // for tracking clicks
-        // referenced: count++ on Data Structures - sorting project
-        int clickTracker = 0;
-
-        // vector for time at each update
-        float currentTime;
+        // game state
+        /// @brief Runs the game logic on its own thread.
+        /// @details Initialized in initShapes()
+        unique_ptr<Simulation> simulation;
+        /// @brief The two newest snapshots published by the simulation.
+        /// @details render() interpolates from previous to current.
+        GameState previous, current;
+        /// @brief How far (0 to 1) the current frame is between previous and current.
+        float interpolation = 1.0f;
 
         // window and size
         /// @brief The actual GLFW window.
         GLFWwindow* window{};
         /// @brief The width and height of the window.
-        const unsigned int width = 700, height = 800; // Window dimensions
+        /// @details The window can be resized, see updateWindowSize().
+        unsigned int width = 700, height = 800; // Window dimensions
 
-        /// Projection matrix
-        const glm::mat4 projection = glm::ortho(0.0f, (float)width, 0.0f, (float)height);
+        /// Projection matrix used for 2D rendering (orthographic projection).
+        /// It maps the window's pixels (screen space) to normalized device coordinates and is rebuilt when the window is resized.
+        /// OpenGL uses the projection matrix to map the 3D scene to a 2D viewport.
+        /// The projection matrix transforms coordinates in the camera space into normalized device coordinates (view space to clip space).
+        /// @note The projection matrix reaches the vertex shaders through frameUniforms.
+        mat4 projection = ortho(0.0f, static_cast<float>(width), 0.0f, static_cast<float>(height), -1.0f, 1.0f);
+
+        // camera
+        /// @brief Pans and zooms over the board (shapes are in world space, text in screen space).
+        Camera camera{vec2(width, height)};
+        /// @brief Scroll wheel movement since the last processInput(), filled in by scrollCallback().
+        double scrollOffset = 0;
 
         // keyboard input
         /// @brief Keyboard state (True if pressed, false if not pressed).
@@ -43,27 +71,141 @@ class Engine {
 
         // shaders and fonts
         /// @brief Responsible for loading and storing all the shaders used in the project.
-        /// @details Initialized in initShaders()
+        /// @details Initialized in initShaders(). Owns the shaders, the renderers keep references to them.
         unique_ptr<ShaderManager> shaderManager;
-        Shader shapeShader;
-        Shader textShader;
+        /// @brief Ring buffer that text and other per-frame geometry is written to.
+        /// @details Initialized in initShaders()
+        unique_ptr<StreamBuffer> streamBuffer;
         unique_ptr<FontRenderer> fontRenderer;
+        /// @brief Uniform buffer with the per-frame constants every shader reads.
+        /// @details Initialized in initShaders(), updated once per frame in render()
+        unique_ptr<FrameUniforms> frameUniforms;
+        /// @brief Draws every visible shape in the scene with instanced draw calls.
+        /// @details Initialized in initShaders()
+        unique_ptr<SceneRenderer> sceneRenderer;
+        /// @brief Draws the visible part of the board (cells up close, a texture far away).
+        /// @details Initialized in initShaders()
+        unique_ptr<BoardRenderer> boardRenderer;
+        /// @brief Draws the charts of the throw log's history.
+        /// @details Initialized in initShaders()
+        unique_ptr<ChartRenderer> chartRenderer;
+        /// @brief Draws the heatmap of where a player's darts landed.
+        /// @details Initialized in initShaders()
+        unique_ptr<HeatmapRenderer> heatmapRenderer;
 
         // shapes to draw
-        /// @brief Shapes to be rendered.
+        /// @brief Holds the data of every shape in contiguous arrays.
+        /// @details Declared before the shapes, which remove themselves from it when destroyed.
+        SceneStore scene;
+        /// @brief The outline drawn behind the light under the mouse.
         /// @details Initialized in initShapes()
-        vector<unique_ptr<Shape>> shapes;
-        vector<unique_ptr<Shape>> hoverShapes;
+        unique_ptr<Rect> hoverOutline;
+        /// @brief Where the board's cells are in world space.
+        /// @details The lights themselves are drawn from the board by boardRenderer, so a board
+        ///          of millions of cells doesn't need a shape per cell.
+        BoardLayout layout;
+        /// @brief The size of the board to play on.
+        int boardCols, boardRows;
+
+        // session snapshots
+        /// @brief Where the session is saved to and resumed from ("" for neither).
+        std::string snapshotPath;
+        /// @brief Saves the session whenever it changes, without holding up the frame.
+        SnapshotWriter snapshotWriter;
+        /// @brief The match the resumed session was scoring (rejoined by connectToMatchServer()).
+        SavedMatch resumedMatch;
+        /// @brief What the last snapshot saved, to tell when the next one is due.
+        uint64_t savedChanges = 0, savedScored = 0;
+        uint32_t savedMatch = 0;
+        clockTime lastSnapshot = 0;
+        /// @brief The board cell under the mouse, or -1 if there is none.
+        int hoveredCell = -1;
+
+        // stats overlay
+        /// @brief True while the stats overlay is shown (toggled with F1).
+        bool showStats = false;
+        bool statsKeyLastFrame = false;
+        /// @brief F5 logs the live GL objects (see GpuMemory).
+        bool memoryKeyLastFrame = false;
+        /// @brief P pauses and resumes the game (and its timer).
+        bool pauseKeyLastFrame = false;
+
+        // presentation
+        /// @brief Paces frames and measures input latency (F3 toggles low latency mode, F4 the throttle).
+        FramePacer pacer;
+        bool presentKeyLastFrame = false;
+        bool throttleKeyLastFrame = false;
+        /// @brief From releasing the mouse on a light to the frame showing it toggled.
+        /// @details The click goes through the simulation thread, so this is longer than the input latency.
+        LatencyStats clickLatency;
+        /// @brief When the last click was released, or -1 once it's on screen.
+        double clickTime = -1;
+        /// @brief When the left mouse button was last released (stamped by mouseButtonCallback()).
+        double releaseTime = 0;
+        /// @brief The click count the board shows once the last click is on screen.
+        int clickTarget = 0;
+
+        // match server
+        /// @brief Scores an X01 match on a match server (shown with F2 once connected).
+        MatchPanel matchPanel;
+        bool showMatch = false;
+        bool matchKeyLastFrame = false;
+        bool enterLastFrame = false;
+        bool backspaceLastFrame = false;
+        /// @brief True while the player statistics are shown (toggled with F6).
+        bool showPlayerStats = false;
+        bool playerStatsKeyLastFrame = false;
+
+        // charts
+        /// @brief True while the charts of the throw log are shown (toggled with F7, the scroll wheel zooms the legs).
+        bool showCharts = false;
+        bool chartsKeyLastFrame = false;
+        /// @brief The throw log the charts are made from ("" without one).
+        std::string throwLogPath;
+        /// @brief Every player's 3-dart average per leg (-1 for players without legs) and where the darts landed.
+        int legSeries[X01Game::MAX_PLAYERS];
+        int positionSeries = -1;
+        /// @brief Legs of the player who played the most, and the ones the chart shows.
+        size_t chartLegs = 0;
+        double chartFirst = 0, chartLast = 1;
+
+        // heatmap
+        /// @brief The player whose heatmap is shown (-1 for none, F8 goes on to the next one).
+        int heatmapPlayer = -1;
+        bool heatmapKeyLastFrame = false;
+        /// @brief The match panel's scored darts the heatmap has seen.
+        uint64_t heatmapScored = 0;
+        /// @brief Finds darts in a camera recording and scores them on the match panel.
+        DartFeed dartFeed;
+        /// @brief A dart from dartFeed waiting for the match panel to take it.
+        Detection detectedDart;
+        bool haveDetectedDart = false;
+
+        // per-frame memory
+        /// @brief Transient text and scratch space for the frame being drawn, reset after every frame.
+        FrameArena frameArena;
+        /// @brief Heap allocations the render thread made last frame (counted in debug builds, see AllocationCounter).
+        uint64_t frameAllocations = 0;
+        uint64_t allocationsAtFrameStart = 0;
+        /// @brief Something happened this frame that may allocate (input, a new screen, a message from the server).
+        bool frameEvent = true;
+        /// @brief Frames in a row without such an event. Once the loop has settled, frames must not allocate.
+        int quietFrames = 0;
 
         // mouse
         double MouseX, MouseY;
         bool mousePressedLastFrame = false;
+        /// @brief Where the mouse was last frame (to pan by dragging with the right button).
+        vec2 lastMouse;
 
     public:
         // sets up
         /// @brief Constructor for the Engine class.
         /// @details Initializes window and shaders.
-        Engine();
+        /// @param cols The number of columns on the board
+        /// @param rows The number of rows on the board
+        /// @param snapshot Where the session is saved, and resumed from if it was ("" for neither)
+        Engine(int cols = 5, int rows = 5, const std::string &snapshot = "");
 
         // cleans up
         /// @brief Destructor for the Engine class.
@@ -76,36 +218,79 @@ class Engine {
         /// @brief Loads shaders from files and stores them in the shaderManager.
         /// @details Renderers are initialized here.
         void initShaders();
-        /// @brief Initializes the shapes to be rendered.
+        /// @brief Initializes the shapes to be rendered and starts the simulation.
         void initShapes();
 
         // game loop pieces
         /// @brief Processes input from the user.
         /// @details (e.g. keyboard input, mouse input, etc.)
         void processInput();
-        /// @brief Updates the game state.
-        /// @details (e.g. collision detection, delta time, etc.)
+        /// @brief Picks up the newest game state from the simulation.
+        /// @details (e.g. snapshot hand-off, interpolation, delta time, etc.)
         void update();
         /// @brief Renders the game state.
         /// @details Displays/renders objects on the screen.
         void render();
+        /// @brief Uploads this frame's projection, viewport, hover position and time.
+        void updateFrameUniforms();
+        /// @brief Draws the stats overlay (GL calls issued/skipped last frame).
+        void renderStats();
+        /// @brief Reads the throw log and uploads the series the charts show.
+        void loadCharts();
+        /// @brief Where the leg average chart goes and the legs it shows.
+        ChartView legChartView() const;
+        /// @brief Draws the leg averages and the throw positions.
+        void renderCharts();
+        /// @brief Reads the heatmap player's darts from the throw log onto the heatmap.
+        void loadHeatmap();
+        /// @brief Draws the heatmap in the middle of the window.
+        void renderHeatmap();
+        /// @brief Reads the last session's snapshot (if it has one for this board) into state.
+        /// @return false to start a new game
+        bool resumeSession(GameState &state);
+        /// @brief Hands a snapshot to the writer if the game or the match changed (or a game is running).
+        void saveSession();
+        /// @brief Frees the frame's transient memory and checks that a settled frame didn't allocate.
+        void endFrame();
+        /// @brief Picks up a new window size (viewport, projection and camera).
+        void updateWindowSize();
+        /// @brief Moves the camera so the whole board is visible (never zooming in past 1:1).
+        void resetCamera();
+        /// @brief GLFW scroll callback, zooms the camera.
+        static void scrollCallback(GLFWwindow* window, double xOffset, double yOffset);
+        /// @brief GLFW character callback, types into the match panel.
+        static void charCallback(GLFWwindow* window, unsigned int codepoint);
+        /// @brief GLFW mouse button callback, stamps the input for the latency measurement.
+        static void mouseButtonCallback(GLFWwindow* window, int button, int action, int mods);
+        /// @brief GLFW key callback, stamps the input for the latency measurement.
+        static void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods);
+
+        /// @brief Chooses how frames are presented (see FramePacer).
+        void setPresentation(presentMode mode, throttleMode throttle);
+
+        /// @brief Joins a match server as a scoring client and shows the match panel.
+        /// @param address "host:port" or "unix:<path>"
+        /// @return false if the server couldn't be reached
+        bool connectToMatchServer(const std::string &address);
+
+        /// @brief Appends every dart scored on the match server to a throw log (see ThrowLog).
+        /// @return false if the log couldn't be opened
+        bool openThrowLog(const std::string &path);
+        /// @brief Scores the darts found in a recorded camera sequence on the match server.
+        /// @param recording directory of .pgm frames
+        /// @param calibration image to board calibration (empty for <recording>/calibration.txt)
+        /// @return false if the recording or calibration couldn't be read
+        bool startDartDetection(const std::string &recording, const std::string &calibration);
 
         /* deltaTime variables */
         float deltaTime = 0.0f; // Time between current frame and last frame
-        float lastFrame = 0.0f; // Time of last frame (used to calculate deltaTime)
+        clockTime lastFrame = GameClock::steadyNow(); // Time of last frame (used to calculate deltaTime)
 
         /// @brief Returns true if the window should close.
         /// @details (Wrapper for glfwWindowShouldClose()).
         /// @return true if the window should close
         /// @return false if the window should not close
         bool shouldClose();
-
-        /// Projection matrix used for 2D rendering (orthographic projection).
-        /// We don't have to change this matrix since the screen size never changes.
-        /// OpenGL uses the projection matrix to map the 3D scene to a 2D viewport.
-        /// The projection matrix transforms coordinates in the camera space into normalized device coordinates (view space to clip space).
-        /// @note The projection matrix is used in the vertex shader.
-        const mat4 PROJECTION = ortho(0.0f, static_cast<float>(width), 0.0f, static_cast<float>(height), -1.0f, 1.0f);
 };
 
 #endif //GRAPHICS_ENGINE_H
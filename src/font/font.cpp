@@ -1,28 +1,59 @@
 #include "font.h"
+#include "../gl/glState.h"
+#include "../util/log.h"
 #include <glad/glad.h>
 
-#include <iostream>
+#include <utility>
 
 Font::Font(std::string fontPath, unsigned int fontSize) {
     FT_Library ft;
 
     // Initialize FreeType library
     if (FT_Init_FreeType(&ft)) {
-        std::cout << "ERROR::FREETYPE: Could not init FreeType Library" << std::endl;
+        LOG_ERROR("FREETYPE", "Could not init FreeType Library");
     }
 
     // Load font as face
     FT_Face face;
     if (FT_New_Face(ft, fontPath.c_str(), 0, &face)) {
-        std::cout << "ERROR::FREETYPE: Failed to load font" << std::endl;
+        LOG_ERROR("FREETYPE", "Failed to load font");
+    }
+    else {
+        loadCharacters(face, fontSize);
+        FT_Done_Face(face);
+    }
+
+    FT_Done_FreeType(ft);
+}
+
+Font::Font(const unsigned char *fontData, size_t fontDataSize, unsigned int fontSize) {
+    FT_Library ft;
+
+    // Initialize FreeType library
+    if (FT_Init_FreeType(&ft)) {
+        LOG_ERROR("FREETYPE", "Could not init FreeType Library");
     }
 
+    // Load font as face straight from memory (FreeType reads the buffer in place)
+    FT_Face face;
+    if (FT_New_Memory_Face(ft, fontData, static_cast<FT_Long>(fontDataSize), 0, &face)) {
+        LOG_ERROR("FREETYPE", "Failed to load font");
+    }
+    else {
+        loadCharacters(face, fontSize);
+        FT_Done_Face(face);
+    }
+
+    FT_Done_FreeType(ft);
+}
+
+void Font::loadCharacters(FT_Face face, unsigned int fontSize) {
     // Set size to load glyphs as
     FT_Set_Pixel_Sizes(face, 0, fontSize);
 
     // Attempt to load character glyph
     if (FT_Load_Char(face, 'X', FT_LOAD_RENDER)) {
-        std::cout << "ERROR::FREETYTPE: Failed to load Glyph" << std::endl;
+        LOG_ERROR("FREETYPE", "Failed to load Glyph");
     }
 
     glPixelStorei(GL_UNPACK_ALIGNMENT, 1); // disable byte-alignment restriction
@@ -31,14 +62,14 @@ Font::Font(std::string fontPath, unsigned int fontSize) {
     for (unsigned char c = 0; c < 128; c++) {
         // load character glyph 
         if (FT_Load_Char(face, c, FT_LOAD_RENDER)) {
-            std::cout << "ERROR::FREETYTPE: Failed to load Glyph" << std::endl;
+            LOG_ERROR("FREETYPE", "Failed to load Glyph");
             continue;
         }
 
         // generate texture
-        unsigned int texture;
-        glGenTextures(1, &texture);
-        glBindTexture(GL_TEXTURE_2D, texture);
+        GLTexture glyph = GLTexture::create();
+        unsigned int texture = glyph.get();
+        GLState::bindTexture(GL_TEXTURE_2D, texture);
         glTexImage2D(
             GL_TEXTURE_2D,
             0,
@@ -56,6 +87,9 @@ Font::Font(std::string fontPath, unsigned int fontSize) {
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        // one byte per texel
+        glyph.setBytes(size_t(face->glyph->bitmap.width) * face->glyph->bitmap.rows);
+        textures.push_back(std::move(glyph));
 
         // now store character for later use
         Character character = {
@@ -66,12 +100,9 @@ Font::Font(std::string fontPath, unsigned int fontSize) {
         };
         Characters.insert(std::pair<char, Character>(c, character));
     }
-    glBindTexture(GL_TEXTURE_2D, 0);
-
-    FT_Done_Face(face);
-    FT_Done_FreeType(ft);
+    GLState::bindTexture(GL_TEXTURE_2D, 0);
 }
 
-std::map<char, Character> Font::getCharacters() const {
+const std::map<char, Character> &Font::getCharacters() const {
     return Characters;
 }
@@ -3,7 +3,8 @@
 
 #include <map>
 #include <string>
-
+#include <vector>
+#include "../gl/gpuResource.h"
 
 #include <glm/glm.hpp>
 
@@ -14,7 +15,7 @@
  * @brief A single character
  * @details This struct is used to store information about a single character
  * 
- * @param TextureID ID handle of the glyph texture
+ * @param TextureID ID handle of the glyph texture (owned by the Font)
  * @param Size Size of glyph
  * @param Bearing Offset from baseline to left/top of glyph
  * @param Advance Offset to advance to next glyph
@@ -28,7 +29,9 @@ struct Character {
 
 /**
  * @brief A font
- * @details This class is used to store information about a font
+ * @details This class is used to store information about a font.
+ *          It owns the glyph textures, so it can be moved but not copied, and the characters
+ *          are only valid while it's alive.
  */
 class Font {
     public:
@@ -40,13 +43,23 @@ class Font {
          */
         Font(std::string fontPath, unsigned int fontSize);
 
+        /**
+         * @brief Construct a new Font object from a font file already in memory
+         * @details The data is read in place (no copy) and only has to stay alive during construction.
+         *
+         * @param fontData The contents of the font file
+         * @param fontDataSize The size of the font file in bytes
+         * @param fontSize The size of the font
+         */
+        Font(const unsigned char *fontData, size_t fontDataSize, unsigned int fontSize);
+
         
         /**
          * @brief Get the characters
          * 
          * @return a map of characters
          */
-        std::map<char, Character> getCharacters() const;
+        const std::map<char, Character> &getCharacters() const;
 
     private:
         /**
@@ -54,6 +67,18 @@ class Font {
          */
         std::map<char, Character> Characters;
 
+        /**
+         * @brief The glyph textures, deleted with the font
+         */
+        std::vector<GLTexture> textures;
+
+        /**
+         * @brief Renders the first 128 ASCII characters of a face into glyph textures
+         *
+         * @param face The loaded font face
+         * @param fontSize The size of the font
+         */
+        void loadCharacters(FT_Face face, unsigned int fontSize);
 };
 
 #endif //GRAPHICS_FONT_H
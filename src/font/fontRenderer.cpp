@@ -1,74 +1,89 @@
 #include "fontRenderer.h"
+#include "../gl/glState.h"
+#include "../gl/glDebug.h"
+#include "../gl/vertexFormat.h"
 
 #include <glad/glad.h>
 #include <glm/glm.hpp>
+#include <cstring>
 
-FontRenderer::FontRenderer(Shader& shader, std::string fontPath, int fontSize) {
-    this->shader = shader;
+FontRenderer::FontRenderer(Shader& shader, StreamBuffer& stream, std::string fontPath, int fontSize)
+    : shader(shader), stream(stream), typeface(fontPath, fontSize) {
     this->initRenderData();
-    Font myFont(fontPath, fontSize);
-    this->font = myFont.getCharacters();
+    this->initGlyphs();
 }
 
-FontRenderer::~FontRenderer() {
-    glDeleteVertexArrays(1, &this->VAO);
-    glDeleteBuffers(1, &this->VBO);
+FontRenderer::FontRenderer(Shader& shader, StreamBuffer& stream, const unsigned char *fontData, size_t fontDataSize, int fontSize)
+    : shader(shader), stream(stream), typeface(fontData, fontDataSize, fontSize) {
+    this->initRenderData();
+    this->initGlyphs();
 }
 
 void FontRenderer::initRenderData() {
-    glGenVertexArrays(1, &this->VAO);
-    glGenBuffers(1, &this->VBO);
-    glBindVertexArray(this->VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, this->VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 6 * 4, NULL, GL_DYNAMIC_DRAW);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), 0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+    this->VAO = GLVertexArray::create();
+    GLState::bindVertexArray(this->VAO.get());
+    // the glyph quads are streamed, so the pointers are set at draw time
+    TexturedVertex::FORMAT.enable();
 }
 
-void FontRenderer::renderText(std::string text, float x, float y, const glm::mat4 projection, float scale, glm::vec3 color) {
-    // activate corresponding render state
+void FontRenderer::initGlyphs() {
+    for (const auto &[c, ch] : typeface.getCharacters()) {
+        if (static_cast<unsigned char>(c) < glyphs.size())
+            glyphs[static_cast<unsigned char>(c)] = ch;
+    }
+}
 
-    this->shader.use();
-    glUniformMatrix4fv(glGetUniformLocation(this->shader.ID, "projection"), 1, false, glm::value_ptr(projection));
-    glUniform3f(glGetUniformLocation(this->shader.ID, "textColor"), color.x, color.y, color.z);
+void FontRenderer::renderText(std::string_view text, float x, float y, float scale, glm::vec3 color) {
+    // 6 vertices of <vec2 pos, 16-bit tex> per character
+    const GLsizeiptr stride = sizeof(TexturedVertex);
+    const GLsizeiptr quadSize = 6 * stride;
+    const uint16_t ONE = 0xffff;
 
-    glActiveTexture(GL_TEXTURE0);
-    glBindVertexArray(this->VAO);
+    // write every glyph's quad into this frame's region of the stream buffer in one go
+    StreamBuffer::Allocation quads = stream.allocate(quadSize * text.size(), stride);
+    if (!quads)
+        return;
 
-    // iterate through all characters
-    std::string::const_iterator c;
-    for (c = text.begin(); c != text.end(); c++) {
-        Character ch = font[*c];
+    TexturedVertex *vertices = static_cast<TexturedVertex *>(quads.data);
+    for (char c : text) {
+        const Character &ch = glyph(c);
 
         float xpos = x + ch.Bearing.x * scale;
         float ypos = y - (ch.Size.y - ch.Bearing.y) * scale;
 
         float w = ch.Size.x * scale;
         float h = ch.Size.y * scale;
-        // update VBO for each character
-        float vertices[6][4] = {
-            { xpos,     ypos + h,   0.0f, 0.0f },            
-            { xpos,     ypos,       0.0f, 1.0f },
-            { xpos + w, ypos,       1.0f, 1.0f },
+        const TexturedVertex quad[6] = {
+            { xpos,     ypos + h,   0,   0 },
+            { xpos,     ypos,       0,   ONE },
+            { xpos + w, ypos,       ONE, ONE },
 
-            { xpos,     ypos + h,   0.0f, 0.0f },
-            { xpos + w, ypos,       1.0f, 1.0f },
-            { xpos + w, ypos + h,   1.0f, 0.0f }           
+            { xpos,     ypos + h,   0,   0 },
+            { xpos + w, ypos,       ONE, ONE },
+            { xpos + w, ypos + h,   ONE, 0 }
         };
-        // render glyph texture over quad
-        glBindTexture(GL_TEXTURE_2D, ch.TextureID);
-        // update content of VBO memory
-        glBindBuffer(GL_ARRAY_BUFFER, VBO);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices); 
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-        // render quad
-        glDrawArrays(GL_TRIANGLES, 0, 6);
+        std::memcpy(vertices, quad, sizeof(quad));
+        vertices += 6;
         // now advance cursors for next glyph (note that advance is number of 1/64 pixels)
         x += (ch.Advance >> 6) * scale; // bitshift by 6 to get value in pixels (2^6 = 64)
     }
+    stream.commit(quads);
 
-    glBindVertexArray(0);
-    glBindTexture(GL_TEXTURE_2D, 0);
+    // activate corresponding render state
+    this->shader.use();
+    glUniform3f(glGetUniformLocation(this->shader.getID(), "textColor"), color.x, color.y, color.z);
+
+    GLState::activeTexture(GL_TEXTURE0);
+    GLState::bindVertexArray(this->VAO.get());
+    GLState::bindBuffer(GL_ARRAY_BUFFER, stream.getBuffer());
+    TexturedVertex::FORMAT.point(quads.offset);
+
+    // render glyph textures over their quads
+    for (size_t i = 0; i < text.size(); ++i) {
+        const Character &ch = glyph(text[i]);
+        if (ch.Size.x == 0 || ch.Size.y == 0)
+            continue; // nothing to draw (e.g. a space)
+        GLState::bindTexture(GL_TEXTURE_2D, ch.TextureID);
+        GL_CALL(glDrawArrays(GL_TRIANGLES, static_cast<GLint>(i * 6), 6));
+    }
 }
@@ -1,9 +1,12 @@
 #ifndef FONTRENDERER_H
 #define FONTRENDERER_H
 
+#include <array>
+#include <string_view>
 #include "../shader/shaderManager.h"
 #include "../shader/shader.h"
 #include "font.h"
+#include "../gl/streamBuffer.h"
 
 /**
  * @brief A font renderer
@@ -16,50 +19,78 @@ class FontRenderer {
          * @details This constructor will call the font constructor and initialize the render data
          * 
          * @param shader The shader to use
+         * @param stream The per-frame vertex buffer glyph quads are written to
          * @param fontPath The path to the font file
          * @param fontSize The size of the font
          */
-        FontRenderer(Shader& shader, std::string fontPath, int fontSize);
+        FontRenderer(Shader& shader, StreamBuffer& stream, std::string fontPath, int fontSize);
 
         /**
-         * @brief Destroy the Font Renderer object
-         * @details destroys the VAO and VBO associated with the font renderer
+         * @brief Construct a new Font Renderer object from a font file already in memory
+         *
+         * @param shader The shader to use
+         * @param stream The per-frame vertex buffer glyph quads are written to
+         * @param fontData The contents of the font file
+         * @param fontDataSize The size of the font file in bytes
+         * @param fontSize The size of the font
          */
-        ~FontRenderer();
+        FontRenderer(Shader& shader, StreamBuffer& stream, const unsigned char *fontData, size_t fontDataSize, int fontSize);
 
         /**
          * @brief Renders text on the screen
          * 
-         * @param text The text to render
+         * @param text The text to render (only read during the call, so it can point into a FrameArena)
          * @param x The x position of the text
          * @param y The y position of the text
-         * @param projection The projection matrix
          * @param scale The scale of the text
          * @param color The color of the text
+         * @note The projection comes from the shared Frame uniform block (see FrameUniforms)
          */
-        void renderText(std::string text, float x, float y, const glm::mat4 projection, float scale, glm::vec3 color);
+        void renderText(std::string_view text, float x, float y, float scale, glm::vec3 color);
 
     private:
         /**
-         * @brief The shader to use
+         * @brief The shader to use (owned by the ShaderManager)
+         */
+        Shader &shader;
+
+        /**
+         * @brief The VAO associated with the font renderer
          */
-        Shader shader;
+        GLVertexArray VAO;
 
         /**
-         * @brief The VAO and VBO associated with the font renderer
+         * @brief The per-frame vertex buffer the glyph quads of every string are written to
          */
-        GLuint VAO, VBO;
+        StreamBuffer& stream;
 
         /**
-         * @brief A set of character structs mapped to their ASCII character representations
-         * @details This is the same map generated by the font class
+         * @brief The loaded font, owns the glyph textures
          */
-        std::map<char, Character> font;
+        Font typeface;
 
         /**
-         * @brief Initializes and configures the buffer and vertex attributes
+         * @brief The typeface's characters indexed by their ASCII code (anything else draws as nothing)
+         * @details A flat copy of the typeface's map, so looking a glyph up never searches or inserts.
+         *          The textures stay owned by the typeface.
+         */
+        std::array<Character, 128> glyphs{};
+
+        /// @brief The glyph for c (an empty one if the font doesn't have it)
+        const Character &glyph(char c) const {
+            static const Character NONE{};
+            unsigned char code = static_cast<unsigned char>(c);
+            return code < glyphs.size() ? glyphs[code] : NONE;
+        }
+
+        /**
+         * @brief Initializes the VAO and enables the vertex attributes
+         * @details The attribute pointer itself is set per string, since it points into the stream buffer
          */
         void initRenderData();
+
+        /// @brief Fills glyphs from the typeface's characters
+        void initGlyphs();
 };
 
 #endif // FONTRENDERER_H
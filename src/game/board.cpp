@@ -0,0 +1,65 @@
+#include "board.h"
+
+#include <algorithm>
+
+Board::Board(int cols, int rows) : cols(cols), rows(rows), words((cols * rows + 63) / 64) {
+    fill(true);
+}
+
+bool Board::isOn(int index) const {
+    return (words[index >> 6] >> (index & 63)) & 1u;
+}
+
+void Board::fill(bool on) {
+    for (uint64_t &w : words)
+        w = on ? ~uint64_t(0) : 0;
+    clearPadding();
+}
+
+void Board::setWords(const uint64_t *saved) {
+    std::copy(saved, saved + words.size(), words.begin());
+    clearPadding();
+}
+
+void Board::flip(int index) {
+    words[index >> 6] ^= uint64_t(1) << (index & 63);
+}
+
+void Board::press(int index) {
+    int col = index % cols;
+    int row = index / cols;
+
+    flip(index);
+    if (col > 0)        flip(index - 1);    // left
+    if (col < cols - 1) flip(index + 1);    // right
+    if (row > 0)        flip(index - cols); // below
+    if (row < rows - 1) flip(index + cols); // above
+}
+
+void Board::scramble(int presses, std::minstd_rand &rng) {
+    std::uniform_int_distribution<int> cell(0, getCellCount() - 1);
+    // don't hand the player a board that is already solved
+    do {
+        fill(true);
+        for (int i = 0; i < presses; ++i)
+            press(cell(rng));
+    } while (litCount() == 0);
+}
+
+int Board::litCount() const {
+    int count = 0;
+    for (uint64_t w : words) {
+        // SWAR popcount: sum bits in pairs, nibbles, then bytes
+        w = w - ((w >> 1) & 0x5555555555555555ull);
+        w = (w & 0x3333333333333333ull) + ((w >> 2) & 0x3333333333333333ull);
+        w = (w + (w >> 4)) & 0x0f0f0f0f0f0f0f0full;
+        count += static_cast<int>((w * 0x0101010101010101ull) >> 56);
+    }
+    return count;
+}
+
+void Board::clearPadding() {
+    int used = getCellCount() & 63;
+    if (used != 0)
+        words.back() &= (uint64_t(1) << used) - 1;
+}
@@ -0,0 +1,56 @@
+#ifndef GRAPHICS_BOARD_H
+#define GRAPHICS_BOARD_H
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+/// @brief The Lights Out grid stored as a bitboard.
+/// @details Cells are indexed row-major from the bottom-left corner (index = row * cols + col)
+///          and each cell is a single bit, so copying a board is a plain memcpy of its words.
+class Board {
+    public:
+        /// @brief Construct a board with every light on
+        /// @param cols number of columns
+        /// @param rows number of rows
+        Board(int cols = 5, int rows = 5);
+
+        int getCols() const { return cols; }
+        int getRows() const { return rows; }
+        int getCellCount() const { return cols * rows; }
+
+        /// @brief Returns true if the light at index is on
+        bool isOn(int index) const;
+
+        /// @brief Turns every light on or off
+        void fill(bool on);
+
+        /// @brief Toggles the light at index and the (up to) four lights it borders
+        void press(int index);
+
+        /// @brief Presses random lights starting from a fully lit board
+        /// @details Pressing is its own inverse, so any board built this way is solvable.
+        /// @param presses the number of random presses
+        /// @param rng the random number generator to draw cells from
+        void scramble(int presses, std::minstd_rand &rng);
+
+        /// @brief Returns the number of lights that are on
+        int litCount() const;
+
+        /// @brief The raw bitboard (bit i of word i / 64 is cell i)
+        const std::vector<uint64_t> &getWords() const { return words; }
+        /// @brief Replaces the lights with a saved bitboard of the same size (getWords().size() words)
+        void setWords(const uint64_t *saved);
+
+    private:
+        int cols, rows;
+        std::vector<uint64_t> words;
+
+        /// @brief Flips a single cell
+        void flip(int index);
+
+        /// @brief Clears the unused bits past the last cell so litCount() stays exact
+        void clearPadding();
+};
+
+#endif //GRAPHICS_BOARD_H
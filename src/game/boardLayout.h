@@ -0,0 +1,64 @@
+#ifndef GRAPHICS_BOARDLAYOUT_H
+#define GRAPHICS_BOARDLAYOUT_H
+
+#include <cmath>
+#include "glm/glm.hpp"
+#include "../util/bounds.h"
+
+using glm::vec2;
+
+/**
+ * @brief Where the cells of a board are in world space.
+ * @details Cells sit on a regular grid, so finding the cell under a point or the cells inside a
+ *          rectangle is a division instead of a walk over every cell. Cell (col, row) is centered on
+ *          origin + (col, row) * step and is cellSize wide; the rest of the step is the gap between lights.
+ */
+struct BoardLayout {
+    int cols = 0, rows = 0;
+    /// @brief Center of cell 0 (bottom left)
+    vec2 origin = vec2(100, 100);
+    /// @brief Distance between the centers of neighbouring cells
+    float step = 125;
+    /// @brief Width and height of a light
+    float cellSize = 100;
+
+    /// @brief The center of a cell
+    vec2 cellCenter(int index) const {
+        return origin + vec2(index % cols, index / cols) * step;
+    }
+
+    /// @brief The cell whose light contains point (gaps don't count)
+    /// @return the cell's index, or -1 if there is none
+    int cellAt(vec2 point) const {
+        vec2 local = (point - origin) / step + 0.5f;
+        int col = static_cast<int>(std::floor(local.x));
+        int row = static_cast<int>(std::floor(local.y));
+        if (col < 0 || col >= cols || row < 0 || row >= rows)
+            return -1;
+        // distance from the cell center in world units
+        vec2 d = (local - vec2(col, row) - 0.5f) * step;
+        float half = cellSize * 0.5f;
+        if (d.x <= -half || d.x >= half || d.y <= -half || d.y >= half)
+            return -1;
+        return row * cols + col;
+    }
+
+    /// @brief The area the board covers in world space
+    Bounds getBounds() const {
+        vec2 half(cellSize * 0.5f);
+        return {origin - half, origin + vec2(cols - 1, rows - 1) * step + half};
+    }
+
+    /// @brief Finds the columns and rows with a cell that overlaps view
+    /// @return false if no cell is visible
+    bool visibleRange(const Bounds &view, int &firstCol, int &firstRow, int &lastCol, int &lastRow) const {
+        float half = cellSize * 0.5f;
+        firstCol = glm::max(0, static_cast<int>(std::ceil((view.min.x - half - origin.x) / step)));
+        firstRow = glm::max(0, static_cast<int>(std::ceil((view.min.y - half - origin.y) / step)));
+        lastCol = glm::min(cols - 1, static_cast<int>(std::floor((view.max.x + half - origin.x) / step)));
+        lastRow = glm::min(rows - 1, static_cast<int>(std::floor((view.max.y + half - origin.y) / step)));
+        return firstCol <= lastCol && firstRow <= lastRow;
+    }
+};
+
+#endif //GRAPHICS_BOARDLAYOUT_H
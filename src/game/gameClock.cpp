@@ -0,0 +1,136 @@
+#include "gameClock.h"
+
+#include <chrono>
+#include <cstdio>
+
+clockTime GameClock::steadyNow() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+size_t GameClock::format(clockTime time, char *text, size_t size) {
+    if (time < 0)
+        time = 0;
+    // tenths, rounded down so a timer never shows a second before it has passed
+    int64_t tenths = time / (SECOND / 10);
+    int64_t seconds = tenths / 10, minutes = seconds / 60, hours = minutes / 60;
+    int written;
+    if (hours > 0)
+        written = std::snprintf(text, size, "%d:%02d:%02d.%d", static_cast<int>(hours), static_cast<int>(minutes % 60),
+                                static_cast<int>(seconds % 60), static_cast<int>(tenths % 10));
+    else
+        written = std::snprintf(text, size, "%d:%02d.%d", static_cast<int>(minutes), static_cast<int>(seconds % 60),
+                                static_cast<int>(tenths % 10));
+    if (written < 0)
+        return 0;
+    return static_cast<size_t>(written) < size ? static_cast<size_t>(written) : size - 1;
+}
+
+void GameClock::reset(clockTime now) {
+    *this = GameClock();
+    origin = now;
+}
+
+void GameClock::pause(clockTime now) {
+    if (paused)
+        return;
+    paused = true;
+    pausedAt = now;
+}
+
+void GameClock::resume(clockTime now) {
+    if (!paused)
+        return;
+    paused = false;
+    pausedTotal += now - pausedAt;
+}
+
+void GameClock::rebase(clockTime from, clockTime to) {
+    origin += to - from;
+    pausedAt += to - from;
+}
+
+clockTime GameClock::getElapsed(clockTime now) const {
+    // while paused, the clock stands where the pause started
+    return (paused ? pausedAt : now) - origin - pausedTotal;
+}
+
+clockTime GameClock::getPausedTime(clockTime now) const {
+    return pausedTotal + (paused ? now - pausedAt : 0);
+}
+
+void GameClock::startLeg(clockTime now) {
+    if (legRunning)
+        endLeg(now);
+    legRunning = true;
+    legStart = getElapsed(now);
+    legVisits = 0;
+    visitPlayer = -1;
+    players.fill(PlayerSplits());
+}
+
+void GameClock::endLeg(clockTime now) {
+    if (!legRunning)
+        return;
+    endVisit(now);
+    legRunning = false;
+
+    LegSplit &leg = legs[next];
+    leg.start = legStart;
+    leg.duration = getElapsed(now) - legStart;
+    leg.visits = legVisits;
+    next = (next + 1) % LEG_HISTORY;
+    legCount++;
+}
+
+clockTime GameClock::getLegTime(clockTime now) const {
+    if (legRunning)
+        return getElapsed(now) - legStart;
+    return legCount > 0 ? getLeg(0).duration : 0;
+}
+
+void GameClock::startVisit(int player, clockTime now) {
+    if (player < 0 || player >= MAX_PLAYERS)
+        return;
+    endVisit(now);
+    // a visit outside a leg starts one
+    if (!legRunning)
+        startLeg(now);
+    visitPlayer = player;
+    visitStart = getElapsed(now);
+}
+
+void GameClock::endVisit(clockTime now) {
+    if (visitPlayer < 0)
+        return;
+    clockTime duration = getElapsed(now) - visitStart;
+    PlayerSplits &splits = players[visitPlayer];
+    splits.total += duration;
+    splits.last = duration;
+    splits.visits++;
+    legVisits++;
+    visitPlayer = -1;
+}
+
+clockTime GameClock::getVisitTime(clockTime now) const {
+    return visitPlayer >= 0 ? getElapsed(now) - visitStart : 0;
+}
+
+clockTime GameClock::getPlayerTime(int player, clockTime now) const {
+    clockTime total = players[player].total;
+    if (player == visitPlayer)
+        total += getVisitTime(now);
+    return total;
+}
+
+clockTime GameClock::getAverageVisit(int player) const {
+    const PlayerSplits &splits = players[player];
+    return splits.visits > 0 ? splits.total / splits.visits : 0;
+}
+
+const LegSplit &GameClock::getLeg(int back) const {
+    static const LegSplit NONE;
+    if (back < 0 || back >= legCount || back >= LEG_HISTORY)
+        return NONE;
+    return legs[(next - 1 - back + LEG_HISTORY) % LEG_HISTORY];
+}
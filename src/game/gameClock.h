@@ -0,0 +1,130 @@
+#ifndef GRAPHICS_GAMECLOCK_H
+#define GRAPHICS_GAMECLOCK_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/// @brief A time or duration in nanoseconds (fixed point, so sums and differences are exact)
+typedef int64_t clockTime;
+
+/// @brief How long one leg took, as kept by GameClock
+struct LegSplit {
+    /// @brief Clock time the leg started and how long it ran (pauses not included)
+    clockTime start = 0;
+    clockTime duration = 0;
+    /// @brief Visits thrown in the leg
+    int visits = 0;
+};
+
+/**
+ * @brief A pausable game clock with split times for legs and visits.
+ * @details The clock doesn't read the time itself: every call is given the current time (from
+ *          steadyNow(), a simulation tick or a camera frame), which makes it exact to replay.
+ *          Clock time is the time that has run since reset() without the pauses, and every split
+ *          is measured in clock time, so pausing the game freezes the leg and visit timers too.
+ *
+ *          Everything is kept in fixed-size arrays, nothing is allocated after construction.
+ *
+ * Usage:
+ * @code
+ * GameClock clock;
+ * clock.reset(GameClock::steadyNow());
+ * clock.startLeg(now);
+ * clock.startVisit(player, now);
+ * ...
+ * clock.endVisit(now);
+ * double seconds = GameClock::toSeconds(clock.getPlayerTime(player, now));
+ * @endcode
+ */
+class GameClock {
+    public:
+        static const int MAX_PLAYERS = 8;
+        /// @brief Legs kept by getLeg() (the oldest are forgotten)
+        static const int LEG_HISTORY = 16;
+        static constexpr clockTime SECOND = 1000000000;
+
+        /// @brief Now, from a steady (monotonic) high resolution clock
+        static clockTime steadyNow();
+        static double toSeconds(clockTime time) { return static_cast<double>(time) / SECOND; }
+        static clockTime fromSeconds(double seconds) { return static_cast<clockTime>(seconds * SECOND + (seconds < 0 ? -0.5 : 0.5)); }
+        /// @brief Writes a time as "m:ss.t" (or "h:mm:ss.t") into text, without allocating
+        /// @return the length written
+        static size_t format(clockTime time, char *text, size_t size);
+
+        /// @brief Starts the clock again from zero (running) and forgets all splits
+        void reset(clockTime now);
+
+        void pause(clockTime now);
+        void resume(clockTime now);
+        bool isPaused() const { return paused; }
+        /// @brief Moves the clock onto another time base (e.g. steadyNow() of a new process), so it
+        ///        reads at to what it read at from and the time in between doesn't count
+        void rebase(clockTime from, clockTime to);
+
+        /// @brief Clock time at now: time since reset() without the pauses
+        clockTime getElapsed(clockTime now) const;
+        /// @brief Total time spent paused (up to now)
+        clockTime getPausedTime(clockTime now) const;
+
+        /// @brief Starts timing a leg (ending the one that was running, if any)
+        void startLeg(clockTime now);
+        /// @brief Ends the running leg (and its visit) and adds it to the leg history
+        void endLeg(clockTime now);
+        bool inLeg() const { return legRunning; }
+        /// @brief How long the running leg has gone, or the last one took if none is running
+        clockTime getLegTime(clockTime now) const;
+
+        /// @brief Starts timing player's visit (ending the one that was running, if any)
+        void startVisit(int player, clockTime now);
+        /// @brief Ends the running visit and adds it to its player's totals
+        void endVisit(clockTime now);
+        /// @brief The player whose visit is running, or -1
+        int getVisitPlayer() const { return visitPlayer; }
+        /// @brief How long the running visit has gone, or 0 if none is running
+        clockTime getVisitTime(clockTime now) const;
+
+        /// @brief Time player has spent throwing this leg, including a running visit
+        clockTime getPlayerTime(int player, clockTime now) const;
+        /// @brief Visits player has finished this leg
+        int getPlayerVisits(int player) const { return players[player].visits; }
+        /// @brief How long player's last finished visit took (0 if none yet)
+        clockTime getLastVisit(int player) const { return players[player].last; }
+        /// @brief Mean of player's finished visits this leg (0 if none yet)
+        clockTime getAverageVisit(int player) const;
+
+        /// @brief Legs finished since reset() (LEG_HISTORY at most are kept)
+        int getLegCount() const { return legCount; }
+        /// @brief A finished leg, 0 being the most recent
+        const LegSplit &getLeg(int back) const;
+
+    private:
+        /// @brief A player's visits in the running leg
+        struct PlayerSplits {
+            clockTime total = 0;
+            clockTime last = 0;
+            int visits = 0;
+        };
+
+        /// @brief steadyNow() (or whatever time base the caller uses) at reset()
+        clockTime origin = 0;
+        /// @brief Pause time before the current pause
+        clockTime pausedTotal = 0;
+        /// @brief When the current pause started
+        clockTime pausedAt = 0;
+        bool paused = false;
+
+        bool legRunning = false;
+        clockTime legStart = 0;
+        int legVisits = 0;
+        int visitPlayer = -1;
+        clockTime visitStart = 0;
+        std::array<PlayerSplits, MAX_PLAYERS> players{};
+
+        /// @brief Ring of finished legs, next is where the next one goes
+        std::array<LegSplit, LEG_HISTORY> legs{};
+        int legCount = 0;
+        int next = 0;
+};
+
+#endif //GRAPHICS_GAMECLOCK_H
@@ -0,0 +1,55 @@
+#ifndef GRAPHICS_GAMESTATE_H
+#define GRAPHICS_GAMESTATE_H
+
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include "board.h"
+#include "gameClock.h"
+
+/// @brief Which screen the game is on
+enum state {start, play, over};
+
+/// @brief A complete, immutable-once-published copy of the simulation state.
+/// @details The simulation thread fills one of these every tick and hands it to the
+///          render thread through a TripleBuffer. The renderer only ever reads it.
+///          It holds everything the simulation needs to carry on (the timer and the random
+///          numbers too), so a game saved from one (see SessionSnapshot) resumes exactly.
+struct GameState {
+    /// @brief Number of simulation ticks run so far
+    uint64_t tick = 0;
+    /// @brief Number of times the game changed (a command was applied, the screen changed), to tell when to save it
+    uint64_t changes = 0;
+    /// @brief Simulated time in seconds (tick * Simulation::DT)
+    double simTime = 0.0;
+    /// @brief Wall-clock time this snapshot was published, used to interpolate between ticks
+    std::chrono::steady_clock::time_point publishedAt;
+
+    state screen = start;
+    Board board;
+
+    /// @brief Number of lights the player has clicked
+    int clicks = 0;
+    /// @brief Time spent on the play screen, not counting pauses
+    clockTime elapsed = 0;
+    /// @brief Times the play screen, in tick time (see Simulation::tickTime())
+    GameClock clock;
+    /// @brief True while the game is paused (the timer stands still and clicks are ignored)
+    bool paused = false;
+
+    /// @brief The most recently pressed cell (-1 if none) and the simTime it was pressed at
+    int lastPressed = -1;
+    double lastPressTime = 0.0;
+
+    /// @brief Scrambles new boards
+    std::minstd_rand rng;
+};
+
+/// @brief Something the player did, sent from the input thread to the simulation thread
+struct GameCommand {
+    enum Type {startGame, pressCell, togglePause} type;
+    /// @brief The cell to press (pressCell only)
+    int cell = -1;
+};
+
+#endif //GRAPHICS_GAMESTATE_H
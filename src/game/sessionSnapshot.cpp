@@ -0,0 +1,308 @@
+#include "sessionSnapshot.h"
+#include "../util/log.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <type_traits>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define SNAPSHOT_POSIX 1
+#endif
+
+static const char MAGIC[8] = {'D', 'A', 'R', 'T', 'S', 'N', 'A', 'P'};
+
+// kept as bytes, so they have to be plain memory
+static_assert(std::is_trivially_copyable<SessionSnapshot>::value, "snapshots are read in place");
+static_assert(std::is_trivially_copyable<std::minstd_rand>::value, "the generator is saved as its bytes");
+static_assert(sizeof(SessionSnapshot) % sizeof(uint64_t) == 0, "the board's words follow the snapshot");
+
+// FNV-1a, 64 bit
+static uint64_t fnv1a(const unsigned char *data, size_t size) {
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= data[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+// everything after the checksum field
+static uint64_t checksumOf(const unsigned char *file, size_t size) {
+    const size_t start = offsetof(SessionSnapshot, checksum) + sizeof(uint64_t);
+    return fnv1a(file + start, size - start);
+}
+
+size_t SessionSnapshot::bytesFor(int cols, int rows) {
+    return sizeof(SessionSnapshot) + (size_t(cols) * rows + 63) / 64 * sizeof(uint64_t);
+}
+
+void SessionSnapshot::write(const GameState &state, const SavedMatch &match, vector<unsigned char> &out) {
+    const Board &board = state.board;
+    const vector<uint64_t> &words = board.getWords();
+    out.resize(bytesFor(board.getCols(), board.getRows()));
+
+    // zeroed first, so no stale bytes end up in the padding
+    SessionSnapshot snapshot;
+    std::memset(static_cast<void *>(&snapshot), 0, sizeof(snapshot));
+    std::memcpy(snapshot.magic, MAGIC, sizeof(MAGIC));
+    snapshot.version = VERSION;
+    snapshot.snapshotSize = sizeof(SessionSnapshot);
+    snapshot.clockSize = sizeof(GameClock);
+    snapshot.rngSize = sizeof(std::minstd_rand);
+    snapshot.fileSize = out.size();
+    snapshot.tick = state.tick;
+    snapshot.changes = state.changes;
+    snapshot.simTime = state.simTime;
+    snapshot.screen = state.screen;
+    snapshot.clicks = state.clicks;
+    snapshot.elapsed = state.elapsed;
+    snapshot.paused = state.paused ? 1 : 0;
+    snapshot.lastPressed = state.lastPressed;
+    snapshot.lastPressTime = state.lastPressTime;
+    snapshot.clock = state.clock;
+    std::memcpy(snapshot.rng, &state.rng, sizeof(snapshot.rng));
+    snapshot.cols = board.getCols();
+    snapshot.rows = board.getRows();
+    snapshot.boardWords = words.size();
+    snapshot.match = match;
+
+    std::memcpy(out.data(), &snapshot, sizeof(snapshot));
+    std::memcpy(out.data() + sizeof(snapshot), words.data(), words.size() * sizeof(uint64_t));
+    uint64_t checksum = checksumOf(out.data(), out.size());
+    std::memcpy(out.data() + offsetof(SessionSnapshot, checksum), &checksum, sizeof(checksum));
+}
+
+void SessionSnapshot::restore(GameState &state) const {
+    state.tick = tick;
+    state.changes = changes;
+    state.simTime = simTime;
+    state.publishedAt = std::chrono::steady_clock::now();
+    state.screen = static_cast<enum state>(screen);
+    state.board = Board(cols, rows);
+    state.board.setWords(getWords());
+    state.clicks = clicks;
+    state.elapsed = elapsed;
+    state.clock = clock;
+    state.paused = paused != 0;
+    state.lastPressed = lastPressed;
+    state.lastPressTime = lastPressTime;
+    std::memcpy(&state.rng, rng, sizeof(rng));
+}
+
+// checks a snapshot of size bytes, logging why it can't be used
+static bool isUsable(const string &path, const unsigned char *file, size_t size) {
+    if (size < sizeof(SessionSnapshot) || std::memcmp(file, MAGIC, sizeof(MAGIC)) != 0) {
+        LOG_WARNING("SNAPSHOT", "{} isn't a session snapshot", path);
+        return false;
+    }
+    const SessionSnapshot *snapshot = reinterpret_cast<const SessionSnapshot *>(file);
+    if (snapshot->version != SessionSnapshot::VERSION || snapshot->snapshotSize != sizeof(SessionSnapshot) ||
+        snapshot->clockSize != sizeof(GameClock) || snapshot->rngSize != sizeof(std::minstd_rand)) {
+        LOG_WARNING("SNAPSHOT", "{} is from a different version of the game", path);
+        return false;
+    }
+    if (snapshot->fileSize != size || snapshot->cols < 1 || snapshot->rows < 1 ||
+        snapshot->boardWords != (uint64_t(snapshot->cols) * snapshot->rows + 63) / 64 ||
+        size != SessionSnapshot::bytesFor(snapshot->cols, snapshot->rows) ||
+        snapshot->screen < start || snapshot->screen > over || checksumOf(file, size) != snapshot->checksum) {
+        LOG_WARNING("SNAPSHOT", "{} is damaged", path);
+        return false;
+    }
+    return true;
+}
+
+SnapshotReader::~SnapshotReader() {
+    close();
+}
+
+#ifdef SNAPSHOT_POSIX
+
+bool SnapshotReader::open(const string &path) {
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        // no snapshot is the usual first start
+        if (errno != ENOENT)
+            LOG_WARNING("SNAPSHOT", "Could not open {}: {}", path, std::strerror(errno));
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        LOG_WARNING("SNAPSHOT", "Could not read the size of {}: {}", path, std::strerror(errno));
+        ::close(fd);
+        return false;
+    }
+    size_t size = static_cast<size_t>(info.st_size);
+    void *data = size > 0 ? mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+    // the mapping keeps the file open
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        LOG_WARNING("SNAPSHOT", "Could not map {}", path);
+        return false;
+    }
+    mapping = data;
+    mappedBytes = size;
+    if (!isUsable(path, static_cast<const unsigned char *>(data), size)) {
+        close();
+        return false;
+    }
+    snapshot = static_cast<const SessionSnapshot *>(data);
+    return true;
+}
+
+void SnapshotReader::close() {
+    if (mapping != nullptr)
+        munmap(mapping, mappedBytes);
+    mapping = nullptr;
+    mappedBytes = 0;
+    snapshot = nullptr;
+}
+
+bool SnapshotWriter::writeFile(const vector<unsigned char> &snapshot) {
+    int fd = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        LOG_ERROR("SNAPSHOT", "Could not create {}: {}", temporary, std::strerror(errno));
+        return false;
+    }
+    const unsigned char *data = snapshot.data();
+    size_t left = snapshot.size();
+    while (left > 0) {
+        ssize_t done = ::write(fd, data, left);
+        if (done < 0 && errno == EINTR)
+            continue;
+        if (done <= 0) {
+            LOG_ERROR("SNAPSHOT", "Could not write {}: {}", temporary, std::strerror(errno));
+            ::close(fd);
+            return false;
+        }
+        data += done;
+        left -= static_cast<size_t>(done);
+    }
+    // the data has to be on disk before the rename is, or a power loss could leave an empty file
+#ifdef __APPLE__
+    int synced = fcntl(fd, F_FULLFSYNC);
+#else
+    int synced = fdatasync(fd);
+#endif
+    if (synced != 0) {
+        // the old snapshot stays, it's the last one known to be on disk
+        LOG_ERROR("SNAPSHOT", "Could not sync {}: {}", temporary, std::strerror(errno));
+        ::close(fd);
+        ::unlink(temporary.c_str());
+        return false;
+    }
+    ::close(fd);
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        LOG_ERROR("SNAPSHOT", "Could not replace {}: {}", path, std::strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+#else
+
+bool SnapshotReader::open(const string &path) {
+    close();
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in)
+        return false;
+    size_t size = static_cast<size_t>(in.tellg());
+    copy.assign((size + sizeof(uint64_t) - 1) / sizeof(uint64_t), 0);
+    in.seekg(0);
+    in.read(reinterpret_cast<char *>(copy.data()), static_cast<std::streamsize>(size));
+    if (!in || !isUsable(path, reinterpret_cast<const unsigned char *>(copy.data()), size)) {
+        close();
+        return false;
+    }
+    snapshot = reinterpret_cast<const SessionSnapshot *>(copy.data());
+    return true;
+}
+
+void SnapshotReader::close() {
+    copy.clear();
+    snapshot = nullptr;
+}
+
+bool SnapshotWriter::writeFile(const vector<unsigned char> &snapshot) {
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char *>(snapshot.data()), static_cast<std::streamsize>(snapshot.size()));
+        if (!out.flush()) {
+            LOG_ERROR("SNAPSHOT", "Could not write {}", temporary);
+            return false;
+        }
+    }
+#ifdef _WIN32
+    // rename doesn't replace a file on Windows
+    std::remove(path.c_str());
+#endif
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        LOG_ERROR("SNAPSHOT", "Could not replace {}", path);
+        return false;
+    }
+    return true;
+}
+
+#endif
+
+SnapshotWriter::~SnapshotWriter() {
+    close();
+}
+
+void SnapshotWriter::open(const string &path, size_t bytes) {
+    close();
+    this->path = path;
+    temporary = path + ".tmp";
+    pending.reserve(bytes);
+    writing.reserve(bytes);
+    havePending = false;
+    running = true;
+    writer = std::thread(&SnapshotWriter::run, this);
+}
+
+void SnapshotWriter::close() {
+    if (!writer.joinable())
+        return;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        running = false;
+    }
+    wake.notify_one();
+    writer.join();
+}
+
+void SnapshotWriter::submit(const GameState &state, const SavedMatch &match) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (havePending)
+            skipped.fetch_add(1, std::memory_order_relaxed);
+        SessionSnapshot::write(state, match, pending);
+        havePending = true;
+    }
+    wake.notify_one();
+}
+
+void SnapshotWriter::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+        wake.wait(lock, [this] { return havePending || !running; });
+        // the last one is written before stopping
+        if (!havePending)
+            return;
+        // both buffers keep their memory, they only change places
+        std::swap(pending, writing);
+        havePending = false;
+        lock.unlock();
+        if (writeFile(writing))
+            written.fetch_add(1, std::memory_order_relaxed);
+        lock.lock();
+    }
+}
@@ -0,0 +1,168 @@
+#ifndef GRAPHICS_SESSIONSNAPSHOT_H
+#define GRAPHICS_SESSIONSNAPSHOT_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "gameClock.h"
+#include "gameState.h"
+
+using std::string, std::vector;
+
+/// @brief The X01 match being scored on a match server, as much of it as the game needs to rejoin it
+struct SavedMatch {
+    /// @brief The server's match (0 for none)
+    uint32_t match = 0;
+    int32_t players = 2;
+    int32_t startScore = 501;
+    /// @brief The match panel's leg and visit splits
+    GameClock clock;
+    /// @brief GameClock::steadyNow() when it was saved, so the clock can be moved onto a new process's time
+    clockTime savedAt = 0;
+};
+
+/**
+ * @brief A session as it lies in a snapshot file, read straight from the mapped file.
+ * @details Every field has a fixed size and place, so loading a snapshot is mapping the file and
+ *          checking the header and checksum, with nothing to parse. The board's words follow it
+ *          (getWords()). The clock and the random number generator are kept as their bytes, so a
+ *          snapshot is only read by a build that lays them out the same way (the header has their
+ *          sizes, and the version goes up whenever this struct changes).
+ */
+struct alignas(8) SessionSnapshot {
+    static const uint32_t VERSION = 1;
+
+    /// @brief "DARTSNAP"
+    char magic[8];
+    uint32_t version;
+    /// @brief sizeof(SessionSnapshot), sizeof(GameClock) and sizeof(std::minstd_rand) of the build that wrote it
+    uint32_t snapshotSize, clockSize, rngSize;
+    /// @brief Bytes in the file (this and the board after it)
+    uint64_t fileSize;
+    /// @brief FNV-1a of everything after it
+    uint64_t checksum;
+
+    // the simulation (see GameState)
+    uint64_t tick;
+    uint64_t changes;
+    double simTime;
+    int32_t screen;
+    int32_t clicks;
+    clockTime elapsed;
+    int32_t paused;
+    int32_t lastPressed;
+    double lastPressTime;
+    GameClock clock;
+    unsigned char rng[sizeof(std::minstd_rand)];
+    int32_t cols, rows;
+    uint64_t boardWords;
+
+    // the match panel
+    SavedMatch match;
+
+    /// @brief The board's bitboard, right after the snapshot
+    const uint64_t *getWords() const { return reinterpret_cast<const uint64_t *>(this + 1); }
+
+    /// @brief Bytes in the snapshot of a board of cols x rows
+    static size_t bytesFor(int cols, int rows);
+    /// @brief Writes a snapshot of a state and a match into out (resized to bytesFor() the board)
+    static void write(const GameState &state, const SavedMatch &match, vector<unsigned char> &out);
+    /// @brief Fills a state from the snapshot (publishedAt is now)
+    void restore(GameState &state) const;
+};
+
+/**
+ * @brief Maps a snapshot file and checks it, the snapshot is then read in place.
+ *
+ * Usage:
+ * @code
+ * SnapshotReader reader;
+ * if (reader.open("session.snap"))
+ *     reader.get()->restore(state);
+ * @endcode
+ */
+class SnapshotReader {
+    public:
+        SnapshotReader() = default;
+        ~SnapshotReader();
+
+        SnapshotReader(const SnapshotReader &) = delete;
+        SnapshotReader &operator=(const SnapshotReader &) = delete;
+
+        /// @brief Maps a snapshot and checks its header, sizes and checksum
+        /// @return false if there's none, or it can't be used (the reason is logged)
+        bool open(const string &path);
+        void close();
+
+        /// @brief The snapshot (valid until close())
+        const SessionSnapshot *get() const { return snapshot; }
+
+    private:
+        void *mapping = nullptr;
+        size_t mappedBytes = 0;
+        /// @brief Where the file is read to where it can't be mapped
+        vector<uint64_t> copy;
+        const SessionSnapshot *snapshot = nullptr;
+};
+
+/**
+ * @brief Saves snapshots on its own thread, so the game never waits for the disk.
+ * @details submit() copies the snapshot into a buffer and wakes the writer, which writes it to
+ *          path + ".tmp", syncs it and renames it over path. A crash at any point leaves either the
+ *          old snapshot or the new one, never half of one. If snapshots come faster than the disk
+ *          takes them, the writer skips to the newest.
+ *
+ * Usage:
+ * @code
+ * SnapshotWriter writer;
+ * writer.open("session.snap", SessionSnapshot::bytesFor(cols, rows));
+ * writer.submit(state, match);   // whenever something changed
+ * @endcode
+ */
+class SnapshotWriter {
+    public:
+        SnapshotWriter() = default;
+        /// @brief Writes the last snapshot submitted and stops the writer
+        ~SnapshotWriter();
+
+        SnapshotWriter(const SnapshotWriter &) = delete;
+        SnapshotWriter &operator=(const SnapshotWriter &) = delete;
+
+        /// @brief Starts the writer
+        /// @param bytes the size of the snapshots (their buffers are allocated now, so submitting never allocates)
+        void open(const string &path, size_t bytes);
+        /// @brief Writes the last snapshot submitted and stops the writer
+        void close();
+        bool isOpen() const { return writer.joinable(); }
+
+        /// @brief Hands a snapshot to the writer, replacing one it hasn't started on
+        void submit(const GameState &state, const SavedMatch &match);
+
+        /// @brief Snapshots written, and ones replaced by a newer one before they were
+        uint64_t getWritten() const { return written.load(std::memory_order_relaxed); }
+        uint64_t getSkipped() const { return skipped.load(std::memory_order_relaxed); }
+
+    private:
+        string path, temporary;
+        std::thread writer;
+        std::mutex mutex;
+        std::condition_variable wake;
+        bool running = false;
+        /// @brief The newest snapshot (if there is one) and the one being written
+        vector<unsigned char> pending, writing;
+        bool havePending = false;
+        std::atomic<uint64_t> written{0}, skipped{0};
+
+        /// @brief The writer thread's loop
+        void run();
+        /// @brief Writes, syncs and renames one snapshot
+        bool writeFile(const vector<unsigned char> &snapshot);
+};
+
+#endif //GRAPHICS_SESSIONSNAPSHOT_H
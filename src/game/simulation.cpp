@@ -0,0 +1,126 @@
+#include "simulation.h"
+
+using std::chrono::steady_clock, std::chrono::duration, std::chrono::duration_cast;
+
+// how many random presses to scramble a new board with
+static const int SCRAMBLE_PRESSES = 10;
+// never run more than this many ticks to catch up after a stall, drop the rest instead
+static const int MAX_CATCH_UP_TICKS = 8;
+
+// builds the state a new game starts in
+static GameState newGame(int cols, int rows) {
+    GameState game;
+    game.rng.seed(std::random_device{}());
+    game.board = Board(cols, rows);
+    game.board.scramble(SCRAMBLE_PRESSES, game.rng);
+    return game;
+}
+
+// every snapshot slot starts as a copy of the real state, so publishing never has to allocate
+Simulation::Simulation(int cols, int rows)
+    : game(newGame(cols, rows)), published(game) {}
+
+Simulation::Simulation(const GameState &resume)
+    : game(resume), published(game) {}
+
+Simulation::~Simulation() {
+    stop();
+}
+
+void Simulation::start() {
+    if (running.exchange(true))
+        return;
+    thread = std::thread(&Simulation::run, this);
+}
+
+void Simulation::stop() {
+    running = false;
+    if (thread.joinable())
+        thread.join();
+}
+
+bool Simulation::submit(const GameCommand &command) {
+    return commands.push(command);
+}
+
+void Simulation::run() {
+    const auto step = duration_cast<steady_clock::duration>(duration<double>(DT));
+    auto next = steady_clock::now();
+
+    while (running.load(std::memory_order_acquire)) {
+        auto now = steady_clock::now();
+        int ticks = 0;
+        while (next <= now && ticks < MAX_CATCH_UP_TICKS) {
+            tick();
+            next += step;
+            ++ticks;
+        }
+        // we fell too far behind (e.g. the process was suspended), so don't try to replay it all
+        if (ticks == MAX_CATCH_UP_TICKS)
+            next = now + step;
+        if (ticks > 0)
+            publish();
+
+        std::this_thread::sleep_until(next);
+    }
+}
+
+void Simulation::tick() {
+    GameCommand command;
+    while (commands.pop(command))
+        apply(command);
+
+    game.tick++;
+    game.simTime = game.tick * DT;
+    clockTime now = tickTime(game.tick);
+
+    if (game.screen == state::play) {
+        // the timer stops with the last light
+        if (game.board.litCount() == 0) {
+            game.screen = state::over;
+            game.clock.pause(now);
+            game.changes++;
+        }
+        game.elapsed = game.clock.getElapsed(now);
+    }
+}
+
+void Simulation::apply(const GameCommand &command) {
+    switch (command.type) {
+        case GameCommand::startGame: {
+            if (game.screen == state::start) {
+                game.screen = state::play;
+                game.clock.reset(tickTime(game.tick));
+                game.changes++;
+            }
+            break;
+        }
+        case GameCommand::togglePause: {
+            if (game.screen != state::play)
+                break;
+            game.paused = !game.paused;
+            if (game.paused)
+                game.clock.pause(tickTime(game.tick));
+            else
+                game.clock.resume(tickTime(game.tick));
+            game.changes++;
+            break;
+        }
+        case GameCommand::pressCell: {
+            if (game.screen != state::play || game.paused || command.cell < 0 || command.cell >= game.board.getCellCount())
+                break;
+            game.board.press(command.cell);
+            game.clicks++;
+            game.lastPressed = command.cell;
+            game.lastPressTime = game.simTime;
+            game.changes++;
+            break;
+        }
+    }
+}
+
+void Simulation::publish() {
+    game.publishedAt = steady_clock::now();
+    published.back() = game;
+    published.publish();
+}
@@ -0,0 +1,76 @@
+#ifndef GRAPHICS_SIMULATION_H
+#define GRAPHICS_SIMULATION_H
+
+#include <atomic>
+#include <thread>
+#include "gameClock.h"
+#include "gameState.h"
+#include "../util/spscQueue.h"
+#include "../util/tripleBuffer.h"
+
+/**
+ * @brief Runs the game logic on its own thread at a fixed tick rate.
+ * @details Input arrives as GameCommands through a lock-free queue and every tick's
+ *          result is published as a GameState snapshot through a lock-free triple buffer,
+ *          so a slow frame never holds up the game logic and a slow tick never holds up a frame.
+ */
+class Simulation {
+    public:
+        /// @brief Ticks per second
+        static constexpr double TICK_RATE = 120.0;
+        /// @brief Seconds per tick
+        static constexpr double DT = 1.0 / TICK_RATE;
+
+        /// @brief The clock time of a tick, worked out from the tick count so it never drifts
+        static clockTime tickTime(uint64_t tick) {
+            return static_cast<clockTime>(tick) * GameClock::SECOND / static_cast<clockTime>(TICK_RATE);
+        }
+
+        /// @brief Construct a simulation with a freshly scrambled board
+        /// @param cols number of columns on the board
+        /// @param rows number of rows on the board
+        Simulation(int cols, int rows);
+
+        /// @brief Construct a simulation that carries on from a saved state (e.g. a SessionSnapshot)
+        explicit Simulation(const GameState &resume);
+
+        /// @brief Stops the simulation thread if it is running
+        ~Simulation();
+
+        /// @brief Starts the simulation thread
+        void start();
+
+        /// @brief Stops and joins the simulation thread
+        void stop();
+
+        /// @brief Queues a command for the next tick (input thread only)
+        /// @return false if the queue is full and the command was dropped
+        bool submit(const GameCommand &command);
+
+        /// @brief Snapshots published by the simulation (read with update()/front() on the render thread)
+        TripleBuffer<GameState> &snapshots() { return published; }
+
+    private:
+        /// @brief The authoritative state, only touched by the simulation thread
+        GameState game;
+
+        SpscQueue<GameCommand, 256> commands;
+        TripleBuffer<GameState> published;
+
+        std::thread thread;
+        std::atomic<bool> running{false};
+
+        /// @brief The simulation thread's loop
+        void run();
+
+        /// @brief Advances the game by one fixed step
+        void tick();
+
+        /// @brief Applies a single player command
+        void apply(const GameCommand &command);
+
+        /// @brief Copies the current state into the triple buffer and hands it to the reader
+        void publish();
+};
+
+#endif //GRAPHICS_SIMULATION_H
@@ -0,0 +1,57 @@
+#include "camera.h"
+#include <glm/gtc/matrix_transform.hpp>
+
+Camera::Camera(vec2 viewport) : viewport(viewport), center(viewport * 0.5f) {}
+
+void Camera::setViewport(vec2 viewport) {
+    this->viewport = viewport;
+}
+
+void Camera::setZoom(float zoom) {
+    this->zoom = glm::clamp(zoom, minZoom, maxZoom);
+}
+
+void Camera::setZoomLimits(float minZoom, float maxZoom) {
+    this->minZoom = minZoom;
+    this->maxZoom = maxZoom;
+    setZoom(zoom);
+}
+
+void Camera::pan(vec2 screenDelta) {
+    // dragging the world to the right moves the camera to the left
+    center -= screenDelta / zoom;
+}
+
+void Camera::zoomAt(vec2 screenPoint, float factor) {
+    vec2 before = screenToWorld(screenPoint);
+    setZoom(zoom * factor);
+    vec2 after = screenToWorld(screenPoint);
+    // shift so the point under the cursor didn't move
+    center += before - after;
+}
+
+void Camera::fit(const Bounds &bounds, float maxZoom) {
+    vec2 extent = bounds.max - bounds.min;
+    center = (bounds.min + bounds.max) * 0.5f;
+    setZoom(glm::min(maxZoom, glm::min(viewport.x / extent.x, viewport.y / extent.y)));
+}
+
+mat4 Camera::getView() const {
+    // move center to the origin, scale by zoom, then move the origin to the middle of the viewport
+    mat4 view = glm::translate(mat4(1.0f), glm::vec3(viewport * 0.5f, 0.0f));
+    view = glm::scale(view, glm::vec3(zoom, zoom, 1.0f));
+    return glm::translate(view, glm::vec3(-center, 0.0f));
+}
+
+vec2 Camera::screenToWorld(vec2 screenPoint) const {
+    return center + (screenPoint - viewport * 0.5f) / zoom;
+}
+
+vec2 Camera::worldToScreen(vec2 worldPoint) const {
+    return (worldPoint - center) * zoom + viewport * 0.5f;
+}
+
+Bounds Camera::getVisibleBounds() const {
+    vec2 half = viewport * 0.5f / zoom;
+    return {center - half, center + half};
+}
@@ -0,0 +1,67 @@
+#ifndef GRAPHICS_CAMERA_H
+#define GRAPHICS_CAMERA_H
+
+#include "glm/glm.hpp"
+#include "../util/bounds.h"
+
+using glm::vec2, glm::mat4;
+
+/**
+ * @brief A 2D camera that pans and zooms over the world.
+ * @details Screen space is in window pixels with the origin in the bottom left corner (the space
+ *          the projection maps to clip space, and the one text is drawn in). The camera's view
+ *          matrix maps world space to screen space: the world point at center ends up in the middle
+ *          of the viewport, scaled by zoom (screen pixels per world unit).
+ */
+class Camera {
+    public:
+        /// @brief Creates a camera looking at the middle of the viewport at zoom 1 (world = screen)
+        /// @param viewport The size of the window in pixels
+        explicit Camera(vec2 viewport);
+
+        /// @brief Changes the size of the viewport (e.g. after the window was resized)
+        /// @details The world point in the middle of the screen stays there.
+        void setViewport(vec2 viewport);
+        vec2 getViewport() const { return viewport; }
+
+        /// @brief Looks at a world position
+        void setCenter(vec2 center) { this->center = center; }
+        vec2 getCenter() const { return center; }
+
+        /// @brief Sets the zoom (clamped to the zoom limits)
+        void setZoom(float zoom);
+        float getZoom() const { return zoom; }
+
+        /// @brief Limits how far the camera can zoom out and in
+        void setZoomLimits(float minZoom, float maxZoom);
+
+        /// @brief Moves the view by a distance in screen pixels (e.g. a mouse drag)
+        void pan(vec2 screenDelta);
+
+        /// @brief Zooms by factor while keeping the world point under screenPoint in place
+        void zoomAt(vec2 screenPoint, float factor);
+
+        /// @brief Centers on bounds and zooms so all of it is visible (never zooming past maxZoom)
+        void fit(const Bounds &bounds, float maxZoom = 1.0f);
+
+        /// @brief The matrix that maps world space to screen space
+        mat4 getView() const;
+
+        /// @brief Converts a point in screen pixels to world space
+        vec2 screenToWorld(vec2 screenPoint) const;
+
+        /// @brief Converts a point in world space to screen pixels
+        vec2 worldToScreen(vec2 worldPoint) const;
+
+        /// @brief The part of the world that is currently on screen
+        Bounds getVisibleBounds() const;
+
+    private:
+        vec2 viewport;
+        vec2 center;
+        float zoom = 1.0f;
+        float minZoom = 1.0f / 1024.0f;
+        float maxZoom = 16.0f;
+};
+
+#endif //GRAPHICS_CAMERA_H
@@ -0,0 +1,114 @@
+#include "framePacer.h"
+#include <GLFW/glfw3.h>
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+// woken this long before the frame is expected to need to start, for the OS scheduler's sake
+static const double WAKE_MARGIN = 0.0005;
+// sleeping is only precise to about a millisecond, the rest of the wait spins
+static const double SPIN_TIME = 0.0015;
+// how long fence throttling waits for the GPU at most (nanoseconds)
+static const GLuint64 FENCE_TIMEOUT = 100000000;
+
+void LatencyStats::add(double seconds) {
+    samples[next] = seconds;
+    next = (next + 1) % SAMPLES;
+    count = std::min(count + 1, SAMPLES);
+    last = seconds;
+}
+
+double LatencyStats::getAverage() const {
+    double sum = 0;
+    for (size_t i = 0; i < count; ++i)
+        sum += samples[i];
+    return count > 0 ? sum / count : 0;
+}
+
+double LatencyStats::getMax() const {
+    return count > 0 ? *std::max_element(samples, samples + count) : 0;
+}
+
+FramePacer::~FramePacer() {
+    if (fence != nullptr)
+        glDeleteSync(fence);
+}
+
+void FramePacer::release() {
+    if (fence != nullptr)
+        glDeleteSync(fence);
+    fence = nullptr;
+    throttle = noThrottle;
+}
+
+void FramePacer::setMode(presentMode mode, throttleMode throttle) {
+    this->mode = mode;
+    this->throttle = throttle;
+    glfwSwapInterval(mode == vsync ? 1 : 0);
+    if (throttle != fenceThrottle && fence != nullptr) {
+        glDeleteSync(fence);
+        fence = nullptr;
+    }
+    deadline = 0;
+    // the numbers of the old mode say nothing about the new one
+    inputLatency.clear();
+}
+
+void FramePacer::setRefreshRate(double hz) {
+    period = 1.0 / std::clamp(hz, 24.0, 1000.0);
+}
+
+void FramePacer::waitForFrame() {
+    if (mode == lowLatency) {
+        double now = glfwGetTime();
+        // a missed deadline isn't caught up on, pacing starts over from now
+        if (deadline <= now)
+            deadline = now + period;
+
+        double wake = deadline - workEstimate - WAKE_MARGIN;
+        if (wake - now > SPIN_TIME)
+            std::this_thread::sleep_for(std::chrono::duration<double>(wake - now - SPIN_TIME));
+        while (glfwGetTime() < wake)
+            std::this_thread::yield();
+    }
+
+    // input is polled right after this
+    frameStart = glfwGetTime();
+    if (lastPoll > 0)
+        pollInterval = frameStart - lastPoll;
+    lastPoll = frameStart;
+}
+
+void FramePacer::inputArrived(double time) {
+    if (pendingInput < 0)
+        pendingInput = time;
+}
+
+void FramePacer::presented() {
+    if (throttle == finishThrottle) {
+        glFinish();
+    }
+    else if (throttle == fenceThrottle) {
+        // wait for the previous frame, so there's never more than this one queued
+        GLsync current = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        if (fence != nullptr) {
+            glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, FENCE_TIMEOUT);
+            glDeleteSync(fence);
+        }
+        fence = current;
+    }
+
+    presentTime = glfwGetTime();
+    frameWork = presentTime - frameStart;
+    // follow slower frames right away and faster ones slowly, a late frame costs more than an early one
+    workEstimate = std::max(frameWork, workEstimate - period * 0.01);
+    workEstimate = std::min(workEstimate, period);
+    if (mode == lowLatency && deadline > 0)
+        deadline += period;
+
+    if (pendingInput >= 0) {
+        inputLatency.add(presentTime - pendingInput);
+        pendingInput = -1;
+    }
+}
@@ -0,0 +1,113 @@
+#ifndef GRAPHICS_FRAMEPACER_H
+#define GRAPHICS_FRAMEPACER_H
+
+#include <glad/glad.h>
+#include <cstddef>
+
+/// @brief How frames are presented
+enum presentMode {vsync, lowLatency};
+/// @brief How far the CPU may run ahead of the GPU
+enum throttleMode {noThrottle, fenceThrottle, finishThrottle};
+
+/// @brief Latency samples over the last couple of seconds (in seconds)
+class LatencyStats {
+    public:
+        static const size_t SAMPLES = 128;
+
+        void add(double seconds);
+        void clear() { count = next = 0; last = 0; }
+
+        size_t getCount() const { return count; }
+        double getLast() const { return last; }
+        double getAverage() const;
+        double getMax() const;
+
+    private:
+        double samples[SAMPLES] = {};
+        size_t count = 0, next = 0;
+        double last = 0;
+};
+
+/**
+ * @brief Decides when each frame starts and measures how long input takes to reach the screen.
+ * @details In vsync mode glfwSwapBuffers() blocks until the next refresh, so input polled at the
+ *          start of a frame is up to a frame old by the time it is shown, plus whatever frames the
+ *          driver has queued. In low latency mode the swap interval is 0 and the pacer sleeps
+ *          instead, until just before the next refresh is due (less the time recent frames took),
+ *          so input is polled as late as possible. Either mode can throttle the CPU after the swap:
+ *          with a fence it waits for the previous frame, so at most one frame is queued, and with
+ *          glFinish it waits for the current one.
+ *
+ *          Input latency is measured from the moment an event is handed to the game to the moment
+ *          the swap (and throttle) of the frame that processed it returns. GLFW doesn't say when the
+ *          OS got the event, so events waiting for the next poll add up to getPollInterval() on top.
+ *
+ * Usage per frame:
+ * @code
+ * pacer.waitForFrame();
+ * glfwPollEvents();     // the callbacks call pacer.inputArrived(glfwGetTime())
+ * // ... update and render ...
+ * glfwSwapBuffers(window);
+ * pacer.presented();
+ * @endcode
+ */
+class FramePacer {
+    public:
+        FramePacer() = default;
+        /// @brief Deletes the pending fence, unless release() already did
+        ~FramePacer();
+
+        FramePacer(const FramePacer &) = delete;
+        FramePacer &operator=(const FramePacer &) = delete;
+
+        /// @brief Deletes the pending fence and stops throttling, while the context is still current
+        ///        (the destructor has nothing left to do then)
+        void release();
+
+        /// @brief Switches modes (sets the swap interval, so the context must be current)
+        void setMode(presentMode mode, throttleMode throttle);
+        presentMode getMode() const { return mode; }
+        throttleMode getThrottle() const { return throttle; }
+
+        /// @brief The display's refresh rate, which low latency mode paces to
+        void setRefreshRate(double hz);
+        double getRefreshRate() const { return 1.0 / period; }
+
+        /// @brief Sleeps until it's time to start the next frame (call right before polling input)
+        void waitForFrame();
+        /// @brief Stamps an input event (call from the GLFW input callbacks)
+        void inputArrived(double time);
+        /// @brief Throttles and finishes the latency samples (call right after glfwSwapBuffers())
+        void presented();
+
+        /// @brief When the last presented() returned (glfwGetTime() seconds)
+        double getPresentTime() const { return presentTime; }
+        /// @brief Event to swap completion
+        const LatencyStats &getInputLatency() const { return inputLatency; }
+        /// @brief How long the last frame took from waking up to its swap completing
+        double getFrameWork() const { return frameWork; }
+        /// @brief Time between input polls, how long an event can wait before it's handed to the game
+        double getPollInterval() const { return pollInterval; }
+
+    private:
+        presentMode mode = vsync;
+        throttleMode throttle = noThrottle;
+        double period = 1.0 / 60.0;
+
+        /// @brief When the next frame should be on screen (low latency mode), 0 if not known
+        double deadline = 0;
+        /// @brief How long a frame is expected to take, decays slowly after a slow frame
+        double workEstimate = 0;
+        double frameStart = 0, frameWork = 0;
+        double lastPoll = 0, pollInterval = 0;
+        double presentTime = 0;
+
+        /// @brief The oldest event not yet on screen, or a negative value if there is none
+        double pendingInput = -1;
+        LatencyStats inputLatency;
+
+        /// @brief The previous frame's fence (fence throttling)
+        GLsync fence = nullptr;
+};
+
+#endif //GRAPHICS_FRAMEPACER_H
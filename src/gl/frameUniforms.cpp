@@ -0,0 +1,21 @@
+#include "frameUniforms.h"
+#include "glState.h"
+
+#include <cstring>
+
+FrameUniforms::FrameUniforms() {
+    UBO = GLBuffer::create();
+    GLState::bindBuffer(GL_UNIFORM_BUFFER, UBO.get());
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameConstants), &current, GL_DYNAMIC_DRAW);
+    UBO.setBytes(sizeof(FrameConstants));
+    // the binding point never changes, so this is the only time it's set
+    GLState::bindBufferBase(GL_UNIFORM_BUFFER, BINDING, UBO.get());
+}
+
+void FrameUniforms::update(const FrameConstants &constants) {
+    if (std::memcmp(&constants, &current, sizeof(FrameConstants)) == 0)
+        return;
+    current = constants;
+    GLState::bindBuffer(GL_UNIFORM_BUFFER, UBO.get());
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(FrameConstants), &current);
+}
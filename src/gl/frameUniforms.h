@@ -0,0 +1,64 @@
+#ifndef GRAPHICS_FRAMEUNIFORMS_H
+#define GRAPHICS_FRAMEUNIFORMS_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include "gpuResource.h"
+
+/**
+ * @brief Per-frame constants shared by every shader.
+ * @details Mirrors the std140 "Frame" uniform block declared in the shaders:
+ * @code
+ * layout (std140) uniform Frame {
+ *     mat4 projection;
+ *     mat4 view;
+ *     vec4 viewport;
+ *     vec2 hover;
+ *     float time;
+ * };
+ * @endcode
+ */
+struct FrameConstants {
+    /// @brief Orthographic projection from screen space (window pixels) to clip space
+    glm::mat4 projection;
+    /// @brief The camera's world to screen space transform
+    glm::mat4 view;
+    /// @brief The viewport rectangle in pixels (x, y, width, height)
+    glm::vec4 viewport;
+    /// @brief Mouse position in world space
+    glm::vec2 hover;
+    /// @brief Seconds since the game started
+    float time;
+    float padding;
+};
+static_assert(sizeof(FrameConstants) == 160, "FrameConstants must match the std140 layout of the Frame block");
+
+/**
+ * @brief A uniform buffer holding the FrameConstants, bound once to a fixed binding point.
+ * @details Shaders pick it up through their "Frame" block (ShaderManager binds the block of every
+ *          shader it loads), so the projection and friends are uploaded once per frame in total
+ *          instead of once per shader or per draw.
+ */
+class FrameUniforms {
+    public:
+        /// @brief The uniform buffer binding point the Frame block is attached to
+        static const GLuint BINDING = 0;
+        /// @brief The name of the uniform block in the shaders
+        static constexpr const char *BLOCK_NAME = "Frame";
+
+        /// @brief Creates the uniform buffer and attaches it to BINDING
+        FrameUniforms();
+
+        /// @brief Uploads the constants for this frame (skipped if nothing changed)
+        /// @note Call at most once per frame, before drawing
+        void update(const FrameConstants &constants);
+
+        /// @brief The constants most recently uploaded
+        const FrameConstants &get() const { return current; }
+
+    private:
+        GLBuffer UBO;
+        FrameConstants current{};
+};
+
+#endif //GRAPHICS_FRAMEUNIFORMS_H
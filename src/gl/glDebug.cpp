@@ -0,0 +1,187 @@
+#include "glDebug.h"
+#include "../util/log.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#if DARTS_GL_DEBUG
+
+// how much of a message goes into one log line (the log copies at most ~150 characters per message)
+static const size_t CHUNK = 120;
+
+static bool callbackInstalled = false;
+static bool installed = false;
+
+// the last GL_CALL on each thread, the callback runs inside it (synchronous output)
+static thread_local const char *markCall = nullptr;
+static thread_local const char *markFile = nullptr;
+static thread_local int markLine = 0;
+
+// how often each message was seen, by a hash of it (the driver may call back from its own threads)
+static std::mutex seenMutex;
+static std::unordered_map<uint64_t, unsigned long> seen;
+static unsigned long messages = 0, suppressed = 0;
+
+static const char *sourceName(GLenum source) {
+    switch (source) {
+        case GL_DEBUG_SOURCE_API: return "API";
+        case GL_DEBUG_SOURCE_WINDOW_SYSTEM: return "window system";
+        case GL_DEBUG_SOURCE_SHADER_COMPILER: return "shader compiler";
+        case GL_DEBUG_SOURCE_THIRD_PARTY: return "third party";
+        case GL_DEBUG_SOURCE_APPLICATION: return "application";
+        default: return "other";
+    }
+}
+
+static const char *typeName(GLenum type) {
+    switch (type) {
+        case GL_DEBUG_TYPE_ERROR: return "error";
+        case GL_DEBUG_TYPE_DEPRECATED_BEHAVIOR: return "deprecated behavior";
+        case GL_DEBUG_TYPE_UNDEFINED_BEHAVIOR: return "undefined behavior";
+        case GL_DEBUG_TYPE_PORTABILITY: return "portability";
+        case GL_DEBUG_TYPE_PERFORMANCE: return "performance";
+        default: return "other";
+    }
+}
+
+static const char *errorName(GLenum error) {
+    switch (error) {
+        case GL_INVALID_ENUM: return "INVALID_ENUM";
+        case GL_INVALID_VALUE: return "INVALID_VALUE";
+        case GL_INVALID_OPERATION: return "INVALID_OPERATION";
+        case GL_STACK_OVERFLOW: return "STACK_OVERFLOW";
+        case GL_STACK_UNDERFLOW: return "STACK_UNDERFLOW";
+        case GL_OUT_OF_MEMORY: return "OUT_OF_MEMORY";
+        case GL_INVALID_FRAMEBUFFER_OPERATION: return "INVALID_FRAMEBUFFER_OPERATION";
+        default: return "unknown error";
+    }
+}
+
+// FNV-1a, so a repeated message is counted without building a key string
+static const uint64_t FNV_BASIS = 14695981039346656037ull;
+
+static uint64_t hash(std::string_view text, uint64_t h = FNV_BASIS) {
+    for (char c : text)
+        h = (h ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+    return h;
+}
+
+static uint64_t hash(uint64_t value, uint64_t h) {
+    return hash(std::string_view(reinterpret_cast<const char *>(&value), sizeof(value)), h);
+}
+
+// counts a message, returns how many times it was seen or 0 if this repeat shouldn't be logged
+static unsigned long count(uint64_t key) {
+    std::lock_guard<std::mutex> lock(seenMutex);
+    messages++;
+    unsigned long n = ++seen[key];
+    // 1, 10, 100, 1000, ...
+    unsigned long power = 1;
+    while (power < n)
+        power *= 10;
+    if (power != n) {
+        suppressed++;
+        return 0;
+    }
+    return n;
+}
+
+// logs a message with the location of the last GL_CALL, split over several lines if it's long
+// (the severity is only known at run time, so this goes to Log::write instead of the LOG_* macros)
+static void report(logSeverity severity, const char *what, std::string_view message, unsigned long times) {
+    const char *call = markCall != nullptr ? markCall : "(unchecked call)";
+    const char *file = markFile != nullptr ? markFile : "?";
+    if (times > 1) {
+        Log::write(severity, "GL", "{} seen {} times, last in {} at {}:{}", what, times, call, file, markLine);
+        return;
+    }
+    Log::write(severity, "GL", "{} in {} at {}:{}", what, call, file, markLine);
+    for (size_t start = 0; start < message.size(); start += CHUNK)
+        Log::write(severity, "GL", "  {}", message.substr(start, CHUNK));
+}
+
+static void APIENTRY callback(GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length,
+                              const GLchar *message, const void *) {
+    std::string_view text(message, length >= 0 ? static_cast<size_t>(length) : std::char_traits<char>::length(message));
+    unsigned long times = count(hash(text, hash(id, hash(type, hash(source, FNV_BASIS)))));
+    if (times == 0)
+        return;
+
+    logSeverity level = severity == GL_DEBUG_SEVERITY_HIGH || type == GL_DEBUG_TYPE_ERROR ? logError
+                      : severity == GL_DEBUG_SEVERITY_MEDIUM ? logWarning : logInfo;
+    char what[64];
+    std::snprintf(what, sizeof(what), "%s %s %u", sourceName(source), typeName(type), id);
+    report(level, what, text, times);
+}
+
+void GLDebug::install() {
+    if (installed)
+        return;
+    installed = true;
+
+    if (glDebugMessageCallback != nullptr) {
+        // KHR_debug or GL 4.3
+        glEnable(GL_DEBUG_OUTPUT);
+        glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+        glDebugMessageCallback(callback, nullptr);
+        // notifications (e.g. "buffer will use video memory") are just noise
+        glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DEBUG_SEVERITY_NOTIFICATION, 0, nullptr, GL_FALSE);
+        callbackInstalled = true;
+    }
+    else if (glDebugMessageCallbackARB != nullptr) {
+        // ARB_debug_output has no notifications and is always on once a callback is set
+        glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS_ARB);
+        glDebugMessageCallbackARB(callback, nullptr);
+        callbackInstalled = true;
+    }
+    LOG_INFO("GL", "Error reporting: {}", callbackInstalled ? "debug output callback" : "polling glGetError");
+}
+
+bool GLDebug::hasCallback() {
+    return callbackInstalled;
+}
+
+void GLDebug::mark(const char *call, const char *file, int line) {
+    markCall = call;
+    markFile = file;
+    markLine = line;
+}
+
+void GLDebug::check() {
+    if (callbackInstalled || !installed)
+        return;
+    // fallback: ask the driver, which waits for it to catch up
+    GLenum error;
+    while ((error = glGetError()) != GL_NO_ERROR) {
+        const char *name = errorName(error);
+        unsigned long times = count(hash(static_cast<uint64_t>(markLine), hash(markFile != nullptr ? markFile : "", hash(name))));
+        if (times != 0)
+            report(logError, name, std::string_view(), times);
+    }
+}
+
+unsigned long GLDebug::getMessageCount() {
+    std::lock_guard<std::mutex> lock(seenMutex);
+    return messages;
+}
+
+unsigned long GLDebug::getSuppressedCount() {
+    std::lock_guard<std::mutex> lock(seenMutex);
+    return suppressed;
+}
+
+#else
+
+// release builds: nothing is checked
+void GLDebug::install() {}
+bool GLDebug::hasCallback() { return false; }
+void GLDebug::mark(const char *, const char *, int) {}
+void GLDebug::check() {}
+unsigned long GLDebug::getMessageCount() { return 0; }
+unsigned long GLDebug::getSuppressedCount() { return 0; }
+
+#endif
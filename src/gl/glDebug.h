@@ -0,0 +1,59 @@
+#ifndef GRAPHICS_GLDEBUG_H
+#define GRAPHICS_GLDEBUG_H
+
+#include <glad/glad.h>
+
+// GL error reporting is compiled in for debug builds and compiled out for release builds,
+// define DARTS_GL_DEBUG as 0 or 1 to choose yourself.
+#ifndef DARTS_GL_DEBUG
+#ifdef NDEBUG
+#define DARTS_GL_DEBUG 0
+#else
+#define DARTS_GL_DEBUG 1
+#endif
+#endif
+
+/**
+ * @brief Reports GL errors and driver warnings through the log, with where they happened.
+ * @details With KHR_debug (core in GL 4.3) or ARB_debug_output the driver calls back whenever something
+ *          goes wrong, so checked calls cost nothing but remembering where they are. Output is
+ *          synchronous, so the callback runs inside the offending call and the location is exact.
+ *          Without either extension it falls back to polling glGetError after every checked call,
+ *          which waits for the driver each time.
+ *
+ *          The same message (same source, type, id and text) is only logged the first time and then
+ *          again after 10, 100, 1000, ... repeats, so an error in the frame loop doesn't flood the log.
+ *
+ * Usage:
+ * @code
+ * GLDebug::install();                                      // once, after loading GL
+ * GL_CALL(glDrawArrays(GL_TRIANGLES, 0, count));           // a checked call
+ * @endcode
+ */
+class GLDebug {
+    public:
+        /// @brief Installs the debug callback, or sets up polling if the driver has no debug output
+        /// @note Needs a current context, and works best with a debug context (GLFW_OPENGL_DEBUG_CONTEXT)
+        static void install();
+
+        /// @brief True if the driver reports through the callback, false if errors are polled
+        static bool hasCallback();
+
+        /// @brief Remembers the call about to be made, for messages it causes (GL_CALL does this)
+        static void mark(const char *call, const char *file, int line);
+        /// @brief Polls glGetError if there's no callback (GL_CALL does this after the call)
+        static void check();
+
+        /// @brief Messages received so far, and how many of them were repeats that weren't logged
+        static unsigned long getMessageCount();
+        static unsigned long getSuppressedCount();
+};
+
+#if DARTS_GL_DEBUG
+/// @brief Makes a GL call, reporting any error it causes with the call's source location
+#define GL_CALL(call) do { GLDebug::mark(#call, __FILE__, __LINE__); call; GLDebug::check(); } while (0)
+#else
+#define GL_CALL(call) do { call; } while (0)
+#endif
+
+#endif //GRAPHICS_GLDEBUG_H
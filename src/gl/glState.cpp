@@ -0,0 +1,190 @@
+#include "glState.h"
+
+// number of texture units tracked (the GL minimum for fragment shaders)
+static const int MAX_TEXTURE_UNITS = 16;
+// sentinel for "we don't know what is bound"
+static const GLuint UNKNOWN = ~0u;
+static const GLenum UNKNOWN_ENUM = ~0u;
+
+/// @brief The tracker's view of the current context
+struct TrackedState {
+    GLuint program = UNKNOWN;
+    GLuint vertexArray = UNKNOWN;
+    GLuint arrayBuffer = UNKNOWN;
+    GLuint elementBuffer = UNKNOWN;
+    GLuint uniformBuffer = UNKNOWN;
+    GLuint framebuffer = UNKNOWN;
+    GLenum activeUnit = UNKNOWN_ENUM;
+    GLuint textures[MAX_TEXTURE_UNITS];
+    int blend = -1;
+    int programPointSize = -1;
+    GLenum blendSrc = UNKNOWN_ENUM, blendDst = UNKNOWN_ENUM;
+
+    TrackedState() {
+        for (GLuint &t : textures)
+            t = UNKNOWN;
+    }
+};
+
+static TrackedState state;
+static GLStats frameStats, previousFrameStats;
+
+// returns true (and counts an issued call) if cached differs from value, and updates the cache
+template <typename T>
+static bool changed(T &cached, T value) {
+    if (cached == value) {
+        frameStats.skipped++;
+        return false;
+    }
+    cached = value;
+    frameStats.issued++;
+    return true;
+}
+
+// the slot for a buffer target, or nullptr if the target isn't tracked
+static GLuint *bufferSlot(GLenum target) {
+    switch (target) {
+        case GL_ARRAY_BUFFER:         return &state.arrayBuffer;
+        case GL_ELEMENT_ARRAY_BUFFER: return &state.elementBuffer;
+        case GL_UNIFORM_BUFFER:       return &state.uniformBuffer;
+        default:                      return nullptr;
+    }
+}
+
+void GLState::useProgram(GLuint program) {
+    if (changed(state.program, program))
+        glUseProgram(program);
+}
+
+void GLState::bindVertexArray(GLuint vao) {
+    if (changed(state.vertexArray, vao)) {
+        glBindVertexArray(vao);
+        // each VAO remembers its own element buffer
+        state.elementBuffer = UNKNOWN;
+    }
+}
+
+void GLState::bindBuffer(GLenum target, GLuint buffer) {
+    GLuint *slot = bufferSlot(target);
+    if (slot == nullptr) {
+        frameStats.issued++;
+        glBindBuffer(target, buffer);
+    }
+    else if (changed(*slot, buffer)) {
+        glBindBuffer(target, buffer);
+    }
+}
+
+void GLState::bindBufferBase(GLenum target, GLuint index, GLuint buffer) {
+    // indexed bindings are set rarely (once per buffer), so they aren't cached
+    frameStats.issued++;
+    glBindBufferBase(target, index, buffer);
+    if (GLuint *slot = bufferSlot(target))
+        *slot = buffer;
+}
+
+void GLState::bindFramebuffer(GLuint framebuffer) {
+    if (changed(state.framebuffer, framebuffer))
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+}
+
+void GLState::activeTexture(GLenum unit) {
+    if (changed(state.activeUnit, unit))
+        glActiveTexture(unit);
+}
+
+void GLState::bindTexture(GLenum target, GLuint texture) {
+    int unit = state.activeUnit == UNKNOWN_ENUM ? -1 : static_cast<int>(state.activeUnit - GL_TEXTURE0);
+    // only 2D textures on known units are tracked
+    if (target != GL_TEXTURE_2D || unit < 0 || unit >= MAX_TEXTURE_UNITS) {
+        frameStats.issued++;
+        glBindTexture(target, texture);
+        // we don't know which unit that changed, so forget them all
+        if (target == GL_TEXTURE_2D) {
+            for (GLuint &t : state.textures)
+                t = UNKNOWN;
+        }
+        return;
+    }
+    if (changed(state.textures[unit], texture))
+        glBindTexture(target, texture);
+}
+
+void GLState::setBlend(bool enabled) {
+    if (changed(state.blend, enabled ? 1 : 0)) {
+        if (enabled)
+            glEnable(GL_BLEND);
+        else
+            glDisable(GL_BLEND);
+    }
+}
+
+void GLState::setProgramPointSize(bool enabled) {
+    if (changed(state.programPointSize, enabled ? 1 : 0)) {
+        if (enabled)
+            glEnable(GL_PROGRAM_POINT_SIZE);
+        else
+            glDisable(GL_PROGRAM_POINT_SIZE);
+    }
+}
+
+void GLState::blendFunc(GLenum sfactor, GLenum dfactor) {
+    if (state.blendSrc == sfactor && state.blendDst == dfactor) {
+        frameStats.skipped++;
+        return;
+    }
+    state.blendSrc = sfactor;
+    state.blendDst = dfactor;
+    frameStats.issued++;
+    glBlendFunc(sfactor, dfactor);
+}
+
+void GLState::forgetProgram(GLuint program) {
+    if (state.program == program)
+        state.program = UNKNOWN;
+}
+
+void GLState::forgetVertexArray(GLuint vao) {
+    if (state.vertexArray == vao) {
+        state.vertexArray = UNKNOWN;
+        state.elementBuffer = UNKNOWN;
+    }
+}
+
+void GLState::forgetBuffer(GLuint buffer) {
+    if (state.arrayBuffer == buffer)
+        state.arrayBuffer = UNKNOWN;
+    if (state.elementBuffer == buffer)
+        state.elementBuffer = UNKNOWN;
+    if (state.uniformBuffer == buffer)
+        state.uniformBuffer = UNKNOWN;
+}
+
+void GLState::forgetTexture(GLuint texture) {
+    for (GLuint &t : state.textures) {
+        if (t == texture)
+            t = UNKNOWN;
+    }
+}
+
+void GLState::forgetFramebuffer(GLuint framebuffer) {
+    if (state.framebuffer == framebuffer)
+        state.framebuffer = UNKNOWN;
+}
+
+void GLState::invalidate() {
+    state = TrackedState();
+}
+
+void GLState::beginFrame() {
+    previousFrameStats = frameStats;
+    frameStats = GLStats();
+}
+
+GLStats GLState::lastFrame() {
+    return previousFrameStats;
+}
+
+GLStats GLState::thisFrame() {
+    return frameStats;
+}
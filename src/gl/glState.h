@@ -0,0 +1,74 @@
+#ifndef GRAPHICS_GLSTATE_H
+#define GRAPHICS_GLSTATE_H
+
+#include <glad/glad.h>
+
+/// @brief How many state-changing GL calls were sent to the driver and how many were dropped
+struct GLStats {
+    unsigned int issued = 0;
+    unsigned int skipped = 0;
+};
+
+/**
+ * @brief Shadow copy of the OpenGL binding state that drops redundant calls.
+ * @details Every bind/use/enable in the renderer goes through here instead of calling GL directly.
+ *          If the requested state is already current the call is skipped, which matters a lot on
+ *          software and embedded drivers where every GL call is expensive.
+ *          All state is per context, and the game only has one.
+ * @note Anything that changes these bindings behind the tracker's back must call invalidate().
+ */
+class GLState {
+    public:
+        /// @brief glUseProgram
+        static void useProgram(GLuint program);
+
+        /// @brief glBindVertexArray
+        /// @details The element array binding is part of the VAO, so it is re-read from the new VAO's state.
+        static void bindVertexArray(GLuint vao);
+
+        /// @brief glBindBuffer
+        static void bindBuffer(GLenum target, GLuint buffer);
+
+        /// @brief glBindBufferBase (also sets the generic binding for target)
+        static void bindBufferBase(GLenum target, GLuint index, GLuint buffer);
+
+        /// @brief glBindFramebuffer(GL_FRAMEBUFFER), 0 for the window
+        static void bindFramebuffer(GLuint framebuffer);
+
+        /// @brief glActiveTexture
+        static void activeTexture(GLenum unit);
+
+        /// @brief glBindTexture on the active texture unit
+        static void bindTexture(GLenum target, GLuint texture);
+
+        /// @brief glEnable/glDisable(GL_BLEND)
+        static void setBlend(bool enabled);
+
+        /// @brief glEnable/glDisable(GL_PROGRAM_POINT_SIZE), points sized by the vertex shader
+        static void setProgramPointSize(bool enabled);
+
+        /// @brief glBlendFunc
+        static void blendFunc(GLenum sfactor, GLenum dfactor);
+
+        /// @brief Forgets a deleted object so a new object reusing its name gets bound again
+        /// @details GL silently unbinds objects when they are deleted.
+        static void forgetProgram(GLuint program);
+        static void forgetVertexArray(GLuint vao);
+        static void forgetBuffer(GLuint buffer);
+        static void forgetTexture(GLuint texture);
+        static void forgetFramebuffer(GLuint framebuffer);
+
+        /// @brief Forgets everything, so the next call of each kind is always issued
+        static void invalidate();
+
+        /// @brief Starts counting calls for a new frame
+        static void beginFrame();
+
+        /// @brief Calls issued and skipped during the previous frame
+        static GLStats lastFrame();
+
+        /// @brief Calls issued and skipped so far this frame
+        static GLStats thisFrame();
+};
+
+#endif //GRAPHICS_GLSTATE_H
@@ -0,0 +1,114 @@
+#include "gpuResource.h"
+#include "glState.h"
+
+#include <cstdio>
+
+static long counts[GPU_RESOURCE_TYPES] = {};
+static size_t bytes[GPU_RESOURCE_TYPES] = {};
+
+static const char *const TYPE_NAMES[GPU_RESOURCE_TYPES] = {"buffers", "vertex arrays", "textures", "programs", "framebuffers"};
+
+// e.g. "1.2 MB"
+static std::string formatBytes(size_t size) {
+    char text[32];
+    if (size >= 1024 * 1024)
+        std::snprintf(text, sizeof(text), "%.1f MB", size / (1024.0 * 1024.0));
+    else
+        std::snprintf(text, sizeof(text), "%.1f KB", size / 1024.0);
+    return text;
+}
+
+long GpuMemory::getCount(gpuResourceType type) {
+    return counts[type];
+}
+
+size_t GpuMemory::getBytes(gpuResourceType type) {
+    return bytes[type];
+}
+
+size_t GpuMemory::getTotalBytes() {
+    size_t total = 0;
+    for (size_t size : bytes)
+        total += size;
+    return total;
+}
+
+const char *GpuMemory::typeName(gpuResourceType type) {
+    return TYPE_NAMES[type];
+}
+
+std::string GpuMemory::report() {
+    std::string text;
+    for (int i = 0; i < GPU_RESOURCE_TYPES; ++i) {
+        text += std::string(TYPE_NAMES[i]) + ": " + std::to_string(counts[i]);
+        if (bytes[i] > 0)
+            text += " (" + formatBytes(bytes[i]) + ")";
+        text += "\n";
+    }
+    text += "total: " + formatBytes(getTotalBytes()) + "\n";
+    return text;
+}
+
+size_t GpuMemory::summary(char *text, size_t size) {
+    size_t total = getTotalBytes();
+    bool mega = total >= 1024 * 1024;
+    int written = std::snprintf(text, size, "gpu: %.1f %s buf %ld vao %ld tex %ld prog %ld fbo %ld",
+                                mega ? total / (1024.0 * 1024.0) : total / 1024.0, mega ? "MB" : "KB",
+                                counts[bufferResource], counts[vertexArrayResource],
+                                counts[textureResource], counts[programResource], counts[framebufferResource]);
+    if (written < 0)
+        return 0;
+    return static_cast<size_t>(written) < size ? static_cast<size_t>(written) : size - 1;
+}
+
+GLuint GpuMemory::create(gpuResourceType type) {
+    GLuint name = 0;
+    switch (type) {
+        case bufferResource: glGenBuffers(1, &name); break;
+        case vertexArrayResource: glGenVertexArrays(1, &name); break;
+        case textureResource: glGenTextures(1, &name); break;
+        case programResource: name = glCreateProgram(); break;
+        case framebufferResource: glGenFramebuffers(1, &name); break;
+        default: break;
+    }
+    return name;
+}
+
+void GpuMemory::destroy(gpuResourceType type, GLuint name) {
+    switch (type) {
+        case bufferResource:
+            glDeleteBuffers(1, &name);
+            GLState::forgetBuffer(name);
+            break;
+        case vertexArrayResource:
+            glDeleteVertexArrays(1, &name);
+            GLState::forgetVertexArray(name);
+            break;
+        case textureResource:
+            glDeleteTextures(1, &name);
+            GLState::forgetTexture(name);
+            break;
+        case programResource:
+            glDeleteProgram(name);
+            GLState::forgetProgram(name);
+            break;
+        case framebufferResource:
+            glDeleteFramebuffers(1, &name);
+            GLState::forgetFramebuffer(name);
+            break;
+        default: break;
+    }
+}
+
+void GpuMemory::added(gpuResourceType type) {
+    counts[type]++;
+}
+
+void GpuMemory::removed(gpuResourceType type, size_t size) {
+    counts[type]--;
+    bytes[type] -= size;
+}
+
+void GpuMemory::resized(gpuResourceType type, size_t oldBytes, size_t newBytes) {
+    bytes[type] = bytes[type] - oldBytes + newBytes;
+}
@@ -0,0 +1,127 @@
+#ifndef GRAPHICS_GPURESOURCE_H
+#define GRAPHICS_GPURESOURCE_H
+
+#include <glad/glad.h>
+#include <cstddef>
+#include <string>
+
+/// @brief The kinds of GL objects the game owns
+enum gpuResourceType {bufferResource, vertexArrayResource, textureResource, programResource, framebufferResource, GPU_RESOURCE_TYPES};
+
+/**
+ * @brief Counts the live GL objects of each kind and estimates how much GPU memory they hold.
+ * @details Every GpuHandle reports itself here when it creates, resizes or deletes its object, so a
+ *          session that runs for days can check that the numbers stay flat. The sizes are what the
+ *          game asked for (e.g. width * height * bytes per texel), not what the driver allocated.
+ * @note GL objects only live on the render thread, and so do these counters.
+ */
+class GpuMemory {
+    public:
+        /// @brief Live objects of a kind
+        static long getCount(gpuResourceType type);
+        /// @brief Estimated bytes held by the live objects of a kind
+        static size_t getBytes(gpuResourceType type);
+        /// @brief Estimated bytes held by all live objects
+        static size_t getTotalBytes();
+
+        /// @brief One line per kind, e.g. "textures: 129 (1.2 MB)"
+        static std::string report();
+        /// @brief The same on one line, for the stats overlay, written into text without allocating
+        /// @return the length written
+        static size_t summary(char *text, size_t size);
+
+        /// @brief Names of the kinds, e.g. "textures"
+        static const char *typeName(gpuResourceType type);
+
+        /// @brief Generates a new object of a kind (programs are created, the rest generated)
+        static GLuint create(gpuResourceType type);
+        /// @brief Deletes an object and forgets it in GLState
+        static void destroy(gpuResourceType type, GLuint name);
+
+        /// @brief Bookkeeping for GpuHandle
+        static void added(gpuResourceType type);
+        static void removed(gpuResourceType type, size_t bytes);
+        static void resized(gpuResourceType type, size_t oldBytes, size_t newBytes);
+};
+
+/**
+ * @brief Owns one GL object and deletes it when it goes away.
+ * @details Move-only, so every object has exactly one owner. Anything else that needs the object
+ *          keeps its name (get()) and must not outlive the handle.
+ *
+ * Usage:
+ * @code
+ * GLBuffer buffer = GLBuffer::create();
+ * GLState::bindBuffer(GL_ARRAY_BUFFER, buffer.get());
+ * glBufferData(GL_ARRAY_BUFFER, size, data, GL_STATIC_DRAW);
+ * buffer.setBytes(size);
+ * @endcode
+ */
+template <gpuResourceType TYPE>
+class GpuHandle {
+    public:
+        /// @brief An empty handle (owns nothing)
+        GpuHandle() = default;
+
+        /// @brief Takes ownership of an object created elsewhere (e.g. by glCreateProgram)
+        explicit GpuHandle(GLuint name) : name(name) {
+            if (name != 0)
+                GpuMemory::added(TYPE);
+        }
+
+        /// @brief Creates a new object
+        static GpuHandle create() { return GpuHandle(GpuMemory::create(TYPE)); }
+
+        ~GpuHandle() { reset(); }
+
+        GpuHandle(const GpuHandle &) = delete;
+        GpuHandle &operator=(const GpuHandle &) = delete;
+
+        GpuHandle(GpuHandle &&other) noexcept : name(other.name), bytes(other.bytes) {
+            other.name = 0;
+            other.bytes = 0;
+        }
+
+        GpuHandle &operator=(GpuHandle &&other) noexcept {
+            if (this != &other) {
+                reset();
+                name = other.name;
+                bytes = other.bytes;
+                other.name = 0;
+                other.bytes = 0;
+            }
+            return *this;
+        }
+
+        /// @brief Deletes the object (if any), leaving the handle empty
+        void reset() {
+            if (name == 0)
+                return;
+            GpuMemory::destroy(TYPE, name);
+            GpuMemory::removed(TYPE, bytes);
+            name = 0;
+            bytes = 0;
+        }
+
+        /// @brief Records how much memory the object's storage takes (call after glBufferData etc.)
+        void setBytes(size_t size) {
+            GpuMemory::resized(TYPE, bytes, size);
+            bytes = size;
+        }
+
+        GLuint get() const { return name; }
+        size_t getBytes() const { return bytes; }
+        explicit operator bool() const { return name != 0; }
+
+    private:
+        GLuint name = 0;
+        size_t bytes = 0;
+};
+
+typedef GpuHandle<bufferResource> GLBuffer;
+typedef GpuHandle<vertexArrayResource> GLVertexArray;
+typedef GpuHandle<textureResource> GLTexture;
+typedef GpuHandle<programResource> GLProgram;
+typedef GpuHandle<framebufferResource> GLFramebuffer;
+
+#endif //GRAPHICS_GPURESOURCE_H
@@ -0,0 +1,128 @@
+#include "streamBuffer.h"
+#include "glState.h"
+#include "glDebug.h"
+
+#include <cstring>
+
+StreamBuffer::StreamBuffer(GLsizeiptr regionSize) : regionSize(regionSize) {
+    createStorage();
+}
+
+StreamBuffer::~StreamBuffer() {
+    destroyStorage();
+}
+
+void StreamBuffer::createStorage() {
+    VBO = GLBuffer::create();
+    GLState::bindBuffer(GL_ARRAY_BUFFER, VBO.get());
+
+    GLsizeiptr size = regionSize * REGIONS;
+    if (glBufferStorage != nullptr) {
+        // map once and keep writing through the same pointer for the buffer's whole life
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        GL_CALL(glBufferStorage(GL_ARRAY_BUFFER, size, nullptr, flags));
+        persistent = static_cast<unsigned char *>(glMapBufferRange(GL_ARRAY_BUFFER, 0, size, flags));
+        if (persistent == nullptr) {
+            // immutable storage can't fall back to glBufferData, so start over with a new buffer
+            VBO = GLBuffer::create();
+            GLState::bindBuffer(GL_ARRAY_BUFFER, VBO.get());
+        }
+    }
+    if (persistent == nullptr)
+        GL_CALL(glBufferData(GL_ARRAY_BUFFER, size, nullptr, GL_STREAM_DRAW));
+    VBO.setBytes(size);
+}
+
+void StreamBuffer::destroyStorage() {
+    for (GLsync &fence : fences) {
+        if (fence != nullptr)
+            glDeleteSync(fence);
+        fence = nullptr;
+    }
+    if (persistent != nullptr) {
+        GLState::bindBuffer(GL_ARRAY_BUFFER, VBO.get());
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+        persistent = nullptr;
+    }
+    VBO.reset();
+}
+
+void StreamBuffer::beginFrame() {
+    region = (region + 1) % REGIONS;
+    used = 0;
+
+    GLsync &fence = fences[region];
+    if (fence == nullptr)
+        return;
+
+    // poll (timeout 0), never wait
+    GLenum status = glClientWaitSync(fence, 0, 0);
+    if (status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED) {
+        glDeleteSync(fence);
+        fence = nullptr;
+        return;
+    }
+
+    // The GPU is more than REGIONS - 1 frames behind and still reading this region.
+    // Rather than stall, give the buffer fresh storage and let the driver free the old one later.
+    orphans++;
+    if (persistent != nullptr) {
+        // immutable storage can't be re-specified, so make a new buffer
+        destroyStorage();
+        createStorage();
+    }
+    else {
+        for (GLsync &f : fences) {
+            if (f != nullptr)
+                glDeleteSync(f);
+            f = nullptr;
+        }
+        GLState::bindBuffer(GL_ARRAY_BUFFER, VBO.get());
+        GL_CALL(glBufferData(GL_ARRAY_BUFFER, regionSize * REGIONS, nullptr, GL_STREAM_DRAW));
+    }
+}
+
+void StreamBuffer::endFrame() {
+    if (fences[region] != nullptr)
+        glDeleteSync(fences[region]);
+    fences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+StreamBuffer::Allocation StreamBuffer::allocate(GLsizeiptr bytes, GLsizeiptr alignment) {
+    Allocation allocation;
+    GLsizeiptr start = (used + alignment - 1) / alignment * alignment;
+    if (bytes <= 0 || start + bytes > regionSize)
+        return allocation;
+
+    allocation.offset = region * regionSize + start;
+    allocation.size = bytes;
+    used = start + bytes;
+
+    if (persistent != nullptr) {
+        allocation.data = persistent + allocation.offset;
+    }
+    else {
+        // the fence already guarantees the GPU isn't reading this range, so skip the driver's sync
+        GLState::bindBuffer(GL_ARRAY_BUFFER, VBO.get());
+        allocation.data = glMapBufferRange(GL_ARRAY_BUFFER, allocation.offset, bytes,
+                                           GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+    }
+    return allocation;
+}
+
+void StreamBuffer::commit(const Allocation &allocation) {
+    // coherent persistent mappings are visible to the GPU as soon as they're written
+    if (persistent != nullptr || !allocation)
+        return;
+    GLState::bindBuffer(GL_ARRAY_BUFFER, VBO.get());
+    glUnmapBuffer(GL_ARRAY_BUFFER);
+}
+
+StreamBuffer::Allocation StreamBuffer::write(const void *data, GLsizeiptr bytes, GLsizeiptr alignment) {
+    Allocation allocation = allocate(bytes, alignment);
+    if (allocation) {
+        std::memcpy(allocation.data, data, bytes);
+        commit(allocation);
+    }
+    return allocation;
+}
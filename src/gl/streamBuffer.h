@@ -0,0 +1,100 @@
+#ifndef GRAPHICS_STREAMBUFFER_H
+#define GRAPHICS_STREAMBUFFER_H
+
+#include <glad/glad.h>
+#include <cstddef>
+#include "gpuResource.h"
+
+/**
+ * @brief A ring of per-frame regions in one big vertex buffer for geometry that changes every frame.
+ * @details Each frame writes into its own region, and a fence placed at the end of the frame says when
+ *          the GPU is done reading it, so writes never have to synchronise with draws still in flight.
+ *          When the driver supports it (GL 4.4 / ARB_buffer_storage) the buffer is mapped once,
+ *          persistently, and allocations are written in place. Otherwise each allocation is mapped
+ *          with GL_MAP_UNSYNCHRONIZED_BIT. If the GPU is ever still using the region we're about to
+ *          reuse, the buffer is orphaned (given fresh storage) instead of waiting for it.
+ *
+ * Usage per frame:
+ * @code
+ * stream.beginFrame();
+ * StreamBuffer::Allocation a = stream.allocate(bytes, stride);
+ * // ... write bytes to a.data ...
+ * stream.commit(a);
+ * // ... bind stream.getBuffer(), point attributes at a.offset and draw ...
+ * stream.endFrame();
+ * @endcode
+ */
+class StreamBuffer {
+    public:
+        /// @brief Number of frames that can be in flight at once
+        static const int REGIONS = 3;
+
+        /// @brief Space handed out by allocate()
+        struct Allocation {
+            /// @brief Where to write the data (null if the allocation failed)
+            void *data = nullptr;
+            /// @brief Byte offset of the data in getBuffer()
+            GLintptr offset = 0;
+            GLsizeiptr size = 0;
+
+            explicit operator bool() const { return data != nullptr; }
+        };
+
+        /// @brief Creates the buffer
+        /// @param regionSize bytes available to each frame
+        explicit StreamBuffer(GLsizeiptr regionSize);
+
+        /// @brief Deletes the buffer and any pending fences
+        ~StreamBuffer();
+
+        StreamBuffer(const StreamBuffer &) = delete;
+        StreamBuffer &operator=(const StreamBuffer &) = delete;
+
+        /// @brief Moves on to the next region, orphaning the buffer if the GPU still uses it
+        void beginFrame();
+
+        /// @brief Fences the current region so it isn't reused until the GPU is done with it
+        void endFrame();
+
+        /// @brief Reserves space in this frame's region
+        /// @details Only one allocation may be open (allocated but not committed) at a time.
+        /// @param bytes the number of bytes to reserve
+        /// @param alignment the offset is rounded up to a multiple of this (e.g. the vertex stride)
+        /// @return the allocation, or an empty allocation if the region is full
+        Allocation allocate(GLsizeiptr bytes, GLsizeiptr alignment = 16);
+
+        /// @brief Makes the data written to an allocation visible to the GPU
+        void commit(const Allocation &allocation);
+
+        /// @brief Copies data into this frame's region (allocate + memcpy + commit)
+        /// @return the allocation the data was written to (empty if the region is full)
+        Allocation write(const void *data, GLsizeiptr bytes, GLsizeiptr alignment = 16);
+
+        /// @brief The GL buffer object (can change when the buffer is orphaned, so don't cache it across frames)
+        GLuint getBuffer() const { return VBO.get(); }
+
+        /// @brief True if the buffer is persistently mapped
+        bool isPersistent() const { return persistent != nullptr; }
+
+        /// @brief Number of times the buffer had to be orphaned because the GPU fell behind
+        unsigned int getOrphanCount() const { return orphans; }
+
+    private:
+        GLBuffer VBO;
+        GLsizeiptr regionSize;
+        /// @brief Persistent mapping of the whole buffer (null if not supported)
+        unsigned char *persistent = nullptr;
+        GLsync fences[REGIONS] = {};
+        int region = 0;
+        /// @brief Bytes used in the current region
+        GLsizeiptr used = 0;
+        unsigned int orphans = 0;
+
+        /// @brief Allocates (or re-allocates) the buffer's storage
+        void createStorage();
+
+        /// @brief Frees the buffer's storage
+        void destroyStorage();
+};
+
+#endif //GRAPHICS_STREAMBUFFER_H
@@ -0,0 +1,64 @@
+#include "vertexFormat.h"
+
+#include <cstddef>
+#include <cstring>
+
+const VertexFormat TexturedVertex::FORMAT(sizeof(TexturedVertex), {
+    {0, 2, GL_FLOAT, false, offsetof(TexturedVertex, x)},
+    {1, 2, GL_UNSIGNED_SHORT, true, offsetof(TexturedVertex, u)},
+});
+
+VertexFormat::VertexFormat(GLsizei stride, std::initializer_list<VertexAttribute> attributes, GLuint divisor) :
+    stride(stride), divisor(divisor), attributes() {
+    for (const VertexAttribute &attribute : attributes) {
+        if (count < MAX_ATTRIBUTES)
+            this->attributes[count++] = attribute;
+    }
+}
+
+void VertexFormat::enable() const {
+    for (int i = 0; i < count; ++i) {
+        glEnableVertexAttribArray(attributes[i].location);
+        if (divisor != 0)
+            glVertexAttribDivisor(attributes[i].location, divisor);
+    }
+}
+
+void VertexFormat::point(GLintptr offset) const {
+    for (int i = 0; i < count; ++i) {
+        const VertexAttribute &a = attributes[i];
+        glVertexAttribPointer(a.location, a.components, a.type, a.normalized ? GL_TRUE : GL_FALSE, stride,
+                              reinterpret_cast<void *>(offset + a.offset));
+    }
+}
+
+uint16_t toHalf(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000);
+    int exponent = static_cast<int>((bits >> 23) & 0xff) - 127 + 15;
+    uint32_t mantissa = bits & 0x7fffff;
+
+    // NaN stays NaN, anything too big becomes infinity
+    if (((bits >> 23) & 0xff) == 0xff)
+        return static_cast<uint16_t>(sign | 0x7c00 | (mantissa != 0 ? 0x200 : 0));
+    if (exponent >= 31)
+        return static_cast<uint16_t>(sign | 0x7c00);
+    // too small even for a denormal
+    if (exponent < -10)
+        return sign;
+    if (exponent <= 0) {
+        // denormal: shift the mantissa (with its implicit 1) into place, rounding to nearest
+        mantissa |= 0x800000;
+        int shift = 14 - exponent;
+        uint32_t half = mantissa >> shift;
+        if ((mantissa >> (shift - 1)) & 1)
+            half++;
+        return static_cast<uint16_t>(sign | half);
+    }
+    uint32_t half = (static_cast<uint32_t>(exponent) << 10) | (mantissa >> 13);
+    // round to nearest (a carry into the exponent is still the right answer)
+    if (mantissa & 0x1000)
+        half++;
+    return static_cast<uint16_t>(sign | (half > 0x7c00 ? 0x7c00 : half));
+}
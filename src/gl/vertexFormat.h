@@ -0,0 +1,83 @@
+#ifndef GRAPHICS_VERTEXFORMAT_H
+#define GRAPHICS_VERTEXFORMAT_H
+
+#include <glad/glad.h>
+#include <cstdint>
+#include <initializer_list>
+
+/// @brief One attribute of a vertex (or instance) and how it's stored
+struct VertexAttribute {
+    /// @brief The shader's layout location
+    GLuint location;
+    /// @brief 1 to 4
+    GLint components;
+    /// @brief GL_FLOAT, GL_HALF_FLOAT, GL_SHORT, GL_UNSIGNED_SHORT, GL_UNSIGNED_BYTE, ...
+    GLenum type;
+    /// @brief Integer types are read as [0, 1] (unsigned) or [-1, 1] (signed) floats
+    bool normalized;
+    /// @brief Bytes from the start of the vertex
+    GLuint offset;
+};
+
+/**
+ * @brief Describes the layout of a vertex or instance struct for glVertexAttribPointer.
+ * @details The renderers use packed formats (16-bit positions and texture coordinates, half float
+ *          sizes, 8-bit colours) to cut the bytes uploaded every frame, and this keeps the attribute
+ *          setup for all of them in one place.
+ *
+ * Usage:
+ * @code
+ * // once, with the VAO bound
+ * format.enable();
+ * // per draw, with the buffer bound to GL_ARRAY_BUFFER
+ * format.point(allocation.offset);
+ * @endcode
+ */
+class VertexFormat {
+    public:
+        static const int MAX_ATTRIBUTES = 4;
+
+        /// @param stride size of one vertex (sizeof the struct)
+        /// @param divisor 0 for per-vertex data, 1 for per-instance data
+        VertexFormat(GLsizei stride, std::initializer_list<VertexAttribute> attributes, GLuint divisor = 0);
+
+        /// @brief Enables the attributes (and sets their divisor) in the bound VAO
+        void enable() const;
+
+        /// @brief Points the attributes at vertices starting offset bytes into the bound GL_ARRAY_BUFFER
+        void point(GLintptr offset) const;
+
+        GLsizei getStride() const { return stride; }
+
+    private:
+        GLsizei stride;
+        GLuint divisor;
+        VertexAttribute attributes[MAX_ATTRIBUTES];
+        int count = 0;
+};
+
+/// @brief A 2D vertex with texture coordinates (text glyphs, the board texture): 12 bytes instead of 16
+struct TexturedVertex {
+    float x, y;
+    /// @brief Normalized, 0 to 65535 is 0 to 1 (see toUnorm16())
+    uint16_t u, v;
+
+    static const VertexFormat FORMAT;
+};
+
+/// @brief Converts a float in [0, 1] to a normalized unsigned short
+inline uint16_t toUnorm16(float value) {
+    value = value < 0.0f ? 0.0f : value > 1.0f ? 1.0f : value;
+    return static_cast<uint16_t>(value * 65535.0f + 0.5f);
+}
+
+/// @brief Converts a float in [-1, 1] to a normalized signed short
+inline int16_t toSnorm16(float value) {
+    value = value < -1.0f ? -1.0f : value > 1.0f ? 1.0f : value;
+    return static_cast<int16_t>(value * 32767.0f + (value < 0 ? -0.5f : 0.5f));
+}
+
+/// @brief Converts a float to a 16-bit half float (rounded to nearest, out of range values become infinity)
+uint16_t toHalf(float value);
+
+#endif //GRAPHICS_VERTEXFORMAT_H
@@ -1,10 +1,80 @@
 #include "engine.h"
+#include "util/resources.h"
+#include "util/log.h"
 
-#include <iostream>
+#include <cstdio>
+#include <string>
 
 
 int main(int argc, char *argv[]) {
-    Engine engine;
+    // --resources <dir> loads shaders and fonts from disk instead of the embedded copies (for development)
+    // --board <cols>x<rows> (or --board <n> for n x n) plays on a bigger board, e.g. --board 2048
+    // --server <host:port | unix:path> scores an X01 match on a match server (F2 shows it)
+    // --detect <dir> scores the darts found in a recorded camera sequence (.pgm frames) on that match,
+    //   --calibration <file> maps the camera image onto the board (default <dir>/calibration.txt)
+    // --present <vsync | low-latency> --throttle <none | fence | finish> chooses how frames are presented (F3/F4 switch)
+    // --log <file> writes the log to a file (rotated every 4 MB) instead of stderr
+    // --throw-log <file> is where every dart scored on the match server is appended (default throws.bin, "" for none)
+    // --snapshot <file> is where the session is saved whenever it changes and resumed from on the next start
+    //   (default session.snap, "" for neither)
+    int cols = 5, rows = 5;
+    presentMode present = vsync;
+    throttleMode throttle = noThrottle;
+    std::string server, recording, calibration, throwLog = "throws.bin", snapshot = "session.snap";
+    LogConfig logConfig;
+    // reported once the log is started, so it goes where --log says
+    bool badBoard = false;
+    for (int i = 1; i + 1 < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--resources")
+            Resource::setOverrideDirectory(argv[++i]);
+        else if (arg == "--server")
+            server = argv[++i];
+        else if (arg == "--detect")
+            recording = argv[++i];
+        else if (arg == "--calibration")
+            calibration = argv[++i];
+        else if (arg == "--log")
+            logConfig.path = argv[++i];
+        else if (arg == "--throw-log")
+            throwLog = argv[++i];
+        else if (arg == "--snapshot")
+            snapshot = argv[++i];
+        else if (arg == "--present")
+            present = std::string(argv[++i]) == "low-latency" ? lowLatency : vsync;
+        else if (arg == "--throttle") {
+            std::string mode = argv[++i];
+            throttle = mode == "fence" ? fenceThrottle : mode == "finish" ? finishThrottle : noThrottle;
+        }
+        else if (arg == "--board") {
+            int matched = std::sscanf(argv[++i], "%dx%d", &cols, &rows);
+            if (matched == 1)
+                rows = cols;
+            if (matched < 1 || cols < 1 || rows < 1) {
+                badBoard = true;
+                cols = rows = 5;
+            }
+        }
+    }
+
+    // before anything can log
+    Log::start(logConfig);
+    if (badBoard)
+        LOG_ERROR("MAIN", "--board expects <cols>x<rows>, using 5x5");
+
+    Engine engine(cols, rows, snapshot);
+    engine.setPresentation(present, throttle);
+    if (!server.empty()) {
+        if (!throwLog.empty())
+            engine.openThrowLog(throwLog);
+        engine.connectToMatchServer(server);
+    }
+    if (!recording.empty()) {
+        if (server.empty())
+            LOG_ERROR("MAIN", "--detect needs a --server to score the darts on");
+        else
+            engine.startDartDetection(recording, calibration);
+    }
 
     while (!engine.shouldClose()) {
         engine.processInput();
@@ -12,6 +82,6 @@ int main(int argc, char *argv[]) {
         engine.render();
     }
 
-    glfwTerminate();
+    // the engine deletes its GL objects and then terminates GLFW when it goes out of scope
     return 0;
 }
@@ -0,0 +1,211 @@
+#include "matchClient.h"
+#include "../util/log.h"
+
+#include <cstring>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#define MATCH_CLIENT_SOCKETS 1
+// macOS has no MSG_NOSIGNAL, SO_NOSIGPIPE is set on the socket instead
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+#endif
+
+// how much is read from the socket at a time
+static const size_t READ_SIZE = 64 * 1024;
+
+MatchClient::~MatchClient() {
+    close();
+}
+
+#ifdef MATCH_CLIENT_SOCKETS
+
+int MatchClient::openConnection(const string &address) {
+    int fd = -1;
+    if (address.rfind("unix:", 0) == 0) {
+        string path = address.substr(5);
+        sockaddr_un addr{};
+        if (path.size() >= sizeof(addr.sun_path)) {
+            LOG_ERROR("MATCHCLIENT", "Socket path too long: {}", path);
+            return -1;
+        }
+        addr.sun_family = AF_UNIX;
+        std::strcpy(addr.sun_path, path.c_str());
+        fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0 || ::connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0) {
+            LOG_ERROR("MATCHCLIENT", "Could not connect to {}: {}", address, std::strerror(errno));
+            if (fd >= 0)
+                ::close(fd);
+            return -1;
+        }
+    }
+    else {
+        size_t colon = address.rfind(':');
+        if (colon == string::npos) {
+            LOG_ERROR("MATCHCLIENT", "Expected host:port or unix:<path>, got {}", address);
+            return -1;
+        }
+        string host = address.substr(0, colon), port = address.substr(colon + 1);
+
+        addrinfo hints{};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        addrinfo *found = nullptr;
+        if (getaddrinfo(host.c_str(), port.c_str(), &hints, &found) != 0) {
+            LOG_ERROR("MATCHCLIENT", "Could not resolve {}", address);
+            return -1;
+        }
+        for (addrinfo *a = found; a != nullptr && fd < 0; a = a->ai_next) {
+            fd = ::socket(a->ai_family, a->ai_socktype, a->ai_protocol);
+            if (fd >= 0 && ::connect(fd, a->ai_addr, a->ai_addrlen) != 0) {
+                ::close(fd);
+                fd = -1;
+            }
+        }
+        freeaddrinfo(found);
+        if (fd < 0) {
+            LOG_ERROR("MATCHCLIENT", "Could not connect to {}: {}", address, std::strerror(errno));
+            return -1;
+        }
+        // messages are tiny, send them right away instead of waiting to fill a packet
+        int on = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+    }
+
+#ifdef SO_NOSIGPIPE
+    int noSigpipe = 1;
+    setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &noSigpipe, sizeof(noSigpipe));
+#endif
+    return fd;
+}
+
+bool MatchClient::connect(const string &address) {
+    close();
+    fd = openConnection(address);
+    if (fd < 0)
+        return false;
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+    return true;
+}
+
+void MatchClient::close() {
+    if (fd >= 0)
+        ::close(fd);
+    fd = -1;
+    out.clear();
+    outOffset = 0;
+    in.clear();
+}
+
+bool MatchClient::flush() {
+    while (fd >= 0 && outOffset < out.size()) {
+        ssize_t written = ::send(fd, out.data() + outOffset, out.size() - outOffset, MSG_NOSIGNAL);
+        if (written < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+                break;
+            if (errno == EINTR)
+                continue;
+            close();
+            return false;
+        }
+        outOffset += written;
+    }
+    // everything went out, reuse the buffer from the start
+    if (outOffset == out.size()) {
+        out.clear();
+        outOffset = 0;
+    }
+    return fd >= 0;
+}
+
+bool MatchClient::receive(vector<MatchMessage> &messages, int timeoutMs) {
+    if (!flush())
+        return false;
+
+    pollfd p{fd, POLLIN, 0};
+    if (poll(&p, 1, timeoutMs) <= 0)
+        return true;
+
+    // read everything that is there
+    while (true) {
+        size_t size = in.size();
+        in.resize(size + READ_SIZE);
+        ssize_t got = ::recv(fd, in.data() + size, READ_SIZE, 0);
+        in.resize(size + (got > 0 ? got : 0));
+        if (got > 0)
+            continue;
+        if (got < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            break;
+        if (got < 0 && errno == EINTR)
+            continue;
+        // closed by the server or failed
+        close();
+        return false;
+    }
+
+    size_t offset = 0;
+    MatchMessage message;
+    while (true) {
+        long used = decodeMessage(in.data() + offset, in.size() - offset, message);
+        if (used == 0)
+            break;
+        if (used < 0) {
+            LOG_ERROR("MATCHCLIENT", "Malformed frame from server");
+            close();
+            return false;
+        }
+        messages.push_back(message);
+        offset += used;
+    }
+    in.erase(in.begin(), in.begin() + offset);
+    return true;
+}
+
+#else
+
+int MatchClient::openConnection(const string &address) {
+    LOG_ERROR("MATCHCLIENT", "Connecting to a match server isn't supported on this platform");
+    return -1;
+}
+
+bool MatchClient::connect(const string &address) {
+    LOG_ERROR("MATCHCLIENT", "Connecting to a match server isn't supported on this platform");
+    return false;
+}
+
+void MatchClient::close() {
+    fd = -1;
+    out.clear();
+    outOffset = 0;
+    in.clear();
+}
+
+bool MatchClient::flush() {
+    return false;
+}
+
+bool MatchClient::receive(vector<MatchMessage> &messages, int timeoutMs) {
+    return false;
+}
+
+#endif
+
+uint32_t MatchClient::send(MatchMessage message) {
+    message.sequence = nextSequence++;
+    if (fd < 0)
+        return message.sequence;
+
+    size_t size = out.size();
+    out.resize(size + MAX_FRAME_SIZE);
+    out.resize(size + encodeMessage(message, out.data() + size));
+    return message.sequence;
+}
@@ -0,0 +1,62 @@
+#ifndef GRAPHICS_MATCHCLIENT_H
+#define GRAPHICS_MATCHCLIENT_H
+
+#include <string>
+#include <vector>
+#include "protocol.h"
+
+using std::string, std::vector;
+
+/**
+ * @brief A connection to the match server.
+ * @details The socket is non-blocking: send() only queues a frame, flush() writes as much as the
+ *          socket takes and receive() decodes whatever responses have arrived. That lets the game
+ *          poll it once per frame and lets the load generator keep many requests in flight.
+ * @note Uses POSIX sockets; on other platforms connect() always fails.
+ */
+class MatchClient {
+    public:
+        MatchClient() = default;
+        ~MatchClient();
+
+        MatchClient(const MatchClient &) = delete;
+        MatchClient &operator=(const MatchClient &) = delete;
+
+        /// @brief Connects to the server
+        /// @param address "host:port" for TCP, or "unix:<path>" for a Unix socket
+        /// @return false if the connection failed (the reason is printed)
+        bool connect(const string &address);
+
+        /// @brief Closes the connection (queued frames are dropped)
+        void close();
+
+        bool isConnected() const { return fd >= 0; }
+
+        /// @brief Opens a blocking stream socket to address (see connect())
+        /// @return the socket, or -1 if the connection failed (the reason is printed)
+        static int openConnection(const string &address);
+
+        /// @brief Queues a request, filling in a new sequence number
+        /// @return the sequence number the response will carry
+        uint32_t send(MatchMessage message);
+
+        /// @brief Writes queued frames to the socket
+        /// @return false if the connection was lost
+        bool flush();
+
+        /// @brief Flushes, then waits up to timeoutMs for responses and appends every whole one to messages
+        /// @return false if the connection was lost
+        bool receive(vector<MatchMessage> &messages, int timeoutMs = 0);
+
+        /// @brief Bytes queued but not written yet
+        size_t pendingOutput() const { return out.size() - outOffset; }
+
+    private:
+        int fd = -1;
+        uint32_t nextSequence = 1;
+        vector<uint8_t> out;
+        size_t outOffset = 0;
+        vector<uint8_t> in;
+};
+
+#endif //GRAPHICS_MATCHCLIENT_H
@@ -0,0 +1,157 @@
+#include "protocol.h"
+
+// little-endian helpers, so the format doesn't depend on the machine
+static uint8_t *put8(uint8_t *out, uint8_t value) {
+    *out = value;
+    return out + 1;
+}
+
+static uint8_t *put16(uint8_t *out, uint16_t value) {
+    out[0] = static_cast<uint8_t>(value);
+    out[1] = static_cast<uint8_t>(value >> 8);
+    return out + 2;
+}
+
+static uint8_t *put32(uint8_t *out, uint32_t value) {
+    for (int i = 0; i < 4; ++i)
+        out[i] = static_cast<uint8_t>(value >> (8 * i));
+    return out + 4;
+}
+
+static uint16_t get16(const uint8_t *in) {
+    return static_cast<uint16_t>(in[0] | (in[1] << 8));
+}
+
+static uint32_t get32(const uint8_t *in) {
+    return uint32_t(in[0]) | (uint32_t(in[1]) << 8) | (uint32_t(in[2]) << 16) | (uint32_t(in[3]) << 24);
+}
+
+size_t encodeMessage(const MatchMessage &message, uint8_t *out) {
+    uint8_t *p = out + FRAME_HEADER_SIZE;
+    p = put32(p, message.sequence);
+
+    switch (message.type) {
+        case MatchMessage::createMatch:
+            p = put8(p, message.players);
+            p = put16(p, message.startScore);
+            p = put8(p, message.doubleOut ? 1 : 0);
+            break;
+        case MatchMessage::matchCreated:
+        case MatchMessage::getMatch:
+            p = put32(p, message.match);
+            break;
+        case MatchMessage::submitThrow:
+            p = put32(p, message.match);
+            p = put8(p, message.player);
+            p = put8(p, message.dart.segment);
+            p = put8(p, message.dart.multiplier);
+            break;
+        case MatchMessage::throwResult:
+            p = put32(p, message.match);
+            p = put8(p, message.result);
+            p = put8(p, message.player);
+            p = put16(p, message.remaining[message.player % X01Game::MAX_PLAYERS]);
+            p = put8(p, message.current);
+            p = put8(p, static_cast<uint8_t>(message.winner));
+            break;
+        case MatchMessage::matchState: {
+            int players = message.players > X01Game::MAX_PLAYERS ? X01Game::MAX_PLAYERS : message.players;
+            p = put32(p, message.match);
+            p = put8(p, static_cast<uint8_t>(players));
+            p = put8(p, message.current);
+            p = put8(p, static_cast<uint8_t>(message.winner));
+            p = put8(p, message.dartsInVisit);
+            for (int i = 0; i < players; ++i)
+                p = put16(p, message.remaining[i]);
+            break;
+        }
+        case MatchMessage::error:
+            p = put32(p, message.match);
+            p = put8(p, message.errorCode);
+            break;
+    }
+
+    size_t payload = p - out - FRAME_HEADER_SIZE;
+    put16(out, static_cast<uint16_t>(payload));
+    put8(out + 2, message.type);
+    return p - out;
+}
+
+long decodeMessage(const uint8_t *data, size_t size, MatchMessage &message) {
+    if (size < FRAME_HEADER_SIZE)
+        return 0;
+    size_t payload = get16(data);
+    if (payload + FRAME_HEADER_SIZE > MAX_FRAME_SIZE || payload < 4)
+        return -1;
+    if (size < FRAME_HEADER_SIZE + payload)
+        return 0;
+
+    const uint8_t type = data[2];
+    const uint8_t *p = data + FRAME_HEADER_SIZE + 4; // past the sequence number
+
+    // the payload has to be exactly as long as the type needs
+    size_t expected;
+    switch (type) {
+        case MatchMessage::createMatch:  expected = 8;  break;
+        case MatchMessage::matchCreated: expected = 8;  break;
+        case MatchMessage::getMatch:     expected = 8;  break;
+        case MatchMessage::submitThrow:  expected = 11; break;
+        case MatchMessage::throwResult:  expected = 14; break;
+        case MatchMessage::error:        expected = 9;  break;
+        case MatchMessage::matchState: {
+            if (payload < 12 || p[4] > X01Game::MAX_PLAYERS)
+                return -1;
+            expected = 12 + 2 * p[4];
+            break;
+        }
+        default:
+            return -1;
+    }
+    if (payload != expected)
+        return -1;
+
+    message = MatchMessage();
+    message.type = static_cast<MatchMessage::Type>(type);
+    message.sequence = get32(data + FRAME_HEADER_SIZE);
+
+    switch (message.type) {
+        case MatchMessage::createMatch:
+            message.players = p[0];
+            message.startScore = get16(p + 1);
+            message.doubleOut = p[3] != 0;
+            break;
+        case MatchMessage::matchCreated:
+        case MatchMessage::getMatch:
+            message.match = get32(p);
+            break;
+        case MatchMessage::submitThrow:
+            message.match = get32(p);
+            message.player = p[4];
+            message.dart.segment = p[5];
+            message.dart.multiplier = p[6];
+            break;
+        case MatchMessage::throwResult:
+            message.match = get32(p);
+            message.result = p[4];
+            message.player = p[5] % X01Game::MAX_PLAYERS;
+            message.remaining[message.player] = get16(p + 6);
+            message.current = p[8];
+            message.winner = static_cast<int8_t>(p[9]);
+            break;
+        case MatchMessage::matchState:
+            message.match = get32(p);
+            message.players = p[4];
+            message.current = p[5];
+            message.winner = static_cast<int8_t>(p[6]);
+            message.dartsInVisit = p[7];
+            for (int i = 0; i < message.players; ++i)
+                message.remaining[i] = get16(p + 8 + 2 * i);
+            break;
+        case MatchMessage::error:
+            message.match = get32(p);
+            message.errorCode = p[4];
+            break;
+    }
+
+    return static_cast<long>(FRAME_HEADER_SIZE + payload);
+}
@@ -0,0 +1,68 @@
+#ifndef GRAPHICS_PROTOCOL_H
+#define GRAPHICS_PROTOCOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include "../darts/x01.h"
+
+/**
+ * @brief One message between a scoring client and the match server.
+ * @details On the wire every message is a frame: a little-endian u16 payload length, a u8 type and
+ *          the payload. Only the fields a type uses are sent, e.g. a submitThrow frame is 14 bytes.
+ *          Every request carries a sequence number that the server copies into its response, so
+ *          clients can pipeline requests and still tell the responses apart.
+ *
+ * | type         | payload                                                                    |
+ * |--------------|----------------------------------------------------------------------------|
+ * | createMatch  | sequence u32, players u8, startScore u16, doubleOut u8                     |
+ * | matchCreated | sequence u32, match u32                                                    |
+ * | submitThrow  | sequence u32, match u32, player u8, segment u8, multiplier u8              |
+ * | throwResult  | sequence u32, match u32, result u8, player u8, remaining u16, current u8, winner i8 |
+ * | getMatch     | sequence u32, match u32                                                    |
+ * | matchState   | sequence u32, match u32, players u8, current u8, winner i8, dartsInVisit u8, remaining u16 * players |
+ * | error        | sequence u32, match u32, code u8                                           |
+ */
+struct MatchMessage {
+    enum Type : uint8_t {createMatch = 1, matchCreated, submitThrow, throwResult, getMatch, matchState, error} type = error;
+    /// @brief Why a request failed (error only)
+    enum Error : uint8_t {unknownMatch = 1, badRequest, serverBusy};
+
+    uint32_t sequence = 0;
+    uint32_t match = 0;
+
+    // createMatch / matchState
+    uint8_t players = 2;
+    uint16_t startScore = 501;
+    bool doubleOut = true;
+
+    // submitThrow / throwResult
+    uint8_t player = 0;
+    Dart dart;
+    uint8_t result = 0;
+
+    // throwResult / matchState
+    uint8_t current = 0;
+    int8_t winner = -1;
+    uint8_t dartsInVisit = 0;
+    /// @brief Remaining score per player (throwResult only fills in the player that threw)
+    uint16_t remaining[X01Game::MAX_PLAYERS] = {};
+
+    uint8_t errorCode = 0;
+};
+
+/// @brief Size of the frame header (u16 length + u8 type)
+const size_t FRAME_HEADER_SIZE = 3;
+/// @brief The largest frame any message encodes to
+const size_t MAX_FRAME_SIZE = FRAME_HEADER_SIZE + 12 + 2 * X01Game::MAX_PLAYERS;
+
+/// @brief Writes message as a frame
+/// @param out At least MAX_FRAME_SIZE bytes
+/// @return the number of bytes written
+size_t encodeMessage(const MatchMessage &message, uint8_t *out);
+
+/// @brief Reads one frame from the front of data
+/// @return the number of bytes the frame took, 0 if data doesn't hold a whole frame yet,
+///         or -1 if the frame is malformed (the connection should be dropped)
+long decodeMessage(const uint8_t *data, size_t size, MatchMessage &message);
+
+#endif //GRAPHICS_PROTOCOL_H
@@ -0,0 +1,387 @@
+#include "spectatorStream.h"
+
+#include <algorithm>
+
+// what a record carries (bit mask)
+enum recordField : uint8_t {
+    fieldNew      = 1 << 0, // players, start score, double-out
+    fieldScores   = 1 << 1,
+    fieldTurn     = 1 << 2, // current player, darts thrown this visit
+    fieldWinner   = 1 << 3,
+    fieldLastDart = 1 << 4,
+    fieldCheckout = 1 << 5,
+    fieldRemoved  = 1 << 6,
+};
+
+// largest varint a frame length is allowed to be (guards against garbage)
+static const uint64_t MAX_FRAME_PAYLOAD = 64 << 20;
+
+// --------------------------------------------------------
+// Byte helpers
+// --------------------------------------------------------
+
+static void putVarint(vector<uint8_t> &out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+static uint64_t zigzag(int64_t value) {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+static int64_t unzigzag(uint64_t value) {
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+/// @brief segment in the low 5 bits, multiplier in the next 2
+static uint8_t packDart(Dart dart) {
+    return static_cast<uint8_t>((dart.segment & 0x1f) | ((dart.multiplier & 0x3) << 5));
+}
+
+static Dart unpackDart(uint8_t packed) {
+    return {static_cast<uint8_t>(packed & 0x1f), static_cast<uint8_t>((packed >> 5) & 0x3)};
+}
+
+static bool sameDart(Dart a, Dart b) {
+    return a.segment == b.segment && a.multiplier == b.multiplier;
+}
+
+static bool sameCheckout(const Checkout &a, const Checkout &b) {
+    if (a.count != b.count)
+        return false;
+    for (int i = 0; i < a.count; ++i)
+        if (!sameDart(a.darts[i], b.darts[i]))
+            return false;
+    return true;
+}
+
+/// @brief Reads from a frame without ever going past its end
+struct Reader {
+    const uint8_t *p;
+    const uint8_t *end;
+    bool failed = false;
+
+    uint8_t byte() {
+        if (p >= end) {
+            failed = true;
+            return 0;
+        }
+        return *p++;
+    }
+
+    uint64_t varint() {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            uint8_t b = byte();
+            value |= uint64_t(b & 0x7f) << shift;
+            if (!(b & 0x80))
+                return value;
+        }
+        failed = true;
+        return 0;
+    }
+
+    uint64_t u64() {
+        uint64_t value = 0;
+        for (int i = 0; i < 8; ++i)
+            value |= uint64_t(byte()) << (8 * i);
+        return value;
+    }
+};
+
+// --------------------------------------------------------
+// SpectatorMatch / SpectatorState
+// --------------------------------------------------------
+
+uint64_t SpectatorMatch::hash() const {
+    // FNV-1a over every field
+    uint64_t h = 1469598103934665603ull;
+    auto mix = [&h](uint64_t value, int bytes) {
+        for (int i = 0; i < bytes; ++i) {
+            h ^= (value >> (8 * i)) & 0xff;
+            h *= 1099511628211ull;
+        }
+    };
+    mix(id, 4);
+    mix(players, 1);
+    mix(startScore, 2);
+    mix(doubleOut, 1);
+    for (uint16_t score : remaining)
+        mix(score, 2);
+    mix(current, 1);
+    mix(dartsInVisit, 1);
+    mix(static_cast<uint8_t>(winner), 1);
+    mix(lastPlayer, 1);
+    mix(packDart(lastDart), 1);
+    mix(checkout.count, 1);
+    for (int i = 0; i < checkout.count; ++i)
+        mix(packDart(checkout.darts[i]), 1);
+    return h;
+}
+
+void SpectatorState::set(const SpectatorMatch &match) {
+    auto found = matches.find(match.id);
+    if (found != matches.end()) {
+        hash ^= found->second.hash();
+        found->second = match;
+    }
+    else {
+        matches.emplace(match.id, match);
+    }
+    hash ^= match.hash();
+}
+
+void SpectatorState::remove(uint32_t id) {
+    auto found = matches.find(id);
+    if (found == matches.end())
+        return;
+    hash ^= found->second.hash();
+    matches.erase(found);
+}
+
+void SpectatorState::clear() {
+    matches.clear();
+    hash = 0;
+}
+
+const SpectatorMatch *SpectatorState::find(uint32_t id) const {
+    auto found = matches.find(id);
+    return found == matches.end() ? nullptr : &found->second;
+}
+
+// --------------------------------------------------------
+// Encoding
+// --------------------------------------------------------
+
+/// @brief Writes the fields of after that differ from before
+/// @return false if nothing differs (nothing is written)
+static bool encodeRecord(const SpectatorMatch &before, const SpectatorMatch &after, uint32_t previousId, vector<uint8_t> &out) {
+    uint8_t mask = 0;
+    uint8_t scoreMask = 0;
+    if (before.players != after.players || before.startScore != after.startScore || before.doubleOut != after.doubleOut)
+        mask |= fieldNew;
+    for (int i = 0; i < X01Game::MAX_PLAYERS; ++i)
+        if (before.remaining[i] != after.remaining[i])
+            scoreMask |= 1 << i;
+    if (scoreMask != 0)
+        mask |= fieldScores;
+    if (before.current != after.current || before.dartsInVisit != after.dartsInVisit)
+        mask |= fieldTurn;
+    if (before.winner != after.winner)
+        mask |= fieldWinner;
+    if (before.lastPlayer != after.lastPlayer || !sameDart(before.lastDart, after.lastDart))
+        mask |= fieldLastDart;
+    if (!sameCheckout(before.checkout, after.checkout))
+        mask |= fieldCheckout;
+    if (mask == 0)
+        return false;
+
+    putVarint(out, after.id - previousId);
+    out.push_back(mask);
+    if (mask & fieldNew) {
+        out.push_back(static_cast<uint8_t>(((after.players - 1) & 0x7) | (after.doubleOut ? 0x8 : 0)));
+        putVarint(out, after.startScore);
+    }
+    if (mask & fieldScores) {
+        out.push_back(scoreMask);
+        for (int i = 0; i < X01Game::MAX_PLAYERS; ++i)
+            if (scoreMask & (1 << i))
+                putVarint(out, zigzag(int64_t(after.remaining[i]) - before.remaining[i]));
+    }
+    if (mask & fieldTurn)
+        out.push_back(static_cast<uint8_t>((after.current & 0x7) | ((after.dartsInVisit & 0x3) << 3)));
+    if (mask & fieldWinner)
+        out.push_back(static_cast<uint8_t>(after.winner + 1));
+    if (mask & fieldLastDart)
+        putVarint(out, (uint64_t(after.lastPlayer) << 7) | packDart(after.lastDart));
+    if (mask & fieldCheckout) {
+        out.push_back(static_cast<uint8_t>(after.checkout.count));
+        for (int i = 0; i < after.checkout.count; ++i)
+            out.push_back(packDart(after.checkout.darts[i]));
+    }
+    return true;
+}
+
+/// @brief Wraps a payload into a frame
+static void writeFrame(uint8_t kind, uint64_t tick, uint64_t hash, size_t count, const vector<uint8_t> &records, vector<uint8_t> &out) {
+    vector<uint8_t> header;
+    putVarint(header, tick);
+    for (int i = 0; i < 8; ++i)
+        header.push_back(static_cast<uint8_t>(hash >> (8 * i)));
+    putVarint(header, count);
+
+    out.clear();
+    putVarint(out, 1 + header.size() + records.size());
+    out.push_back(kind);
+    out.insert(out.end(), header.begin(), header.end());
+    out.insert(out.end(), records.begin(), records.end());
+}
+
+void SpectatorEncoder::update(const SpectatorMatch &match) {
+    auto found = live.find(match.id);
+    if (found == live.end())
+        live.emplace(match.id, match);
+    else
+        found->second = match;
+    changed.push_back(match.id);
+}
+
+void SpectatorEncoder::retireFinished() {
+    for (const auto &entry : published.getMatches()) {
+        if (entry.second.winner >= 0) {
+            live.erase(entry.first);
+            changed.push_back(entry.first);
+        }
+    }
+}
+
+void SpectatorEncoder::retire(uint32_t id) {
+    if (live.erase(id) > 0)
+        changed.push_back(id);
+}
+
+bool SpectatorEncoder::encodeDelta(uint64_t tick, vector<uint8_t> &out) {
+    out.clear();
+    if (changed.empty())
+        return false;
+
+    // ids are sent as differences, so go through them in order (and only once each)
+    std::sort(changed.begin(), changed.end());
+    changed.erase(std::unique(changed.begin(), changed.end()), changed.end());
+
+    vector<uint8_t> records;
+    size_t count = 0;
+    uint32_t previousId = 0;
+    const SpectatorMatch empty;
+    for (uint32_t id : changed) {
+        const SpectatorMatch *before = published.find(id);
+        auto after = live.find(id);
+
+        if (after == live.end()) {
+            if (before == nullptr)
+                continue;
+            putVarint(records, id - previousId);
+            records.push_back(fieldRemoved);
+            published.remove(id);
+        }
+        else {
+            SpectatorMatch base = before != nullptr ? *before : empty;
+            if (!encodeRecord(base, after->second, previousId, records))
+                continue;
+            published.set(after->second);
+        }
+        previousId = id;
+        count++;
+    }
+    changed.clear();
+
+    if (count == 0)
+        return false;
+    writeFrame(delta, tick, published.getHash(), count, records, out);
+    return true;
+}
+
+void SpectatorEncoder::encodeKeyframe(uint64_t tick, vector<uint8_t> &out) const {
+    vector<uint32_t> ids;
+    ids.reserve(published.getMatches().size());
+    for (const auto &entry : published.getMatches())
+        ids.push_back(entry.first);
+    std::sort(ids.begin(), ids.end());
+
+    vector<uint8_t> records;
+    uint32_t previousId = 0;
+    size_t count = 0;
+    for (uint32_t id : ids) {
+        SpectatorMatch empty;
+        empty.id = id;
+        if (encodeRecord(empty, *published.find(id), previousId, records)) {
+            previousId = id;
+            count++;
+        }
+    }
+    writeFrame(keyframe, tick, published.getHash(), count, records, out);
+}
+
+// --------------------------------------------------------
+// Decoding
+// --------------------------------------------------------
+
+SpectatorDecoder::status SpectatorDecoder::decode(const uint8_t *data, size_t size, size_t &used) {
+    Reader header{data, data + size};
+    uint64_t length = header.varint();
+    if (header.failed)
+        return size >= 10 ? malformed : incomplete;
+    if (length == 0 || length > MAX_FRAME_PAYLOAD)
+        return malformed;
+    size_t headerSize = header.p - data;
+    if (size < headerSize + length)
+        return incomplete;
+    used = headerSize + length;
+
+    Reader in{header.p, header.p + length};
+    uint8_t kind = in.byte();
+    uint64_t frameTick = in.varint();
+    uint64_t frameHash = in.u64();
+    uint64_t count = in.varint();
+    if (in.failed || (kind != SpectatorEncoder::keyframe && kind != SpectatorEncoder::delta))
+        return malformed;
+
+    // deltas only make sense on top of a keyframe
+    if (kind == SpectatorEncoder::delta && !synced)
+        return skipped;
+    if (kind == SpectatorEncoder::keyframe)
+        state.clear();
+
+    uint32_t id = 0;
+    for (uint64_t r = 0; r < count && !in.failed; ++r) {
+        id += static_cast<uint32_t>(in.varint());
+        uint8_t mask = in.byte();
+        if (mask & fieldRemoved) {
+            state.remove(id);
+            continue;
+        }
+
+        const SpectatorMatch *existing = state.find(id);
+        SpectatorMatch match = existing != nullptr ? *existing : SpectatorMatch();
+        match.id = id;
+        if (mask & fieldNew) {
+            uint8_t b = in.byte();
+            match.players = static_cast<uint8_t>((b & 0x7) + 1);
+            match.doubleOut = (b & 0x8) != 0;
+            match.startScore = static_cast<uint16_t>(in.varint());
+        }
+        if (mask & fieldScores) {
+            uint8_t scoreMask = in.byte();
+            for (int i = 0; i < X01Game::MAX_PLAYERS; ++i)
+                if (scoreMask & (1 << i))
+                    match.remaining[i] = static_cast<uint16_t>(match.remaining[i] + unzigzag(in.varint()));
+        }
+        if (mask & fieldTurn) {
+            uint8_t b = in.byte();
+            match.current = b & 0x7;
+            match.dartsInVisit = (b >> 3) & 0x3;
+        }
+        if (mask & fieldWinner)
+            match.winner = static_cast<int8_t>(in.byte() - 1);
+        if (mask & fieldLastDart) {
+            uint64_t v = in.varint();
+            match.lastPlayer = static_cast<uint8_t>(v >> 7);
+            match.lastDart = unpackDart(static_cast<uint8_t>(v & 0x7f));
+        }
+        if (mask & fieldCheckout) {
+            match.checkout.count = std::min<int>(in.byte(), X01Game::DARTS_PER_VISIT);
+            for (int i = 0; i < match.checkout.count; ++i)
+                match.checkout.darts[i] = unpackDart(in.byte());
+        }
+        state.set(match);
+    }
+    if (in.failed || in.p != in.end)
+        return malformed;
+
+    synced = true;
+    tick = frameTick;
+    return state.getHash() == frameHash ? applied : mismatch;
+}
@@ -0,0 +1,121 @@
+#ifndef GRAPHICS_SPECTATORSTREAM_H
+#define GRAPHICS_SPECTATORSTREAM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "../darts/x01.h"
+#include "../darts/checkout.h"
+
+using std::vector;
+
+/// @brief A match as spectators see it
+struct SpectatorMatch {
+    uint32_t id = 0;
+    uint8_t players = 0;
+    uint16_t startScore = 0;
+    bool doubleOut = true;
+    uint16_t remaining[X01Game::MAX_PLAYERS] = {};
+    uint8_t current = 0;
+    uint8_t dartsInVisit = 0;
+    int8_t winner = -1;
+    /// @brief The most recent dart and who threw it
+    uint8_t lastPlayer = 0;
+    Dart lastDart;
+    /// @brief Suggested finish for the player at the oche (count 0 if none)
+    Checkout checkout;
+
+    /// @brief Hash of every field, the stream's checksum is the XOR of these
+    uint64_t hash() const;
+};
+
+/**
+ * @brief Every match a spectator knows about, with a checksum that is updated as matches change.
+ * @details The publisher keeps one of these with what it has sent, a subscriber rebuilds the same
+ *          one from the frames. Each frame carries the publisher's checksum, so a subscriber can
+ *          check that its copy is exactly the source's.
+ */
+class SpectatorState {
+    public:
+        /// @brief Adds or replaces a match
+        void set(const SpectatorMatch &match);
+        /// @brief Removes a match (no-op if it isn't there)
+        void remove(uint32_t id);
+        void clear();
+
+        /// @return the match, or null if there is none with that id
+        const SpectatorMatch *find(uint32_t id) const;
+        const std::unordered_map<uint32_t, SpectatorMatch> &getMatches() const { return matches; }
+        uint64_t getHash() const { return hash; }
+
+    private:
+        std::unordered_map<uint32_t, SpectatorMatch> matches;
+        uint64_t hash = 0;
+};
+
+/**
+ * @brief Turns match updates into a compact stream of keyframes and deltas.
+ * @details A frame is a varint payload length, a kind byte and the payload: varint tick, u64
+ *          checksum, varint record count and one record per changed match. Records are sorted by
+ *          match id and carry the id as a varint difference from the previous one, a bit mask of
+ *          what changed and only those fields: scores as zigzag varint differences for the players
+ *          whose score moved, turn and darts bit-packed into a byte, darts as 7 bits (segment and
+ *          multiplier). A keyframe is the same thing relative to an empty state.
+ *          A throw typically costs 6 to 8 bytes.
+ */
+class SpectatorEncoder {
+    public:
+        enum FrameKind : uint8_t {keyframe = 1, delta = 2};
+
+        /// @brief Records the newest state of a match (sent with the next delta)
+        void update(const SpectatorMatch &match);
+
+        /// @brief Drops matches that were already published as won (sent as removals with the next delta)
+        void retireFinished();
+        /// @brief Drops a match whether it's won or not (no-op if it isn't there)
+        void retire(uint32_t id);
+
+        /// @brief Encodes everything that changed since the last delta and marks it as sent
+        /// @return false if nothing changed (out is left empty)
+        bool encodeDelta(uint64_t tick, vector<uint8_t> &out);
+
+        /// @brief Encodes everything that has been sent so far as one frame (for new or lagging subscribers)
+        void encodeKeyframe(uint64_t tick, vector<uint8_t> &out) const;
+
+        /// @brief What subscribers have been sent
+        const SpectatorState &getPublished() const { return published; }
+
+    private:
+        /// @brief The newest state of every match
+        std::unordered_map<uint32_t, SpectatorMatch> live;
+        SpectatorState published;
+        /// @brief Matches updated since the last delta
+        vector<uint32_t> changed;
+};
+
+/**
+ * @brief Rebuilds a SpectatorState from a stream of frames.
+ */
+class SpectatorDecoder {
+    public:
+        /// @brief What decode() found
+        enum status {incomplete, applied, skipped, malformed, mismatch};
+
+        /// @brief Decodes and applies the frame at the front of data
+        /// @param used set to the frame's size (when it isn't incomplete)
+        /// @return applied if the state now matches the source's checksum, mismatch if it doesn't,
+        ///         skipped for a delta before the first keyframe, incomplete if more bytes are needed
+        status decode(const uint8_t *data, size_t size, size_t &used);
+
+        const SpectatorState &getState() const { return state; }
+        uint64_t getTick() const { return tick; }
+        bool isSynced() const { return synced; }
+
+    private:
+        SpectatorState state;
+        uint64_t tick = 0;
+        bool synced = false;
+};
+
+#endif //GRAPHICS_SPECTATORSTREAM_H
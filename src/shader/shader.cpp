@@ -1,11 +1,27 @@
 #include "shader.h"
+#include "../gl/glState.h"
+#include "../util/log.h"
+
+#include <cstring>
+
+// logs a GL info log one line at a time, so long logs aren't cut short
+static void logInfoLog(const char *infoLog) {
+    const char *line = infoLog;
+    while (*line != '\0') {
+        const char *end = std::strchr(line, '\n');
+        size_t length = end != nullptr ? end - line : std::strlen(line);
+        if (length > 0)
+            LOG_ERROR("SHADER", "  {}", std::string_view(line, length));
+        line += end != nullptr ? length + 1 : length;
+    }
+}
 
 Shader &Shader::use() {
-    glUseProgram(this->ID);
+    GLState::useProgram(this->getID());
     return *this;
 }
 
-void Shader::compile(const char* vertexSource, const char* fragmentSource, const char* geometrySource) {
+void Shader::compile(const char* vertexSource, const char* fragmentSource, const char* geometrySource, bool retrievable) {
     unsigned int sVertex, sFragment, gShader;
 
     // vertex Shader
@@ -29,14 +45,18 @@ void Shader::compile(const char* vertexSource, const char* fragmentSource, const
     }
 
     // shader program
-    this->ID = glCreateProgram();
-    glAttachShader(this->ID, sVertex);
-    glAttachShader(this->ID, sFragment);
+    this->program = GLProgram::create();
+    glAttachShader(this->getID(), sVertex);
+    glAttachShader(this->getID(), sFragment);
     if (geometrySource != nullptr)
-        glAttachShader(this->ID, gShader);
+        glAttachShader(this->getID(), gShader);
 
-    glLinkProgram(this->ID);
-    checkCompileErrors(this->ID, "PROGRAM");
+    // ask the driver to keep the binary around so it can be cached
+    if (retrievable)
+        glProgramParameteri(this->getID(), GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+
+    glLinkProgram(this->getID());
+    checkCompileErrors(this->getID(), "PROGRAM");
 
     // delete the shaders as they're linked into our program now and no longer necessary
     glDeleteShader(sVertex);
@@ -46,42 +66,47 @@ void Shader::compile(const char* vertexSource, const char* fragmentSource, const
 }
 
 void Shader::setFloat(const char *name, float value) const {
-    glUniform1f(glGetUniformLocation(this->ID, name), value);
+    glUniform1f(glGetUniformLocation(this->getID(), name), value);
 }
 
 void Shader::setInteger(const char *name, int value) const {
-    glUniform1i(glGetUniformLocation(this->ID, name), value);
+    glUniform1i(glGetUniformLocation(this->getID(), name), value);
 
 }
 
 void Shader::setVector2f(const char *name, float x, float y) const {
-    glUniform2f(glGetUniformLocation(this->ID, name), x, y);
+    glUniform2f(glGetUniformLocation(this->getID(), name), x, y);
 }
 
 void Shader::setVector2f(const char *name, const glm::vec2 &value) const {
-    glUniform2f(glGetUniformLocation(this->ID, name), value.x, value.y);
+    glUniform2f(glGetUniformLocation(this->getID(), name), value.x, value.y);
 }
 
 void Shader::setVector3f(const char *name, float x, float y, float z) const {
-    glUniform3f(glGetUniformLocation(this->ID, name), x, y, z);
+    glUniform3f(glGetUniformLocation(this->getID(), name), x, y, z);
 }
 
 void Shader::setVector3f(const char *name, const glm::vec3 &value) const {
-    glUniform3f(glGetUniformLocation(this->ID, name), value.x, value.y, value.z);
+    glUniform3f(glGetUniformLocation(this->getID(), name), value.x, value.y, value.z);
 }
 
 void Shader::setVector4f(const char *name, float x, float y, float z, float w) const {
-    glUniform4f(glGetUniformLocation(this->ID, name), x, y, z, w);
+    glUniform4f(glGetUniformLocation(this->getID(), name), x, y, z, w);
 }
 
 void Shader::setVector4f(const char *name, const glm::vec4 &value) const {
-    glUniform4f(glGetUniformLocation(this->ID, name), value.x, value.y, value.z, value.w);
+    glUniform4f(glGetUniformLocation(this->getID(), name), value.x, value.y, value.z, value.w);
 }
 
 void Shader::setMatrix4(const char *name, const glm::mat4 &matrix) const {
-    glUniformMatrix4fv(glGetUniformLocation(this->ID, name), 1, false, glm::value_ptr(matrix));
+    glUniformMatrix4fv(glGetUniformLocation(this->getID(), name), 1, false, glm::value_ptr(matrix));
 }
 
+void Shader::bindUniformBlock(const char *name, unsigned int binding) const {
+    unsigned int index = glGetUniformBlockIndex(this->getID(), name);
+    if (index != GL_INVALID_INDEX)
+        glUniformBlockBinding(this->getID(), index, binding);
+}
 
 void Shader::checkCompileErrors(unsigned int object, string type) {
     int success;
@@ -91,9 +116,8 @@ void Shader::checkCompileErrors(unsigned int object, string type) {
         glGetShaderiv(object, GL_COMPILE_STATUS, &success);
         if (!success) {
             glGetShaderInfoLog(object, 1024, NULL, infoLog);
-            cout << "| ERROR::SHADER: Compile-time error: Type: " << type << "\n"
-                      << infoLog << "\n -- --------------------------------------------------- -- "
-                      << endl;
+            LOG_ERROR("SHADER", "Compile-time error: Type: {}", type);
+            logInfoLog(infoLog);
         }
     }
 
@@ -101,9 +125,8 @@ void Shader::checkCompileErrors(unsigned int object, string type) {
         glGetProgramiv(object, GL_LINK_STATUS, &success);
         if (!success) {
             glGetProgramInfoLog(object, 1024, NULL, infoLog);
-            cout << "| ERROR::Shader: Link-time error: Type: " << type << "\n"
-                      << infoLog << "\n -- --------------------------------------------------- -- "
-                      << endl;
+            LOG_ERROR("SHADER", "Link-time error: Type: {}", type);
+            logInfoLog(infoLog);
         }
     }
 }
\ No newline at end of file
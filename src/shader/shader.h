@@ -5,18 +5,23 @@
 #include <glad/glad.h>
 #include <glm/gtc/type_ptr.hpp>
 #include <iostream>
+#include "../gl/gpuResource.h"
 using std::string, std::ifstream, std::stringstream, std::cout, std::endl;
 
 /// @brief General purpose shader object.
 /// @details Compiles from file, generates compile/link-time error messages and hosts several utility functions for easy management.
+///          The shader owns its program, so it can be moved but not copied (pass references around).
 class Shader {
     public:
-        /// @brief The shader program ID
-        unsigned int ID;
-
         /// @brief Construct a new Shader object
         Shader() { }
 
+        /// @brief The shader program ID (0 until compiled)
+        GLuint getID() const { return program.get(); }
+
+        /// @brief Takes ownership of an already linked program (e.g. one restored by ShaderCache)
+        void setProgram(GLProgram linked) { program = std::move(linked); }
+
         /// @brief Inform OpenGL to use this shader
         /// @return A pointer to this shader object (for method chaining)
         Shader &use();
@@ -27,7 +32,8 @@ class Shader {
         /// @param vertexSource the source code for the vertex shader
         /// @param fragmentSource the source code for the fragment shader
         /// @param geometrySource the source code for the geometry shader (optional)
-        void compile(const char *vertexSource, const char *fragmentSource, const char *geometrySource = nullptr); // note: geometry source code is optional
+        /// @param retrievable set if the linked program will be saved with glGetProgramBinary
+        void compile(const char *vertexSource, const char *fragmentSource, const char *geometrySource = nullptr, bool retrievable = false); // note: geometry source code is optional
 
         // ------------------------------------------------------------------------
         // utility functions
@@ -87,7 +93,16 @@ class Shader {
         /// @param useShader boolean to indicate whether to use this shader
         void setMatrix4(const char *name, const glm::mat4 &matrix) const;
 
+        /// @brief attach a uniform block in the shader to a uniform buffer binding point
+        /// @details does nothing if the shader doesn't declare the block
+        /// @param name name of the uniform block
+        /// @param binding the binding point to attach it to
+        void bindUniformBlock(const char *name, unsigned int binding) const;
+
     private:
+        /// @brief The linked program, deleted with the shader
+        GLProgram program;
+
         /// @brief Checks if compilation or linking failed and if so, print the error logs
         /// @param object the shader object to check
         /// @param type the type of shader object (vertex, fragment, geometry)
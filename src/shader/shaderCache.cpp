@@ -0,0 +1,156 @@
+#include "shaderCache.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <utility>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+// "DSPC": Darts Shader Program Cache
+static const char MAGIC[4] = {'D', 'S', 'P', 'C'};
+// bump this whenever the file layout changes
+static const uint32_t VERSION = 1;
+
+/// @brief The fixed-size header at the start of every cache file
+struct CacheHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t key;
+    uint32_t format;
+    uint32_t length;
+};
+
+// FNV-1a, 64-bit
+static const uint64_t FNV_OFFSET = 14695981039346656037ull;
+static const uint64_t FNV_PRIME = 1099511628211ull;
+
+static uint64_t fnv1a(uint64_t hash, const char *str) {
+    if (str == nullptr)
+        str = "";
+    for (; *str; ++str)
+        hash = (hash ^ static_cast<unsigned char>(*str)) * FNV_PRIME;
+    // hash a separator too, so ("ab", "c") and ("a", "bc") don't collide
+    return (hash ^ 0xff) * FNV_PRIME;
+}
+
+ShaderCache::ShaderCache(std::string directory) : directory(std::move(directory)) {
+    if (this->directory.empty() || glProgramBinary == nullptr || glGetProgramBinary == nullptr)
+        return;
+    int formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    supported = formats > 0;
+
+    // a binary is only valid for the exact driver that produced it
+    driverHash = FNV_OFFSET;
+    driverHash = fnv1a(driverHash, reinterpret_cast<const char *>(glGetString(GL_VENDOR)));
+    driverHash = fnv1a(driverHash, reinterpret_cast<const char *>(glGetString(GL_RENDERER)));
+    driverHash = fnv1a(driverHash, reinterpret_cast<const char *>(glGetString(GL_VERSION)));
+}
+
+bool ShaderCache::isEnabled() const {
+    return supported;
+}
+
+uint64_t ShaderCache::key(const char *vertexSource, const char *fragmentSource, const char *geometrySource) const {
+    uint64_t hash = driverHash;
+    hash = fnv1a(hash, vertexSource);
+    hash = fnv1a(hash, fragmentSource);
+    hash = fnv1a(hash, geometrySource);
+    return hash;
+}
+
+bool ShaderCache::load(uint64_t key, Shader &shader) const {
+    if (!supported)
+        return false;
+
+    std::ifstream file(pathFor(key), std::ios::binary);
+    if (!file)
+        return false;
+
+    CacheHeader header{};
+    if (!file.read(reinterpret_cast<char *>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 ||
+        header.version != VERSION || header.key != key || header.length == 0)
+        return false;
+
+    std::vector<char> binary(header.length);
+    if (!file.read(binary.data(), header.length))
+        return false;
+
+    GLProgram program = GLProgram::create();
+    glProgramBinary(program.get(), header.format, binary.data(), static_cast<GLsizei>(header.length));
+
+    // the driver is allowed to reject a binary at any time (e.g. after an update), so check it linked
+    int success = 0;
+    glGetProgramiv(program.get(), GL_LINK_STATUS, &success);
+    if (!success)
+        return false;
+
+    shader.setProgram(std::move(program));
+    return true;
+}
+
+void ShaderCache::store(uint64_t key, const Shader &shader) const {
+    if (!supported)
+        return;
+
+    int length = 0;
+    glGetProgramiv(shader.getID(), GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+        return;
+
+    std::vector<char> binary(length);
+    GLenum format = 0;
+    glGetProgramBinary(shader.getID(), length, &length, &format, binary.data());
+
+    CacheHeader header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.key = key;
+    header.format = format;
+    header.length = static_cast<uint32_t>(length);
+
+    std::error_code error;
+    fs::create_directories(directory, error);
+
+    // write to a temporary file and rename it, so a crash never leaves a half-written binary behind
+    std::string path = pathFor(key);
+    std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        if (!file)
+            return;
+        file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        file.write(binary.data(), length);
+        if (!file)
+            return;
+    }
+    fs::rename(temporary, path, error);
+    if (error)
+        fs::remove(temporary, error);
+}
+
+std::string ShaderCache::defaultDirectory() {
+    if (const char *dir = std::getenv("DARTS_SHADER_CACHE"))
+        return dir;
+#ifdef _WIN32
+    if (const char *dir = std::getenv("LOCALAPPDATA"))
+        return (fs::path(dir) / "Darts" / "shaders").string();
+#else
+    if (const char *dir = std::getenv("XDG_CACHE_HOME"))
+        return (fs::path(dir) / "darts" / "shaders").string();
+    if (const char *dir = std::getenv("HOME"))
+        return (fs::path(dir) / ".cache" / "darts" / "shaders").string();
+#endif
+    return "";
+}
+
+std::string ShaderCache::pathFor(uint64_t key) const {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(key));
+    return (fs::path(directory) / name).string();
+}
@@ -0,0 +1,59 @@
+#ifndef GRAPHICS_SHADERCACHE_H
+#define GRAPHICS_SHADERCACHE_H
+
+#include "shader.h"
+
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief On-disk cache of linked shader program binaries.
+ * @details Programs are stored with glGetProgramBinary and restored with glProgramBinary,
+ *          keyed by a hash of their source code and the driver that built them. A cache hit
+ *          replaces compiling and linking with a single file read. Anything that doesn't
+ *          validate (wrong driver, truncated file, rejected binary) is treated as a miss.
+ */
+class ShaderCache {
+    public:
+        /// @brief Construct a cache that stores its binaries in the given directory
+        /// @details The directory is created on the first store() if it doesn't exist.
+        /// @note Needs a current OpenGL context
+        /// @param directory where to keep the binaries (an empty string disables the cache)
+        explicit ShaderCache(std::string directory);
+
+        /// @brief Returns true if the driver can save and restore program binaries
+        bool isEnabled() const;
+
+        /// @brief Computes the cache key for a set of shader sources on the current driver
+        /// @param vertexSource the source code for the vertex shader
+        /// @param fragmentSource the source code for the fragment shader
+        /// @param geometrySource the source code for the geometry shader (optional)
+        /// @return a 64-bit FNV-1a hash of the sources and the GL vendor, renderer and version strings
+        uint64_t key(const char *vertexSource, const char *fragmentSource, const char *geometrySource) const;
+
+        /// @brief Restores a program from the cache
+        /// @param key the key returned by key()
+        /// @param shader the shader that takes ownership of the restored program on success
+        /// @return true if the program was restored and linked successfully
+        bool load(uint64_t key, Shader &shader) const;
+
+        /// @brief Saves a linked program to the cache
+        /// @details The program should have been linked with GL_PROGRAM_BINARY_RETRIEVABLE_HINT set.
+        /// @param key the key returned by key()
+        /// @param shader the linked shader to save
+        void store(uint64_t key, const Shader &shader) const;
+
+        /// @brief The default cache directory for this user (e.g. ~/.cache/darts/shaders)
+        static std::string defaultDirectory();
+
+    private:
+        std::string directory;
+        bool supported = false;
+        /// @brief Hash of the GL vendor, renderer and version strings, the starting point of every key
+        uint64_t driverHash = 0;
+
+        /// @brief The file a key is stored in
+        std::string pathFor(uint64_t key) const;
+};
+
+#endif //GRAPHICS_SHADERCACHE_H
@@ -1,25 +1,46 @@
 #include "shaderManager.h"
+#include "../gl/frameUniforms.h"
 #include <fstream>
-#include <sstream>
+#include <stdexcept>
+#include "../util/log.h"
 
 
 ShaderManager::~ShaderManager() {
     clear();
 }
 
-Shader ShaderManager::loadShader(const char *vShaderFile, const char *fShaderFile, const char *gShaderFile, std::string name) {
+Shader &ShaderManager::loadShader(const char *vShaderFile, const char *fShaderFile, const char *gShaderFile, std::string name) {
     return shaders[name] = loadShaderFromFile(vShaderFile, fShaderFile, gShaderFile);
 }
 
+Shader &ShaderManager::loadShaderFromMemory(const char *vShaderCode, const char *fShaderCode, const char *gShaderCode, std::string name) {
+    return shaders[name] = loadShaderFromSource(vShaderCode, fShaderCode, gShaderCode);
+}
+
 Shader &ShaderManager::getShader(std::string name) {
     return shaders[name];
 }
 
 void ShaderManager::clear() {
-    // delete all shaders: "iter" here is const std::pair<std::string, Shader>&, so we need to use
-    // "iter.second" to get the Shader, and delete the program by ID
-    for (const auto &iter: shaders)
-        glDeleteProgram(iter.second.ID);
+    // every Shader owns its program, so erasing them deletes the programs
+    shaders.clear();
+}
+
+void ShaderManager::enableCache(std::string directory) {
+    cache = std::make_unique<ShaderCache>(std::move(directory));
+    if (!cache->isEnabled())
+        cache.reset();
+}
+
+// reads a whole file in one go
+static std::string readFile(const char *path) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file)
+        throw std::runtime_error(std::string("could not open ") + path);
+    std::string contents(static_cast<size_t>(file.tellg()), '\0');
+    file.seekg(0);
+    file.read(&contents[0], contents.size());
+    return contents;
 }
 
 Shader ShaderManager::loadShaderFromFile(const char *vShaderFile, const char *fShaderFile, const char *gShaderFile) {
@@ -28,36 +49,35 @@ Shader ShaderManager::loadShaderFromFile(const char *vShaderFile, const char *fS
     std::string fragmentCode;
     std::string geometryCode;
     try {
-        // open files
-        std::ifstream vertexShaderFile(vShaderFile);
-        std::ifstream fragmentShaderFile(fShaderFile);
-        std::stringstream vShaderStream, fShaderStream;
-        // read file's buffer contents into streams
-        vShaderStream << vertexShaderFile.rdbuf();
-        fShaderStream << fragmentShaderFile.rdbuf();
-        // close file handlers
-        vertexShaderFile.close();
-        fragmentShaderFile.close();
-        // convert stream into string
-        vertexCode = vShaderStream.str();
-        fragmentCode = fShaderStream.str();
+        vertexCode = readFile(vShaderFile);
+        fragmentCode = readFile(fShaderFile);
         // if geometry shader path is present, also load a geometry shader
-        if (gShaderFile != nullptr) {
-            std::ifstream geometryShaderFile(gShaderFile);
-            std::stringstream gShaderStream;
-            gShaderStream << geometryShaderFile.rdbuf();
-            geometryShaderFile.close();
-            geometryCode = gShaderStream.str();
-        }
+        if (gShaderFile != nullptr)
+            geometryCode = readFile(gShaderFile);
     }
     catch (std::exception &e) {
-        std::cout << "ERROR::SHADER: Failed to read shader files" << std::endl;
+        LOG_ERROR("SHADER", "Failed to read shader files: {}", e.what());
     }
-    const char *vShaderCode = vertexCode.c_str();
-    const char *fShaderCode = fragmentCode.c_str();
-    const char *gShaderCode = geometryCode.c_str();
     // 2. now create shader object from source code
+    return loadShaderFromSource(vertexCode.c_str(), fragmentCode.c_str(), gShaderFile != nullptr ? geometryCode.c_str() : nullptr);
+}
+
+Shader ShaderManager::loadShaderFromSource(const char *vShaderCode, const char *fShaderCode, const char *gShaderCode) {
     Shader shader;
-    shader.compile(vShaderCode, fShaderCode, gShaderFile != nullptr ? gShaderCode : nullptr);
+    if (!cache) {
+        shader.compile(vShaderCode, fShaderCode, gShaderCode);
+    }
+    else {
+        // warm start: the driver already built this exact program before
+        uint64_t key = cache->key(vShaderCode, fShaderCode, gShaderCode);
+        if (!cache->load(key, shader)) {
+            // cold start (or the driver rejected the old binary): compile, then save for next time
+            shader.compile(vShaderCode, fShaderCode, gShaderCode, true);
+            cache->store(key, shader);
+        }
+    }
+
+    // every shader gets the per-frame constants (projection etc.) from the same uniform buffer
+    shader.bindUniformBlock(FrameUniforms::BLOCK_NAME, FrameUniforms::BINDING);
     return shader;
-}
\ No newline at end of file
+}
@@ -2,8 +2,10 @@
 #define GRAPHICS_SHADERMANAGER_H
 
 #include "shader.h"
+#include "shaderCache.h"
 
 #include <map>
+#include <memory>
 #include <iostream>
 
 class ShaderManager {
@@ -20,27 +22,53 @@ public:
     /// @param fShaderFile The fragment shader file
     /// @param gShaderFile The geometry shader file (optional)
     /// @param name Name used for the shader in the shaders map
-    /// @return The shader that was loaded
-    Shader loadShader(const char *vShaderFile, const char *fShaderFile, const char *gShaderFile, std::string name);
+    /// @return The shader that was loaded (owned by the manager, valid until clear())
+    Shader &loadShader(const char *vShaderFile, const char *fShaderFile, const char *gShaderFile, std::string name);
+
+    /// @brief Compiles a shader from source code already in memory and stores it in the shaders map
+    /// @param vShaderCode The vertex shader source
+    /// @param fShaderCode The fragment shader source
+    /// @param gShaderCode The geometry shader source (optional)
+    /// @param name Name used for the shader in the shaders map
+    /// @return The shader that was loaded (owned by the manager, valid until clear())
+    Shader &loadShaderFromMemory(const char *vShaderCode, const char *fShaderCode, const char *gShaderCode, std::string name);
 
     /// @brief Returns a reference to the shader with the given name in the shaders map
     /// @param name The name of the shader
     /// @return The shader with the given name
     Shader& getShader(std::string name);
 
-     /// @brief Clears the shaders map
+     /// @brief Clears the shaders map, deleting every program
     void clear();
 
+    /// @brief Caches linked program binaries in the given directory
+    /// @details Shaders loaded afterwards are restored from the cache when their sources and the driver
+    ///          haven't changed, and compiled (then cached) otherwise.
+    /// @note Needs a current OpenGL context
+    /// @param directory where to keep the binaries
+    void enableCache(std::string directory);
+
 private:
     /// @brief A map of shaders, with the key being the name of the shader
     std::map<std::string, Shader> shaders;
 
+    /// @brief Program binary cache (null if caching is disabled)
+    std::unique_ptr<ShaderCache> cache;
+
      /// @brief Loads and compiles a shader from a file
      /// @details This function is private because we only want to load shaders from within this class
      /// @param vShaderFile The vertex shader file
      /// @param fShaderFile The fragment shader file
      /// @param gShaderFile The geometry shader file (optional)
      /// @return The shader that was loaded
-    Shader loadShaderFromFile(const char *vShaderFile, const char *fShaderFile, const char *gShaderFile=nullptr);};
+    Shader loadShaderFromFile(const char *vShaderFile, const char *fShaderFile, const char *gShaderFile=nullptr);
+
+     /// @brief Restores a shader from the cache, or compiles it (and caches it) on a miss
+     /// @param vShaderCode The vertex shader source
+     /// @param fShaderCode The fragment shader source
+     /// @param gShaderCode The geometry shader source (optional)
+     /// @return The shader that was loaded
+    Shader loadShaderFromSource(const char *vShaderCode, const char *fShaderCode, const char *gShaderCode=nullptr);
+};
 
 #endif //GRAPHICS_SHADERMANAGER_H
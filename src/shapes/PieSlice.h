@@ -5,7 +5,6 @@
 #include "rect.h"
 #include "circle.h"
 #include "triangle.h"
-#include "../shader/shader.h"
 #include <memory>
 
 using std::make_unique, std::unique_ptr;
@@ -13,16 +12,12 @@ using std::make_unique, std::unique_ptr;
 class PieSlice {
 private:
     // Each Pie Slice contains 1 triangle and 1 circle to make the end rounded
-    // Store the shapes in a vector and use polymorphism
-    // to draw
+    // Store the shapes in a vector; they are drawn with the rest of the scene
     vector<unique_ptr<Shape>> shapes;
 public:
     // Constructors
     PieSlice();
-    PieSlice(Shader& shader, vec2 pos);
-
-    // Draw the cloud
-    void setUniformsAndDraw() const;
+    PieSlice(SceneStore& scene, vec2 pos);
 /*
     // This will allow us to move the clouds left and right
     void moveXWithinBounds(int delta, const unsigned int width);
@@ -0,0 +1,161 @@
+#include "boardRenderer.h"
+#include "../gl/glState.h"
+#include "../gl/glDebug.h"
+
+#include <algorithm>
+#include <iostream>
+
+// the most cell instances written to the stream buffer per draw
+static const int MAX_INSTANCES_PER_PASS = 1 << 15;
+
+BoardRenderer::BoardRenderer(SceneRenderer &cells, Shader &lodShader, StreamBuffer &stream)
+    : cells(cells), lodShader(lodShader), stream(stream) {
+    // the quad's vertices are streamed, so the pointers are set at draw time
+    VAO = GLVertexArray::create();
+    GLState::bindVertexArray(VAO.get());
+    TexturedVertex::FORMAT.enable();
+
+    lodShader.use();
+    lodShader.setInteger("lights", 0);
+}
+
+void BoardRenderer::draw(const Board &board, const BoardLayout &layout, const Camera &camera,
+                         struct color onColor, struct color offColor, int flashCell, struct color flashColor) {
+    cellsDrawn = 0;
+    lod = false;
+
+    int firstCol, firstRow, lastCol, lastRow;
+    if (!layout.visibleRange(camera.getVisibleBounds(), firstCol, firstRow, lastCol, lastRow))
+        return;
+
+    // Far out, single cells aren't worth drawing (or there are too many of them), so fall back to the texture.
+    // If the board doesn't fit in a texture, draw as many cells as the stream buffer allows instead.
+    long visible = long(lastCol - firstCol + 1) * (lastRow - firstRow + 1);
+    bool tooSmall = layout.step * camera.getZoom() < LOD_CELL_PIXELS || visible > MAX_CELL_INSTANCES;
+    if (tooSmall && updateTexture(board)) {
+        lod = true;
+        drawTexture(board, layout, onColor, offColor);
+        return;
+    }
+
+    drawCells(board, layout, firstCol, firstRow, lastCol, lastRow, onColor, offColor, flashCell, flashColor);
+}
+
+void BoardRenderer::drawCells(const Board &board, const BoardLayout &layout, int firstCol, int firstRow, int lastCol, int lastRow,
+                              struct color onColor, struct color offColor, int flashCell, struct color flashColor) {
+    typedef SceneRenderer::Instance Instance;
+    const std::vector<uint64_t> &words = board.getWords();
+    const int cols = board.getCols();
+    // packed once, every cell is one of these
+    const rgba8 on = onColor.packed(), off = offColor.packed(), flash = flashColor.packed();
+    const uint16_t size = toHalf(layout.cellSize);
+
+    int col = firstCol, row = firstRow;
+    while (row <= lastRow) {
+        StreamBuffer::Allocation allocation = stream.allocate(MAX_INSTANCES_PER_PASS * sizeof(Instance), sizeof(Instance));
+        if (!allocation)
+            return; // this frame's region is full
+
+        Instance *instances = static_cast<Instance *>(allocation.data);
+        uint32_t written = 0;
+        for (; row <= lastRow && written < MAX_INSTANCES_PER_PASS; ++row, col = firstCol) {
+            vec2 rowStart = layout.origin + vec2(0, row) * layout.step;
+            for (; col <= lastCol && written < MAX_INSTANCES_PER_PASS; ++col) {
+                int index = row * cols + col;
+                bool lit = (words[index >> 6] >> (index & 63)) & 1;
+                Instance &instance = instances[written++];
+                instance.position = vec2(rowStart.x + col * layout.step, rowStart.y);
+                instance.size[0] = instance.size[1] = size;
+                instance.color = index == flashCell ? flash : lit ? on : off;
+            }
+            // the pass is full in the middle of a row, pick it up where it stopped
+            if (col <= lastCol)
+                break;
+        }
+        stream.commit(allocation);
+        cells.drawInstances(ShapeType::Rect, allocation, written);
+        cellsDrawn += written;
+    }
+}
+
+void BoardRenderer::drawTexture(const Board &board, const BoardLayout &layout, struct color onColor, struct color offColor) {
+    // each texel covers a whole step (light and gap)
+    vec2 min = layout.origin - vec2(layout.step * 0.5f);
+    vec2 max = min + vec2(board.getCols(), board.getRows()) * layout.step;
+    const TexturedVertex quad[4] = {
+        { min.x, max.y, 0, 0xffff },
+        { min.x, min.y, 0, 0 },
+        { max.x, max.y, 0xffff, 0xffff },
+        { max.x, min.y, 0xffff, 0 }
+    };
+    StreamBuffer::Allocation vertices = stream.write(quad, sizeof(quad), sizeof(TexturedVertex));
+    if (!vertices)
+        return;
+
+    lodShader.use();
+    lodShader.setVector4f("onColor", onColor.vec);
+    lodShader.setVector4f("offColor", offColor.vec);
+    GLState::activeTexture(GL_TEXTURE0);
+    GLState::bindTexture(GL_TEXTURE_2D, texture.get());
+    GLState::bindVertexArray(VAO.get());
+    GLState::bindBuffer(GL_ARRAY_BUFFER, stream.getBuffer());
+    TexturedVertex::FORMAT.point(vertices.offset);
+    GL_CALL(glDrawArrays(GL_TRIANGLE_STRIP, 0, 4));
+}
+
+bool BoardRenderer::updateTexture(const Board &board) {
+    const int cols = board.getCols(), rows = board.getRows();
+    const std::vector<uint64_t> &words = board.getWords();
+
+    if (!texture || textureCols != cols || textureRows != rows) {
+        GLint maxSize = 0;
+        glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxSize);
+        if (cols > maxSize || rows > maxSize)
+            return false;
+
+        if (!texture)
+            texture = GLTexture::create();
+        GLState::activeTexture(GL_TEXTURE0);
+        GLState::bindTexture(GL_TEXTURE_2D, texture.get());
+        GL_CALL(glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, cols, rows, 0, GL_RED, GL_UNSIGNED_BYTE, nullptr));
+        // one byte per cell, plus a third for the mipmaps
+        texture.setBytes(size_t(cols) * rows * 4 / 3);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        // sharp cells up close, averaged (and shimmer-free while panning) far away
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        textureCols = cols;
+        textureRows = rows;
+        texels.resize(size_t(cols) * rows);
+        // make every word look changed, so the whole board is uploaded below
+        uploadedWords.resize(words.size());
+        for (size_t i = 0; i < words.size(); ++i)
+            uploadedWords[i] = ~words[i];
+    }
+
+    // find the range of words that changed since the last upload (a press touches at most three rows)
+    size_t firstWord = 0, lastWord = words.size();
+    while (firstWord < words.size() && words[firstWord] == uploadedWords[firstWord])
+        ++firstWord;
+    if (firstWord == words.size())
+        return true;
+    while (lastWord-- > firstWord && words[lastWord] == uploadedWords[lastWord]) {}
+
+    int first = static_cast<int>(firstWord * 64 / cols);
+    int last = std::min(rows - 1, static_cast<int>((lastWord * 64 + 63) / cols));
+    for (int row = first; row <= last; ++row) {
+        for (int col = 0; col < cols; ++col) {
+            int i = row * cols + col;
+            texels[i] = ((words[i >> 6] >> (i & 63)) & 1) ? 255 : 0;
+        }
+    }
+
+    GLState::activeTexture(GL_TEXTURE0);
+    GLState::bindTexture(GL_TEXTURE_2D, texture.get());
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    GL_CALL(glTexSubImage2D(GL_TEXTURE_2D, 0, 0, first, cols, last - first + 1, GL_RED, GL_UNSIGNED_BYTE, texels.data() + size_t(first) * cols));
+    GL_CALL(glGenerateMipmap(GL_TEXTURE_2D));
+    std::copy(words.begin() + firstWord, words.begin() + lastWord + 1, uploadedWords.begin() + firstWord);
+    return true;
+}
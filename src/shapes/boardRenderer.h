@@ -0,0 +1,75 @@
+#ifndef GRAPHICS_BOARDRENDERER_H
+#define GRAPHICS_BOARDRENDERER_H
+
+#include <glad/glad.h>
+#include <vector>
+#include "sceneRenderer.h"
+#include "../game/board.h"
+#include "../game/boardLayout.h"
+#include "../gl/camera.h"
+#include "../util/color.h"
+
+/**
+ * @brief Draws a Lights Out board straight from its bitboard.
+ * @details Only the cells inside the camera's view are drawn, found with grid math instead of a
+ *          walk over the board, and written as rect instances for the SceneRenderer. When the
+ *          camera is zoomed out so far that a cell is only a few pixels wide (or too many cells
+ *          are visible), the board is drawn as one textured quad instead (level of detail). The
+ *          texture has one texel per cell and only the rows that changed are uploaded again.
+ */
+class BoardRenderer {
+    public:
+        /// @brief Below this many screen pixels per cell the board is drawn as a texture
+        static constexpr float LOD_CELL_PIXELS = 6.0f;
+        /// @brief The most cells drawn as instances in a frame, more switch to the texture
+        static const int MAX_CELL_INSTANCES = 1 << 16;
+
+        /// @brief Creates the texture quad
+        /// @param cells Draws the cells as rect instances
+        /// @param lodShader The board shader (samples the cell texture)
+        /// @param stream The per-frame vertex buffer instances and the quad are written to
+        BoardRenderer(SceneRenderer &cells, Shader &lodShader, StreamBuffer &stream);
+
+        BoardRenderer(const BoardRenderer &) = delete;
+        BoardRenderer &operator=(const BoardRenderer &) = delete;
+
+        /// @brief Draws the part of the board the camera can see
+        /// @param flashCell A cell drawn in flashColor instead (-1 for none)
+        void draw(const Board &board, const BoardLayout &layout, const Camera &camera,
+                  struct color onColor, struct color offColor, int flashCell = -1, struct color flashColor = {});
+
+        /// @brief Number of cells drawn as instances last draw (0 when the texture was used)
+        int getCellsDrawn() const { return cellsDrawn; }
+
+        /// @brief True if the last draw used the texture
+        bool usedTexture() const { return lod; }
+
+    private:
+        SceneRenderer &cells;
+        Shader &lodShader;
+        StreamBuffer &stream;
+
+        GLVertexArray VAO;
+        GLTexture texture;
+        int textureCols = 0, textureRows = 0;
+        /// @brief The board as it is in the texture
+        std::vector<uint64_t> uploadedWords;
+        /// @brief Staging memory for changed rows (one byte per cell)
+        std::vector<uint8_t> texels;
+
+        int cellsDrawn = 0;
+        bool lod = false;
+
+        /// @brief Writes the visible cells as instances and draws them
+        void drawCells(const Board &board, const BoardLayout &layout, int firstCol, int firstRow, int lastCol, int lastRow,
+                       struct color onColor, struct color offColor, int flashCell, struct color flashColor);
+
+        /// @brief Draws the board as one quad textured with its lights
+        void drawTexture(const Board &board, const BoardLayout &layout, struct color onColor, struct color offColor);
+
+        /// @brief Brings the texture up to date with the board
+        /// @return false if the board can't be stored in a texture
+        bool updateTexture(const Board &board);
+};
+
+#endif //GRAPHICS_BOARDRENDERER_H
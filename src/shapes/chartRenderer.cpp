@@ -0,0 +1,140 @@
+#include "chartRenderer.h"
+#include "../gl/glState.h"
+#include "../gl/glDebug.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+const VertexFormat ChartVertex::FORMAT(sizeof(ChartVertex), {
+    {0, 2, GL_FLOAT, false, offsetof(ChartVertex, x)},
+});
+
+void LinePyramid::build(const float *values, size_t count, vector<ChartVertex> &vertices) {
+    this->count = count;
+    offsets.assign(1, 0);
+    vertices.clear();
+    vertices.reserve(count + count * 2 / (FACTOR - 1) + 2 * FACTOR);
+    for (size_t i = 0; i < count; ++i)
+        vertices.push_back({static_cast<float>(i), values[i]});
+
+    // every level from the one below: FACTOR of its buckets (points on level 0) make one bucket
+    size_t below = 0, belowVertices = count, perBucketBelow = 1;
+    for (size_t bucket = FACTOR; bucket / FACTOR < count; bucket *= FACTOR) {
+        size_t level = vertices.size();
+        offsets.push_back(level);
+        size_t span = FACTOR * perBucketBelow;
+        for (size_t first = below; first < below + belowVertices; first += span) {
+            size_t end = std::min(first + span, below + belowVertices);
+            size_t low = first, high = first;
+            for (size_t i = first + 1; i < end; ++i) {
+                if (vertices[i].y < vertices[low].y)
+                    low = i;
+                if (vertices[i].y > vertices[high].y)
+                    high = i;
+            }
+            // in the order they come, so the strip goes through them the way the series does
+            ChartVertex a = vertices[std::min(low, high)], b = vertices[std::max(low, high)];
+            vertices.push_back(a);
+            vertices.push_back(b);
+        }
+        below = level;
+        belowVertices = vertices.size() - level;
+        perBucketBelow = 2;
+    }
+}
+
+int LinePyramid::chooseLevel(double pointsPerPixel) const {
+    int level = 0;
+    for (size_t bucket = FACTOR; level + 1 < getLevels() && static_cast<double>(bucket) <= pointsPerPixel; bucket *= FACTOR)
+        level++;
+    return level;
+}
+
+size_t LinePyramid::range(int level, size_t first, size_t last, size_t &start) const {
+    if (level == 0) {
+        start = first;
+        return last - first + 1;
+    }
+    size_t bucket = 1;
+    for (int i = 0; i < level; ++i)
+        bucket *= FACTOR;
+    size_t firstBucket = first / bucket, lastBucket = last / bucket;
+    start = offsets[level] + 2 * firstBucket;
+    return 2 * (lastBucket - firstBucket + 1);
+}
+
+ChartRenderer::ChartRenderer(Shader &shader) : shader(shader) {
+    // scatter points are sized by the shader
+    GLState::setProgramPointSize(true);
+}
+
+int ChartRenderer::addLine(const float *values, size_t count) {
+    LinePyramid pyramid;
+    pyramid.build(values, count, staging);
+    int index = upload(staging.data(), staging.size(), true);
+    series[index].points = count;
+    series[index].pyramid = pyramid;
+    return index;
+}
+
+int ChartRenderer::addPoints(const ChartVertex *points, size_t count) {
+    return upload(points, count, false);
+}
+
+int ChartRenderer::upload(const ChartVertex *vertices, size_t count, bool line) {
+    Series added;
+    added.points = count;
+    added.line = line;
+    added.buffer = GLBuffer::create();
+    added.VAO = GLVertexArray::create();
+    GLState::bindVertexArray(added.VAO.get());
+    GLState::bindBuffer(GL_ARRAY_BUFFER, added.buffer.get());
+    size_t bytes = std::max<size_t>(count, 1) * sizeof(ChartVertex);
+    GL_CALL(glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(bytes), count > 0 ? vertices : nullptr, GL_STATIC_DRAW));
+    added.buffer.setBytes(bytes);
+    ChartVertex::FORMAT.enable();
+    ChartVertex::FORMAT.point(0);
+    series.push_back(std::move(added));
+    return static_cast<int>(series.size() - 1);
+}
+
+void ChartRenderer::clear() {
+    series.clear();
+    // the staging memory is only worth keeping while charts are being built
+    staging = vector<ChartVertex>();
+}
+
+void ChartRenderer::draw(int index, const ChartView &view, struct color color, float pointSize) {
+    verticesDrawn = 0;
+    levelDrawn = 0;
+    const Series &s = series[index];
+    glm::vec2 size = view.screenMax - view.screenMin, span = view.dataMax - view.dataMin;
+    if (s.points == 0 || size.x <= 0 || size.y <= 0 || span.x <= 0 || span.y <= 0)
+        return;
+
+    size_t start = 0, count = s.points;
+    GLenum mode = GL_POINTS;
+    if (s.line) {
+        // the points in view, and one either side so the line runs on to the edges
+        double first = std::floor(view.dataMin.x) - 1, last = std::ceil(view.dataMax.x) + 1;
+        if (last < 0 || first > static_cast<double>(s.points - 1))
+            return;
+        size_t a = first < 0 ? 0 : static_cast<size_t>(first);
+        size_t b = std::min(static_cast<size_t>(last), s.points - 1);
+        levelDrawn = s.pyramid.chooseLevel(static_cast<double>(b - a + 1) / size.x);
+        count = s.pyramid.range(levelDrawn, a, b, start);
+        mode = GL_LINE_STRIP;
+    }
+
+    shader.use();
+    shader.setVector2f("dataMin", view.dataMin);
+    shader.setVector2f("dataScale", size / span);
+    shader.setVector2f("screenMin", view.screenMin);
+    shader.setVector2f("screenMax", view.screenMax);
+    shader.setFloat("pointSize", pointSize);
+    shader.setVector4f("color", color.vec);
+    GLState::bindVertexArray(s.VAO.get());
+    GL_CALL(glDrawArrays(mode, static_cast<GLint>(start), static_cast<GLsizei>(count)));
+    verticesDrawn = count;
+}
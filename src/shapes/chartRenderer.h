@@ -0,0 +1,127 @@
+#ifndef GRAPHICS_CHARTRENDERER_H
+#define GRAPHICS_CHARTRENDERER_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <vector>
+#include "../gl/gpuResource.h"
+#include "../gl/vertexFormat.h"
+#include "../shader/shader.h"
+#include "../util/color.h"
+
+using std::vector;
+
+/// @brief A point of a chart, in the chart's own units: 8 bytes
+struct ChartVertex {
+    float x, y;
+
+    static const VertexFormat FORMAT;
+};
+
+/**
+ * @brief A line series (y for x = 0, 1, 2, ...) with a min/max decimation pyramid.
+ * @details Level 0 is the points themselves. Every level above it splits the points into buckets
+ *          FACTOR times bigger than the level below and keeps two points per bucket: the lowest and
+ *          the highest, in the order they come. Drawn as one line strip, a level still reaches every
+ *          peak and dip of the series, so a zoomed out chart looks the same as with every point but
+ *          draws only a few per pixel column. All levels together are 5/3 of the points.
+ */
+class LinePyramid {
+    public:
+        /// @brief How many times bigger a level's buckets are than the ones below it
+        static const size_t FACTOR = 4;
+
+        /// @brief Builds the levels of a series
+        /// @param vertices filled with every level, one after the other (for uploading)
+        void build(const float *values, size_t count, vector<ChartVertex> &vertices);
+
+        size_t getCount() const { return count; }
+        int getLevels() const { return static_cast<int>(offsets.size()); }
+
+        /// @brief The coarsest level that still has a bucket per pixel column
+        /// @param pointsPerPixel points of the series in a pixel column (at the current zoom)
+        int chooseLevel(double pointsPerPixel) const;
+        /// @brief The vertices of a level covering points first to last
+        /// @param start the first vertex (index into everything build() wrote)
+        /// @return the number of vertices
+        size_t range(int level, size_t first, size_t last, size_t &start) const;
+
+    private:
+        size_t count = 0;
+        /// @brief Where each level's vertices start
+        vector<size_t> offsets;
+};
+
+/// @brief Where a chart goes and what part of its data it shows
+struct ChartView {
+    /// @brief The chart's rectangle on screen, pixels from the bottom left of the window
+    glm::vec2 screenMin, screenMax;
+    /// @brief The data at its bottom left and top right corners
+    glm::vec2 dataMin, dataMax;
+};
+
+/**
+ * @brief Draws line charts and scatter plots of series uploaded to the GPU once.
+ * @details Every series lives in its own static vertex buffer, so drawing one is a single draw call
+ *          however long it is, with nothing uploaded per frame and no shape per point. Line series
+ *          are drawn from the level of their LinePyramid that fits the zoom, so a million point
+ *          series zoomed all the way out draws a few thousand vertices. Scatter plots are drawn as
+ *          points, all of them (a point is a few pixels, there's nothing to merge). The shader
+ *          clips everything to the chart's rectangle.
+ *
+ * Usage:
+ * @code
+ * int averages = charts.addLine(values.data(), values.size());
+ * charts.draw(averages, ChartView{{20, 20}, {420, 220}, {0, 0}, {values.size() - 1, 180}}, color);
+ * @endcode
+ */
+class ChartRenderer {
+    public:
+        /// @param shader The chart shader
+        explicit ChartRenderer(Shader &shader);
+
+        ChartRenderer(const ChartRenderer &) = delete;
+        ChartRenderer &operator=(const ChartRenderer &) = delete;
+
+        /// @brief Uploads a line series, point i at (i, values[i])
+        /// @return the series to draw
+        int addLine(const float *values, size_t count);
+        /// @brief Uploads a scatter series
+        int addPoints(const ChartVertex *points, size_t count);
+        /// @brief Deletes every series
+        void clear();
+
+        /// @brief Points in a series
+        size_t getCount(int series) const { return this->series[series].points; }
+
+        /// @brief Draws a series in a view
+        /// @param pointSize the size of scatter points in pixels
+        void draw(int series, const ChartView &view, struct color color, float pointSize = 2.0f);
+
+        /// @brief Vertices and pyramid level of the last draw (the level is 0 for scatter plots)
+        size_t getVerticesDrawn() const { return verticesDrawn; }
+        int getLevelDrawn() const { return levelDrawn; }
+
+    private:
+        struct Series {
+            GLBuffer buffer;
+            GLVertexArray VAO;
+            size_t points = 0;
+            bool line = false;
+            LinePyramid pyramid;
+        };
+
+        Shader &shader;
+        vector<Series> series;
+        /// @brief Staging for the pyramid (kept so uploading another series doesn't allocate again)
+        vector<ChartVertex> staging;
+
+        size_t verticesDrawn = 0;
+        int levelDrawn = 0;
+
+        /// @brief Puts vertices in a new series' buffer
+        int upload(const ChartVertex *vertices, size_t count, bool line);
+};
+
+#endif //GRAPHICS_CHARTRENDERER_H
@@ -0,0 +1,130 @@
+#include "heatmapRenderer.h"
+#include "../gl/glState.h"
+#include "../gl/glDebug.h"
+#include "../util/log.h"
+
+#include <algorithm>
+#include <cstddef>
+
+// the first instance buffer holds this many darts
+static const size_t FIRST_CAPACITY = 4096;
+
+const VertexFormat HeatPoint::FORMAT(sizeof(HeatPoint), {
+    {0, 2, GL_SHORT, false, offsetof(HeatPoint, x)},
+}, 1);
+
+HeatmapRenderer::HeatmapRenderer(Shader &splatShader, Shader &toneShader)
+    : splatShader(splatShader), toneShader(toneShader), cells(size_t(CELLS) * CELLS, 0) {
+    // one float per texel, so a million darts on the same spot still add up exactly
+    densities = GLTexture::create();
+    GLState::activeTexture(GL_TEXTURE0);
+    GLState::bindTexture(GL_TEXTURE_2D, densities.get());
+    GL_CALL(glTexImage2D(GL_TEXTURE_2D, 0, GL_R32F, RESOLUTION, RESOLUTION, 0, GL_RED, GL_FLOAT, nullptr));
+    densities.setBytes(size_t(RESOLUTION) * RESOLUTION * sizeof(float));
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    framebuffer = GLFramebuffer::create();
+    GLState::bindFramebuffer(framebuffer.get());
+    GL_CALL(glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, densities.get(), 0));
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    if (status != GL_FRAMEBUFFER_COMPLETE)
+        LOG_ERROR("HEATMAP", "Can't draw into a float texture (framebuffer status {})", status);
+    GLState::bindFramebuffer(0);
+    clearTexture();
+
+    // the instance buffer's pointer is set at draw time, it starts at the first dart not splatted yet
+    instances = GLBuffer::create();
+    splatVAO = GLVertexArray::create();
+    GLState::bindVertexArray(splatVAO.get());
+    HeatPoint::FORMAT.enable();
+    quadVAO = GLVertexArray::create();
+
+    // the sprite reaches 3 sigma, past that a splat adds next to nothing
+    splatShader.use();
+    splatShader.setFloat("extent", EXTENT);
+    splatShader.setFloat("sigma", SIGMA);
+    splatShader.setFloat("radius", 3 * SIGMA);
+    toneShader.use();
+    toneShader.setInteger("densities", 0);
+    toneShader.setFloat("extent", EXTENT);
+}
+
+void HeatmapRenderer::add(const HeatPoint *added, size_t count) {
+    points.insert(points.end(), added, added + count);
+    for (size_t i = 0; i < count; ++i) {
+        // tenths of millimetres to cells, darts off the texture don't count
+        int col = static_cast<int>((added[i].x * 0.1f + EXTENT) / SIGMA);
+        int row = static_cast<int>((added[i].y * 0.1f + EXTENT) / SIGMA);
+        if (col < 0 || row < 0 || col >= CELLS || row >= CELLS)
+            continue;
+        peak = std::max(peak, ++cells[size_t(row) * CELLS + col]);
+    }
+}
+
+void HeatmapRenderer::clear() {
+    points.clear();
+    firstPending = 0;
+    splatted = 0;
+    std::fill(cells.begin(), cells.end(), 0);
+    peak = 0;
+    clearTexture();
+}
+
+void HeatmapRenderer::draw(glm::vec2 screenMin, glm::vec2 screenMax) {
+    splatted = 0;
+    if (firstPending < points.size())
+        splat();
+
+    // a cell's darts land within about a sigma of each other, so its middle gets most of each splat
+    toneShader.use();
+    toneShader.setVector2f("screenMin", screenMin);
+    toneShader.setVector2f("screenMax", screenMax);
+    toneShader.setFloat("peak", std::max(0.8f * static_cast<float>(peak), 1.0f));
+    GLState::activeTexture(GL_TEXTURE0);
+    GLState::bindTexture(GL_TEXTURE_2D, densities.get());
+    GLState::bindVertexArray(quadVAO.get());
+    GL_CALL(glDrawArrays(GL_TRIANGLE_STRIP, 0, 4));
+}
+
+void HeatmapRenderer::splat() {
+    const size_t count = points.size() - firstPending;
+    GLState::bindVertexArray(splatVAO.get());
+    GLState::bindBuffer(GL_ARRAY_BUFFER, instances.get());
+    if (points.size() > capacity) {
+        // a bigger buffer, with every dart in it again (the old ones are already in the texture)
+        capacity = std::max({points.size(), capacity * 2, FIRST_CAPACITY});
+        GL_CALL(glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(capacity * sizeof(HeatPoint)), nullptr, GL_DYNAMIC_DRAW));
+        instances.setBytes(capacity * sizeof(HeatPoint));
+        GL_CALL(glBufferSubData(GL_ARRAY_BUFFER, 0, static_cast<GLsizeiptr>(points.size() * sizeof(HeatPoint)), points.data()));
+    }
+    else {
+        GL_CALL(glBufferSubData(GL_ARRAY_BUFFER, static_cast<GLintptr>(firstPending * sizeof(HeatPoint)),
+                                static_cast<GLsizeiptr>(count * sizeof(HeatPoint)), points.data() + firstPending));
+    }
+    HeatPoint::FORMAT.point(static_cast<GLintptr>(firstPending * sizeof(HeatPoint)));
+
+    // every new dart in one draw, added onto what's there
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    GLState::bindFramebuffer(framebuffer.get());
+    glViewport(0, 0, RESOLUTION, RESOLUTION);
+    GLState::blendFunc(GL_ONE, GL_ONE);
+    splatShader.use();
+    GL_CALL(glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, static_cast<GLsizei>(count)));
+    GLState::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    GLState::bindFramebuffer(0);
+    glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+
+    splatted = count;
+    firstPending = points.size();
+}
+
+void HeatmapRenderer::clearTexture() {
+    const GLfloat zero[4] = {0, 0, 0, 0};
+    GLState::bindFramebuffer(framebuffer.get());
+    GL_CALL(glClearBufferfv(GL_COLOR, 0, zero));
+    GLState::bindFramebuffer(0);
+}
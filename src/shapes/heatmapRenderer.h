@@ -0,0 +1,104 @@
+#ifndef GRAPHICS_HEATMAPRENDERER_H
+#define GRAPHICS_HEATMAPRENDERER_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "../gl/gpuResource.h"
+#include "../gl/vertexFormat.h"
+#include "../shader/shader.h"
+
+using std::vector;
+
+/// @brief Where a dart landed, tenths of millimetres from the bull (as in a ThrowRecord): 4 bytes
+struct HeatPoint {
+    int16_t x, y;
+
+    /// @brief One per splat instance
+    static const VertexFormat FORMAT;
+};
+
+/**
+ * @brief Draws how densely darts landed on the board, from any number of them.
+ * @details Every dart is a Gaussian splat (SIGMA millimetres wide) added into a float texture that
+ *          covers the board, with additive blending: one instanced draw of a quad per dart, its
+ *          position the only per-instance data. The texture is kept, so when darts arrive only they
+ *          are splatted, and drawing the heatmap is one quad that tone maps the densities through a
+ *          colour ramp (log scaled, so a few stray darts still show next to the treble 20) with the
+ *          board's wires drawn over it.
+ *
+ *          The brightest spot is estimated on the CPU from counts in SIGMA sized cells, so the tone
+ *          mapping needs nothing read back from the GPU.
+ *
+ * Usage:
+ * @code
+ * heatmap.add(points.data(), points.size());   // everything so far, splatted on the next draw
+ * heatmap.add(HeatPoint{record.x, record.y});  // one more, only it is splatted
+ * heatmap.draw({20, 20}, {420, 420});
+ * @endcode
+ */
+class HeatmapRenderer {
+    public:
+        /// @brief Texels along each side of the density texture
+        static const int RESOLUTION = 512;
+        /// @brief Millimetres from the bull to the texture's edges (the board's outer wire is at 170)
+        static constexpr float EXTENT = 180.0f;
+        /// @brief The standard deviation of a dart's splat in millimetres
+        static constexpr float SIGMA = 3.0f;
+
+        /// @brief Creates the density texture and its framebuffer
+        /// @param splatShader The splat shader (adds a dart's Gaussian to the densities)
+        /// @param toneShader The heatmap shader (densities to colours)
+        HeatmapRenderer(Shader &splatShader, Shader &toneShader);
+
+        HeatmapRenderer(const HeatmapRenderer &) = delete;
+        HeatmapRenderer &operator=(const HeatmapRenderer &) = delete;
+
+        /// @brief Adds darts, splatted on the next draw
+        void add(const HeatPoint *points, size_t count);
+        void add(HeatPoint point) { add(&point, 1); }
+        /// @brief Forgets every dart
+        void clear();
+
+        /// @brief Darts added
+        size_t getCount() const { return points.size(); }
+        /// @brief Darts splatted by the last draw (0 if none were new)
+        size_t getSplatted() const { return splatted; }
+
+        /// @brief Splats the darts added since the last draw, then draws the heatmap
+        /// @param screenMin,screenMax the square it's drawn in, pixels from the bottom left of the window
+        void draw(glm::vec2 screenMin, glm::vec2 screenMax);
+
+    private:
+        /// @brief Cells of the peak estimate along each side
+        static const int CELLS = static_cast<int>(2 * EXTENT / SIGMA);
+
+        Shader &splatShader;
+        Shader &toneShader;
+
+        GLTexture densities;
+        GLFramebuffer framebuffer;
+        /// @brief The darts, one instance each (grown by doubling, like a vector)
+        GLBuffer instances;
+        size_t capacity = 0;
+        GLVertexArray splatVAO;
+        /// @brief Has no attributes, the quad's corners come from gl_VertexID
+        GLVertexArray quadVAO;
+
+        /// @brief Every dart added, the ones from first pending on aren't in the texture yet
+        vector<HeatPoint> points;
+        size_t firstPending = 0;
+        size_t splatted = 0;
+        /// @brief Darts per cell, and the most in any one
+        vector<uint32_t> cells;
+        uint32_t peak = 0;
+
+        /// @brief Uploads the pending darts and adds their splats to the texture
+        void splat();
+        /// @brief Sets every density to 0
+        void clearTexture();
+};
+
+#endif //GRAPHICS_HEATMAPRENDERER_H
@@ -0,0 +1,145 @@
+#include "sceneRenderer.h"
+#include "../gl/glState.h"
+#include "../gl/glDebug.h"
+
+#include <algorithm>
+#include <cstddef>
+
+// the most instances written to the stream buffer per draw pass
+static const size_t MAX_INSTANCES_PER_PASS = 1 << 15;
+// number of x,y points around the circle mesh
+static const int CIRCLE_SEGMENTS = 100;
+
+const VertexFormat SceneRenderer::MeshVertex::FORMAT(sizeof(MeshVertex), {
+    {0, 2, GL_SHORT, true, offsetof(MeshVertex, x)},
+});
+
+const VertexFormat SceneRenderer::Instance::FORMAT(sizeof(Instance), {
+    {1, 2, GL_FLOAT, false, offsetof(Instance, position)},
+    {2, 2, GL_HALF_FLOAT, false, offsetof(Instance, size)},
+    {3, 4, GL_UNSIGNED_BYTE, true, offsetof(Instance, color)},
+}, 1);
+
+SceneRenderer::SceneRenderer(Shader &shader, StreamBuffer &stream) : shader(shader), stream(stream) {
+    initMesh(ShapeType::Rect, {
+        -0.5f, 0.5f,   // Top left
+        0.5f, 0.5f,    // Top right
+        -0.5f, -0.5f,  // Bottom left
+        0.5f, -0.5f    // Bottom right
+    }, {
+        0, 1, 2, // First triangle
+        1, 2, 3  // Second triangle
+    }, GL_TRIANGLES);
+
+    initMesh(ShapeType::Triangle, {
+        -0.5f, -0.5f,  // Bottom left
+        0.5f, -0.5f,   // Bottom right
+        0.0f, 0.5f     // Top
+    }, {
+        0, 1, 2,
+    }, GL_TRIANGLES);
+
+    // Center of circle, then the rim (radius 0.5 so the size is the diameter)
+    std::vector<float> circle = {0.0f, 0.0f};
+    for (int i = 0; i <= CIRCLE_SEGMENTS; ++i) {
+        float theta = 2.0f * 3.1415926f * float(i) / float(CIRCLE_SEGMENTS);
+        circle.push_back(0.5f * cosf(theta)); // x = r*cos(theta)
+        circle.push_back(0.5f * sinf(theta)); // y = r*sin(theta)
+    }
+    initMesh(ShapeType::Circle, circle, {}, GL_TRIANGLE_FAN);
+}
+
+void SceneRenderer::initMesh(ShapeType type, const std::vector<float> &vertices, const std::vector<unsigned int> &indices, GLenum mode) {
+    Mesh &mesh = meshes[static_cast<int>(type)];
+    mesh.mode = mode;
+
+    mesh.VAO = GLVertexArray::create();
+    GLState::bindVertexArray(mesh.VAO.get());
+
+    // Unit mesh vertices (x, y as normalized shorts) at location 0
+    std::vector<MeshVertex> packed(vertices.size() / 2);
+    for (size_t i = 0; i < packed.size(); ++i)
+        packed[i] = {toSnorm16(vertices[2 * i]), toSnorm16(vertices[2 * i + 1])};
+    mesh.VBO = GLBuffer::create();
+    GLState::bindBuffer(GL_ARRAY_BUFFER, mesh.VBO.get());
+    glBufferData(GL_ARRAY_BUFFER, packed.size() * sizeof(MeshVertex), packed.data(), GL_STATIC_DRAW);
+    mesh.VBO.setBytes(packed.size() * sizeof(MeshVertex));
+    MeshVertex::FORMAT.enable();
+    MeshVertex::FORMAT.point(0);
+
+    if (!indices.empty()) {
+        mesh.EBO = GLBuffer::create();
+        GLState::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.EBO.get());
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
+        mesh.EBO.setBytes(indices.size() * sizeof(unsigned int));
+        mesh.count = static_cast<GLsizei>(indices.size());
+    }
+    else {
+        mesh.count = static_cast<GLsizei>(packed.size());
+    }
+
+    // Per-instance position, size and color (locations 1 to 3), advanced once per shape.
+    // The pointers are set at draw time because they point into the stream buffer.
+    Instance::FORMAT.enable();
+}
+
+void SceneRenderer::draw(const SceneStore &scene, const Bounds &view) {
+    const vector<vec2> &positions = scene.getPositions();
+    const vector<vec2> &sizes = scene.getSizes();
+    const vector<struct color> &colors = scene.getColors();
+    const vector<ShapeType> &types = scene.getTypes();
+    const vector<uint8_t> &flags = scene.getFlags();
+    const uint8_t wanted = SceneStore::ALIVE | SceneStore::VISIBLE;
+
+    size_t slot = 0, slots = scene.slotCount();
+    while (slot < slots) {
+        size_t capacity = std::min(scene.size(), MAX_INSTANCES_PER_PASS);
+        if (capacity == 0)
+            return;
+        StreamBuffer::Allocation allocation = stream.allocate(capacity * sizeof(Instance), sizeof(Instance));
+        if (!allocation)
+            return; // this frame's region is full
+
+        // one linear walk over the arrays, writing instances and splitting them into same-type runs
+        Instance *instances = static_cast<Instance *>(allocation.data);
+        uint32_t written = 0;
+        batches.clear();
+        for (; slot < slots && written < capacity; ++slot) {
+            if ((flags[slot] & wanted) != wanted || !view.intersects(positions[slot], sizes[slot]))
+                continue;
+            Instance &instance = instances[written];
+            instance.position = positions[slot];
+            instance.size[0] = toHalf(sizes[slot].x);
+            instance.size[1] = toHalf(sizes[slot].y);
+            instance.color = colors[slot].packed();
+            if (batches.empty() || batches.back().type != types[slot])
+                batches.push_back({types[slot], written, 0});
+            batches.back().count++;
+            written++;
+        }
+        stream.commit(allocation);
+
+        for (const Batch &batch : batches) {
+            StreamBuffer::Allocation run = allocation;
+            run.offset += batch.first * sizeof(Instance);
+            drawInstances(batch.type, run, batch.count);
+        }
+    }
+}
+
+void SceneRenderer::drawInstances(ShapeType type, const StreamBuffer::Allocation &instances, uint32_t count) {
+    if (count == 0)
+        return;
+
+    shader.use();
+    const Mesh &mesh = meshes[static_cast<int>(type)];
+    GLState::bindVertexArray(mesh.VAO.get());
+    GLState::bindBuffer(GL_ARRAY_BUFFER, stream.getBuffer());
+
+    Instance::FORMAT.point(instances.offset);
+
+    if (mesh.EBO)
+        GL_CALL(glDrawElementsInstanced(mesh.mode, mesh.count, GL_UNSIGNED_INT, nullptr, count));
+    else
+        GL_CALL(glDrawArraysInstanced(mesh.mode, 0, mesh.count, count));
+}
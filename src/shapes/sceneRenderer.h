@@ -0,0 +1,81 @@
+#ifndef GRAPHICS_SCENERENDERER_H
+#define GRAPHICS_SCENERENDERER_H
+
+#include <glad/glad.h>
+#include <vector>
+#include "sceneStore.h"
+#include "../shader/shader.h"
+#include "../gl/streamBuffer.h"
+#include "../gl/vertexFormat.h"
+#include "../gl/gpuResource.h"
+#include "../util/bounds.h"
+
+/**
+ * @brief Draws every visible shape in a SceneStore with instanced draw calls.
+ * @details Each shape type has one unit mesh. Per frame, the renderer walks the store's arrays once,
+ *          writes one packed 16 byte instance (position, size, color) per visible shape into the stream buffer and
+ *          issues one instanced draw per run of consecutive shapes of the same type, which keeps the
+ *          scene's draw order. Shapes outside the camera's view are skipped. Nothing is allocated
+ *          per frame.
+ */
+class SceneRenderer {
+    public:
+        /// @brief Creates the unit meshes
+        /// @param shader The shape shader (reads per-instance attributes 1 to 3)
+        /// @param stream The per-frame vertex buffer instances are written to
+        SceneRenderer(Shader &shader, StreamBuffer &stream);
+
+        SceneRenderer(const SceneRenderer &) = delete;
+        SceneRenderer &operator=(const SceneRenderer &) = delete;
+
+        /// @brief What is uploaded per shape, 16 bytes (half of 4 floats for the transform and 4 for the color)
+        struct Instance {
+            glm::vec2 position;
+            /// @brief Half floats (see toHalf()), plenty for sizes
+            uint16_t size[2];
+            rgba8 color;
+
+            static const VertexFormat FORMAT;
+        };
+
+        /// @brief Draws every visible shape in the scene that overlaps view, in slot order
+        void draw(const SceneStore &scene, const Bounds &view);
+
+        /// @brief Draws count instances of one shape type that were written to the stream buffer
+        /// @details For renderers that generate their instances themselves (e.g. BoardRenderer).
+        void drawInstances(ShapeType type, const StreamBuffer::Allocation &instances, uint32_t count);
+
+    private:
+        /// @brief A unit mesh vertex, normalized shorts (the mesh is within [-0.5, 0.5])
+        struct MeshVertex {
+            int16_t x, y;
+
+            static const VertexFormat FORMAT;
+        };
+
+        /// @brief A unit-sized mesh for one shape type, centered on the origin
+        struct Mesh {
+            GLVertexArray VAO;
+            GLBuffer VBO, EBO;
+            GLenum mode = GL_TRIANGLES;
+            GLsizei count = 0;
+        };
+
+        /// @brief A run of consecutive instances of the same type
+        struct Batch {
+            ShapeType type;
+            uint32_t first, count;
+        };
+
+        Shader &shader;
+        StreamBuffer &stream;
+        Mesh meshes[SHAPE_TYPE_COUNT];
+        /// @brief Reused every frame (cleared, never shrunk)
+        std::vector<Batch> batches;
+
+        /// @brief Packs and uploads a unit mesh (x, y pairs) and sets up its VAO
+        void initMesh(ShapeType type, const std::vector<float> &vertices, const std::vector<unsigned int> &indices, GLenum mode);
+
+};
+
+#endif //GRAPHICS_SCENERENDERER_H
@@ -0,0 +1,70 @@
+#include "sceneStore.h"
+
+void SceneStore::reserve(size_t n) {
+    positions.reserve(n);
+    sizes.reserve(n);
+    colors.reserve(n);
+    types.reserve(n);
+    flagBits.reserve(n);
+    tags.reserve(n);
+    generations.reserve(n);
+}
+
+ShapeHandle SceneStore::create(ShapeType type, vec2 pos, vec2 size, struct color color) {
+    uint32_t i;
+    if (!freeSlots.empty()) {
+        i = freeSlots.back();
+        freeSlots.pop_back();
+        positions[i] = pos;
+        sizes[i] = size;
+        colors[i] = color;
+        types[i] = type;
+        tags[i] = NO_TAG;
+    }
+    else {
+        i = static_cast<uint32_t>(types.size());
+        positions.push_back(pos);
+        sizes.push_back(size);
+        colors.push_back(color);
+        types.push_back(type);
+        flagBits.push_back(0);
+        tags.push_back(NO_TAG);
+        generations.push_back(0);
+    }
+    flagBits[i] = ALIVE | VISIBLE | PICKABLE;
+    live++;
+    return {i, generations[i]};
+}
+
+void SceneStore::destroy(ShapeHandle handle) {
+    if (!isAlive(handle))
+        return;
+    flagBits[handle.index] = 0;
+    generations[handle.index]++;
+    freeSlots.push_back(handle.index);
+    live--;
+}
+
+bool SceneStore::isAlive(ShapeHandle handle) const {
+    return handle.index < types.size() && generations[handle.index] == handle.generation &&
+           (flagBits[handle.index] & ALIVE);
+}
+
+bool SceneStore::contains(uint32_t i, vec2 point) const {
+    vec2 d = point - positions[i];
+    vec2 half = sizes[i] * 0.5f;
+    if (types[i] == ShapeType::Circle)
+        return d.x * d.x + d.y * d.y < half.x * half.x;
+    // rects and triangles use their bounding box
+    return d.x > -half.x && d.x < half.x && d.y > -half.y && d.y < half.y;
+}
+
+ShapeHandle SceneStore::hitTest(vec2 point) const {
+    const uint8_t wanted = ALIVE | VISIBLE | PICKABLE;
+    // walk backwards so the shape drawn last (on top) wins
+    for (size_t i = types.size(); i-- > 0;) {
+        if ((flagBits[i] & wanted) == wanted && contains(static_cast<uint32_t>(i), point))
+            return handleAt(static_cast<uint32_t>(i));
+    }
+    return ShapeHandle();
+}
@@ -0,0 +1,112 @@
+#ifndef GRAPHICS_SCENESTORE_H
+#define GRAPHICS_SCENESTORE_H
+
+#include <cstdint>
+#include <vector>
+#include "glm/glm.hpp"
+#include "../util/color.h"
+
+using std::vector, glm::vec2;
+
+/// @brief The kinds of shape the scene can hold
+enum class ShapeType : uint8_t {Rect, Circle, Triangle};
+/// @brief Number of ShapeType values
+const int SHAPE_TYPE_COUNT = 3;
+
+/// @brief Stable reference to a shape in a SceneStore
+/// @details The generation changes every time a slot is reused, so a handle to a destroyed
+///          shape never silently refers to whichever shape took its slot.
+struct ShapeHandle {
+    uint32_t index = ~0u;
+    uint32_t generation = 0;
+
+    bool operator==(const ShapeHandle &other) const { return index == other.index && generation == other.generation; }
+    bool operator!=(const ShapeHandle &other) const { return !(*this == other); }
+};
+
+/**
+ * @brief Structure-of-arrays storage for every shape in the scene.
+ * @details Each property lives in its own contiguous array indexed by slot, so rendering,
+ *          hit-testing and animation walk memory linearly instead of chasing one heap object per
+ *          shape. Destroyed slots go on a free list and are reused, so after warm-up creating and
+ *          destroying shapes doesn't allocate either.
+ */
+class SceneStore {
+    public:
+        /// @brief Per-shape flags
+        enum Flags : uint8_t {
+            ALIVE    = 1 << 0, ///< The slot holds a shape
+            VISIBLE  = 1 << 1, ///< The shape is drawn
+            PICKABLE = 1 << 2, ///< The shape can be found by hitTest()
+        };
+
+        /// @brief Value of a shape's tag when none has been set
+        static const uint32_t NO_TAG = ~0u;
+
+        /// @brief Reserves room for n shapes so creating them doesn't reallocate
+        void reserve(size_t n);
+
+        /// @brief Adds a shape (visible and pickable)
+        ShapeHandle create(ShapeType type, vec2 pos, vec2 size, struct color color);
+
+        /// @brief Removes a shape and puts its slot on the free list
+        void destroy(ShapeHandle handle);
+
+        /// @brief Returns true if the handle refers to a shape that hasn't been destroyed
+        bool isAlive(ShapeHandle handle) const;
+
+        /// @brief Finds the topmost (last drawn) visible, pickable shape containing point
+        /// @return the shape's handle, or an invalid handle if there is none
+        ShapeHandle hitTest(vec2 point) const;
+
+        /// @brief Returns true if the shape in slot i contains point
+        bool contains(uint32_t i, vec2 point) const;
+
+        /// @brief Number of live shapes
+        size_t size() const { return live; }
+
+        /// @brief Number of slots (live or free); the length of every array below
+        size_t slotCount() const { return types.size(); }
+
+        /// @brief The handle of the shape in slot i
+        ShapeHandle handleAt(uint32_t i) const { return {i, generations[i]}; }
+
+        // --------------------------------------------------------
+        // Per-shape access (the handle must be alive)
+        // --------------------------------------------------------
+        vec2 &pos(ShapeHandle h)                { return positions[h.index]; }
+        vec2 &size(ShapeHandle h)               { return sizes[h.index]; }
+        struct color &color(ShapeHandle h)      { return colors[h.index]; }
+        uint8_t &flags(ShapeHandle h)           { return flagBits[h.index]; }
+        uint32_t &tag(ShapeHandle h)            { return tags[h.index]; }
+        ShapeType type(ShapeHandle h) const     { return types[h.index]; }
+        vec2 pos(ShapeHandle h) const           { return positions[h.index]; }
+        vec2 size(ShapeHandle h) const          { return sizes[h.index]; }
+        struct color color(ShapeHandle h) const { return colors[h.index]; }
+        uint8_t flags(ShapeHandle h) const      { return flagBits[h.index]; }
+        uint32_t tag(ShapeHandle h) const       { return tags[h.index]; }
+
+        // --------------------------------------------------------
+        // Bulk access for linear passes (indexed by slot)
+        // --------------------------------------------------------
+        const vector<vec2> &getPositions() const          { return positions; }
+        const vector<vec2> &getSizes() const              { return sizes; }
+        const vector<struct color> &getColors() const     { return colors; }
+        const vector<ShapeType> &getTypes() const         { return types; }
+        const vector<uint8_t> &getFlags() const           { return flagBits; }
+        vector<struct color> &getColors()                 { return colors; }
+
+    private:
+        vector<vec2> positions;
+        vector<vec2> sizes;
+        vector<struct color> colors;
+        vector<ShapeType> types;
+        vector<uint8_t> flagBits;
+        /// @brief Caller-defined id per shape (e.g. which board cell it shows), returned through hitTest()
+        vector<uint32_t> tags;
+        vector<uint32_t> generations;
+        vector<uint32_t> freeSlots;
+        size_t live = 0;
+};
+
+#endif //GRAPHICS_SCENESTORE_H
@@ -1,109 +1,90 @@
 #include "shape.h"
 
-Shape::Shape(Shader &shader, glm::vec2 pos, glm::vec2 size, struct color color) :
-    shader(shader), pos(pos), size(size), color(color) {
-    initVAO();
-    initVBO();
-    initEBO();
-}
-
-Shape::Shape(Shape const& other) :
-    shader(other.shader), pos(other.pos), size(other.size), color(other.color) {}
+Shape::Shape(SceneStore &scene, ShapeType type, glm::vec2 pos, glm::vec2 size, struct color color) :
+    scene(&scene), handle(scene.create(type, pos, size, color)) {}
 
-// Initialize VAO
-unsigned int Shape::initVAO() {
-    glGenVertexArrays(1, &VAO); // Generate VAO
-    glBindVertexArray(VAO); // Bind VAO
-    return VAO;
+Shape::Shape(Shape &&other) noexcept : scene(other.scene), handle(other.handle) {
+    other.scene = nullptr;
 }
 
-// Initialize VBO
-void Shape::initVBO() {
-    // Generate VBO, bind it to VAO, and copy vertices data into it
-    glGenBuffers(1, &VBO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
-
-    // Set the vertex attribute pointers (2 floats per vertex (x, y))
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), nullptr);
-    glEnableVertexAttribArray(0); // Enable the vertex attribute at location 0
-    glBindBuffer(GL_ARRAY_BUFFER, 0); // Unbind VBO
+Shape &Shape::operator=(Shape &&other) noexcept {
+    if (this != &other) {
+        if (scene != nullptr)
+            scene->destroy(handle);
+        scene = other.scene;
+        handle = other.handle;
+        other.scene = nullptr;
+    }
+    return *this;
 }
 
-// Initialize EBO
-void Shape::initEBO() {
-    glGenBuffers(1, &EBO);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(float), indices.data(), GL_STATIC_DRAW);
-    // Don't unbind EBO because it's bound to VAO
+Shape::~Shape() {
+    if (scene != nullptr)
+        scene->destroy(handle);
 }
 
-void Shape::setUniforms() const {
-    this->shader.use();
-    // Define the model matrix for the shape as a 4x4 identity matrix
-    mat4 model = mat4(1.0f);
-    // The model matrix is used to transform the vertices of the shape in relation to the world space.
-    model = translate(model, vec3(pos, 0.0f));
-    // The size of the shape is scaled by the model matrix to make the shape larger or smaller.
-    model = scale(model, vec3(size, 1.0f));
-
-    // Set the model matrix and color uniform variables in the shader
-    this->shader.setMatrix4("model", model);
-    this->shader.setVector4f("shapeColor", color.vec);
-}
+ShapeHandle Shape::getHandle() const { return handle; }
 
 bool Shape::isOverlapping(const vec2 &point) const {
-    // A shape is overlapping a point if the point is within the shape's bounding box.
-    // Hint: Even though getLeft, getRight, getTop, and getBottom aren't implemented
-    //       in this class, you can still call them from here.
-    if (point.x > getLeft() && point.x < getRight() &&
-        point.y > getBottom() && point.y < getTop())
-        return true;
-    return false; // Placeholder for compilation
+    return scene->contains(handle.index, point);
 }
 
-void Shape::toggle(struct color a, struct color b) {
-    // simple switch to keep track over a button's status
-    if (isOn) {
-        isOn = false;
-        color = a;
-    }
-    else {
-        isOn = true;
-        color = b;
+bool Shape::isOverlapping(const Shape &other) const {
+    if (scene->type(handle) == ShapeType::Circle && other.scene->type(other.handle) == ShapeType::Circle) {
+        // Check if the distance between the centers of the circles is less than the sum of their radii
+        float radiusSum = (getSize().x + other.getSize().x) / 2;
+        return distance(getPos(), other.getPos()) < radiusSum;
     }
+    return getLeft() < other.getRight() && getRight() > other.getLeft() &&
+           getBottom() < other.getTop() && getTop() > other.getBottom();
 }
 
-
-
 // Setters
-void Shape::move(vec2 offset)         { pos += offset; }
-void Shape::moveX(float x)            { pos.x += x; }
-void Shape::moveY(float y)            { pos.y += y; }
-void Shape::setPos(vec2 pos)          { this->pos = pos; }
-void Shape::setPosX(float x)          { pos.x = x; }
-void Shape::setPosY(float y)          { pos.y = y; }
+void Shape::move(vec2 offset)         { scene->pos(handle) += offset; }
+void Shape::moveX(float x)            { scene->pos(handle).x += x; }
+void Shape::moveY(float y)            { scene->pos(handle).y += y; }
+void Shape::setPos(vec2 pos)          { scene->pos(handle) = pos; }
+void Shape::setPosX(float x)          { scene->pos(handle).x = x; }
+void Shape::setPosY(float y)          { scene->pos(handle).y = y; }
+
+void Shape::setColor(struct color c)  { scene->color(handle) = c; }
+void Shape::setColor(vec4 c)          { scene->color(handle).vec = c; }
+void Shape::setColor(vec3 c)          { scene->color(handle).vec = vec4(c, 1.0); }
+void Shape::setRed(float r)           { scene->color(handle).red = r; }
+void Shape::setGreen(float g)         { scene->color(handle).green = g; }
+void Shape::setBlue(float b)          { scene->color(handle).blue = b; }
+void Shape::setOpacity(float a)       { scene->color(handle).alpha = a; }
+
+void Shape::setSize(vec2 size)        { scene->size(handle) = size; }
+void Shape::setSizeX(float x)         { scene->size(handle).x = x; }
+void Shape::setSizeY(float y)         { scene->size(handle).y = y; }
+
+void Shape::setVisible(bool visible) {
+    uint8_t &flags = scene->flags(handle);
+    flags = visible ? (flags | SceneStore::VISIBLE) : (flags & ~SceneStore::VISIBLE);
+}
 
-void Shape::setColor(struct color c)  { color = c; }
-void Shape::setColor(vec4 c)          { color.vec = c; }
-void Shape::setColor(vec3 c)          { color.vec = vec4(c, 1.0); }
-void Shape::setRed(float r)           { color.red = r; }
-void Shape::setGreen(float g)         { color.green = g; }
-void Shape::setBlue(float b)          { color.blue = b; }
-void Shape::setOpacity(float a)       { color.alpha = a; }
+void Shape::setPickable(bool pickable) {
+    uint8_t &flags = scene->flags(handle);
+    flags = pickable ? (flags | SceneStore::PICKABLE) : (flags & ~SceneStore::PICKABLE);
+}
 
-void Shape::setSize(vec2 size)        { this->size = size; }
-void Shape::setSizeX(float x)         { size.x = x; }
-void Shape::setSizeY(float y)         { size.y = y; }
+void Shape::setTag(uint32_t tag)      { scene->tag(handle) = tag; }
 
 // Getters
-vec2 Shape::getPos() const      { return pos; }
-float Shape::getPosX() const    { return pos.x; }
-float Shape::getPosY() const    { return pos.y; }
-vec2 Shape::getSize() const     { return size; }
-vec3 Shape::getColor3() const   { return {color.red, color.green, color.blue}; }
-vec4 Shape::getColor4() const   { return color.vec; }
-float Shape::getRed() const     { return color.red; }
-float Shape::getGreen() const   { return color.green; }
-float Shape::getBlue() const    { return color.blue; }
-float Shape::getOpacity() const { return color.alpha; }
\ No newline at end of file
+vec2 Shape::getPos() const      { return scene->pos(handle); }
+float Shape::getPosX() const    { return getPos().x; }
+float Shape::getPosY() const    { return getPos().y; }
+vec2 Shape::getSize() const     { return scene->size(handle); }
+vec3 Shape::getColor3() const   { color c = scene->color(handle); return {c.red, c.green, c.blue}; }
+vec4 Shape::getColor4() const   { return scene->color(handle).vec; }
+float Shape::getRed() const     { return scene->color(handle).red; }
+float Shape::getGreen() const   { return scene->color(handle).green; }
+float Shape::getBlue() const    { return scene->color(handle).blue; }
+float Shape::getOpacity() const { return scene->color(handle).alpha; }
+bool Shape::isVisible() const   { return scene->flags(handle) & SceneStore::VISIBLE; }
+
+float Shape::getLeft() const    { return getPos().x - (getSize().x / 2); }
+float Shape::getRight() const   { return getPos().x + (getSize().x / 2); }
+float Shape::getTop() const     { return getPos().y + (getSize().y / 2); }
+float Shape::getBottom() const  { return getPos().y - (getSize().y / 2); }
@@ -3,44 +3,37 @@
 
 #include "glm/glm.hpp"
 #include <vector>
-#include "../shader/shader.h"
+#include "sceneStore.h"
 #include "../util/color.h"
 
 using std::vector, glm::vec2, glm::vec3, glm::vec4, glm::mat4, glm::translate, glm::scale, glm::rotate, glm::radians;
 
+/// @brief A lightweight handle to a shape living in a SceneStore.
+/// @details The shape's data (position, size, color, ...) is stored in the scene's contiguous arrays;
+///          this class only forwards to them, so it is cheap to create, move and keep around.
+///          The shape is removed from the scene when its Shape object is destroyed.
+///          Drawing is done for the whole scene at once by SceneRenderer.
 class Shape {
     public:
         /// @brief Construct a new Shape object
-        /// @param shader The shader to use for rendering
+        /// @param scene The scene the shape is added to
+        /// @param type The kind of shape
         /// @param pos The position of the shape
         /// @param size The size of the shape
         /// @param color The color of the shape
-        Shape(Shader& shader, vec2 pos, glm::vec2 size, struct color color);
+        Shape(SceneStore& scene, ShapeType type, vec2 pos, glm::vec2 size, struct color color);
 
-        mutable bool isOn;
+        /// @brief Shapes own their slot in the scene, so they can be moved but not copied
+        Shape(Shape&& other) noexcept;
+        Shape& operator=(Shape&& other) noexcept;
+        Shape(Shape const& other) = delete;
+        Shape& operator=(Shape const& other) = delete;
 
-        /// @brief Copy constructor for Shape
-        Shape(Shape const& other);
+        /// @brief Destroy the Shape object and remove it from the scene
+        virtual ~Shape();
 
-        /// @brief Destroy the Shape object
-        virtual ~Shape() = default;
-
-        // --------------------------------------------------------
-        // Initialization functions
-        // --------------------------------------------------------
-
-        /// @brief Initializes the VAO.
-        /// @details This function is called in the derived classes' constructor.
-        unsigned int initVAO();
-
-        /// @brief Initializes the VBO.
-        /// @details This function is called in the derived classes' constructor.
-        void initVBO();
-
-        /// @brief Initializes the EBO.
-        /// @details This function is called in the derived classes' constructor.
-        /// @details If function has no indices, pass nullptr for indices and 0 for indexCount.
-        void initEBO();
+        /// @brief The handle of this shape in its scene
+        ShapeHandle getHandle() const;
 
         // --------------------------------------------------------
         // Getters
@@ -50,11 +43,10 @@ class Shape {
         float getPosY() const;
         vec2 getPos() const;
 
-
-        virtual float getLeft() const = 0;
-        virtual float getRight() const = 0;
-        virtual float getTop() const = 0;
-        virtual float getBottom() const = 0;
+        float getLeft() const;
+        float getRight() const;
+        float getTop() const;
+        float getBottom() const;
 
         // Color Functions
         vec4 getColor4() const;
@@ -67,6 +59,9 @@ class Shape {
         // Size Functions
         vec2 getSize() const;
 
+        // Visibility
+        bool isVisible() const;
+
         // --------------------------------------------------------
         // Setters
         // --------------------------------------------------------
@@ -86,7 +81,6 @@ class Shape {
         void setSizeX(float x);
         void setSizeY(float y);
 
-
         // Color
         void setColor(color color);
         void setColor(vec4 color);
@@ -96,56 +90,28 @@ class Shape {
         void setBlue(float b);
         void setOpacity(float a);
 
-        // --------------------------------------------------------
-        // Collision functions
-        // --------------------------------------------------------
-        virtual bool isOverlapping(const vec2& point) const;
-
-
-        /// @brief Switches isOn variable and the color when a button is clicked.
-        void toggle(color a, color b);
+        // Visibility and picking
+        void setVisible(bool visible);
+        void setPickable(bool pickable);
+        /// @brief Sets a caller-defined id that SceneStore::hitTest() results can be mapped back with
+        void setTag(uint32_t tag);
 
         // --------------------------------------------------------
         // Collision functions
         // --------------------------------------------------------
-        virtual bool isOverlapping(const Shape& other) const = 0;
-
-        // --------------------------------------------------------
-        // Drawing functions
-        // --------------------------------------------------------
-
-        /// @brief Sets the uniform variables from members, and calls the virtual draw function
-        void setUniforms() const;
+        /// @brief Returns true if the point is inside the shape
+        bool isOverlapping(const vec2& point) const;
 
-        /// @brief Pure virtual function to draw the shape.
-        virtual void draw() const = 0;
+        /// @brief Returns true if the two shapes overlap
+        /// @details Circles are tested by radius against other circles, everything else by bounding box.
+        bool isOverlapping(const Shape& other) const;
 
 protected:
-        /// @brief Shader used to draw all abstract shapes.
-        Shader & shader;
-
-        /// @brief The position of the shape
-        vec2 pos;
-
-        // @brief A 2D vector representing the size of the shape
-        vec2 size;
-
-        /// @brief The rotation of the shape in degrees
-        float rotation = 0.0f;
-
-        /// @brief The VAO of the shape
-        struct color color;
-
-        /// @brief The Vertex Array Object, Vertex Buffer Object, and Element Buffer Object of the shape.
-        unsigned int VAO, VBO, EBO;
-
-        /// @brief The vertices of the shape
-        vector<float> vertices;
-
-        /// @brief The indices of the shape
-        vector<unsigned int> indices;
+        /// @brief The scene that stores this shape's data
+        SceneStore* scene;
 
-        virtual void initVectors() = 0;
+        /// @brief This shape's slot in the scene
+        ShapeHandle handle;
 };
 
 #endif //GRAPHICS_SHAPE_H
@@ -0,0 +1,95 @@
+#include "allocationCounter.h"
+
+#include <cstdlib>
+#include <new>
+
+#if DARTS_COUNT_ALLOCATIONS
+
+// plain integers, so they need no construction and work however early the first allocation is
+static thread_local uint64_t count = 0;
+static thread_local uint64_t bytes = 0;
+
+uint64_t AllocationCounter::getCount() {
+    return count;
+}
+
+uint64_t AllocationCounter::getBytes() {
+    return bytes;
+}
+
+// malloc with operator new's behaviour: retry through the new handler, null if there is none
+static void *allocate(size_t size, size_t alignment) {
+    count++;
+    bytes += size;
+    if (size == 0)
+        size = 1;
+    while (true) {
+        void *memory;
+        if (alignment <= alignof(std::max_align_t))
+            memory = std::malloc(size);
+        else {
+#ifdef _WIN32
+            memory = _aligned_malloc(size, alignment);
+#else
+            // aligned_alloc wants a multiple of the alignment
+            memory = std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+#endif
+        }
+        if (memory != nullptr)
+            return memory;
+        std::new_handler handler = std::get_new_handler();
+        if (handler == nullptr)
+            return nullptr;
+        handler();
+    }
+}
+
+static void release(void *memory, size_t alignment) {
+    if (alignment <= alignof(std::max_align_t))
+        std::free(memory);
+    else {
+#ifdef _WIN32
+        _aligned_free(memory);
+#else
+        std::free(memory);
+#endif
+    }
+}
+
+static void *allocateOrThrow(size_t size, size_t alignment) {
+    void *memory = allocate(size, alignment);
+    if (memory == nullptr)
+        throw std::bad_alloc();
+    return memory;
+}
+
+static const size_t NORMAL = alignof(std::max_align_t);
+
+void *operator new(size_t size) { return allocateOrThrow(size, NORMAL); }
+void *operator new[](size_t size) { return allocateOrThrow(size, NORMAL); }
+void *operator new(size_t size, const std::nothrow_t &) noexcept { return allocate(size, NORMAL); }
+void *operator new[](size_t size, const std::nothrow_t &) noexcept { return allocate(size, NORMAL); }
+void *operator new(size_t size, std::align_val_t alignment) { return allocateOrThrow(size, static_cast<size_t>(alignment)); }
+void *operator new[](size_t size, std::align_val_t alignment) { return allocateOrThrow(size, static_cast<size_t>(alignment)); }
+void *operator new(size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept { return allocate(size, static_cast<size_t>(alignment)); }
+void *operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept { return allocate(size, static_cast<size_t>(alignment)); }
+
+void operator delete(void *memory) noexcept { release(memory, NORMAL); }
+void operator delete[](void *memory) noexcept { release(memory, NORMAL); }
+void operator delete(void *memory, size_t) noexcept { release(memory, NORMAL); }
+void operator delete[](void *memory, size_t) noexcept { release(memory, NORMAL); }
+void operator delete(void *memory, const std::nothrow_t &) noexcept { release(memory, NORMAL); }
+void operator delete[](void *memory, const std::nothrow_t &) noexcept { release(memory, NORMAL); }
+void operator delete(void *memory, std::align_val_t alignment) noexcept { release(memory, static_cast<size_t>(alignment)); }
+void operator delete[](void *memory, std::align_val_t alignment) noexcept { release(memory, static_cast<size_t>(alignment)); }
+void operator delete(void *memory, size_t, std::align_val_t alignment) noexcept { release(memory, static_cast<size_t>(alignment)); }
+void operator delete[](void *memory, size_t, std::align_val_t alignment) noexcept { release(memory, static_cast<size_t>(alignment)); }
+void operator delete(void *memory, std::align_val_t alignment, const std::nothrow_t &) noexcept { release(memory, static_cast<size_t>(alignment)); }
+void operator delete[](void *memory, std::align_val_t alignment, const std::nothrow_t &) noexcept { release(memory, static_cast<size_t>(alignment)); }
+
+#else
+
+uint64_t AllocationCounter::getCount() { return 0; }
+uint64_t AllocationCounter::getBytes() { return 0; }
+
+#endif
@@ -0,0 +1,41 @@
+#ifndef GRAPHICS_ALLOCATIONCOUNTER_H
+#define GRAPHICS_ALLOCATIONCOUNTER_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Counting replaces the global operator new and delete, so it's only compiled into debug builds
+// by default. Define DARTS_COUNT_ALLOCATIONS as 0 or 1 to choose yourself.
+#ifndef DARTS_COUNT_ALLOCATIONS
+#ifdef NDEBUG
+#define DARTS_COUNT_ALLOCATIONS 0
+#else
+#define DARTS_COUNT_ALLOCATIONS 1
+#endif
+#endif
+
+/**
+ * @brief Counts heap allocations (operator new) made by each thread.
+ * @details The counts are per thread, so the render loop can check its own allocations without
+ *          the simulation, log and camera threads getting in the way. Allocations made by C
+ *          libraries with malloc (GLFW, FreeType, the driver) aren't counted.
+ *
+ * Usage:
+ * @code
+ * uint64_t before = AllocationCounter::getCount();
+ * drawFrame();
+ * uint64_t allocations = AllocationCounter::getCount() - before;
+ * @endcode
+ */
+class AllocationCounter {
+    public:
+        /// @brief True if allocations are counted in this build
+        static constexpr bool ENABLED = DARTS_COUNT_ALLOCATIONS != 0;
+
+        /// @brief Allocations the calling thread has made so far (always 0 if counting is disabled)
+        static uint64_t getCount();
+        /// @brief Bytes the calling thread has allocated so far
+        static uint64_t getBytes();
+};
+
+#endif //GRAPHICS_ALLOCATIONCOUNTER_H
@@ -0,0 +1,24 @@
+#ifndef GRAPHICS_BOUNDS_H
+#define GRAPHICS_BOUNDS_H
+
+#include "glm/glm.hpp"
+
+/// @brief An axis-aligned rectangle (e.g. the part of the world the camera can see)
+struct Bounds {
+    glm::vec2 min;
+    glm::vec2 max;
+
+    /// @brief Returns true if a shape centered on center with the given size overlaps the bounds
+    bool intersects(glm::vec2 center, glm::vec2 size) const {
+        glm::vec2 half = size * 0.5f;
+        return center.x + half.x >= min.x && center.x - half.x <= max.x &&
+               center.y + half.y >= min.y && center.y - half.y <= max.y;
+    }
+
+    /// @brief Returns true if point is inside the bounds
+    bool contains(glm::vec2 point) const {
+        return point.x >= min.x && point.x <= max.x && point.y >= min.y && point.y <= max.y;
+    }
+};
+
+#endif //GRAPHICS_BOUNDS_H
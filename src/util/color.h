@@ -2,9 +2,15 @@
 #define GRAPHICS_COLOR_H
 
 #include <glm/glm.hpp>
+#include <cstdint>
 #include <iostream>
 using std::ostream, glm::vec4;
 
+// A color packed into 4 bytes, what is uploaded to the GPU (read back as normalized floats)
+typedef struct rgba8 {
+    uint8_t red, green, blue, alpha;
+} rgba8;
+
 // Union treats all members as if they were at the same address, so changing one changes the others.
 // This allows us to access the color as a vec4 or as individual floats.
 typedef struct color {
@@ -20,6 +26,14 @@ typedef struct color {
     color(float r, float g, float b) : vec(r, g, b, 1.0f) {}
     color(float r, float g, float b, float a) : vec(r, g, b, a) {}
 
+    /* Packed */
+    rgba8 packed() const {
+        return {toByte(red), toByte(green), toByte(blue), toByte(alpha)};
+    }
+    static uint8_t toByte(float f) {
+        return static_cast<uint8_t>((f < 0.0f ? 0.0f : f > 1.0f ? 1.0f : f) * 255.0f + 0.5f);
+    }
+
     /* Overloaded Operator */
     friend ostream &operator<<(ostream &outs, const color &c) {
         outs << "Red: " << c.red << ", Green: " << c.green << ", Blue: " << c.blue << ", Alpha: " << c.alpha;
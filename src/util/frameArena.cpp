@@ -0,0 +1,53 @@
+#include "frameArena.h"
+
+#include <algorithm>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+
+FrameArena::FrameArena(size_t capacity) : block(new unsigned char[capacity]), capacity(capacity) {}
+
+void *FrameArena::allocate(size_t bytes, size_t alignment) {
+    uintptr_t base = reinterpret_cast<uintptr_t>(block.get());
+    size_t start = ((base + used + alignment - 1) & ~(uintptr_t(alignment) - 1)) - base;
+    if (start + bytes <= capacity) {
+        used = start + bytes;
+        return block.get() + start;
+    }
+
+    // doesn't fit: this frame gets a heap block, and reset() grows the arena so the next one won't
+    overflow.emplace_back(new unsigned char[bytes + alignment]);
+    overflowBytes += bytes + alignment;
+    uintptr_t address = reinterpret_cast<uintptr_t>(overflow.back().get());
+    return reinterpret_cast<void *>((address + alignment - 1) & ~(uintptr_t(alignment) - 1));
+}
+
+std::string_view FrameArena::print(const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    va_list measure;
+    va_copy(measure, args);
+    int length = std::vsnprintf(nullptr, 0, format, measure);
+    va_end(measure);
+    if (length < 0) {
+        va_end(args);
+        return {};
+    }
+
+    char *text = allocate<char>(static_cast<size_t>(length) + 1);
+    std::vsnprintf(text, static_cast<size_t>(length) + 1, format, args);
+    va_end(args);
+    return std::string_view(text, static_cast<size_t>(length));
+}
+
+void FrameArena::reset() {
+    peak = std::max(peak, getUsed());
+    if (!overflow.empty()) {
+        // room for everything this frame needed, and some
+        capacity = std::max(capacity * 2, peak + peak / 2);
+        block.reset(new unsigned char[capacity]);
+        overflow.clear();
+        overflowBytes = 0;
+    }
+    used = 0;
+}
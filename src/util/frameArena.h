@@ -0,0 +1,68 @@
+#ifndef GRAPHICS_FRAMEARENA_H
+#define GRAPHICS_FRAMEARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief A bump allocator for things that only live for one frame (text, scratch arrays, lists).
+ * @details Allocating moves a pointer through one block, and reset() at the end of the frame frees
+ *          everything at once, so a frame's worth of transient data costs no heap allocations at all.
+ *          If a frame needs more than the block holds, the rest comes from the heap and the block is
+ *          grown to fit at the next reset(), so after the first few frames it never happens again.
+ *
+ *          Nothing allocated here is destructed, so only trivially destructible types can be used.
+ *
+ * Usage:
+ * @code
+ * std::string_view text = arena.print("Clicks: %d", clicks);
+ * Batch *batches = arena.allocate<Batch>(count);
+ * ...
+ * arena.reset();    // once the frame is drawn
+ * @endcode
+ */
+class FrameArena {
+    public:
+        /// @param capacity bytes in the block (grown as needed)
+        explicit FrameArena(size_t capacity = 64 * 1024);
+
+        FrameArena(const FrameArena &) = delete;
+        FrameArena &operator=(const FrameArena &) = delete;
+
+        /// @brief Room for bytes, aligned to alignment (a power of two), valid until reset()
+        void *allocate(size_t bytes, size_t alignment = alignof(std::max_align_t));
+
+        /// @brief Room for count Ts (not constructed), valid until reset()
+        template <typename T>
+        T *allocate(size_t count) {
+            static_assert(std::is_trivially_destructible_v<T>, "the arena never runs destructors");
+            return static_cast<T *>(allocate(count * sizeof(T), alignof(T)));
+        }
+
+        /// @brief Formats text like printf into the arena
+        /// @return the text (also null terminated), valid until reset()
+        std::string_view print(const char *format, ...);
+
+        /// @brief Frees everything allocated since the last reset()
+        void reset();
+
+        /// @brief Bytes allocated since the last reset()
+        size_t getUsed() const { return used + overflowBytes; }
+        /// @brief Most bytes any frame has used
+        size_t getPeak() const { return peak; }
+        size_t getCapacity() const { return capacity; }
+
+    private:
+        std::unique_ptr<unsigned char[]> block;
+        size_t capacity;
+        size_t used = 0;
+        size_t peak = 0;
+        /// @brief Heap blocks for whatever didn't fit this frame
+        std::vector<std::unique_ptr<unsigned char[]>> overflow;
+        size_t overflowBytes = 0;
+};
+
+#endif //GRAPHICS_FRAMEARENA_H
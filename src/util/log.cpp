@@ -0,0 +1,271 @@
+#include "log.h"
+#include "spscQueue.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// records each thread can have waiting (256 bytes each)
+static const size_t QUEUE_CAPACITY = 1024;
+// how long the log thread sleeps when there's nothing to write
+static const std::chrono::milliseconds IDLE_SLEEP(5);
+
+static const char *const SEVERITY_NAMES[] = {"DEBUG", "INFO", "WARNING", "ERROR"};
+
+/// @brief One thread's messages
+struct LogQueue {
+    SpscQueue<LogRecord, QUEUE_CAPACITY> records;
+    std::atomic<uint64_t> dropped{0};
+    /// @brief Set when the thread exits, the queue is removed once it's empty
+    std::atomic<bool> retired{false};
+};
+
+/// @brief Marks the thread's queue retired when the thread exits
+struct ThreadQueue {
+    LogQueue *queue = nullptr;
+    ~ThreadQueue() {
+        if (queue != nullptr)
+            queue->retired = true;
+    }
+};
+
+static thread_local ThreadQueue threadQueue;
+
+// the queues of every thread that ever logged (guarded by registryMutex)
+static std::mutex registryMutex;
+static std::vector<std::unique_ptr<LogQueue>> queues;
+
+// the log thread and where it writes (guarded by controlMutex while starting and stopping)
+static std::mutex controlMutex;
+static std::thread writer;
+static std::atomic<bool> running{false};
+static bool started = false;
+static LogConfig config;
+static FILE *output = nullptr;
+static size_t outputBytes = 0;
+static int64_t startTime = 0;
+
+static std::atomic<int> minimum{logInfo};
+// dropped messages of retired queues, and how many were reported
+static std::atomic<uint64_t> retiredDrops{0};
+static uint64_t reportedDrops = 0;
+
+static int64_t now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void openOutput() {
+    outputBytes = 0;
+    if (config.path.empty()) {
+        output = stderr;
+        return;
+    }
+    output = std::fopen(config.path.c_str(), "a");
+    if (output == nullptr) {
+        std::fprintf(stderr, "ERROR::LOG: Could not open %s, logging to stderr\n", config.path.c_str());
+        output = stderr;
+        return;
+    }
+    std::fseek(output, 0, SEEK_END);
+    long size = std::ftell(output);
+    outputBytes = size > 0 ? static_cast<size_t>(size) : 0;
+}
+
+static void closeOutput() {
+    if (output != nullptr && output != stderr)
+        std::fclose(output);
+    output = nullptr;
+}
+
+// path.2 -> path.3, path.1 -> path.2, path -> path.1, then start a new path
+static void rotate() {
+    closeOutput();
+    for (int i = config.maxFiles - 1; i >= 1; --i)
+        std::rename((config.path + "." + std::to_string(i)).c_str(), (config.path + "." + std::to_string(i + 1)).c_str());
+    if (config.maxFiles > 0)
+        std::rename(config.path.c_str(), (config.path + ".1").c_str());
+    else
+        std::remove(config.path.c_str());
+    openOutput();
+}
+
+static void writeLine(const std::string &line) {
+    std::fwrite(line.data(), 1, line.size(), output);
+    outputBytes += line.size();
+    if (output != stderr && outputBytes >= config.maxFileBytes)
+        rotate();
+}
+
+// formats and writes everything queued so far, returns false if there was nothing
+// (lines is scratch space, sorted by time so messages from different threads come out in order)
+static bool drain(std::vector<std::pair<int64_t, std::string>> &lines) {
+    uint64_t dropped = retiredDrops.load();
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        for (auto it = queues.begin(); it != queues.end();) {
+            LogQueue &queue = **it;
+            // a producer may still be publishing while this runs, anything after this is picked up next time
+            bool retired = queue.retired.load();
+            while (const LogRecord *record = queue.records.peek()) {
+                lines.emplace_back(record->time, Log::format(*record));
+                queue.records.release();
+            }
+            if (retired && queue.records.size() == 0) {
+                retiredDrops += queue.dropped.load();
+                dropped += queue.dropped.load();
+                it = queues.erase(it);
+            }
+            else {
+                dropped += queue.dropped.load();
+                ++it;
+            }
+        }
+    }
+    if (dropped > reportedDrops) {
+        lines.emplace_back(now(), "WARNING::LOG: " + std::to_string(dropped - reportedDrops) + " messages dropped, the queue was full");
+        reportedDrops = dropped;
+    }
+    if (lines.empty())
+        return false;
+
+    std::stable_sort(lines.begin(), lines.end(), [](const auto &a, const auto &b) { return a.first < b.first; });
+    for (auto &line : lines) {
+        char stamp[32];
+        std::snprintf(stamp, sizeof(stamp), "[%10.3f] ", (line.first - startTime) / 1e9);
+        writeLine(stamp + line.second + "\n");
+    }
+    std::fflush(output);
+    lines.clear();
+    return true;
+}
+
+static void run() {
+    std::vector<std::pair<int64_t, std::string>> lines;
+    while (running.load()) {
+        if (!drain(lines))
+            std::this_thread::sleep_for(IDLE_SLEEP);
+    }
+    // whatever came in while stopping
+    drain(lines);
+}
+
+static void stopLocked() {
+    if (!running.load())
+        return;
+    running = false;
+    writer.join();
+    closeOutput();
+}
+
+static void startLocked(const LogConfig &newConfig) {
+    stopLocked();
+    config = newConfig;
+    minimum = config.minSeverity;
+    openOutput();
+    if (!started) {
+        started = true;
+        startTime = now();
+        std::atexit(Log::stop);
+    }
+    running = true;
+    writer = std::thread(run);
+}
+
+void Log::start(const LogConfig &newConfig) {
+    std::lock_guard<std::mutex> lock(controlMutex);
+    startLocked(newConfig);
+}
+
+void Log::stop() {
+    std::lock_guard<std::mutex> lock(controlMutex);
+    stopLocked();
+}
+
+uint64_t Log::getDropped() {
+    uint64_t dropped = retiredDrops.load();
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (const auto &queue : queues)
+        dropped += queue->dropped.load();
+    return dropped;
+}
+
+logSeverity Log::minimumSeverity() {
+    return static_cast<logSeverity>(minimum.load(std::memory_order_relaxed));
+}
+
+LogRecord *Log::reserve() {
+    LogQueue *queue = threadQueue.queue;
+    if (queue == nullptr) {
+        // first message from this thread
+        {
+            std::lock_guard<std::mutex> lock(controlMutex);
+            if (!started)
+                startLocked(LogConfig());
+        }
+        std::lock_guard<std::mutex> lock(registryMutex);
+        queues.push_back(std::make_unique<LogQueue>());
+        queue = threadQueue.queue = queues.back().get();
+    }
+    LogRecord *record = queue->records.reserve();
+    if (record == nullptr)
+        queue->dropped.fetch_add(1, std::memory_order_relaxed);
+    return record;
+}
+
+void Log::publish() {
+    threadQueue.queue->records.publish();
+}
+
+std::string Log::format(const LogRecord &record) {
+    std::string line = SEVERITY_NAMES[record.severity];
+    line += "::";
+    line += record.tag;
+    line += ": ";
+
+    int next = 0;
+    char number[64];
+    for (const char *c = record.format; *c != '\0'; ++c) {
+        if (c[0] != '{' || c[1] != '}' || next >= record.count) {
+            line += *c;
+            continue;
+        }
+        ++c;
+        const int n = next++;
+        switch (record.kinds[n]) {
+            case LogRecord::signedArgument:
+                std::snprintf(number, sizeof(number), "%" PRId64, record.values[n].i);
+                line += number;
+                break;
+            case LogRecord::unsignedArgument:
+                std::snprintf(number, sizeof(number), "%" PRIu64, record.values[n].u);
+                line += number;
+                break;
+            case LogRecord::floatArgument:
+                std::snprintf(number, sizeof(number), "%g", record.values[n].d);
+                line += number;
+                break;
+            case LogRecord::stringArgument:
+                line.append(record.text + record.values[n].s.offset, record.values[n].s.length);
+                break;
+            case LogRecord::boolArgument:
+                line += record.values[n].u ? "true" : "false";
+                break;
+            case LogRecord::charArgument:
+                line += static_cast<char>(record.values[n].u);
+                break;
+            case LogRecord::pointerArgument:
+                std::snprintf(number, sizeof(number), "%p", record.values[n].p);
+                line += number;
+                break;
+        }
+    }
+    return line;
+}
@@ -0,0 +1,196 @@
+#ifndef GRAPHICS_LOG_H
+#define GRAPHICS_LOG_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+/// @brief How bad a log message is
+enum logSeverity {logDebug, logInfo, logWarning, logError};
+
+// Messages below this severity are compiled out (their arguments aren't even evaluated).
+// Defaults to everything in debug builds and info and up in release builds.
+#ifndef LOG_MIN_SEVERITY
+#ifdef NDEBUG
+#define LOG_MIN_SEVERITY logInfo
+#else
+#define LOG_MIN_SEVERITY logDebug
+#endif
+#endif
+
+/// @brief Logs a message, e.g. LOG_ERROR("SHADER", "Failed to read {}: {}", path, error)
+/// @details The tag names the subsystem (printed as ERROR::SHADER:) and the format must be a string
+///          literal, since it's read later on the log thread. Each {} is replaced with the next argument.
+#define LOG_AT(severity, tag, ...) \
+    do { if constexpr ((severity) >= LOG_MIN_SEVERITY) Log::write((severity), (tag), __VA_ARGS__); } while (0)
+#define LOG_DEBUG(tag, ...) LOG_AT(logDebug, tag, __VA_ARGS__)
+#define LOG_INFO(tag, ...) LOG_AT(logInfo, tag, __VA_ARGS__)
+#define LOG_WARNING(tag, ...) LOG_AT(logWarning, tag, __VA_ARGS__)
+#define LOG_ERROR(tag, ...) LOG_AT(logError, tag, __VA_ARGS__)
+
+/**
+ * @brief One message as it waits in a thread's queue: the format, the raw arguments, and copies of
+ *        any strings. Formatting happens later, on the log thread.
+ * @details 256 bytes. Strings that don't fit in the text buffer are cut short (marked with "...").
+ */
+struct LogRecord {
+    static const int MAX_ARGUMENTS = 8;
+    static const size_t TEXT_SIZE = 152;
+
+    enum argumentKind : uint8_t {signedArgument, unsignedArgument, floatArgument, stringArgument,
+                                 boolArgument, charArgument, pointerArgument};
+
+    /// @brief steady_clock nanoseconds
+    int64_t time;
+    const char *tag;
+    const char *format;
+    uint8_t severity;
+    uint8_t count;
+    /// @brief Bytes of text used
+    uint16_t used;
+    argumentKind kinds[MAX_ARGUMENTS];
+    union {
+        int64_t i;
+        uint64_t u;
+        double d;
+        const void *p;
+        /// @brief Where a string is in text
+        struct { uint16_t offset, length; } s;
+    } values[MAX_ARGUMENTS];
+    char text[TEXT_SIZE];
+
+    /// @brief Stores one argument
+    template <typename T>
+    void capture(const T &value) {
+        typedef std::decay_t<T> D;
+        int n = count++;
+        if constexpr (std::is_same_v<D, bool>) {
+            kinds[n] = boolArgument;
+            values[n].u = value;
+        }
+        else if constexpr (std::is_same_v<D, char>) {
+            kinds[n] = charArgument;
+            values[n].u = static_cast<unsigned char>(value);
+        }
+        else if constexpr (std::is_enum_v<D>) {
+            kinds[n] = signedArgument;
+            values[n].i = static_cast<int64_t>(value);
+        }
+        else if constexpr (std::is_integral_v<D> && std::is_signed_v<D>) {
+            kinds[n] = signedArgument;
+            values[n].i = value;
+        }
+        else if constexpr (std::is_integral_v<D>) {
+            kinds[n] = unsignedArgument;
+            values[n].u = value;
+        }
+        else if constexpr (std::is_floating_point_v<D>) {
+            kinds[n] = floatArgument;
+            values[n].d = value;
+        }
+        else if constexpr (std::is_array_v<T>) {
+            copyString(n, std::string_view(value));
+        }
+        else if constexpr (std::is_same_v<D, char *> || std::is_same_v<D, const char *>) {
+            copyString(n, value != nullptr ? std::string_view(value) : std::string_view("(null)"));
+        }
+        else if constexpr (std::is_convertible_v<const D &, std::string_view>) {
+            copyString(n, std::string_view(value));
+        }
+        else {
+            static_assert(std::is_pointer_v<D>, "unsupported log argument type");
+            kinds[n] = pointerArgument;
+            values[n].p = value;
+        }
+    }
+
+    private:
+        void copyString(int n, std::string_view string) {
+            kinds[n] = stringArgument;
+            size_t length = std::min(string.size(), TEXT_SIZE - used);
+            std::memcpy(text + used, string.data(), length);
+            // mark a cut short string, if there's room
+            if (length < string.size() && length >= 3)
+                std::memcpy(text + used + length - 3, "...", 3);
+            values[n].s.offset = used;
+            values[n].s.length = static_cast<uint16_t>(length);
+            used = static_cast<uint16_t>(used + length);
+        }
+};
+
+/// @brief Where and what the log thread writes
+struct LogConfig {
+    /// @brief The log file, or empty for stderr
+    std::string path;
+    /// @brief Once the file is this big it becomes path.1 (path.1 becomes path.2, ...) and a new one is started
+    size_t maxFileBytes = 4 << 20;
+    /// @brief How many old files are kept
+    int maxFiles = 3;
+    /// @brief Messages below this are dropped at run time (LOG_MIN_SEVERITY drops them at compile time)
+    logSeverity minSeverity = logInfo;
+};
+
+/**
+ * @brief Asynchronous logger that never blocks the thread that logs.
+ * @details Every thread that logs gets its own lock-free SpscQueue of LogRecords. Logging captures
+ *          the arguments in place in the next free slot (no allocation, no formatting, no lock), so it
+ *          costs a few tens of nanoseconds. A background thread drains the queues every few
+ *          milliseconds, formats the messages in time order and writes them to stderr or a file.
+ *          If a queue is full the message is dropped and counted rather than waited for.
+ *
+ *          The logger starts with the default config the first time anything is logged, and stops
+ *          (writing whatever is still queued) when the program exits.
+ *
+ * Usage:
+ * @code
+ * Log::start(config);    // optional
+ * LOG_ERROR("SHADER", "Compile-time error: Type: {}", type);
+ * @endcode
+ */
+class Log {
+    public:
+        /// @brief Starts (or restarts) the log thread with a config
+        static void start(const LogConfig &config);
+        /// @brief Writes everything still queued and stops the log thread
+        static void stop();
+
+        /// @brief Messages dropped so far because a queue was full
+        static uint64_t getDropped();
+
+        /// @brief Queues a message (use the LOG_* macros, which filter by severity at compile time)
+        template <typename... Args>
+        static void write(logSeverity severity, const char *tag, const char *format, const Args &... args) {
+            static_assert(sizeof...(Args) <= LogRecord::MAX_ARGUMENTS, "too many log arguments");
+            if (severity < minimumSeverity())
+                return;
+            LogRecord *record = reserve();
+            if (record == nullptr)
+                return;
+            record->time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+            record->tag = tag;
+            record->format = format;
+            record->severity = static_cast<uint8_t>(severity);
+            record->count = 0;
+            record->used = 0;
+            (record->capture(args), ...);
+            publish();
+        }
+
+        /// @brief Formats a record into a line (without a newline), as the log thread does
+        static std::string format(const LogRecord &record);
+
+    private:
+        static logSeverity minimumSeverity();
+        /// @brief The calling thread's next free slot, or null if its queue is full
+        static LogRecord *reserve();
+        /// @brief Hands the slot from reserve() to the log thread
+        static void publish();
+};
+
+#endif //GRAPHICS_LOG_H
@@ -0,0 +1,60 @@
+#include "resources.h"
+#include "embeddedResources.h"
+#include "log.h"
+
+#include <cstdlib>
+#include <fstream>
+
+// set from DARTS_RESOURCE_DIR the first time a resource is loaded
+static std::string overrideDirectory;
+static bool overrideChecked = false;
+
+void Resource::setOverrideDirectory(std::string directory) {
+    overrideDirectory = std::move(directory);
+    overrideChecked = true;
+}
+
+Resource Resource::load(const std::string &name) {
+    if (!overrideChecked) {
+        if (const char *dir = std::getenv("DARTS_RESOURCE_DIR"))
+            overrideDirectory = dir;
+        overrideChecked = true;
+    }
+
+    Resource resource;
+
+    // development override: read the file from disk
+    if (!overrideDirectory.empty()) {
+        std::string path = overrideDirectory + "/" + name;
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file) {
+            LOG_ERROR("RESOURCE", "Failed to open {}", path);
+            return resource;
+        }
+        resource.owned.resize(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        file.read(&resource.owned[0], resource.owned.size());
+        resource.length = resource.owned.size();
+        return resource;
+    }
+
+    // default: point at the copy compiled into the executable
+    for (const EmbeddedResource &entry : EMBEDDED_RESOURCES) {
+        if (name == entry.name) {
+            resource.embedded = entry.data;
+            resource.length = entry.size;
+            return resource;
+        }
+    }
+
+    LOG_ERROR("RESOURCE", "No embedded resource named {}", name);
+    return resource;
+}
+
+const unsigned char *Resource::data() const {
+    return embedded != nullptr ? embedded : reinterpret_cast<const unsigned char *>(owned.c_str());
+}
+
+const char *Resource::c_str() const {
+    return reinterpret_cast<const char *>(data());
+}
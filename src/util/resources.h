@@ -0,0 +1,46 @@
+#ifndef GRAPHICS_RESOURCES_H
+#define GRAPHICS_RESOURCES_H
+
+#include <cstddef>
+#include <string>
+
+/**
+ * @brief A read-only blob of resource data (a shader, a font, ...)
+ * @details Resources are compiled into the executable (see cmake/embedResources.cmake), so by default
+ *          loading one is just a table lookup that points at the embedded bytes without copying them.
+ *          For development, setting the DARTS_RESOURCE_DIR environment variable (or calling
+ *          setOverrideDirectory()) loads them from that directory on disk instead, so shaders can be
+ *          edited without rebuilding.
+ */
+class Resource {
+    public:
+        /// @brief Loads a resource by its path relative to the res directory
+        /// @param name e.g. "shaders/shape.vert"
+        /// @return the resource, or an empty resource if it couldn't be found
+        static Resource load(const std::string &name);
+
+        /// @brief Loads resources from this directory on disk instead of the embedded copies
+        /// @param directory the res directory to use (an empty string goes back to the embedded copies)
+        static void setOverrideDirectory(std::string directory);
+
+        /// @brief The resource's bytes
+        const unsigned char *data() const;
+
+        /// @brief The resource's bytes as a null-terminated string (for text resources)
+        const char *c_str() const;
+
+        /// @brief The number of bytes in the resource (not counting the null terminator)
+        size_t size() const { return length; }
+
+        /// @brief Returns true if the resource couldn't be found
+        bool empty() const { return length == 0; }
+
+    private:
+        /// @brief Points at the embedded bytes, or is null if the resource was read from disk
+        const unsigned char *embedded = nullptr;
+        /// @brief Holds the bytes of a resource read from disk
+        std::string owned;
+        size_t length = 0;
+};
+
+#endif //GRAPHICS_RESOURCES_H
@@ -0,0 +1,76 @@
+#ifndef GRAPHICS_SPSCQUEUE_H
+#define GRAPHICS_SPSCQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+
+/// @brief Bounded lock-free single-producer/single-consumer ring buffer.
+/// @details Capacity must be a power of two. push() fails instead of blocking when the
+///          queue is full, so the producer never waits on the consumer.
+template <typename T, size_t Capacity>
+class SpscQueue {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+    public:
+        /// @brief Adds an item to the queue (producer thread only)
+        /// @return false if the queue is full
+        bool push(const T &item) {
+            const size_t t = tail.load(std::memory_order_relaxed);
+            if (t - head.load(std::memory_order_acquire) == Capacity)
+                return false;
+            items[t & (Capacity - 1)] = item;
+            tail.store(t + 1, std::memory_order_release);
+            return true;
+        }
+
+        /// @brief The slot the next push() would write to, or null if the queue is full (producer thread only)
+        /// @details For items too big to copy around: fill the slot in place, then publish it with publish().
+        T *reserve() {
+            const size_t t = tail.load(std::memory_order_relaxed);
+            if (t - head.load(std::memory_order_acquire) == Capacity)
+                return nullptr;
+            return &items[t & (Capacity - 1)];
+        }
+
+        /// @brief Publishes the slot returned by reserve() (producer thread only)
+        void publish() {
+            tail.store(tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        }
+
+        /// @brief The oldest item, read in place, or null if the queue is empty (consumer thread only)
+        /// @details The item stays valid until release().
+        const T *peek() const {
+            const size_t h = head.load(std::memory_order_relaxed);
+            if (h == tail.load(std::memory_order_acquire))
+                return nullptr;
+            return &items[h & (Capacity - 1)];
+        }
+
+        /// @brief Removes the item returned by peek() (consumer thread only)
+        void release() {
+            head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        }
+
+        /// @brief Removes the oldest item from the queue (consumer thread only)
+        /// @return false if the queue is empty
+        bool pop(T &item) {
+            const size_t h = head.load(std::memory_order_relaxed);
+            if (h == tail.load(std::memory_order_acquire))
+                return false;
+            item = items[h & (Capacity - 1)];
+            head.store(h + 1, std::memory_order_release);
+            return true;
+        }
+
+        /// @brief Number of queued items (approximate when called concurrently)
+        size_t size() const {
+            return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+        }
+
+    private:
+        T items[Capacity];
+        alignas(64) std::atomic<size_t> head{0};
+        alignas(64) std::atomic<size_t> tail{0};
+};
+
+#endif //GRAPHICS_SPSCQUEUE_H
@@ -0,0 +1,64 @@
+#include "threadPool.h"
+
+#include <algorithm>
+
+ThreadPool::ThreadPool(int threads) {
+    if (threads <= 0)
+        threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    for (int i = 0; i < threads; ++i)
+        this->threads.emplace_back(&ThreadPool::workerLoop, this);
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    ready.notify_all();
+    for (std::thread &thread : threads)
+        thread.join();
+}
+
+std::future<void> ThreadPool::submit(std::function<void()> task) {
+    std::packaged_task<void()> packaged(std::move(task));
+    std::future<void> done = packaged.get_future();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        tasks.push_back(std::move(packaged));
+    }
+    ready.notify_one();
+    return done;
+}
+
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t, size_t)> &fn) {
+    size_t parts = std::min(count, threads.size());
+    if (parts <= 1) {
+        if (count > 0)
+            fn(0, count);
+        return;
+    }
+
+    std::vector<std::future<void>> done;
+    done.reserve(parts);
+    for (size_t i = 0; i < parts; ++i) {
+        size_t begin = count * i / parts, end = count * (i + 1) / parts;
+        done.push_back(submit([&fn, begin, end]() { fn(begin, end); }));
+    }
+    for (std::future<void> &part : done)
+        part.get();
+}
+
+void ThreadPool::workerLoop() {
+    while (true) {
+        std::packaged_task<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            ready.wait(lock, [this]() { return stopping || !tasks.empty(); });
+            if (tasks.empty())
+                return;
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+        task();
+    }
+}
@@ -0,0 +1,50 @@
+#ifndef GRAPHICS_THREADPOOL_H
+#define GRAPHICS_THREADPOOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief A fixed set of worker threads running queued tasks in order.
+ * @details Tasks must not wait on other tasks of the same pool (every worker could end up
+ *          waiting); wait on the returned futures from outside the pool instead.
+ */
+class ThreadPool {
+    public:
+        /// @brief Starts the workers
+        /// @param threads number of workers, 0 for one per hardware thread
+        explicit ThreadPool(int threads = 0);
+        /// @brief Finishes the queued tasks, then stops the workers
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool &) = delete;
+        ThreadPool &operator=(const ThreadPool &) = delete;
+
+        /// @brief Queues a task
+        /// @return becomes ready when the task has run
+        std::future<void> submit(std::function<void()> task);
+
+        /// @brief Splits [0, count) into one range per worker and runs fn(begin, end) on each,
+        ///        returning once all of them are done
+        /// @note Only call this from outside the pool
+        void parallelFor(size_t count, const std::function<void(size_t, size_t)> &fn);
+
+        size_t size() const { return threads.size(); }
+
+    private:
+        std::vector<std::thread> threads;
+        std::deque<std::packaged_task<void()>> tasks;
+        std::mutex mutex;
+        std::condition_variable ready;
+        bool stopping = false;
+
+        void workerLoop();
+};
+
+#endif //GRAPHICS_THREADPOOL_H
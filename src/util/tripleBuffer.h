@@ -0,0 +1,58 @@
+#ifndef GRAPHICS_TRIPLEBUFFER_H
+#define GRAPHICS_TRIPLEBUFFER_H
+
+#include <atomic>
+#include <cstdint>
+
+/// @brief Lock-free single-producer/single-consumer triple buffer.
+/// @details The writer always owns one slot (back), the reader always owns one slot (front)
+///          and the third slot (middle) is handed between them with a single atomic exchange.
+///          Neither side ever waits for the other: the writer can publish as often as it likes
+///          and the reader always sees the most recently published value.
+template <typename T>
+class TripleBuffer {
+    public:
+        /// @brief Construct a triple buffer with every slot default constructed
+        TripleBuffer() = default;
+
+        /// @brief Construct a triple buffer with every slot set to a copy of init
+        /// @details Useful when T owns storage (e.g. a vector) that should be sized up front
+        ///          so that copies into the slots never allocate.
+        explicit TripleBuffer(const T &init) : slots{init, init, init} {}
+
+        TripleBuffer(const TripleBuffer &) = delete;
+        TripleBuffer &operator=(const TripleBuffer &) = delete;
+
+        /// @brief The slot the writer is allowed to modify (writer thread only)
+        T &back() { return slots[backIndex]; }
+
+        /// @brief Hands the back slot to the reader and takes the stale middle slot in exchange (writer thread only)
+        void publish() {
+            backIndex = middle.exchange(backIndex | FRESH, std::memory_order_acq_rel) & INDEX;
+        }
+
+        /// @brief Swaps in the newest published slot if there is one (reader thread only)
+        /// @return true if front() changed
+        bool update() {
+            if (!(middle.load(std::memory_order_relaxed) & FRESH))
+                return false;
+            frontIndex = middle.exchange(frontIndex, std::memory_order_acq_rel) & INDEX;
+            return true;
+        }
+
+        /// @brief The most recently acquired slot (reader thread only)
+        const T &front() const { return slots[frontIndex]; }
+
+    private:
+        static constexpr uint8_t INDEX = 0x3;
+        static constexpr uint8_t FRESH = 0x4;
+
+        T slots[3];
+
+        /// @brief Index of the shared slot, with FRESH set while it holds a value the reader hasn't seen
+        alignas(64) std::atomic<uint8_t> middle{1};
+        alignas(64) uint8_t backIndex = 0;
+        alignas(64) uint8_t frontIndex = 2;
+};
+
+#endif //GRAPHICS_TRIPLEBUFFER_H
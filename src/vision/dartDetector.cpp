@@ -0,0 +1,143 @@
+#include "dartDetector.h"
+#include "kernels.h"
+#include "../darts/boardModel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+DartDetector::DartDetector(const Homography &imageToBoard, DetectorConfig config) :
+    imageToBoard(imageToBoard), config(config) {}
+
+void DartDetector::reset(const GrayImage &frame) {
+    background = frame;
+    stillFrames = 0;
+    waitingForClear = false;
+}
+
+bool DartDetector::analyze(size_t index, const GrayImage &frame, size_t motion, const vector<uint8_t> &mask, size_t changed, Detection &detection) {
+    if (!hasBackground() || frame.width != background.width || frame.height != background.height) {
+        reset(frame);
+        return false;
+    }
+
+    if (changed > config.maxChangedFraction * frame.pixels.size())
+        waitingForClear = true;
+    if (motion > config.motionPixels) {
+        stillFrames = 0;
+        return false;
+    }
+    if (++stillFrames < config.settleFrames)
+        return false;
+
+    // whatever is on the board now (maybe nothing, maybe the darts that weren't pulled out) is the new start
+    if (waitingForClear) {
+        reset(frame);
+        return false;
+    }
+    if (changed < config.minDartPixels) {
+        // nothing new, follow slow lighting changes
+        Kernels::blend(background.pixels.data(), frame.pixels.data(), frame.pixels.size());
+        return false;
+    }
+    // only look once per still period, the dart is part of the background from here on
+    if (stillFrames != config.settleFrames)
+        return false;
+
+    findLargestBlob(mask, frame.width, frame.height);
+    // absorb whatever changed, dart or not, so it isn't looked at again
+    background.pixels = frame.pixels;
+    if (largest.size() < config.minDartPixels)
+        return false;
+
+    detection.frame = index;
+    detection.tip = findTip(frame.width);
+    detection.board = imageToBoard.apply(detection.tip);
+    detection.dart = BoardModel::dartAt(detection.board.x, detection.board.y);
+    return true;
+}
+
+void DartDetector::findLargestBlob(const vector<uint8_t> &mask, int width, int height) {
+    const size_t count = static_cast<size_t>(width) * height;
+    visited.assign(count, 0);
+    largest.clear();
+
+    for (size_t start = 0; start < count; ++start) {
+        // most of the mask is empty, skip it eight pixels at a time
+        if ((start & 7) == 0 && start + 8 <= count) {
+            uint64_t word;
+            std::memcpy(&word, mask.data() + start, sizeof(word));
+            if (word == 0) {
+                start += 7;
+                continue;
+            }
+        }
+        if (mask[start] == 0 || visited[start])
+            continue;
+
+        // flood fill the blob (8-connected) with an explicit stack
+        blob.clear();
+        stack.clear();
+        stack.push_back(static_cast<uint32_t>(start));
+        visited[start] = 1;
+        while (!stack.empty()) {
+            uint32_t pixel = stack.back();
+            stack.pop_back();
+            blob.push_back(pixel);
+            int x = static_cast<int>(pixel % width), y = static_cast<int>(pixel / width);
+            for (int dy = -1; dy <= 1; ++dy) {
+                for (int dx = -1; dx <= 1; ++dx) {
+                    int nx = x + dx, ny = y + dy;
+                    if (nx < 0 || ny < 0 || nx >= width || ny >= height)
+                        continue;
+                    size_t next = static_cast<size_t>(ny) * width + nx;
+                    if (mask[next] != 0 && !visited[next]) {
+                        visited[next] = 1;
+                        stack.push_back(static_cast<uint32_t>(next));
+                    }
+                }
+            }
+        }
+        if (blob.size() > largest.size())
+            std::swap(blob, largest);
+    }
+}
+
+Point2 DartDetector::findTip(int width) const {
+    // the blob's principal axis is the dart's axis
+    double meanX = 0, meanY = 0;
+    for (uint32_t pixel : largest) {
+        meanX += pixel % width;
+        meanY += pixel / width;
+    }
+    meanX /= largest.size();
+    meanY /= largest.size();
+    double xx = 0, xy = 0, yy = 0;
+    for (uint32_t pixel : largest) {
+        double x = pixel % width - meanX, y = pixel / width - meanY;
+        xx += x * x;
+        xy += x * y;
+        yy += y * y;
+    }
+    double angle = 0.5 * std::atan2(2 * xy, xx - yy);
+    double dirX = std::cos(angle), dirY = std::sin(angle);
+
+    // how far along the axis the blob reaches either way
+    double low = 0, high = 0;
+    for (uint32_t pixel : largest) {
+        double along = (pixel % width - meanX) * dirX + (pixel / width - meanY) * dirY;
+        low = std::min(low, along);
+        high = std::max(high, along);
+    }
+
+    // the quarter of the length with fewer pixels is the thin end, the tip
+    double quarter = (high - low) / 4;
+    size_t lowEnd = 0, highEnd = 0;
+    for (uint32_t pixel : largest) {
+        double along = (pixel % width - meanX) * dirX + (pixel / width - meanY) * dirY;
+        lowEnd += along < low + quarter;
+        highEnd += along > high - quarter;
+    }
+    double tip = lowEnd < highEnd ? low : high;
+    return {meanX + dirX * tip, meanY + dirY * tip};
+}
@@ -0,0 +1,91 @@
+#ifndef GRAPHICS_DARTDETECTOR_H
+#define GRAPHICS_DARTDETECTOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "frameSource.h"
+#include "homography.h"
+#include "../darts/x01.h"
+
+using std::vector;
+
+/// @brief Thresholds of the dart detector (the defaults suit a 1280x720 camera a metre or two away)
+struct DetectorConfig {
+    /// @brief How much a pixel has to change (0 to 255) to count as changed
+    uint8_t changeThreshold = 40;
+    /// @brief More changed pixels than this since the previous frame means something is moving
+    size_t motionPixels = 300;
+    /// @brief Still frames in a row before the board is looked at
+    int settleFrames = 2;
+    /// @brief The smallest blob of changed pixels that is taken for a dart
+    size_t minDartPixels = 120;
+    /// @brief More of the image than this changed is not a dart (a player in front of the board, darts being pulled out)
+    double maxChangedFraction = 0.05;
+};
+
+/// @brief A dart found in the frames
+struct Detection {
+    /// @brief The frame the dart was found in
+    size_t frame = 0;
+    /// @brief Where the tip is in the image (pixels)
+    Point2 tip;
+    /// @brief Where the tip is on the board (millimetres from the bull)
+    Point2 board;
+    Dart dart;
+};
+
+/**
+ * @brief Finds darts as they land from a fixed camera's frames.
+ * @details It keeps a background image of the board as it was before the current dart. Once the
+ *          picture has stopped moving for a few frames, the largest blob of pixels that differ from
+ *          the background is the new dart: a line fitted through it gives the dart's axis, and the
+ *          tip is the narrower end (the flights are the wide one). The tip is mapped onto the board
+ *          to score it, and the frame becomes the new background so the next dart is found on its own.
+ *          When most of the picture changes (someone walks up to pull the darts out), it waits
+ *          until the picture is still again and starts over from there.
+ *
+ *          The per-pixel work (frame differences and the change mask) is done by the caller, see
+ *          DetectionPipeline, so it can be spread over threads.
+ */
+class DartDetector {
+    public:
+        /// @param imageToBoard Maps image pixels to board millimetres (see Homography::load())
+        DartDetector(const Homography &imageToBoard, DetectorConfig config = DetectorConfig());
+
+        /// @brief Starts over with frame as the empty board
+        void reset(const GrayImage &frame);
+
+        /// @brief Looks at the next frame
+        /// @param index the frame's number (copied into the detection)
+        /// @param motion number of pixels that changed since the previous frame
+        /// @param mask 255 where frame differs from getBackground(), 0 elsewhere (see Kernels::diffMask())
+        /// @param changed number of marked pixels in mask
+        /// @return true if a dart landed, which is then described by detection
+        bool analyze(size_t index, const GrayImage &frame, size_t motion, const vector<uint8_t> &mask, size_t changed, Detection &detection);
+
+        const GrayImage &getBackground() const { return background; }
+        bool hasBackground() const { return !background.pixels.empty(); }
+        const DetectorConfig &getConfig() const { return config; }
+
+    private:
+        Homography imageToBoard;
+        DetectorConfig config;
+
+        GrayImage background;
+        /// @brief Frames in a row without motion
+        int stillFrames = 0;
+        /// @brief True after a big change, until the picture is still again
+        bool waitingForClear = false;
+
+        // reused between frames
+        vector<uint8_t> visited;
+        vector<uint32_t> stack, blob, largest;
+
+        /// @brief Finds the largest blob of marked pixels in mask (into largest)
+        void findLargestBlob(const vector<uint8_t> &mask, int width, int height);
+        /// @brief Fits a line through largest and returns its narrower end
+        Point2 findTip(int width) const;
+};
+
+#endif //GRAPHICS_DARTDETECTOR_H
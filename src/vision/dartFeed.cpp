@@ -0,0 +1,37 @@
+#include "dartFeed.h"
+#include "../util/log.h"
+
+#include <algorithm>
+#include <chrono>
+
+DartFeed::~DartFeed() {
+    stop();
+}
+
+bool DartFeed::start(const string &recording, const string &calibration) {
+    stop();
+    if (!frames.open(recording) || !imageToBoard.load(calibration.empty() ? recording + "/calibration.txt" : calibration))
+        return false;
+
+    // leave a core for rendering
+    int threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()) - 1);
+    pipeline = std::make_unique<DetectionPipeline>(frames, imageToBoard, DetectorConfig(), threads);
+    stopping = false;
+    thread = std::thread([this]() {
+        DetectionPipeline::Stats stats = pipeline->run([this](const Detection &detection) {
+            // the game takes one dart at a time, wait for it rather than losing any
+            while (!darts.push(detection) && !stopping)
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }, &stopping);
+        LOG_INFO("DARTFEED", "{} darts in {} frames ({} frames/s)", stats.darts, stats.frames,
+                 static_cast<int>(stats.frames / std::max(stats.seconds, 1e-9)));
+    });
+    return true;
+}
+
+void DartFeed::stop() {
+    stopping = true;
+    if (thread.joinable())
+        thread.join();
+    pipeline.reset();
+}
@@ -0,0 +1,51 @@
+#ifndef GRAPHICS_DARTFEED_H
+#define GRAPHICS_DARTFEED_H
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include "detectionPipeline.h"
+#include "../util/spscQueue.h"
+
+using std::string, std::unique_ptr;
+
+/**
+ * @brief Detects darts from a recorded camera sequence in the background and hands them to the game.
+ * @details The pipeline runs on its own thread (and pool); the darts it finds wait in a queue until
+ *          the game picks them up with poll(), so scoring never blocks rendering.
+ */
+class DartFeed {
+    public:
+        DartFeed() = default;
+        /// @brief Stops the detection
+        ~DartFeed();
+
+        DartFeed(const DartFeed &) = delete;
+        DartFeed &operator=(const DartFeed &) = delete;
+
+        /// @brief Starts detecting darts
+        /// @param recording directory of .pgm frames (see PgmSequence)
+        /// @param calibration calibration file (see Homography::load()), empty for <recording>/calibration.txt
+        /// @return false if the frames or the calibration couldn't be read (the reason is printed)
+        bool start(const string &recording, const string &calibration);
+
+        /// @brief Stops the detection and waits for it
+        void stop();
+
+        /// @brief Takes the oldest dart found, with where it landed (call from one thread only)
+        /// @return false if there is none
+        bool poll(Detection &detection) { return darts.pop(detection); }
+
+        bool isRunning() const { return thread.joinable(); }
+
+    private:
+        PgmSequence frames;
+        Homography imageToBoard;
+        unique_ptr<DetectionPipeline> pipeline;
+        std::thread thread;
+        std::atomic<bool> stopping{false};
+        SpscQueue<Detection, 64> darts;
+};
+
+#endif //GRAPHICS_DARTFEED_H
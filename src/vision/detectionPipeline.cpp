@@ -0,0 +1,76 @@
+#include "detectionPipeline.h"
+#include "kernels.h"
+#include "../util/log.h"
+
+#include <chrono>
+
+DetectionPipeline::DetectionPipeline(const FrameSource &source, const Homography &imageToBoard,
+                                     DetectorConfig config, int threads) :
+    source(source), detector(imageToBoard, config), pool(threads) {}
+
+void DetectionPipeline::request(vector<Slot> &slots, size_t index) {
+    Slot &slot = slots[index % slots.size()];
+    const FrameSource &frames = source;
+    slot.loaded = pool.submit([&frames, &slot, index]() { slot.ok = frames.load(index, slot.image); });
+}
+
+DetectionPipeline::Stats DetectionPipeline::run(const std::function<void(const Detection &)> &onDart, const std::atomic<bool> *stop) {
+    Stats stats;
+    auto start = std::chrono::steady_clock::now();
+    const DetectorConfig &config = detector.getConfig();
+
+    // two frames in flight per thread keeps every thread busy while the analysis runs
+    vector<Slot> slots(std::max<size_t>(2, pool.size() * 2));
+    const size_t count = source.size();
+    for (size_t i = 0; i < count && i < slots.size(); ++i)
+        request(slots, i);
+
+    GrayImage current, previous;
+    vector<uint8_t> mask;
+    Detection detection;
+    for (size_t i = 0; i < count; ++i) {
+        Slot &slot = slots[i % slots.size()];
+        slot.loaded.get();
+        if (!slot.ok) {
+            LOG_ERROR("DETECTIONPIPELINE", "Stopping at frame {}", i);
+            break;
+        }
+        // take the frame out of its slot so the slot can start on a later frame right away
+        std::swap(current, slot.image);
+        if (i + slots.size() < count && !(stop != nullptr && *stop))
+            request(slots, i + slots.size());
+
+        bool sameSize = current.width == previous.width && current.height == previous.height;
+        if (!detector.hasBackground() || !sameSize) {
+            detector.reset(current);
+        }
+        else {
+            const GrayImage &background = detector.getBackground();
+            mask.resize(current.pixels.size());
+            std::atomic<size_t> motion{0}, changed{0};
+            pool.parallelFor(static_cast<size_t>(current.height), [&](size_t first, size_t last) {
+                size_t offset = first * current.width, n = (last - first) * current.width;
+                motion += Kernels::diffCount(current.pixels.data() + offset, previous.pixels.data() + offset, n, config.changeThreshold);
+                changed += Kernels::diffMask(current.pixels.data() + offset, background.pixels.data() + offset,
+                                             mask.data() + offset, n, config.changeThreshold);
+            });
+            if (detector.analyze(i, current, motion, mask, changed, detection)) {
+                stats.darts++;
+                onDart(detection);
+            }
+        }
+        std::swap(previous, current);
+        stats.frames++;
+
+        if (stop != nullptr && *stop)
+            break;
+    }
+
+    // frames loaded ahead (when stopping early) still write into the slots
+    for (Slot &slot : slots) {
+        if (slot.loaded.valid())
+            slot.loaded.wait();
+    }
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return stats;
+}
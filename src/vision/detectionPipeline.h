@@ -0,0 +1,53 @@
+#ifndef GRAPHICS_DETECTIONPIPELINE_H
+#define GRAPHICS_DETECTIONPIPELINE_H
+
+#include <atomic>
+#include <functional>
+#include <future>
+#include <vector>
+#include "dartDetector.h"
+#include "frameSource.h"
+#include "../util/threadPool.h"
+
+/**
+ * @brief Runs a DartDetector over a FrameSource on a thread pool.
+ * @details The stages overlap: while one frame is being analyzed, the next ones are already being
+ *          loaded (decoding, disk reads) on the pool. The per-pixel stage (difference from the
+ *          previous frame, change mask against the background) is split into bands of rows over
+ *          the pool. Only the analysis itself, which depends on the frames before it, is sequential.
+ */
+class DetectionPipeline {
+    public:
+        /// @brief What a run did
+        struct Stats {
+            size_t frames = 0;
+            size_t darts = 0;
+            double seconds = 0;
+        };
+
+        /// @param threads pool size, 0 for one per hardware thread
+        DetectionPipeline(const FrameSource &source, const Homography &imageToBoard,
+                          DetectorConfig config = DetectorConfig(), int threads = 0);
+
+        /// @brief Processes every frame of the source in order
+        /// @param onDart called (on the calling thread) for every dart found
+        /// @param stop checked between frames, stops the run early when set
+        Stats run(const std::function<void(const Detection &)> &onDart, const std::atomic<bool> *stop = nullptr);
+
+    private:
+        /// @brief A frame being loaded ahead of the analysis
+        struct Slot {
+            GrayImage image;
+            std::future<void> loaded;
+            bool ok = false;
+        };
+
+        const FrameSource &source;
+        DartDetector detector;
+        ThreadPool pool;
+
+        /// @brief Starts loading frame index into its slot
+        void request(vector<Slot> &slots, size_t index);
+};
+
+#endif //GRAPHICS_DETECTIONPIPELINE_H
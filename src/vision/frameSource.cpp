@@ -0,0 +1,89 @@
+#include "frameSource.h"
+#include "../util/log.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+/// @brief Reads the next number of a PGM header, skipping whitespace and # comments
+static bool readHeaderNumber(std::FILE *file, int &value) {
+    int c = std::fgetc(file);
+    while (c != EOF && (std::isspace(c) || c == '#')) {
+        if (c == '#') {
+            while (c != EOF && c != '\n')
+                c = std::fgetc(file);
+        }
+        c = std::fgetc(file);
+    }
+    if (c == EOF || !std::isdigit(c))
+        return false;
+    value = 0;
+    while (c != EOF && std::isdigit(c)) {
+        value = value * 10 + (c - '0');
+        c = std::fgetc(file);
+    }
+    // the single whitespace character after the last number is part of the header
+    return c != EOF && std::isspace(c);
+}
+
+bool loadPgm(const string &path, GrayImage &image) {
+    std::FILE *file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+        LOG_ERROR("FRAMESOURCE", "Could not open {}", path);
+        return false;
+    }
+
+    int width = 0, height = 0, maxValue = 0;
+    bool ok = std::fgetc(file) == 'P' && std::fgetc(file) == '5' &&
+              readHeaderNumber(file, width) && readHeaderNumber(file, height) && readHeaderNumber(file, maxValue) &&
+              width > 0 && height > 0 && maxValue > 0 && maxValue < 256;
+    if (!ok) {
+        LOG_ERROR("FRAMESOURCE", "Not an 8-bit binary PGM: {}", path);
+        std::fclose(file);
+        return false;
+    }
+
+    image.resize(width, height);
+    ok = std::fread(image.pixels.data(), 1, image.pixels.size(), file) == image.pixels.size();
+    std::fclose(file);
+    if (!ok)
+        LOG_ERROR("FRAMESOURCE", "Truncated PGM: {}", path);
+    return ok;
+}
+
+bool savePgm(const string &path, const GrayImage &image) {
+    std::FILE *file = std::fopen(path.c_str(), "wb");
+    if (file == nullptr) {
+        LOG_ERROR("FRAMESOURCE", "Could not write {}", path);
+        return false;
+    }
+    std::fprintf(file, "P5\n%d %d\n255\n", image.width, image.height);
+    bool ok = std::fwrite(image.pixels.data(), 1, image.pixels.size(), file) == image.pixels.size();
+    return std::fclose(file) == 0 && ok;
+}
+
+bool PgmSequence::open(const string &directory) {
+    files.clear();
+    std::error_code error;
+    for (const fs::directory_entry &entry : fs::directory_iterator(directory, error)) {
+        if (entry.is_regular_file() && entry.path().extension() == ".pgm")
+            files.push_back(entry.path().string());
+    }
+    if (error) {
+        LOG_ERROR("FRAMESOURCE", "Could not read directory {}: {}", directory, error.message());
+        return false;
+    }
+    if (files.empty()) {
+        LOG_ERROR("FRAMESOURCE", "No .pgm frames in {}", directory);
+        return false;
+    }
+    std::sort(files.begin(), files.end());
+    return true;
+}
+
+bool PgmSequence::load(size_t index, GrayImage &image) const {
+    return index < files.size() && loadPgm(files[index], image);
+}
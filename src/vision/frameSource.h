@@ -0,0 +1,61 @@
+#ifndef GRAPHICS_FRAMESOURCE_H
+#define GRAPHICS_FRAMESOURCE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using std::string, std::vector;
+
+/// @brief An 8-bit greyscale image, rows stored top to bottom without padding
+struct GrayImage {
+    int width = 0, height = 0;
+    vector<uint8_t> pixels;
+
+    void resize(int width, int height) {
+        this->width = width;
+        this->height = height;
+        pixels.resize(static_cast<size_t>(width) * height);
+    }
+    uint8_t *row(int y) { return pixels.data() + static_cast<size_t>(y) * width; }
+    const uint8_t *row(int y) const { return pixels.data() + static_cast<size_t>(y) * width; }
+};
+
+/// @brief Reads a binary (P5) 8-bit PGM file into image, reusing its memory
+/// @return false if the file can't be read or isn't an 8-bit PGM (the reason is printed)
+bool loadPgm(const string &path, GrayImage &image);
+
+/// @brief Writes image as a binary (P5) PGM file
+bool savePgm(const string &path, const GrayImage &image);
+
+/**
+ * @brief A numbered sequence of camera frames.
+ * @details load() may be called from several threads at once, for different frames.
+ */
+class FrameSource {
+    public:
+        virtual ~FrameSource() = default;
+
+        /// @brief Number of frames in the sequence
+        virtual size_t size() const = 0;
+        /// @brief Reads frame index into image (reusing its memory)
+        /// @return false if the frame couldn't be read
+        virtual bool load(size_t index, GrayImage &image) const = 0;
+};
+
+/// @brief The .pgm files of a directory, in file name order (e.g. frame00001.pgm, frame00002.pgm, ...)
+class PgmSequence : public FrameSource {
+    public:
+        /// @brief Lists the frames in directory
+        /// @return false if the directory doesn't exist or has no .pgm files
+        bool open(const string &directory);
+
+        size_t size() const override { return files.size(); }
+        bool load(size_t index, GrayImage &image) const override;
+
+    private:
+        vector<string> files;
+};
+
+#endif //GRAPHICS_FRAMESOURCE_H
@@ -0,0 +1,164 @@
+#include "homography.h"
+#include "../util/log.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <utility>
+
+/// @brief c = a * b for row-major 3x3 matrices
+static void multiply(const double *a, const double *b, double *c) {
+    for (int row = 0; row < 3; ++row) {
+        for (int col = 0; col < 3; ++col)
+            c[row * 3 + col] = a[row * 3] * b[col] + a[row * 3 + 1] * b[3 + col] + a[row * 3 + 2] * b[6 + col];
+    }
+}
+
+/// @brief Inverts a row-major 3x3 matrix
+/// @return false if it's singular
+static bool invert(const double *m, double *out) {
+    double det = m[0] * (m[4] * m[8] - m[5] * m[7]) - m[1] * (m[3] * m[8] - m[5] * m[6]) + m[2] * (m[3] * m[7] - m[4] * m[6]);
+    if (std::fabs(det) < 1e-12)
+        return false;
+    out[0] = (m[4] * m[8] - m[5] * m[7]) / det;
+    out[1] = (m[2] * m[7] - m[1] * m[8]) / det;
+    out[2] = (m[1] * m[5] - m[2] * m[4]) / det;
+    out[3] = (m[5] * m[6] - m[3] * m[8]) / det;
+    out[4] = (m[0] * m[8] - m[2] * m[6]) / det;
+    out[5] = (m[2] * m[3] - m[0] * m[5]) / det;
+    out[6] = (m[3] * m[7] - m[4] * m[6]) / det;
+    out[7] = (m[1] * m[6] - m[0] * m[7]) / det;
+    out[8] = (m[0] * m[4] - m[1] * m[3]) / det;
+    return true;
+}
+
+/// @brief The similarity that moves points' centroid to the origin at an average distance of sqrt(2)
+/// @details Fitting normalized points keeps pixel and millimetre magnitudes from swamping each other.
+static void normalization(const vector<Point2> &points, double *t) {
+    double cx = 0, cy = 0;
+    for (const Point2 &p : points) {
+        cx += p.x;
+        cy += p.y;
+    }
+    cx /= points.size();
+    cy /= points.size();
+    double distance = 0;
+    for (const Point2 &p : points)
+        distance += std::hypot(p.x - cx, p.y - cy);
+    distance /= points.size();
+    double s = distance > 0 ? std::sqrt(2.0) / distance : 1.0;
+    double matrix[9] = {s, 0, -s * cx, 0, s, -s * cy, 0, 0, 1};
+    std::copy(matrix, matrix + 9, t);
+}
+
+Homography::Homography() : m{1, 0, 0, 0, 1, 0, 0, 0, 1} {}
+
+bool Homography::fit(const vector<Correspondence> &points) {
+    if (points.size() < 4)
+        return false;
+
+    vector<Point2> from, to;
+    for (const Correspondence &c : points) {
+        from.push_back(c.image);
+        to.push_back(c.board);
+    }
+    double tFrom[9], tTo[9];
+    normalization(from, tFrom);
+    normalization(to, tTo);
+
+    // With h33 = 1 every correspondence gives two linear equations in the other eight elements:
+    //   h11 x + h12 y + h13 - h31 x u - h32 y u = u
+    //   h21 x + h22 y + h23 - h31 x v - h32 y v = v
+    // which are solved in the least squares sense through the normal equations.
+    double ata[8][9] = {};
+    for (size_t i = 0; i < points.size(); ++i) {
+        double x = tFrom[0] * from[i].x + tFrom[2], y = tFrom[4] * from[i].y + tFrom[5];
+        double u = tTo[0] * to[i].x + tTo[2], v = tTo[4] * to[i].y + tTo[5];
+        double rows[2][9] = {{x, y, 1, 0, 0, 0, -x * u, -y * u, u},
+                             {0, 0, 0, x, y, 1, -x * v, -y * v, v}};
+        for (const double *row : rows) {
+            for (int r = 0; r < 8; ++r) {
+                for (int c = 0; c < 9; ++c)
+                    ata[r][c] += row[r] * row[c];
+            }
+        }
+    }
+
+    // Gaussian elimination with partial pivoting on the augmented 8x9 system
+    for (int col = 0; col < 8; ++col) {
+        int pivot = col;
+        for (int r = col + 1; r < 8; ++r) {
+            if (std::fabs(ata[r][col]) > std::fabs(ata[pivot][col]))
+                pivot = r;
+        }
+        if (std::fabs(ata[pivot][col]) < 1e-12)
+            return false;
+        std::swap(ata[col], ata[pivot]);
+        for (int r = 0; r < 8; ++r) {
+            if (r == col)
+                continue;
+            double factor = ata[r][col] / ata[col][col];
+            for (int c = col; c < 9; ++c)
+                ata[r][c] -= factor * ata[col][c];
+        }
+    }
+    double normalized[9];
+    for (int i = 0; i < 8; ++i)
+        normalized[i] = ata[i][8] / ata[i][i];
+    normalized[8] = 1;
+
+    // undo the normalization: H = tTo^-1 * normalized * tFrom
+    double toInverse[9], partial[9], result[9];
+    if (!invert(tTo, toInverse))
+        return false;
+    multiply(normalized, tFrom, partial);
+    multiply(toInverse, partial, result);
+    if (std::fabs(result[8]) < 1e-12)
+        return false;
+    for (int i = 0; i < 9; ++i)
+        m[i] = result[i] / result[8];
+    return true;
+}
+
+Point2 Homography::apply(Point2 point) const {
+    double w = m[6] * point.x + m[7] * point.y + m[8];
+    if (w == 0)
+        return {};
+    return {(m[0] * point.x + m[1] * point.y + m[2]) / w, (m[3] * point.x + m[4] * point.y + m[5]) / w};
+}
+
+Homography Homography::inverse() const {
+    Homography result;
+    double inverted[9];
+    if (invert(m, inverted)) {
+        // keep the last element at 1 when it can be (it can't if the origin maps to infinity)
+        double scale = std::fabs(inverted[8]) > 1e-12 ? inverted[8] : 1.0;
+        for (int i = 0; i < 9; ++i)
+            result.m[i] = inverted[i] / scale;
+    }
+    return result;
+}
+
+bool Homography::load(const string &path) {
+    std::ifstream file(path);
+    if (!file) {
+        LOG_ERROR("HOMOGRAPHY", "Could not open calibration {}", path);
+        return false;
+    }
+
+    vector<Correspondence> points;
+    string line;
+    while (std::getline(file, line)) {
+        line = line.substr(0, line.find('#'));
+        std::istringstream fields(line);
+        Correspondence c;
+        if (fields >> c.image.x >> c.image.y >> c.board.x >> c.board.y)
+            points.push_back(c);
+    }
+    if (!fit(points)) {
+        LOG_ERROR("HOMOGRAPHY", "Calibration {} needs at least four points, not all on one line", path);
+        return false;
+    }
+    return true;
+}
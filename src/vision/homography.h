@@ -0,0 +1,51 @@
+#ifndef GRAPHICS_HOMOGRAPHY_H
+#define GRAPHICS_HOMOGRAPHY_H
+
+#include <string>
+#include <vector>
+
+using std::string, std::vector;
+
+/// @brief A point in an image (pixels) or on the board (millimetres)
+struct Point2 {
+    double x = 0, y = 0;
+};
+
+/// @brief Where a known board point appears in the camera image
+struct Correspondence {
+    Point2 image, board;
+};
+
+/**
+ * @brief A projective mapping between two planes (here the camera image and the board).
+ * @details A flat board seen by a fixed camera maps to the image through a 3x3 matrix up to scale,
+ *          so four or more known points are enough to calibrate it.
+ */
+class Homography {
+    public:
+        /// @brief The identity mapping
+        Homography();
+
+        /// @brief Fits the mapping from each correspondence's image point to its board point
+        /// @details Least squares when there are more than four points.
+        /// @return false if there are fewer than four or they're degenerate (e.g. three on a line)
+        bool fit(const vector<Correspondence> &points);
+
+        /// @brief Maps a point
+        Point2 apply(Point2 point) const;
+
+        /// @brief The mapping the other way
+        Homography inverse() const;
+
+        /// @brief Reads a calibration file and fits it
+        /// @details One correspondence per line: "imageX imageY boardX boardY", with board
+        ///          positions in millimetres from the bull (see BoardModel). # starts a comment.
+        /// @return false if the file can't be read or fit (the reason is printed)
+        bool load(const string &path);
+
+    private:
+        /// @brief Row-major, normalized so the last element is 1
+        double m[9];
+};
+
+#endif //GRAPHICS_HOMOGRAPHY_H
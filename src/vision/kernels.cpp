@@ -0,0 +1,107 @@
+#include "kernels.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define KERNELS_SSE2
+#include <emmintrin.h>
+#elif defined(__aarch64__)
+#define KERNELS_NEON
+#include <arm_neon.h>
+#endif
+
+size_t Kernels::diffMask(const uint8_t *a, const uint8_t *b, uint8_t *mask, size_t n, uint8_t threshold) {
+    size_t i = 0, count = 0;
+#if defined(KERNELS_SSE2)
+    // unsigned |a - b| is the larger of the two saturating differences, and it's over the
+    // threshold wherever subtracting the threshold leaves something
+    const __m128i limit = _mm_set1_epi8(static_cast<char>(threshold));
+    const __m128i zero = _mm_setzero_si128(), ones = _mm_set1_epi8(1), all = _mm_set1_epi8(-1);
+    __m128i sums = zero;
+    for (; i + 16 <= n; i += 16) {
+        __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i));
+        __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + i));
+        __m128i diff = _mm_or_si128(_mm_subs_epu8(va, vb), _mm_subs_epu8(vb, va));
+        __m128i marked = _mm_xor_si128(_mm_cmpeq_epi8(_mm_subs_epu8(diff, limit), zero), all);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(mask + i), marked);
+        // sum of absolute differences against zero adds up the 1s of each half
+        sums = _mm_add_epi64(sums, _mm_sad_epu8(_mm_and_si128(marked, ones), zero));
+    }
+    count = static_cast<size_t>(_mm_cvtsi128_si64(sums)) + static_cast<size_t>(_mm_cvtsi128_si64(_mm_unpackhi_epi64(sums, sums)));
+#elif defined(KERNELS_NEON)
+    const uint8x16_t limit = vdupq_n_u8(threshold);
+    uint32x4_t sums = vdupq_n_u32(0);
+    for (; i + 16 <= n; i += 16) {
+        uint8x16_t marked = vcgtq_u8(vabdq_u8(vld1q_u8(a + i), vld1q_u8(b + i)), limit);
+        vst1q_u8(mask + i, marked);
+        sums = vpadalq_u16(sums, vpaddlq_u8(vshrq_n_u8(marked, 7)));
+    }
+    count = vaddvq_u32(sums);
+#endif
+    for (; i < n; ++i) {
+        int diff = a[i] > b[i] ? a[i] - b[i] : b[i] - a[i];
+        mask[i] = diff > threshold ? 255 : 0;
+        count += diff > threshold;
+    }
+    return count;
+}
+
+size_t Kernels::diffCount(const uint8_t *a, const uint8_t *b, size_t n, uint8_t threshold) {
+    size_t i = 0, count = 0;
+#if defined(KERNELS_SSE2)
+    const __m128i limit = _mm_set1_epi8(static_cast<char>(threshold));
+    const __m128i zero = _mm_setzero_si128(), ones = _mm_set1_epi8(1);
+    __m128i sums = zero;
+    for (; i + 16 <= n; i += 16) {
+        __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i));
+        __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + i));
+        __m128i diff = _mm_or_si128(_mm_subs_epu8(va, vb), _mm_subs_epu8(vb, va));
+        // 1 where the pixel is over the threshold, 0 where it isn't
+        __m128i over = _mm_andnot_si128(_mm_cmpeq_epi8(_mm_subs_epu8(diff, limit), zero), ones);
+        sums = _mm_add_epi64(sums, _mm_sad_epu8(over, zero));
+    }
+    count = static_cast<size_t>(_mm_cvtsi128_si64(sums)) + static_cast<size_t>(_mm_cvtsi128_si64(_mm_unpackhi_epi64(sums, sums)));
+#elif defined(KERNELS_NEON)
+    const uint8x16_t limit = vdupq_n_u8(threshold);
+    uint32x4_t sums = vdupq_n_u32(0);
+    for (; i + 16 <= n; i += 16) {
+        uint8x16_t marked = vcgtq_u8(vabdq_u8(vld1q_u8(a + i), vld1q_u8(b + i)), limit);
+        sums = vpadalq_u16(sums, vpaddlq_u8(vshrq_n_u8(marked, 7)));
+    }
+    count = vaddvq_u32(sums);
+#endif
+    for (; i < n; ++i) {
+        int diff = a[i] > b[i] ? a[i] - b[i] : b[i] - a[i];
+        count += diff > threshold;
+    }
+    return count;
+}
+
+void Kernels::blend(uint8_t *background, const uint8_t *frame, size_t n) {
+    size_t i = 0;
+    // avg(bg, avg(bg, frame)) is 3/4 of the background plus 1/4 of the frame
+#if defined(KERNELS_SSE2)
+    for (; i + 16 <= n; i += 16) {
+        __m128i bg = _mm_loadu_si128(reinterpret_cast<const __m128i *>(background + i));
+        __m128i fr = _mm_loadu_si128(reinterpret_cast<const __m128i *>(frame + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(background + i), _mm_avg_epu8(bg, _mm_avg_epu8(bg, fr)));
+    }
+#elif defined(KERNELS_NEON)
+    for (; i + 16 <= n; i += 16) {
+        uint8x16_t bg = vld1q_u8(background + i);
+        vst1q_u8(background + i, vrhaddq_u8(bg, vrhaddq_u8(bg, vld1q_u8(frame + i))));
+    }
+#endif
+    for (; i < n; ++i) {
+        int half = (background[i] + frame[i] + 1) >> 1;
+        background[i] = static_cast<uint8_t>((background[i] + half + 1) >> 1);
+    }
+}
+
+const char *Kernels::instructionSet() {
+#if defined(KERNELS_SSE2)
+    return "SSE2";
+#elif defined(KERNELS_NEON)
+    return "NEON";
+#else
+    return "scalar";
+#endif
+}
@@ -0,0 +1,30 @@
+#ifndef GRAPHICS_KERNELS_H
+#define GRAPHICS_KERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Per-pixel image kernels for the dart detector.
+ * @details Each one runs over a plain run of n 8-bit pixels (an image, or a band of its rows)
+ *          16 pixels at a time with SSE2 on x86-64 and NEON on AArch64, both part of the baseline
+ *          of those targets so no extra compiler flags are needed, and one at a time elsewhere.
+ */
+class Kernels {
+    public:
+        /// @brief Marks the pixels that differ from b by more than threshold
+        /// @param mask set to 255 where |a - b| > threshold and 0 elsewhere
+        /// @return the number of marked pixels
+        static size_t diffMask(const uint8_t *a, const uint8_t *b, uint8_t *mask, size_t n, uint8_t threshold);
+
+        /// @brief Counts the pixels that differ from b by more than threshold (diffMask() without the mask)
+        static size_t diffCount(const uint8_t *a, const uint8_t *b, size_t n, uint8_t threshold);
+
+        /// @brief Moves background a quarter of the way towards frame (slow lighting changes)
+        static void blend(uint8_t *background, const uint8_t *frame, size_t n);
+
+        /// @brief Returns the name of the instruction set the kernels were built with
+        static const char *instructionSet();
+};
+
+#endif //GRAPHICS_KERNELS_H
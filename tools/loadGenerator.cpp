@@ -0,0 +1,182 @@
+// Floods a match server with throws over loopback and reports throughput and latency.
+// Every connection runs on its own thread, keeps a number of matches going and has up to one
+// throw in flight per match; a match that is won is replaced with a new one.
+//
+// loadGenerator --server 127.0.0.1:7878 --connections 4 --matches 64 --seconds 10
+
+#include "../src/net/matchClient.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using std::chrono::steady_clock, std::chrono::duration, std::chrono::duration_cast;
+
+struct Options {
+    std::string server = "127.0.0.1:7878";
+    int connections = 4;
+    int matches = 64;
+    int players = 2;
+    double seconds = 10;
+};
+
+/// @brief What one connection measured
+struct Result {
+    uint64_t throws = 0;
+    uint64_t errors = 0;
+    /// @brief Round trip of every throw in microseconds
+    std::vector<uint32_t> latencies;
+    bool connected = false;
+};
+
+/// @brief A match this connection is playing
+struct Match {
+    uint32_t id = 0;
+    uint8_t current = 0;
+    /// @brief When the throw in flight was sent
+    steady_clock::time_point sent;
+};
+
+static Dart randomDart(std::minstd_rand &rng) {
+    // mostly trebles and singles around the board, sometimes a double, bull or miss
+    std::uniform_int_distribution<int> segment(1, 20), kind(0, 19);
+    Dart dart;
+    int k = kind(rng);
+    dart.segment = k == 0 ? 0 : k == 1 ? 25 : static_cast<uint8_t>(segment(rng));
+    dart.multiplier = k == 0 ? 0 : k == 1 ? 2 : k < 6 ? 3 : k < 9 ? 2 : 1;
+    return dart;
+}
+
+static void runConnection(const Options &options, Result &result, std::atomic<bool> &stop, unsigned seed) {
+    MatchClient client;
+    if (!client.connect(options.server))
+        return;
+    result.connected = true;
+
+    std::minstd_rand rng(seed);
+    std::vector<Match> matches(options.matches);
+    // what each outstanding request was for: sequence -> index in matches
+    std::unordered_map<uint32_t, size_t> pending;
+    std::vector<MatchMessage> responses;
+
+    auto create = [&](size_t index) {
+        MatchMessage request;
+        request.type = MatchMessage::createMatch;
+        request.players = static_cast<uint8_t>(options.players);
+        request.startScore = 501;
+        pending[client.send(request)] = index;
+    };
+    auto throwDart = [&](size_t index) {
+        MatchMessage request;
+        request.type = MatchMessage::submitThrow;
+        request.match = matches[index].id;
+        request.player = matches[index].current;
+        request.dart = randomDart(rng);
+        matches[index].sent = steady_clock::now();
+        pending[client.send(request)] = index;
+    };
+
+    for (size_t i = 0; i < matches.size(); ++i)
+        create(i);
+
+    while (!stop.load(std::memory_order_relaxed)) {
+        responses.clear();
+        if (!client.receive(responses, 10)) {
+            std::cout << "ERROR::LOADGENERATOR: Lost connection to the server" << std::endl;
+            return;
+        }
+        auto now = steady_clock::now();
+        for (const MatchMessage &response : responses) {
+            auto found = pending.find(response.sequence);
+            if (found == pending.end())
+                continue;
+            size_t index = found->second;
+            pending.erase(found);
+
+            switch (response.type) {
+                case MatchMessage::matchCreated:
+                    matches[index].id = response.match;
+                    matches[index].current = 0;
+                    throwDart(index);
+                    break;
+                case MatchMessage::throwResult:
+                    result.throws++;
+                    result.latencies.push_back(static_cast<uint32_t>(
+                        duration_cast<std::chrono::microseconds>(now - matches[index].sent).count()));
+                    if (response.winner >= 0) {
+                        create(index);
+                    }
+                    else {
+                        matches[index].current = response.current;
+                        throwDart(index);
+                    }
+                    break;
+                default:
+                    // the match is gone or the request was refused, start over with a new one
+                    result.errors++;
+                    create(index);
+                    break;
+            }
+        }
+    }
+}
+
+static uint32_t percentile(std::vector<uint32_t> &values, double p) {
+    if (values.empty())
+        return 0;
+    size_t index = std::min(values.size() - 1, static_cast<size_t>(p * values.size()));
+    std::nth_element(values.begin(), values.begin() + index, values.end());
+    return values[index];
+}
+
+int main(int argc, char *argv[]) {
+    Options options;
+    for (int i = 1; i + 1 < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--server")
+            options.server = argv[++i];
+        else if (arg == "--connections")
+            options.connections = std::max(1, std::stoi(argv[++i]));
+        else if (arg == "--matches")
+            options.matches = std::max(1, std::stoi(argv[++i]));
+        else if (arg == "--players")
+            options.players = std::clamp(std::stoi(argv[++i]), 1, X01Game::MAX_PLAYERS);
+        else if (arg == "--seconds")
+            options.seconds = std::stod(argv[++i]);
+    }
+
+    std::vector<Result> results(options.connections);
+    std::vector<std::thread> threads;
+    std::atomic<bool> stop{false};
+
+    auto start = steady_clock::now();
+    for (int i = 0; i < options.connections; ++i)
+        threads.emplace_back(runConnection, std::cref(options), std::ref(results[i]), std::ref(stop), 1234u + i);
+    std::this_thread::sleep_for(duration<double>(options.seconds));
+    stop = true;
+    for (std::thread &thread : threads)
+        thread.join();
+    double elapsed = duration<double>(steady_clock::now() - start).count();
+
+    Result total;
+    for (Result &result : results) {
+        total.throws += result.throws;
+        total.errors += result.errors;
+        total.connected |= result.connected;
+        total.latencies.insert(total.latencies.end(), result.latencies.begin(), result.latencies.end());
+    }
+    if (!total.connected)
+        return 1;
+
+    std::cout << options.connections << " connections x " << options.matches << " matches for " << elapsed << " s" << std::endl;
+    std::cout << "throws: " << total.throws << " (" << static_cast<uint64_t>(total.throws / elapsed) << "/s), errors: " << total.errors << std::endl;
+    std::cout << "latency us: p50 " << percentile(total.latencies, 0.50) << ", p99 " << percentile(total.latencies, 0.99)
+              << ", max " << percentile(total.latencies, 1.0) << std::endl;
+    return 0;
+}
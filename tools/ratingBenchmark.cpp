@@ -0,0 +1,156 @@
+// Plays years of made-up league results between players of known strength, rates them one by one,
+// then rates the whole history again on one thread and on all of them (which has to give exactly the
+// same ratings), again from the last season only, and finally sweeps sets of Elo and Glicko rules
+// over it to find the ones that predict the results best.
+//
+// ratingBenchmark --results 5000000 --players 5000 --rules 200 [--threads 8] [--grain 64]
+
+#include "../src/darts/ratings.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <string>
+
+using std::chrono::steady_clock, std::chrono::duration;
+
+static double secondsSince(steady_clock::time_point start) {
+    return duration<double>(steady_clock::now() - start).count();
+}
+
+// 2019-01-01, the first result
+static const uint32_t FIRST_TIME = 1546300800;
+
+static bool sameRatings(const RatingEngine &a, const RatingEngine &b) {
+    vector<PlayerRating> first = a.standings(), second = b.standings();
+    if (first.size() != second.size())
+        return false;
+    for (size_t i = 0; i < first.size(); ++i) {
+        if (first[i].player != second[i].player || first[i].rating != second[i].rating ||
+            first[i].deviation != second[i].deviation || first[i].results != second[i].results)
+            return false;
+    }
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    uint64_t results = 5000000;
+    uint32_t players = 5000;
+    size_t ruleCount = 200;
+    int threads = 0;
+    size_t grain = RatingEngine::PARALLEL_GRAIN;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--results" && i + 1 < argc)
+            results = std::stoull(argv[++i]);
+        else if (arg == "--players" && i + 1 < argc)
+            players = static_cast<uint32_t>(std::stoul(argv[++i]));
+        else if (arg == "--rules" && i + 1 < argc)
+            ruleCount = std::stoul(argv[++i]);
+        else if (arg == "--threads" && i + 1 < argc)
+            threads = std::stoi(argv[++i]);
+        else if (arg == "--grain" && i + 1 < argc)
+            grain = std::stoul(argv[++i]);
+    }
+    if (players < 2) {
+        std::cerr << "--players has to be at least 2" << std::endl;
+        return 1;
+    }
+
+    // strengths on the Elo scale; every tenth result is a match, which the stronger player wins more often
+    std::minstd_rand rng(2468u);
+    std::normal_distribution<double> strength(1500, 200);
+    std::uniform_real_distribution<double> unit(0, 1);
+    vector<double> strengths(players);
+    for (double &s : strengths)
+        s = strength(rng);
+
+    RatingEngine incremental;
+    incremental.reserve(results);
+    uint32_t time = FIRST_TIME;
+    auto start = steady_clock::now();
+    for (uint64_t i = 0; i < results; ++i) {
+        RatingResult result;
+        time += 1 + rng() % 60;
+        result.time = time;
+        result.first = rng() % players;
+        result.second = (result.first + 1 + rng() % (players - 1)) % players;
+        result.kind = i % 10 == 9 ? matchResult : legResult;
+        double difference = (strengths[result.first] - strengths[result.second]) * (result.kind == matchResult ? 1.5 : 1.0);
+        result.score = unit(rng) < 1 / (1 + std::pow(10.0, -difference / 400)) ? 1.0f : 0.0f;
+        incremental.add(result);
+    }
+    double added = secondsSince(start);
+    printf("%llu results between %u players over %u seasons, added in %.2f s (%.0f ns a result)\n",
+           static_cast<unsigned long long>(results), players, incremental.seasonOf(time) - incremental.seasonOf(FIRST_TIME) + 1,
+           added, added * 1e9 / static_cast<double>(results));
+    const RatingAccuracy &accuracy = incremental.getAccuracy();
+    printf("  predicted: log loss %.4f, Brier %.4f, %.1f%% right\n",
+           accuracy.meanLogLoss(), accuracy.brierScore(), 100 * accuracy.hitRate());
+
+    bool ok = true;
+    ThreadPool pool(threads);
+    RatingEngine recomputed = incremental;
+    recomputed.setParallelGrain(grain);
+    start = steady_clock::now();
+    recomputed.recompute(incremental.getParams());
+    double single = secondsSince(start);
+    bool same = sameRatings(incremental, recomputed);
+    printf("Recomputed on 1 thread in %.2f s: %s\n", single, same ? "same ratings" : "DIFFERENT ratings");
+    ok = ok && same;
+
+    start = steady_clock::now();
+    recomputed.recompute(incremental.getParams(), &pool);
+    double parallel = secondsSince(start);
+    same = sameRatings(incremental, recomputed);
+    printf("Recomputed on %zu threads in %.2f s (%.1fx): %s\n", pool.size(), parallel, single / parallel,
+           same ? "same ratings" : "DIFFERENT ratings");
+    ok = ok && same;
+
+    start = steady_clock::now();
+    recomputed.recompute(incremental.getParams(), &pool, incremental.seasonOf(time));
+    same = sameRatings(incremental, recomputed);
+    printf("Recomputed the last season in %.3f s: %s\n", secondsSince(start), same ? "same ratings" : "DIFFERENT ratings");
+    ok = ok && same;
+
+    // the best players at the end of the first season and now
+    for (uint32_t season : {incremental.seasonOf(FIRST_TIME), incremental.seasonOf(time)}) {
+        vector<PlayerRating> table = incremental.standings(season);
+        printf("Season %u leader: player %u, %.0f (+-%.0f, strength %.0f)\n", season, table[0].player,
+               table[0].rating, 2 * table[0].deviation, strengths[table[0].player]);
+    }
+
+    // K-factors for Elo, and how fast the deviation grows back for Glicko
+    vector<RatingParams> rules(ruleCount);
+    for (size_t i = 0; i < ruleCount; ++i) {
+        double t = ruleCount > 1 ? static_cast<double>(i / 2) / static_cast<double>((ruleCount - 1) / 2 + 1) : 0.0;
+        rules[i].system = i % 2 == 0 ? eloRating : glickoRating;
+        rules[i].k = 4 + 60 * t;
+        rules[i].deviationGrowth = 1 + 40 * t;
+    }
+    start = steady_clock::now();
+    vector<RatingAccuracy> swept = incremental.sweep(rules, &pool);
+    double sweepTime = secondsSince(start);
+    size_t bestElo = 0, bestGlicko = rules.size() > 1 ? 1 : 0;
+    for (size_t i = 0; i < rules.size(); ++i) {
+        size_t &best = rules[i].system == eloRating ? bestElo : bestGlicko;
+        if (swept[i].meanLogLoss() < swept[best].meanLogLoss())
+            best = i;
+    }
+    printf("Swept %zu sets of rules in %.2f s (%.0f ns a result and set of rules)\n", rules.size(), sweepTime,
+           sweepTime * 1e9 / static_cast<double>(results) / static_cast<double>(rules.size()));
+    if (!rules.empty()) {
+        printf("  best Elo: K %.1f, log loss %.4f, %.1f%% right\n", rules[bestElo].k,
+               swept[bestElo].meanLogLoss(), 100 * swept[bestElo].hitRate());
+        if (rules.size() > 1)
+            printf("  best Glicko: growth %.1f a day, log loss %.4f, %.1f%% right\n", rules[bestGlicko].deviationGrowth,
+                   swept[bestGlicko].meanLogLoss(), 100 * swept[bestGlicko].hitRate());
+        // better than a coin toss, or the ratings learnt nothing
+        ok = ok && swept[bestElo].meanLogLoss() < std::log(2.0);
+    }
+
+    printf("%s\n", ok ? "ok" : "FAILED");
+    return ok ? 0 : 1;
+}
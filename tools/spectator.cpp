@@ -0,0 +1,99 @@
+// Watches a match server's spectator stream, checks every frame against its checksum and reports
+// the stream's rate. --slow makes it read slowly, to see the server drop it back to keyframes.
+//
+// spectator --server 127.0.0.1:7879 --seconds 10 [--slow <ms between reads>]
+
+#include "../src/net/matchClient.h"
+#include "../src/net/spectatorStream.h"
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using std::chrono::steady_clock, std::chrono::duration;
+
+int main(int argc, char *argv[]) {
+    std::string server = "127.0.0.1:7879";
+    double seconds = 10;
+    int slow = 0;
+    for (int i = 1; i + 1 < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--server")
+            server = argv[++i];
+        else if (arg == "--seconds")
+            seconds = std::stod(argv[++i]);
+        else if (arg == "--slow")
+            slow = std::stoi(argv[++i]);
+    }
+
+    int fd = MatchClient::openConnection(server);
+    if (fd < 0)
+        return 1;
+
+    SpectatorDecoder decoder;
+    std::vector<uint8_t> input;
+    // counters since the last report, and in total
+    uint64_t frames = 0, bytes = 0, skipped = 0;
+    uint64_t totalFrames = 0, totalBytes = 0, mismatches = 0;
+    bool malformed = false;
+
+    auto start = steady_clock::now();
+    auto nextReport = start + std::chrono::seconds(1);
+    while (!malformed && duration<double>(steady_clock::now() - start).count() < seconds) {
+        pollfd readable{fd, POLLIN, 0};
+        if (poll(&readable, 1, 100) > 0) {
+            uint8_t buffer[64 * 1024];
+            ssize_t got = recv(fd, buffer, slow > 0 ? 512 : sizeof(buffer), 0);
+            if (got <= 0) {
+                std::cout << "ERROR::SPECTATOR: Lost connection to the server" << std::endl;
+                break;
+            }
+            input.insert(input.end(), buffer, buffer + got);
+            bytes += got;
+
+            size_t offset = 0, used = 0;
+            while (offset < input.size()) {
+                SpectatorDecoder::status status = decoder.decode(input.data() + offset, input.size() - offset, used);
+                if (status == SpectatorDecoder::incomplete)
+                    break;
+                if (status == SpectatorDecoder::malformed) {
+                    std::cout << "ERROR::SPECTATOR: Malformed frame" << std::endl;
+                    malformed = true;
+                    break;
+                }
+                offset += used;
+                frames++;
+                if (status == SpectatorDecoder::skipped)
+                    skipped++;
+                else if (status == SpectatorDecoder::mismatch)
+                    mismatches++;
+            }
+            input.erase(input.begin(), input.begin() + offset);
+            if (slow > 0)
+                std::this_thread::sleep_for(std::chrono::milliseconds(slow));
+        }
+
+        auto now = steady_clock::now();
+        if (now >= nextReport) {
+            nextReport += std::chrono::seconds(1);
+            std::cout << "tick " << decoder.getTick() << ", matches " << decoder.getState().getMatches().size()
+                      << ", frames/s " << frames << ", bytes/s " << bytes << ", skipped " << skipped
+                      << ", mismatches " << mismatches << std::endl;
+            totalFrames += frames;
+            totalBytes += bytes;
+            frames = bytes = skipped = 0;
+        }
+    }
+    close(fd);
+
+    totalFrames += frames;
+    totalBytes += bytes;
+    std::cout << "frames: " << totalFrames << ", bytes: " << totalBytes << ", mismatches: " << mismatches << std::endl;
+    return mismatches == 0 && !malformed ? 0 : 1;
+}
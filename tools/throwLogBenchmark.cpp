@@ -0,0 +1,159 @@
+// Writes a throw log through ThrowLog, tears its end the way a power loss would, and scans it back
+// through ThrowLogReader, reporting how fast each step is and checking nothing good was lost. Then
+// counts the player statistics of the whole log, and how long a session's saved ones take to catch up.
+//
+// throwLogBenchmark --records 10000000 --file throws-benchmark.bin [--keep]
+
+#include "../src/darts/playerStats.h"
+#include "../src/darts/throwLog.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+
+using std::chrono::steady_clock, std::chrono::duration;
+
+static double secondsSince(steady_clock::time_point start) {
+    return duration<double>(steady_clock::now() - start).count();
+}
+
+// the i-th record of the benchmark log, so the scan knows what to expect
+static ThrowRecord makeRecord(uint64_t i, std::minstd_rand &rng) {
+    ThrowRecord record;
+    record.time = 1700000000000000000ull + i * 2000000000ull;
+    record.match = static_cast<uint32_t>(i / 60 + 1);
+    record.player = static_cast<uint8_t>(i / 3 % 2);
+    record.leg = static_cast<uint16_t>(i / 60);
+    record.visit = static_cast<uint16_t>(i / 6 % 10);
+    record.dart = static_cast<uint8_t>(i % 3);
+    record.segment = static_cast<uint8_t>(rng() % 20 + 1);
+    record.multiplier = static_cast<uint8_t>(rng() % 3 + 1);
+    record.x = static_cast<int16_t>(rng() % 3400) - 1700;
+    record.y = static_cast<int16_t>(rng() % 3400) - 1700;
+    record.result = accepted;
+    return record;
+}
+
+int main(int argc, char *argv[]) {
+    uint64_t records = 10000000;
+    std::string file = "throws-benchmark.bin";
+    bool keep = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--records" && i + 1 < argc)
+            records = std::stoull(argv[++i]);
+        else if (arg == "--file" && i + 1 < argc)
+            file = argv[++i];
+        else if (arg == "--keep")
+            keep = true;
+    }
+    std::remove(file.c_str());
+
+    // write: the producer only ever queues, the writer batches and syncs
+    ThrowLog log;
+    if (!log.open(file))
+        return 1;
+    std::minstd_rand rng(1234u);
+    uint64_t expectedPoints = 0, retries = 0;
+    double appendSeconds = 0;
+    auto start = steady_clock::now();
+    for (uint64_t i = 0; i < records; ++i) {
+        ThrowRecord record = makeRecord(i, rng);
+        expectedPoints += record.getDart().points();
+        auto before = steady_clock::now();
+        // a game drops a throw if the disk falls this far behind, the benchmark waits instead
+        while (!log.append(record)) {
+            retries++;
+            std::this_thread::yield();
+        }
+        appendSeconds += secondsSince(before);
+    }
+    log.close();
+    double writeSeconds = secondsSince(start);
+    std::cout << log.getWritten() << " records written in " << writeSeconds << " s (" << log.getWritten() / writeSeconds
+              << " records/s, " << log.getBatches() << " batches synced), append " << appendSeconds / records * 1e9
+              << " ns on average (" << retries << " waits for a full queue)" << std::endl;
+
+    // a power loss in the middle of a batch: a torn record and a half written one at the end
+    {
+        std::ofstream out(file, std::ios::binary | std::ios::app);
+        ThrowRecord garbage = makeRecord(records, rng);
+        garbage.checksum = ~garbage.computeChecksum();
+        out.write(reinterpret_cast<const char *>(&garbage), sizeof(garbage));
+        out.write(reinterpret_cast<const char *>(&garbage), sizeof(garbage) / 2);
+    }
+
+    // scan: straight out of the mapping
+    ThrowLogReader reader;
+    start = steady_clock::now();
+    if (!reader.open(file))
+        return 1;
+    double openSeconds = secondsSince(start);
+    start = steady_clock::now();
+    uint64_t points = 0, trebles = 0, located = 0;
+    uint64_t perPlayer[2] = {};
+    for (const ThrowRecord &record : reader) {
+        int dartPoints = record.getDart().points();
+        points += dartPoints;
+        perPlayer[record.player & 1] += dartPoints;
+        trebles += record.multiplier == 3;
+        located += record.hasPosition();
+    }
+    double scanSeconds = secondsSince(start);
+    start = steady_clock::now();
+    size_t verified = reader.verifyAll();
+    double verifySeconds = secondsSince(start);
+    std::cout << reader.size() << " records (" << reader.getTorn() << " torn) opened in " << openSeconds * 1000
+              << " ms, scanned in " << scanSeconds * 1000 << " ms (" << reader.size() / scanSeconds / 1e6
+              << " M records/s), every checksum checked in " << verifySeconds * 1000 << " ms" << std::endl;
+    std::cout << "points " << points << " (P1 " << perPlayer[0] << ", P2 " << perPlayer[1] << "), " << trebles
+              << " trebles, " << located << " with a position" << std::endl;
+    bool ok = reader.size() == records && verified == records && points == expectedPoints && reader.getTorn() == 2;
+
+    // statistics: every throw once, then only the ones after what was saved
+    StatsEngine stats;
+    start = steady_clock::now();
+    stats.catchUp(reader);
+    double statsSeconds = secondsSince(start);
+    StatsSummary first = stats.getPlayer(0).getAllTime();
+    std::string statsFile = file + ".stats";
+    StatsEngine resumed;
+    size_t caughtUp = 0;
+    double resumeSeconds = 0;
+    if (stats.save(statsFile)) {
+        start = steady_clock::now();
+        resumed.load(statsFile);
+        caughtUp = resumed.catchUp(reader);
+        resumeSeconds = secondsSince(start);
+        std::remove(statsFile.c_str());
+    }
+    std::cout << "stats of every throw in " << statsSeconds * 1000 << " ms (" << records / statsSeconds / 1e6
+              << " M throws/s), P1 average " << first.threeDartAverage() << " over " << first.legs << " legs, "
+              << "saved stats loaded and caught up (" << caughtUp << " throws) in " << resumeSeconds * 1000 << " ms" << std::endl;
+    // every match is a leg, and all but the last are over
+    ok = ok && first.darts == records / 6 * 3 + std::min<uint64_t>(records % 6, 3)
+         && first.legs == (records - 1) / 60 && resumed.getThrowCount() == records && caughtUp == 0
+         && resumed.getPlayer(0).getAllTime().visitPoints == first.visitPoints;
+    reader.close();
+
+    // opening it for writing again cuts the torn end off, and new records follow the old ones
+    if (log.open(file)) {
+        log.append(makeRecord(records, rng));
+        log.close();
+    }
+    ok = ok && reader.open(file) && reader.size() == records + 1 && reader.getTorn() == 0;
+    reader.close();
+
+    // ten million records should scan well under a second
+    if (records >= 10000000 && scanSeconds * 1e7 / records >= 1.0)
+        ok = false;
+    std::cout << (ok ? "ok" : "FAILED") << std::endl;
+    if (!keep)
+        std::remove(file.c_str());
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,183 @@
+// Fills a ThrowStore with years of made-up throws, then times the queries a league would run on it
+// (averages per player, a year of them, a treble rate, a month by day, percentiles) one thread and
+// all of them at a time, and checks every answer against sums kept while the throws were made. The
+// store is saved and loaded back, and has to answer the same.
+//
+// throwStoreBenchmark --throws 100000000 --players 8 --dir throw-store [--keep]
+
+#include "../src/darts/throwStore.h"
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <string>
+
+using std::chrono::steady_clock, std::chrono::duration;
+
+static double secondsSince(steady_clock::time_point start) {
+    return duration<double>(steady_clock::now() - start).count();
+}
+
+// 2019-01-01, the first throw
+static const uint32_t FIRST_TIME = 1546300800;
+static const uint32_t YEAR = 365 * 86400;
+
+int main(int argc, char *argv[]) {
+    uint64_t throws = 100000000;
+    uint32_t players = 8;
+    std::string dir = "throw-store";
+    bool keep = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--throws" && i + 1 < argc)
+            throws = std::stoull(argv[++i]);
+        else if (arg == "--players" && i + 1 < argc)
+            players = static_cast<uint32_t>(std::stoul(argv[++i]));
+        else if (arg == "--dir" && i + 1 < argc)
+            dir = argv[++i];
+        else if (arg == "--keep")
+            keep = true;
+    }
+    if (players < 1 || players > 256) {
+        std::cerr << "--players is 1 to 256" << std::endl;
+        return 1;
+    }
+
+    // a throw every one or two seconds, so a hundred million take about five years
+    ThrowStore store;
+    store.reserve(throws);
+    std::minstd_rand rng(4321u);
+    std::vector<uint64_t> count(players), points(players), yearCount(players), yearPoints(players);
+    std::array<uint64_t, ThrowStore::MAX_POINTS + 1> histogram{};
+    uint64_t trebles = 0, playerThrows = 0;
+    uint32_t yearFrom = FIRST_TIME + YEAR, yearTo = FIRST_TIME + 2 * YEAR;
+    uint32_t time = FIRST_TIME;
+    auto start = steady_clock::now();
+    for (uint64_t i = 0; i < throws; ++i) {
+        ThrowRecord record;
+        time += 1 + rng() % 2;
+        record.time = static_cast<uint64_t>(time) * 1000000000ull;
+        record.player = static_cast<uint8_t>(i / 3 % players);
+        uint32_t spot = rng() % 64;
+        if (spot < 60) {
+            record.segment = static_cast<uint8_t>(spot % 20 + 1);
+            record.multiplier = static_cast<uint8_t>(spot / 20 + 1);
+        }
+        else if (spot < 62) {
+            record.segment = 25;
+            record.multiplier = static_cast<uint8_t>(spot - 59);
+        }
+        uint32_t outcome = rng() % 100;
+        record.result = outcome < 3 ? bust : outcome < 4 ? checkout : accepted;
+        store.append(record);
+
+        int dartPoints = record.getDart().points();
+        count[record.player]++;
+        points[record.player] += dartPoints;
+        if (time >= yearFrom && time < yearTo) {
+            yearCount[record.player]++;
+            yearPoints[record.player] += dartPoints;
+        }
+        if (record.player == 0) {
+            playerThrows++;
+            trebles += record.multiplier == 3;
+            histogram[dartPoints]++;
+        }
+    }
+    std::cout << store.size() << " throws of " << players << " players over " << (time - FIRST_TIME) / 86400 << " days stored in "
+              << secondsSince(start) << " s" << std::endl;
+
+    ThreadPool pool;
+    bool ok = store.size() == throws;
+    double groupSeconds = 0;
+    std::vector<ThrowGroup> everything;
+    for (ThreadPool *threads : {static_cast<ThreadPool *>(nullptr), &pool}) {
+        const char *how = threads == nullptr ? "1 thread" : "pool";
+
+        // the average of every player, all time
+        start = steady_clock::now();
+        everything = store.aggregate(ThrowFilter(), byPlayer, threads);
+        double seconds = secondsSince(start);
+        groupSeconds = threads == nullptr ? seconds : std::min(groupSeconds, seconds);
+        ok = ok && everything.size() == players;
+        for (const ThrowGroup &group : everything)
+            ok = ok && group.count == count[group.key] && group.points == points[group.key];
+
+        // the same for the second year
+        ThrowFilter year;
+        year.from = yearFrom;
+        year.to = yearTo;
+        start = steady_clock::now();
+        std::vector<ThrowGroup> yearGroups = store.aggregate(year, byPlayer, threads);
+        double yearSeconds = secondsSince(start);
+        for (const ThrowGroup &group : yearGroups)
+            ok = ok && group.count == yearCount[group.key] && group.points == yearPoints[group.key];
+
+        // the first player's trebles
+        ThrowFilter treble;
+        treble.player = 0;
+        treble.multiplier = 3;
+        start = steady_clock::now();
+        std::vector<ThrowGroup> trebleGroups = store.aggregate(treble, byNothing, threads);
+        double trebleSeconds = secondsSince(start);
+        ok = ok && (trebles == 0 ? trebleGroups.empty() : trebleGroups.size() == 1 && trebleGroups[0].count == trebles);
+
+        // the last 30 days, day by day
+        ThrowFilter month;
+        month.from = time - 30 * 86400;
+        start = steady_clock::now();
+        std::vector<ThrowGroup> days = store.aggregate(month, byDay, threads);
+        double monthSeconds = secondsSince(start);
+        std::vector<ThrowGroup> monthTotal = store.aggregate(month, byNothing, threads);
+        uint64_t dayCount = 0, dayPoints = 0;
+        for (const ThrowGroup &day : days) {
+            dayCount += day.count;
+            dayPoints += day.points;
+        }
+        ok = ok && !days.empty() && days.size() <= 31 && monthTotal.size() == 1 && monthTotal[0].count == dayCount && monthTotal[0].points == dayPoints;
+
+        // the first player's median and 90th percentile
+        ThrowFilter first;
+        first.player = 0;
+        start = steady_clock::now();
+        std::array<uint64_t, ThrowStore::MAX_POINTS + 1> counted = store.histogram(first, threads);
+        int median = store.percentile(first, 50, threads), top = store.percentile(first, 90, threads);
+        double percentileSeconds = secondsSince(start) / 3;
+        ok = ok && counted == histogram && median >= 0 && median <= top;
+
+        std::cout << how << ": average per player " << seconds * 1000 << " ms (" << store.size() / seconds / 1e6
+                  << " M throws/s), a year " << yearSeconds * 1000 << " ms, treble rate " << trebleSeconds * 1000
+                  << " ms, 30 days by day " << monthSeconds * 1000 << " ms, percentile " << percentileSeconds * 1000
+                  << " ms (P1 median " << median << ", 90th " << top << ")" << std::endl;
+    }
+    for (const ThrowGroup &group : everything)
+        std::printf("  P%u: %llu throws, 3-dart average %.2f\n", group.key + 1, static_cast<unsigned long long>(group.count), 3 * group.average());
+    std::cout << pool.size() << " threads, " << (playerThrows > 0 ? 100.0 * trebles / playerThrows : 0.0) << "% trebles for P1" << std::endl;
+
+    // on disk and back
+    start = steady_clock::now();
+    ok = ok && store.save(dir);
+    double saveSeconds = secondsSince(start);
+    uintmax_t bytes = 0;
+    for (const auto &entry : std::filesystem::directory_iterator(dir))
+        bytes += entry.file_size();
+    start = steady_clock::now();
+    ok = ok && store.load(dir);
+    double loadSeconds = secondsSince(start);
+    std::cout << "saved in " << saveSeconds << " s (" << static_cast<double>(bytes) / std::max<uint64_t>(throws, 1)
+              << " bytes a throw), loaded in " << loadSeconds << " s" << std::endl;
+    std::vector<ThrowGroup> loaded = store.aggregate(ThrowFilter(), byPlayer, &pool);
+    ok = ok && loaded.size() == everything.size();
+    for (size_t i = 0; ok && i < loaded.size(); ++i)
+        ok = loaded[i].key == everything[i].key && loaded[i].count == everything[i].count && loaded[i].points == everything[i].points;
+    if (!keep)
+        std::filesystem::remove_all(dir);
+
+    // a hundred million throws should be averaged by player in under a second
+    if (throws >= 100000000 && groupSeconds * 1e8 / throws >= 1.0)
+        ok = false;
+    std::cout << (ok ? "ok" : "FAILED") << std::endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,329 @@
+// Measures the dart detection pipeline on a synthetic camera recording (or a real one) and checks
+// the darts it finds against the ones that were thrown.
+//
+// The synthetic recording is a board seen at an angle, with noise on every frame; darts fly in and
+// land at random spots, three to a visit, and then a player steps in front to pull them out.
+//
+// visionBenchmark --frames 1200 --size 1280x720 [--threads <n>] [--write <dir>]
+// visionBenchmark --recording <dir> --calibration <file>
+//
+// --write saves the synthetic frames (and a calibration.txt) as PGMs and runs on them from disk.
+//
+// The darts also drive a GameClock on the recording's timeline (frame / 120 s): each visit is timed
+// from its first dart to its third and the clock is paused in between, and every split has to come
+// out exact.
+
+#include "../src/darts/boardModel.h"
+#include "../src/game/gameClock.h"
+#include "../src/vision/detectionPipeline.h"
+#include "../src/vision/kernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+static const double PI = 3.14159265358979323846;
+// frames per phase of the script
+static const int FLIGHT_FRAMES = 3, REST_FRAMES = 12, PULL_FRAMES = 4, CLEAR_FRAMES = 8;
+static const int DARTS_PER_CYCLE = 3;
+static const int CYCLE_FRAMES = DARTS_PER_CYCLE * (FLIGHT_FRAMES + REST_FRAMES) + PULL_FRAMES + CLEAR_FRAMES;
+static const int NOISE_PLANES = 4;
+// the camera's frame rate, the recording's timeline
+static const clockTime CAMERA_FPS = 120;
+// from the first dart of a visit being found to the third
+static const clockTime VISIT_TIME = 2 * (FLIGHT_FRAMES + REST_FRAMES) * GameClock::SECOND / CAMERA_FPS;
+
+/// @brief A thrown dart: where it lands and how it sticks out of the board
+struct Throw {
+    Point2 target;
+    Dart expected;
+    /// @brief Direction from the tip to the flights in the image
+    double dirX, dirY;
+};
+
+/**
+ * @brief Renders the synthetic recording frame by frame, as a camera would deliver it.
+ */
+class SyntheticRecording : public FrameSource {
+    public:
+        SyntheticRecording(int width, int height, size_t frames, unsigned seed) : frames(frames) {
+            // the board's 400 mm square seen from below and to the left
+            auto at = [&](double fx, double fy) { return Point2{fx * width, fy * height}; };
+            vector<Correspondence> corners = {{at(0.32, 0.08), {-200, 200}}, {at(0.69, 0.11), {200, 200}},
+                                              {at(0.73, 0.92), {200, -200}}, {at(0.27, 0.89), {-200, -200}}};
+            imageToBoard.fit(corners);
+            boardToImage = imageToBoard.inverse();
+
+            board.resize(width, height);
+            for (int y = 0; y < height; ++y) {
+                for (int x = 0; x < width; ++x)
+                    board.row(y)[x] = shade(imageToBoard.apply({x + 0.5, y + 0.5}));
+            }
+
+            std::minstd_rand rng(seed);
+            std::uniform_int_distribution<int> noise(-5, 5);
+            for (GrayImage &plane : noisePlanes) {
+                plane.resize(width, height);
+                for (uint8_t &pixel : plane.pixels)
+                    pixel = static_cast<uint8_t>(noise(rng));
+            }
+
+            size_t cycles = frames / CYCLE_FRAMES + 1;
+            for (size_t i = 0; i < cycles * DARTS_PER_CYCLE; ++i)
+                throws.push_back(randomThrow(rng));
+        }
+
+        size_t size() const override { return frames; }
+
+        bool load(size_t index, GrayImage &image) const override {
+            image = board;
+            size_t cycle = index / CYCLE_FRAMES;
+            // every cycle starts with the empty board, then the visit, then the darts are pulled out
+            int frame = static_cast<int>(index % CYCLE_FRAMES) - CLEAR_FRAMES;
+            int visitFrames = DARTS_PER_CYCLE * (FLIGHT_FRAMES + REST_FRAMES);
+
+            if (frame >= 0 && frame < visitFrames + PULL_FRAMES) {
+                // the darts thrown so far this visit, the newest one maybe still in flight
+                int thrown = std::min(DARTS_PER_CYCLE, frame / (FLIGHT_FRAMES + REST_FRAMES) + 1);
+                for (int d = 0; d < thrown; ++d) {
+                    int since = frame - d * (FLIGHT_FRAMES + REST_FRAMES);
+                    double away = since < FLIGHT_FRAMES ? (FLIGHT_FRAMES - since) * 45.0 : 0.0;
+                    drawDart(image, throws[cycle * DARTS_PER_CYCLE + d], away);
+                }
+            }
+            if (frame >= visitFrames && frame < visitFrames + PULL_FRAMES) {
+                // someone walks up to the board
+                int step = frame - visitFrames;
+                fillRect(image, image.width * 0.3 + step * 30, image.height * 0.25, image.width * 0.3, image.height * 0.45, 128);
+            }
+
+            const GrayImage &noise = noisePlanes[index % NOISE_PLANES];
+            for (size_t i = 0; i < image.pixels.size(); ++i) {
+                int value = image.pixels[i] + static_cast<int8_t>(noise.pixels[i]);
+                image.pixels[i] = static_cast<uint8_t>(std::clamp(value, 0, 255));
+            }
+            return true;
+        }
+
+        const Homography &getImageToBoard() const { return imageToBoard; }
+
+        /// @brief The darts that land in the first count frames
+        vector<Dart> expectedDarts(size_t count) const {
+            vector<Dart> darts;
+            for (size_t i = 0; i < count; ++i) {
+                int frame = static_cast<int>(i % CYCLE_FRAMES) - CLEAR_FRAMES;
+                // a dart is only detectable once it has been still for a couple of frames
+                if (frame >= 0 && frame < DARTS_PER_CYCLE * (FLIGHT_FRAMES + REST_FRAMES) &&
+                    frame % (FLIGHT_FRAMES + REST_FRAMES) == FLIGHT_FRAMES + 3)
+                    darts.push_back(throws[i / CYCLE_FRAMES * DARTS_PER_CYCLE + frame / (FLIGHT_FRAMES + REST_FRAMES)].expected);
+            }
+            return darts;
+        }
+
+        /// @brief Writes the four calibration corners in the format Homography::load() reads
+        void saveCalibration(const string &path) const {
+            std::ofstream file(path);
+            file << "# imageX imageY boardX boardY\n";
+            for (Point2 corner : {Point2{-200, 200}, Point2{200, 200}, Point2{200, -200}, Point2{-200, -200}}) {
+                Point2 image = boardToImage.apply(corner);
+                file << image.x << " " << image.y << " " << corner.x << " " << corner.y << "\n";
+            }
+        }
+
+    private:
+        size_t frames;
+        Homography imageToBoard, boardToImage;
+        GrayImage board;
+        GrayImage noisePlanes[NOISE_PLANES];
+        vector<Throw> throws;
+
+        /// @brief The board's colour at a point (black and cream beds, red and green rings)
+        static uint8_t shade(Point2 point) {
+            Dart dart = BoardModel::dartAt(point.x, point.y);
+            if (dart.multiplier == 0)
+                return 70;
+            if (dart.segment == 25)
+                return dart.multiplier == 2 ? 110 : 160;
+            int index = 0;
+            while (BoardModel::SEGMENTS[index] != dart.segment)
+                ++index;
+            bool even = index % 2 == 0;
+            if (dart.multiplier == 1)
+                return even ? 30 : 150;
+            return even ? 110 : 160;
+        }
+
+        Throw randomThrow(std::minstd_rand &rng) const {
+            std::uniform_int_distribution<int> segment(0, 19), ring(0, 9);
+            std::uniform_real_distribution<double> offset(-0.6, 0.6), lean(-2.4, -1.9);
+            Throw t;
+            int r = ring(rng);
+            // keep a few millimetres away from the wires, a real dart on a wire is a coin toss
+            double radius = r == 0 ? 3.0 : r == 1 ? 11.0 : r < 4 ? 103.0 : r < 6 ? 166.0 : r < 8 ? 60.0 : 135.0;
+            double angle = BoardModel::segmentAngle(BoardModel::SEGMENTS[segment(rng)]) + offset(rng) * (PI / 20);
+            t.target = {radius * std::cos(angle), radius * std::sin(angle)};
+            t.expected = BoardModel::dartAt(t.target.x, t.target.y);
+            double direction = lean(rng);
+            t.dirX = std::cos(direction);
+            t.dirY = std::sin(direction);
+            return t;
+        }
+
+        /// @brief Draws a dart: a thin barrel from the tip, then wider flights
+        /// @param away how far (pixels) before the target it still is
+        void drawDart(GrayImage &image, const Throw &t, double away) const {
+            const double barrel = 50, length = 80, barrelWidth = 1.6, flightWidth = 8;
+            Point2 tip = boardToImage.apply(t.target);
+            tip.x += t.dirX * away;
+            tip.y += t.dirY * away;
+            int x0 = std::max(0, static_cast<int>(std::min(tip.x, tip.x + t.dirX * length) - flightWidth - 1));
+            int x1 = std::min(image.width - 1, static_cast<int>(std::max(tip.x, tip.x + t.dirX * length) + flightWidth + 1));
+            int y0 = std::max(0, static_cast<int>(std::min(tip.y, tip.y + t.dirY * length) - flightWidth - 1));
+            int y1 = std::min(image.height - 1, static_cast<int>(std::max(tip.y, tip.y + t.dirY * length) + flightWidth + 1));
+            for (int y = y0; y <= y1; ++y) {
+                for (int x = x0; x <= x1; ++x) {
+                    double dx = x + 0.5 - tip.x, dy = y + 0.5 - tip.y;
+                    double along = dx * t.dirX + dy * t.dirY, across = std::fabs(dx * t.dirY - dy * t.dirX);
+                    bool inBarrel = along >= 0 && along <= barrel && across <= barrelWidth;
+                    bool inFlights = along > barrel && along <= length && across <= flightWidth;
+                    if (inBarrel || inFlights)
+                        image.row(y)[x] = 235;
+                }
+            }
+        }
+
+        static void fillRect(GrayImage &image, double x, double y, double w, double h, uint8_t value) {
+            int x0 = std::max(0, static_cast<int>(x)), x1 = std::min(image.width, static_cast<int>(x + w));
+            int y0 = std::max(0, static_cast<int>(y)), y1 = std::min(image.height, static_cast<int>(y + h));
+            for (int row = y0; row < y1; ++row)
+                std::fill(image.row(row) + x0, image.row(row) + std::max(x0, x1), value);
+        }
+};
+
+/// @brief When a frame was taken
+static clockTime frameTime(size_t frame) {
+    return static_cast<clockTime>(frame) * GameClock::SECOND / CAMERA_FPS;
+}
+
+static string dartName(Dart dart) {
+    if (dart.multiplier == 0)
+        return "miss";
+    if (dart.segment == 25)
+        return dart.multiplier == 2 ? "D25" : "25";
+    string prefix = dart.multiplier == 3 ? "T" : dart.multiplier == 2 ? "D" : "S";
+    return prefix + std::to_string(dart.segment);
+}
+
+int main(int argc, char *argv[]) {
+    size_t frames = 1200;
+    int width = 1280, height = 720, threads = 0;
+    string write, recording, calibration;
+    for (int i = 1; i + 1 < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--frames")
+            frames = std::stoul(argv[++i]);
+        else if (arg == "--size")
+            std::sscanf(argv[++i], "%dx%d", &width, &height);
+        else if (arg == "--threads")
+            threads = std::stoi(argv[++i]);
+        else if (arg == "--write")
+            write = argv[++i];
+        else if (arg == "--recording")
+            recording = argv[++i];
+        else if (arg == "--calibration")
+            calibration = argv[++i];
+    }
+
+    // a real recording: print what is found
+    if (!recording.empty()) {
+        PgmSequence sequence;
+        Homography imageToBoard;
+        if (!sequence.open(recording) || !imageToBoard.load(calibration.empty() ? recording + "/calibration.txt" : calibration))
+            return 1;
+        DetectionPipeline pipeline(sequence, imageToBoard, DetectorConfig(), threads);
+        DetectionPipeline::Stats stats = pipeline.run([](const Detection &detection) {
+            std::cout << "frame " << detection.frame << ": " << dartName(detection.dart) << " at (" << detection.board.x
+                      << ", " << detection.board.y << ") mm" << std::endl;
+        });
+        std::cout << stats.frames << " frames, " << stats.darts << " darts, " << stats.frames / stats.seconds << " frames/s" << std::endl;
+        return 0;
+    }
+
+    std::cout << "Rendering " << frames << " synthetic " << width << "x" << height << " frames..." << std::endl;
+    SyntheticRecording synthetic(width, height, frames, 1234u);
+    vector<Dart> expected = synthetic.expectedDarts(frames);
+
+    const FrameSource *source = &synthetic;
+    PgmSequence sequence;
+    if (!write.empty()) {
+        std::filesystem::create_directories(write);
+        GrayImage image;
+        for (size_t i = 0; i < frames; ++i) {
+            char name[32];
+            std::snprintf(name, sizeof(name), "/frame%06zu.pgm", i);
+            synthetic.load(i, image);
+            if (!savePgm(write + name, image))
+                return 1;
+        }
+        synthetic.saveCalibration(write + "/calibration.txt");
+        if (!sequence.open(write))
+            return 1;
+        source = &sequence;
+    }
+
+    vector<Dart> found;
+    found.reserve(expected.size());
+    // one player throwing every visit, the clock only runs while they're at the oche
+    GameClock clock;
+    clock.reset(frameTime(0));
+    clock.pause(frameTime(0));
+    size_t visits = 0, visitsExact = 0;
+    DetectionPipeline pipeline(*source, synthetic.getImageToBoard(), DetectorConfig(), threads);
+    DetectionPipeline::Stats stats = pipeline.run([&](const Detection &detection) {
+        clockTime now = frameTime(detection.frame);
+        if (found.size() % DARTS_PER_CYCLE == 0) {
+            clock.resume(now);
+            clock.startVisit(0, now);
+        }
+        found.push_back(detection.dart);
+        if (found.size() % DARTS_PER_CYCLE == 0) {
+            clock.endVisit(now);
+            clock.pause(now);
+            visits++;
+            if (clock.getLastVisit(0) == VISIT_TIME)
+                visitsExact++;
+        }
+    });
+    // the clock and its pauses add up to the whole recording, and it only ran during visits
+    clockTime end = frameTime(stats.frames);
+    bool clockOk = visitsExact == visits && clock.getElapsed(end) + clock.getPausedTime(end) == end &&
+                   clock.getPlayerTime(0, end) == clock.getElapsed(end);
+
+    size_t correct = 0;
+    for (size_t i = 0; i < std::min(found.size(), expected.size()); ++i) {
+        if (found[i].segment == expected[i].segment && found[i].multiplier == expected[i].multiplier)
+            correct++;
+        else
+            std::cout << "dart " << i << ": found " << dartName(found[i]) << ", thrown " << dartName(expected[i]) << std::endl;
+    }
+    double fps = stats.frames / stats.seconds;
+    std::cout << "kernels: " << Kernels::instructionSet() << ", source: " << (write.empty() ? "memory" : write) << std::endl;
+    std::cout << stats.frames << " frames in " << stats.seconds << " s: " << fps << " frames/s ("
+              << 1000.0 / fps << " ms per frame)" << std::endl;
+    std::cout << "darts: " << found.size() << " found, " << expected.size() << " thrown, " << correct << " scored right" << std::endl;
+    char visitText[24], clockText[24];
+    GameClock::format(clock.getAverageVisit(0), visitText, sizeof(visitText));
+    GameClock::format(clock.getElapsed(end), clockText, sizeof(clockText));
+    std::cout << "clock: " << visits << " visits, " << visitsExact << " timed exactly, average " << visitText
+              << ", " << clockText << " at the oche" << (clockOk ? "" : " (WRONG)") << std::endl;
+
+    // the camera delivers 120 frames per second, anything slower falls behind
+    bool ok = fps >= 120 && found.size() == expected.size() && correct == expected.size() && clockOk;
+    return ok ? 0 : 1;
+}